@@ -4,8 +4,12 @@
 
 #include "harness/Benchmark.h"
 #include <icl/core/Img.h>
+#include <icl/core/BayerConverter.h>
 #include <icl/core/CCFunctions.h>
+#include <icl/core/CoreFunctions.h>
+#include <icl/utils/StringUtils.h>
 
+using namespace icl;
 using namespace icl::utils;
 using namespace icl::core;
 
@@ -65,6 +69,69 @@ namespace {
     }
   });
 
+  static BenchmarkRegistrar bench_cc_matrix({"core.cc.matrix",
+    "Any color conversion, e.g. src=rgb dst=lab srcDepth=8u dstDepth=32f (mt=0: single-threaded)",
+    {BenchParamDef::Str("src", "rgb"),
+     BenchParamDef::Str("dst", "hls"),
+     BenchParamDef::Str("srcDepth", "8u"),
+     BenchParamDef::Str("dstDepth", "8u"),
+     BenchParamDef::Int("mt", 1, 0, 1),
+     BenchParamDef::Int("roi", 0, 0, 1),
+     BenchParamDef::Int("width", 1920, 64, 7680),
+     BenchParamDef::Int("height", 1080, 64, 4320)},
+    [](const BenchParams &p){
+      static ImgBase *src = nullptr, *dst = nullptr;
+      const Size size(p.getInt("width"), p.getInt("height"));
+      const Rect roi = p.getInt("roi") ? Rect(size.width/8, size.height/8, size.width*3/4, size.height*3/4)
+                                       : Rect(Point::null, size);
+      const format srcFmt = parse<format>(p.getStr("src"));
+      const depth srcDepth = parse<depth>(p.getStr("srcDepth"));
+      if(!src || src->getSize() != size || src->getFormat() != srcFmt || src->getDepth() != srcDepth){
+        // all channels cover the full range (dark pixels included)
+        Img8u pattern(size, srcFmt);
+        for(int c = 0; c < pattern.getChannels(); ++c){
+          icl8u *d = pattern.getData(c);
+          for(int i = 0; i < pattern.getDim(); ++i) d[i] = static_cast<icl8u>(i * (c + 1) * 7 / 5);
+        }
+        ensureCompatible(&src, srcDepth, size, srcFmt);
+        pattern.convert(src);
+      }
+      src->setROI(roi);
+      ensureCompatible(&dst, parse<depth>(p.getStr("dstDepth")), size, parse<format>(p.getStr("dst")), roi);
+      setCCMultiThreaded(p.getInt("mt"));
+      cc(src, dst, p.getInt("roi"));
+      setCCMultiThreaded(true);
+    }
+  });
+
+  // --- Bayer demosaicing benchmarks ---
+
+  static BenchmarkRegistrar bench_bayer({"core.bayer",
+    "Bayer to RGB conversion, default 5MP (method=bilinear|hqLinear|edgeSense|simple|nearestNeighbor, out=planar|interleaved)",
+    {BenchParamDef::Str("method", "bilinear"),
+     BenchParamDef::Str("out", "planar"),
+     BenchParamDef::Int("mt", 1, 0, 1),
+     BenchParamDef::Int("width", 2448, 64, 7680),
+     BenchParamDef::Int("height", 2048, 64, 4320)},
+    [](const BenchParams &p){
+      static Img8u src, dst;
+      static std::vector<icl8u> rgb;
+      const Size size(p.getInt("width"), p.getInt("height"));
+      if(src.getSize() != size){
+        src = Img8u(size, 1);
+        for(int i = 0; i < size.getDim(); ++i) src.getData(0)[i] = static_cast<icl8u>(i * 7 / 5 + i / size.width);
+      }
+      BayerConverter bc("RGGB", p.getStr("method"));
+      bc.setMultiThreaded(p.getInt("mt"));
+      if(p.getStr("out") == "interleaved"){
+        rgb.resize(size.getDim() * 3);
+        bc.applyInterleaved(src, rgb.data());
+      }else{
+        bc.apply(src, dst);
+      }
+    }
+  });
+
   // --- Image scaling benchmarks ---
 
   static BenchmarkRegistrar bench_scale_nn_8u({"core.scale.nn_8u",
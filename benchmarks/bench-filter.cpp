@@ -17,6 +17,7 @@
 #include <icl/filter/BinaryLogicalOp.h>
 #include <icl/filter/WarpOp.h>
 #include <icl/filter/BilateralFilterOp.h>
+#include <icl/filter/CannyOp.h>
 
 using namespace icl::utils;
 using namespace icl::core;
@@ -375,4 +376,29 @@ namespace {
     }
   });
 
+  // ================================================================
+  // CannyOp benchmarks
+  // ================================================================
+
+  static BenchmarkRegistrar bench_canny_8u({"filter.canny.sobel_8u",
+    "Canny on icl8u: fused 8u mode vs. separate derivative images",
+    {BenchParamDef::Int("width", 640, 64, 7680),
+     BenchParamDef::Int("height", 480, 64, 4320),
+     BenchParamDef::Str("mode", "fused"),
+     BenchParamDef::Str("backend", "auto"),
+     BenchParamDef::Int("threads", 1, 0, 64)},
+    [](const BenchParams &p){
+      int w = p.getInt("width"), h = p.getInt("height");
+      Img8u src = Img8u::from(w, h, 1, [](int x, int y, int) -> icl::icl8u {
+        return ((x / 32 + y / 32) % 2) ? 200 : 50;
+      });
+      // mode: "fused" or "separate"; threads: 0 = all pool threads
+      CannyOp op(30, 120);
+      op.setMode(p.getStr("mode") == "fused" ? CannyOp::fused8u : CannyOp::separateDerivatives);
+      op.setThreadCount(p.getInt("threads"));
+      applyBackend(op, p.getStr("backend"));
+      op.apply(Image(src));
+    }
+  });
+
 } // anonymous namespace
@@ -0,0 +1,140 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// ICL - Image Component Library (https://github.com/iclcv/icl)
+// Copyright (C) 2006-2026 Christof Elbrechter
+
+#include "harness/Benchmark.h"
+#include <icl/core/Img.h>
+#include <icl/geom/PointCloudNormalEstimator.h>
+#include <icl/geom/PointToPlaneICP.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace icl::utils;
+using namespace icl::core;
+using namespace icl::geom;
+
+namespace {
+
+  /// synthetic depth image: a tilted, curved surface with a box in front of it
+  const Img32f &depth_image(int w, int h){
+    static Img32f depth;
+    if(depth.getWidth() != w || depth.getHeight() != h){
+      depth = Img32f(Size(w,h), 1);
+      for(int y = 0; y < h; ++y){
+        for(int x = 0; x < w; ++x){
+          float v = 1000 + 0.5f*x + 0.2f*y + 50*std::sin(x*0.05f)*std::cos(y*0.03f);
+          if(x > w/2 && x < w/2 + w/6 && y > h/3 && y < h/3 + h/5) v -= 300;
+          depth(x,y,0) = v + ((x*7 + y*13) % 11) * 0.5f;
+        }
+      }
+    }
+    return depth;
+  }
+
+  PointCloudNormalEstimator &estimator(int w, int h){
+    static std::unique_ptr<PointCloudNormalEstimator> e;
+    static Size size;
+    if(!e || size != Size(w,h)){
+      size = Size(w,h);
+      e = std::make_unique<PointCloudNormalEstimator>(size);
+      e->setUseCL(false);
+    }
+    return *e;
+  }
+
+  static BenchmarkRegistrar bench_normals({"geom.normals",
+    "PointCloudNormalEstimator CPU path: fused calculate() vs. the separate stages",
+    {BenchParamDef::Int("width", 640, 64, 3840),
+     BenchParamDef::Int("height", 480, 64, 2160),
+     BenchParamDef::Str("path", "fused"),
+     BenchParamDef::Int("median", 3, 1, 9),
+     BenchParamDef::Int("smoothing", 2, 0, 2),
+     BenchParamDef::Int("range", 2, 1, 7)},
+    [](const BenchParams &p){
+      int w = p.getInt("width"), h = p.getInt("height");
+      int median = p.getInt("median"), smoothing = p.getInt("smoothing");
+      const Img32f &depth = depth_image(w, h);
+      PointCloudNormalEstimator &e = estimator(w, h);
+      e.setMedianFilterSize(median);
+      e.setNormalAveragingRange(p.getInt("range"));
+      e.setAngleNeighborhoodRange(p.getInt("range"));
+      // path: "fused" or "stages"; smoothing: 0 = none, 1 = box averaging, 2 = gaussian
+      if(p.getStr("path") == "fused"){
+        e.calculate(depth, median > 1, smoothing > 0, smoothing == 2);
+      }else{
+        e.setUseNormalAveraging(smoothing > 0);
+        e.setUseGaussSmoothing(smoothing == 2);
+        e.setDepthImage(depth);
+        if(median > 1) e.applyMedianFilter();
+        else e.setFilteredDepthImage(depth);
+        e.applyNormalCalculation(); // includes the smoothing
+        e.applyAngleImageCalculation();
+        e.applyImageBinarization();
+      }
+    }
+  });
+
+  /// organized point clouds for the ICP benchmark: the depth image seen by
+  /// a pinhole camera (target, with normals) and a slightly moved copy (source)
+  struct ICPClouds {
+    Size size;
+    Camera camera;
+    std::vector<Vec> target, normals, source;
+    DataSegment<float,4> seg(std::vector<Vec> &v){
+      return DataSegment<float,4>(&v[0][0], sizeof(Vec), v.size(), size.width);
+    }
+  };
+
+  ICPClouds &icp_clouds(int w, int h){
+    static ICPClouds c;
+    if(c.size == Size(w,h)) return c;
+    c.size = Size(w,h);
+    c.camera = Camera(Vec(0,0,0,1), Vec(0,0,1,1), Vec(0,1,0,1), 3,
+                      Point32f(w/2,h/2), 175, 175);
+    const Img32f &depth = depth_image(w, h);
+    const float f = 3 * 175;
+    c.target.resize(w*h);
+    for(int y = 0; y < h; ++y){
+      for(int x = 0; x < w; ++x){
+        const float z = depth(x,y,0);
+        c.target[x+y*w] = Vec((x-w/2)*z/f, (y-h/2)*z/f, z, 1);
+      }
+    }
+    c.normals.assign(w*h, Vec(0,0,0,0));
+    for(int y = 1; y < h-1; ++y){
+      for(int x = 1; x < w-1; ++x){
+        Vec n = cross(c.target[x+1+y*w] - c.target[x-1+y*w],
+                      c.target[x+(y+1)*w] - c.target[x+(y-1)*w]);
+        const float l = std::sqrt(n[0]*n[0] + n[1]*n[1] + n[2]*n[2]);
+        if(l > 0) c.normals[x+y*w] = Vec(n[0]/l, n[1]/l, n[2]/l, 0);
+      }
+    }
+    const float a = 0.02f;
+    const Mat motion(std::cos(a), 0, std::sin(a), 15,
+                     0, 1, 0, -10,
+                     -std::sin(a), 0, std::cos(a), 20,
+                     0, 0, 0, 1);
+    c.source.resize(w*h);
+    for(int i = 0; i < w*h; ++i) c.source[i] = motion * c.target[i];
+    return c;
+  }
+
+  static BenchmarkRegistrar bench_icp({"geom.icp",
+    "PointToPlaneICP on organized clouds: projective vs. k-d tree association",
+    {BenchParamDef::Int("width", 640, 64, 3840),
+     BenchParamDef::Int("height", 480, 64, 2160),
+     BenchParamDef::Str("association", "projective"),
+     BenchParamDef::Int("levels", 3, 1, 6)},
+    [](const BenchParams &p){
+      ICPClouds &c = icp_clouds(p.getInt("width"), p.getInt("height"));
+      // association: "projective" or "kdtree" (includes building the tree)
+      PointToPlaneICP icp(20, 100, p.getInt("levels"));
+      icp.setTarget(c.seg(c.target), c.seg(c.normals));
+      if(p.getStr("association") == "projective") icp.setTargetCamera(c.camera);
+      icp.apply(c.seg(c.source));
+    }
+  });
+
+} // anonymous namespace
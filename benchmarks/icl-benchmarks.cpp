@@ -14,7 +14,7 @@ int main(int argc, char **argv){
   pa_init(argc, argv,
     "-list|-l "
     "-filter|-f(pattern=*) "
-    "-param|-p(...params) "
+    "-param|-p(...) "
     "-iterations|-n(int=50) "
     "-warmup|-w(double=2.0) "
     "-csv "
@@ -6,6 +6,13 @@
 #include <icl/core/CoreFunctions.h>
 #include <icl/core/CCFunctions.h>
 #include <icl/utils/Exception.h>
+#include <icl/utils/SSETypes.h>
+#include <icl/utils/ThreadPool.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <type_traits>
+#include <vector>
 
 using namespace icl::utils;
 
@@ -26,43 +33,400 @@ namespace icl::core {
 
   BayerConverter::~BayerConverter() { }
 
+  namespace {
+    /// conversions run on the ThreadPool for images with at least this number of pixels
+    constexpr int BAYER_PARALLEL_PIXELS = 1 << 16;
+
+    /// approximate number of pixels per band
+    constexpr int BAYER_BAND_PIXELS = 1 << 15;
+
+    /// reflects i into [0,n) (i = -1 -> 1, n -> n-2), which preserves the bayer cell
+    inline int mirror(int i, int n){
+      if(n == 1) return 0;
+      while(i < 0 || i >= n) i = i < 0 ? -i : 2 * n - 2 - i;
+      return i;
+    }
+
+    inline int clip8u(int v){
+      return v < 0 ? 0 : v > 255 ? 255 : v;
+    }
+
+    /// Input of a row kernel
+    /** Rows with a red pixel are called A-rows with A = red, the others
+        A-rows with A = blue. In both, the non-green pixels (A pixels) sit
+        at x-parity aParity. The kernels compute five candidates per pixel:
+        c: center, h: value of the horizontal neighbours' color, v: value
+        of the vertical neighbours' color, g: green at an A pixel, d: value
+        of the diagonal neighbours' color at an A pixel. */
+    struct RowCtx {
+      const icl8u *r[5];   ///< bayer rows y-2..y+2 (mirrored at the border)
+      const icl8u *gp[3];  ///< interpolated green rows y-1..y+1 (edgeSense only)
+      int w;
+      int aParity;
+    };
+
+    template<bool BORDER>
+    inline int px(const icl8u *row, int x, int w){
+      return row[BORDER ? mirror(x, w) : x];
+    }
+
+    struct Bilinear {
+      template<bool B>
+      static void pixel(const RowCtx &r, int x, int &c, int &h, int &v, int &g, int &d){
+        const int w = r.w;
+        const int N = px<B>(r.r[1],x,w), S = px<B>(r.r[3],x,w);
+        const int W = px<B>(r.r[2],x-1,w), E = px<B>(r.r[2],x+1,w);
+        c = px<B>(r.r[2],x,w);
+        h = (W + E + 1) >> 1;
+        v = (N + S + 1) >> 1;
+        g = (N + S + W + E + 2) >> 2;
+        d = (px<B>(r.r[1],x-1,w) + px<B>(r.r[1],x+1,w) + px<B>(r.r[3],x-1,w) + px<B>(r.r[3],x+1,w) + 2) >> 2;
+      }
+    };
+
+    /// Malvar-He-Cutler kernels (as in libdc's hqLinear)
+    struct HQLinear {
+      template<bool B>
+      static void pixel(const RowCtx &r, int x, int &c, int &h, int &v, int &g, int &d){
+        const int w = r.w;
+        const int N = px<B>(r.r[1],x,w), S = px<B>(r.r[3],x,w);
+        const int W = px<B>(r.r[2],x-1,w), E = px<B>(r.r[2],x+1,w);
+        const int N2 = px<B>(r.r[0],x,w), S2 = px<B>(r.r[4],x,w);
+        const int W2 = px<B>(r.r[2],x-2,w), E2 = px<B>(r.r[2],x+2,w);
+        const int D = px<B>(r.r[1],x-1,w) + px<B>(r.r[1],x+1,w) + px<B>(r.r[3],x-1,w) + px<B>(r.r[3],x+1,w);
+        c = px<B>(r.r[2],x,w);
+        h = clip8u((5*c + 4*(W + E) - W2 - E2 - D + ((N2 + S2 + 1) >> 1) + 4) >> 3);
+        v = clip8u((5*c + 4*(N + S) - N2 - S2 - D + ((W2 + E2 + 1) >> 1) + 4) >> 3);
+        g = clip8u((2*(N + S + W + E) - (N2 + S2 + W2 + E2) + 4*c + 4) >> 3);
+        d = clip8u((2*D - ((3*(N2 + S2 + W2 + E2) + 1) >> 1) + 6*c + 4) >> 3);
+      }
+    };
+
+    /// green interpolated along the smaller gradient (used by EdgeSense)
+    template<bool B>
+    inline int edge_green(const icl8u *const *r, int x, int w, bool isA){
+      const int c = px<B>(r[2],x,w);
+      if(!isA) return c;
+      const int N = px<B>(r[1],x,w), S = px<B>(r[3],x,w);
+      const int W = px<B>(r[2],x-1,w), E = px<B>(r[2],x+1,w);
+      const int dh = std::abs(W - E) + std::abs(2*c - px<B>(r[2],x-2,w) - px<B>(r[2],x+2,w));
+      const int dv = std::abs(N - S) + std::abs(2*c - px<B>(r[0],x,w) - px<B>(r[4],x,w));
+      return dh < dv ? (W + E + 1) >> 1 : dv < dh ? (N + S + 1) >> 1 : (N + S + W + E + 2) >> 2;
+    }
+
+    /// red and blue from the color differences to the interpolated green
+    struct EdgeSense {
+      template<bool B>
+      static void pixel(const RowCtx &r, int x, int &c, int &h, int &v, int &g, int &d){
+        const int w = r.w;
+        auto diff = [&](int k, int dx){ return px<B>(r.r[k+1],x+dx,w) - px<B>(r.gp[k],x+dx,w); };
+        c = px<B>(r.r[2],x,w);
+        g = px<B>(r.gp[1],x,w);
+        h = clip8u(g + ((diff(1,-1) + diff(1,1) + 1) >> 1));
+        v = clip8u(g + ((diff(0,0) + diff(2,0) + 1) >> 1));
+        d = clip8u(g + ((diff(0,-1) + diff(0,1) + diff(2,-1) + diff(2,1) + 2) >> 2));
+      }
+    };
+
+    template<class M, bool B>
+    inline void scalar_pixel(const RowCtx &r, int x, icl8u *a, icl8u *gr, icl8u *o){
+      int c, h, v, g, d;
+      M::template pixel<B>(r, x, c, h, v, g, d);
+      if((x & 1) == r.aParity){
+        a[x] = c; gr[x] = g; o[x] = d;
+      }else{
+        a[x] = h; gr[x] = c; o[x] = v;
+      }
+    }
+
+    template<bool B>
+    inline void scalar_green(const RowCtx &r, int x, icl8u *dst){
+      dst[x] = edge_green<B>(r.r, x, r.w, (x & 1) == r.aParity);
+    }
+
+#ifdef ICL_HAVE_SSE2
+    /// 8 pixels at x as 16 bit values
+    inline __m128i load8(const icl8u *p){
+      return _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)), _mm_setzero_si128());
+    }
+
+    inline void store8(icl8u *p, __m128i v){
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(p), _mm_packus_epi16(v, v));
+    }
+
+    inline __m128i select(__m128i mask, __m128i a, __m128i b){
+      return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+    }
+
+    inline __m128i abs16(__m128i v){
+      return _mm_max_epi16(v, _mm_sub_epi16(_mm_setzero_si128(), v));
+    }
+
+    /// lanes of A pixels, x must be even
+    inline __m128i a_mask(int aParity){
+      return aParity ? _mm_set_epi16(-1,0,-1,0,-1,0,-1,0) : _mm_set_epi16(0,-1,0,-1,0,-1,0,-1);
+    }
+
+    /// (a+b+1)>>1 and (a+b+c+d+2)>>2 of 16 bit values
+    inline __m128i mean2(__m128i a, __m128i b){
+      return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(a, b), _mm_set1_epi16(1)), 1);
+    }
+
+    inline __m128i mean4(__m128i a, __m128i b, __m128i c, __m128i d){
+      return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(_mm_add_epi16(a, b), _mm_add_epi16(c, d)),
+                                          _mm_set1_epi16(2)), 2);
+    }
+
+    struct Bilinear8 {
+      static void pixels(const RowCtx &r, int x, __m128i &c, __m128i &h, __m128i &v, __m128i &g, __m128i &d){
+        const __m128i N = load8(r.r[1]+x), S = load8(r.r[3]+x);
+        const __m128i W = load8(r.r[2]+x-1), E = load8(r.r[2]+x+1);
+        c = load8(r.r[2]+x);
+        h = mean2(W, E);
+        v = mean2(N, S);
+        g = mean4(N, S, W, E);
+        d = mean4(load8(r.r[1]+x-1), load8(r.r[1]+x+1), load8(r.r[3]+x-1), load8(r.r[3]+x+1));
+      }
+    };
+
+    struct HQLinear8 {
+      static void pixels(const RowCtx &r, int x, __m128i &c, __m128i &h, __m128i &v, __m128i &g, __m128i &d){
+        const __m128i N = load8(r.r[1]+x), S = load8(r.r[3]+x);
+        const __m128i W = load8(r.r[2]+x-1), E = load8(r.r[2]+x+1);
+        const __m128i N2 = load8(r.r[0]+x), S2 = load8(r.r[4]+x);
+        const __m128i W2 = load8(r.r[2]+x-2), E2 = load8(r.r[2]+x+2);
+        const __m128i D = _mm_add_epi16(_mm_add_epi16(load8(r.r[1]+x-1), load8(r.r[1]+x+1)),
+                                        _mm_add_epi16(load8(r.r[3]+x-1), load8(r.r[3]+x+1)));
+        c = load8(r.r[2]+x);
+        const __m128i four = _mm_set1_epi16(4);
+        const __m128i c5 = _mm_add_epi16(_mm_slli_epi16(c, 2), c);
+        const __m128i NS = _mm_add_epi16(N, S), WE = _mm_add_epi16(W, E);
+        const __m128i NS2 = _mm_add_epi16(N2, S2), WE2 = _mm_add_epi16(W2, E2);
+        // all intermediate values lie within [-1530,3570]
+        h = _mm_add_epi16(_mm_sub_epi16(_mm_add_epi16(c5, _mm_slli_epi16(WE, 2)), _mm_add_epi16(WE2, D)),
+                          mean2(N2, S2));
+        v = _mm_add_epi16(_mm_sub_epi16(_mm_add_epi16(c5, _mm_slli_epi16(NS, 2)), _mm_add_epi16(NS2, D)),
+                          mean2(W2, E2));
+        const __m128i all2 = _mm_add_epi16(NS2, WE2);
+        g = _mm_add_epi16(_mm_sub_epi16(_mm_slli_epi16(_mm_add_epi16(NS, WE), 1), all2), _mm_slli_epi16(c, 2));
+        const __m128i all2x3 = _mm_add_epi16(_mm_add_epi16(all2, all2), all2);
+        const __m128i c6 = _mm_slli_epi16(_mm_add_epi16(_mm_add_epi16(c, c), c), 1);
+        d = _mm_add_epi16(_mm_sub_epi16(_mm_slli_epi16(D, 1),
+                                        _mm_srai_epi16(_mm_add_epi16(all2x3, _mm_set1_epi16(1)), 1)), c6);
+        // negative values are clamped by the final packus
+        h = _mm_srai_epi16(_mm_add_epi16(h, four), 3);
+        v = _mm_srai_epi16(_mm_add_epi16(v, four), 3);
+        g = _mm_srai_epi16(_mm_add_epi16(g, four), 3);
+        d = _mm_srai_epi16(_mm_add_epi16(d, four), 3);
+      }
+    };
+
+    struct EdgeSense8 {
+      static void pixels(const RowCtx &r, int x, __m128i &c, __m128i &h, __m128i &v, __m128i &g, __m128i &d){
+        auto diff = [&](int k, int dx){ return _mm_sub_epi16(load8(r.r[k+1]+x+dx), load8(r.gp[k]+x+dx)); };
+        c = load8(r.r[2]+x);
+        g = load8(r.gp[1]+x);
+        const __m128i one = _mm_set1_epi16(1);
+        h = _mm_add_epi16(g, _mm_srai_epi16(_mm_add_epi16(_mm_add_epi16(diff(1,-1), diff(1,1)), one), 1));
+        v = _mm_add_epi16(g, _mm_srai_epi16(_mm_add_epi16(_mm_add_epi16(diff(0,0), diff(2,0)), one), 1));
+        d = _mm_add_epi16(g, _mm_srai_epi16(_mm_add_epi16(_mm_add_epi16(_mm_add_epi16(diff(0,-1), diff(0,1)),
+                                                                        _mm_add_epi16(diff(2,-1), diff(2,1))),
+                                                          _mm_set1_epi16(2)), 2));
+      }
+    };
+
+    inline __m128i edge_green8(const RowCtx &r, int x, __m128i mask){
+      const __m128i N = load8(r.r[1]+x), S = load8(r.r[3]+x);
+      const __m128i W = load8(r.r[2]+x-1), E = load8(r.r[2]+x+1);
+      const __m128i c = load8(r.r[2]+x);
+      const __m128i c2 = _mm_add_epi16(c, c);
+      const __m128i dh = _mm_add_epi16(abs16(_mm_sub_epi16(W, E)),
+                                       abs16(_mm_sub_epi16(c2, _mm_add_epi16(load8(r.r[2]+x-2), load8(r.r[2]+x+2)))));
+      const __m128i dv = _mm_add_epi16(abs16(_mm_sub_epi16(N, S)),
+                                       abs16(_mm_sub_epi16(c2, _mm_add_epi16(load8(r.r[0]+x), load8(r.r[4]+x)))));
+      __m128i g = select(_mm_cmplt_epi16(dh, dv), mean2(W, E),
+                         select(_mm_cmplt_epi16(dv, dh), mean2(N, S), mean4(N, S, W, E)));
+      return select(mask, g, c);
+    }
+
+    template<class M> struct Simd;
+    template<> struct Simd<Bilinear> { using type = Bilinear8; };
+    template<> struct Simd<HQLinear> { using type = HQLinear8; };
+    template<> struct Simd<EdgeSense> { using type = EdgeSense8; };
+#endif
+
+    /// computes the columns [x0,x1) of the interior (2 <= x0, x1 <= w-2)
+    template<class M>
+    void interior_row(const RowCtx &r, int x0, int x1, icl8u *a, icl8u *g, icl8u *o){
+      int x = x0;
+#ifdef ICL_HAVE_SSE2
+      const __m128i mask = a_mask(r.aParity);
+      for(; x + 8 <= x1; x += 8){
+        __m128i c, h, v, gg, d;
+        Simd<M>::type::pixels(r, x, c, h, v, gg, d);
+        store8(a + x, select(mask, c, h));
+        store8(g + x, select(mask, gg, c));
+        store8(o + x, select(mask, d, v));
+      }
+#endif
+      for(; x < x1; ++x) scalar_pixel<M,false>(r, x, a, g, o);
+    }
+
+    /// converts one row into the A, green and other channel rows
+    template<class M>
+    void convert_row(const RowCtx &r, icl8u *a, icl8u *g, icl8u *o){
+      const int w = r.w;
+      const int x0 = std::min(2, w), x1 = std::max(x0, w - 2);
+      for(int x = 0; x < x0; ++x) scalar_pixel<M,true>(r, x, a, g, o);
+      // the SIMD loop starts at an even column (the lane mask assumes this)
+      interior_row<M>(r, x0, x1, a, g, o);
+      for(int x = x1; x < w; ++x) scalar_pixel<M,true>(r, x, a, g, o);
+    }
+
+    void green_row(const RowCtx &r, icl8u *dst){
+      const int w = r.w;
+      const int x0 = std::min(2, w), x1 = std::max(x0, w - 2);
+      for(int x = 0; x < x0; ++x) scalar_green<true>(r, x, dst);
+      int x = x0;
+#ifdef ICL_HAVE_SSE2
+      const __m128i mask = a_mask(r.aParity);
+      for(; x + 8 <= x1; x += 8) store8(dst + x, edge_green8(r, x, mask));
+#endif
+      for(; x < x1; ++x) scalar_green<false>(r, x, dst);
+      for(x = x1; x < w; ++x) scalar_green<true>(r, x, dst);
+    }
+
+    /// Converts the rows [y0,y1) of a bayer image
+    /** red is located at (rx,ry) of each 2x2 cell. If planes is null, the
+        result is interleaved into rgb */
+    template<class M>
+    void convert_band(const Img8u &src, int rx, int ry, int y0, int y1,
+                      icl8u *const *planes, icl8u *rgb, int lineStep){
+      const int w = src.getWidth(), h = src.getHeight();
+      const icl8u *data = src.getData(0);
+      auto setup = [&](RowCtx &r, int y){
+        for(int k = 0; k < 5; ++k) r.r[k] = data + static_cast<size_t>(mirror(y + k - 2, h)) * w;
+        r.w = w;
+        r.aParity = (y & 1) == ry ? rx : 1 - rx;
+      };
+
+      std::vector<icl8u> tmp(planes ? 0 : 3 * w);
+      // interpolated green of rows y-1..y+1 in a ring buffer
+      const bool edge = std::is_same_v<M,EdgeSense>;
+      std::vector<icl8u> green(edge ? 3 * w : 0);
+      auto green_of = [&](int y){ return green.data() + ((y + 3) % 3) * w; };
+      if(edge){
+        RowCtx r;
+        for(int y = y0 - 1; y <= y0; ++y){
+          setup(r, mirror(y, h));
+          green_row(r, green_of(y));
+        }
+      }
+
+      for(int y = y0; y < y1; ++y){
+        RowCtx r;
+        if(edge){
+          setup(r, mirror(y + 1, h));
+          green_row(r, green_of(y + 1));
+          for(int k = 0; k < 3; ++k) r.gp[k] = green_of(y + k - 1);
+        }
+        setup(r, y);
+        icl8u *rgbRow[3];
+        for(int c = 0; c < 3; ++c){
+          rgbRow[c] = planes ? planes[c] + static_cast<size_t>(y) * w : tmp.data() + c * w;
+        }
+        // red rows contain red and green, the others blue and green
+        const bool redRow = (y & 1) == ry;
+        convert_row<M>(r, rgbRow[redRow ? 0 : 2], rgbRow[1], rgbRow[redRow ? 2 : 0]);
+        if(!planes){
+          icl8u *d = rgb + static_cast<size_t>(y) * lineStep;
+          for(int x = 0; x < w; ++x, d += 3){
+            d[0] = rgbRow[0][x];
+            d[1] = rgbRow[1][x];
+            d[2] = rgbRow[2][x];
+          }
+        }
+      }
+    }
+
+    template<class M>
+    void convert_image(const Img8u &src, int rx, int ry, icl8u *const *planes,
+                       icl8u *rgb, int lineStep, bool mt){
+      const Size size = src.getSize();
+      if(!mt || size.getDim() < BAYER_PARALLEL_PIXELS || ThreadPool::global().getConcurrency() < 2){
+        convert_band<M>(src, rx, ry, 0, size.height, planes, rgb, lineStep);
+        return;
+      }
+      const int grain = std::max(2, BAYER_BAND_PIXELS / size.width);
+      parallelFor(0, size.height, grain, [&](int y0, int y1){
+        convert_band<M>(src, rx, ry, y0, y1, planes, rgb, lineStep);
+      });
+    }
+  }
+
   void BayerConverter::apply(const Img8u *src, ImgBase **dst) {
     ICLASSERT_THROW(src,ICLException("BayerConvert::apply: source image was NULL"));
     ensureCompatible(dst, depth8u, src->getSize(), 3, formatRGB);
-    m_buffer.resize(src->getDim()*3);
+    apply(*src, *(*dst)->asImg<icl8u>());
+  }
 
-    switch (m_eConvMethod) {
-      case nearestNeighbor:
-        FUNCTION_LOG("Nearest Neighbor interpolation");
-        nnInterpolation(src);
-        break;
+  void BayerConverter::apply(const Img8u &src, Img8u &dst) {
+    dst.setFormat(formatRGB);
+    dst.setSize(src.getSize());
+    icl8u *planes[3] = { dst.getData(0), dst.getData(1), dst.getData(2) };
+    convert(src, planes, nullptr, 0);
+  }
 
-      case bilinear:
-        FUNCTION_LOG("Bilinear interpolation");
-        bilinearInterpolation(src);
-        break;
+  void BayerConverter::applyPlanar(const Img8u &src, icl8u *r, icl8u *g, icl8u *b) {
+    ICLASSERT_THROW(r && g && b,ICLException("BayerConvert::applyPlanar: destination channel was NULL"));
+    icl8u *planes[3] = { r, g, b };
+    convert(src, planes, nullptr, 0);
+  }
 
-      case hqLinear:
-        FUNCTION_LOG("High Quality Linear interpolation");
-        hqLinearInterpolation(src);
-        break;
+  void BayerConverter::applyInterleaved(const Img8u &src, icl8u *rgb, int lineStep) {
+    ICLASSERT_THROW(rgb,ICLException("BayerConvert::applyInterleaved: destination was NULL"));
+    convert(src, nullptr, rgb, lineStep ? lineStep : 3 * src.getWidth());
+  }
 
+  void BayerConverter::convert(const Img8u &src, icl8u *const *planes, icl8u *rgb, int lineStep) {
+    if(!src.getDim()) return;
+    const int i = m_eBayerPattern - bayerPattern_RGGB;
+    const int rx = i >> 1, ry = i & 1; // position of red in the cell (RGGB,GBRG,GRBG,BGGR)
+    switch (m_eConvMethod) {
+      case bilinear:
+        convert_image<Bilinear>(src, rx, ry, planes, rgb, lineStep, m_multiThreaded);
+        return;
+      case hqLinear:
+        convert_image<HQLinear>(src, rx, ry, planes, rgb, lineStep, m_multiThreaded);
+        return;
       case edgeSense:
-        FUNCTION_LOG("Edge Sense interpolation");
-        edgeSenseInterpolation(src);
-        break;
-
-      case simple:
-        FUNCTION_LOG("Simple interpolation");
-        simpleInterpolation(src);
+        convert_image<EdgeSense>(src, rx, ry, planes, rgb, lineStep, m_multiThreaded);
+        return;
+      default:
         break;
+    }
 
-      default:
-        nnInterpolation(src);
+    m_buffer.resize(src.getDim()*3);
+    if (m_eConvMethod == simple) {
+      FUNCTION_LOG("Simple interpolation");
+      simpleInterpolation(&src);
+    } else {
+      FUNCTION_LOG("Nearest Neighbor interpolation");
+      nnInterpolation(&src);
     }
 
-    interleavedToPlanar(m_buffer.data(), (*dst)->asImg<icl8u>());
+    const int w = src.getWidth();
+    if(planes){
+      Img8u dst(src.getSize(), formatRGB, std::vector<icl8u*>(planes, planes + 3));
+      interleavedToPlanar(m_buffer.data(), &dst);
+    }else{
+      for(int y = 0; y < src.getHeight(); ++y){
+        std::copy(m_buffer.data() + y * 3 * w, m_buffer.data() + (y + 1) * 3 * w,
+                  rgb + static_cast<size_t>(y) * lineStep);
+      }
+    }
   }
+
   // TODO: add IPP backend via ippiCFAToRGB_8u_C1C3R (available in modern oneAPI IPP)
   void BayerConverter::nnInterpolation(const Img<icl8u> *poBayerImg) {
     int iWidth = poBayerImg->getWidth();
@@ -143,571 +507,6 @@ namespace icl::core {
     }
   }
 
-  void BayerConverter::bilinearInterpolation(const Img<icl8u> *poBayerImg) {
-    int iWidth = poBayerImg->getWidth();
-    int iHeight = poBayerImg->getHeight();
-    const int iBayerStep = iWidth;
-    const int iRGBStep = 3 * iWidth;
-    const icl8u *bayer = poBayerImg->getData(0);
-    icl8u *pucRGBInterImg = m_buffer.data();
-
-    int blue = m_eBayerPattern == bayerPattern_BGGR
-      || m_eBayerPattern == bayerPattern_GBRG ? -1 : 1;
-    int start_with_green = m_eBayerPattern == bayerPattern_GBRG
-      || m_eBayerPattern == bayerPattern_GRBG;
-
-    clearBorders(pucRGBInterImg, iWidth, iHeight, 1);
-    pucRGBInterImg += iRGBStep + 3 + 1;
-    iHeight -= 2;
-    iWidth -= 2;
-
-    for (; iHeight--; bayer += iBayerStep, pucRGBInterImg += iRGBStep) {
-      int t0, t1;
-      const icl8u *bayerEnd = bayer + iWidth;
-
-      if (start_with_green) {
-        /* OpenCV has a bug in the next line, which was
-           t0 = (bayer[0] + bayer[iBayerStep * 2] + 1) >> 1; */
-        t0 = (bayer[1] + bayer[iBayerStep * 2 + 1] + 1) >> 1;
-        t1 = (bayer[iBayerStep] + bayer[iBayerStep + 2] + 1) >> 1;
-        pucRGBInterImg[-blue] = static_cast<icl8u>(t0);
-        pucRGBInterImg[0] = bayer[iBayerStep + 1];
-        pucRGBInterImg[blue] = static_cast<icl8u>(t1);
-        bayer++;
-        pucRGBInterImg += 3;
-      }
-
-      if (blue > 0) {
-        for (; bayer <= bayerEnd - 2; bayer += 2, pucRGBInterImg += 6) {
-          t0 = (bayer[0] + bayer[2] + bayer[iBayerStep * 2] +
-                bayer[iBayerStep * 2 + 2] + 2) >> 2;
-          t1 = (bayer[1] + bayer[iBayerStep] +
-                bayer[iBayerStep + 2] + bayer[iBayerStep * 2 + 1] +
-                2) >> 2;
-          pucRGBInterImg[-1] = static_cast<icl8u>(t0);
-          pucRGBInterImg[0] = static_cast<icl8u>(t1);
-          pucRGBInterImg[1] = bayer[iBayerStep + 1];
-
-          t0 = (bayer[2] + bayer[iBayerStep * 2 + 2] + 1) >> 1;
-          t1 = (bayer[iBayerStep + 1] + bayer[iBayerStep + 3] +
-                1) >> 1;
-          pucRGBInterImg[2] = static_cast<icl8u>(t0);
-          pucRGBInterImg[3] = bayer[iBayerStep + 2];
-          pucRGBInterImg[4] = static_cast<icl8u>(t1);
-        }
-      } else {
-        for (; bayer <= bayerEnd - 2; bayer += 2, pucRGBInterImg += 6) {
-          t0 = (bayer[0] + bayer[2] + bayer[iBayerStep * 2] +
-                bayer[iBayerStep * 2 + 2] + 2) >> 2;
-          t1 = (bayer[1] + bayer[iBayerStep] +
-                bayer[iBayerStep + 2] + bayer[iBayerStep * 2 + 1] +
-                2) >> 2;
-          pucRGBInterImg[1] = static_cast<icl8u>(t0);
-          pucRGBInterImg[0] = static_cast<icl8u>(t1);
-          pucRGBInterImg[-1] = bayer[iBayerStep + 1];
-
-          t0 = (bayer[2] + bayer[iBayerStep * 2 + 2] + 1) >> 1;
-          t1 = (bayer[iBayerStep + 1] + bayer[iBayerStep + 3] +
-                1) >> 1;
-          pucRGBInterImg[4] = static_cast<icl8u>(t0);
-          pucRGBInterImg[3] = bayer[iBayerStep + 2];
-          pucRGBInterImg[2] = static_cast<icl8u>(t1);
-        }
-      }
-
-      if (bayer < bayerEnd) {
-        t0 = (bayer[0] + bayer[2] + bayer[iBayerStep * 2] +
-              bayer[iBayerStep * 2 + 2] + 2) >> 2;
-        t1 = (bayer[1] + bayer[iBayerStep] +
-              bayer[iBayerStep + 2] + bayer[iBayerStep * 2 + 1] +
-              2) >> 2;
-        pucRGBInterImg[-blue] = static_cast<icl8u>(t0);
-        pucRGBInterImg[0] = static_cast<icl8u>(t1);
-        pucRGBInterImg[blue] = bayer[iBayerStep + 1];
-        bayer++;
-        pucRGBInterImg += 3;
-      }
-
-      bayer -= iWidth;
-      pucRGBInterImg -= iWidth * 3;
-
-      blue = -blue;
-      start_with_green = !start_with_green;
-    }
-  }
-
-  void BayerConverter::hqLinearInterpolation(const Img<icl8u> *poBayerImg) {
-    int iWidth = poBayerImg->getWidth();
-    int iHeight = poBayerImg->getHeight();
-    const int iBayerStep = iWidth;
-    const int iRGBStep = 3 * iWidth;
-    const icl8u *bayer = poBayerImg->getData(0);
-    icl8u *pucRGBInterImg = m_buffer.data();
-
-    int blue = m_eBayerPattern == bayerPattern_BGGR
-      || m_eBayerPattern == bayerPattern_GBRG ? -1 : 1;
-    int start_with_green = m_eBayerPattern == bayerPattern_GBRG
-      || m_eBayerPattern == bayerPattern_GRBG;
-
-    clearBorders(pucRGBInterImg, iWidth, iHeight, 1);
-    pucRGBInterImg += 2 * iRGBStep + 6 + 1;
-    iHeight -= 4;
-    iWidth -= 4;
-
-    /* We begin with a (+1 line,+1 column) offset with respect to bilinear decoding, so start_with_green is the same, but blue is opposite */
-    blue = -blue;
-
-    for (; iHeight--; bayer += iBayerStep, pucRGBInterImg += iRGBStep) {
-      int t0, t1;
-      const icl8u *bayerEnd = bayer + iWidth;
-      const int iBayerStep2 = iBayerStep * 2;
-      const int iBayerStep3 = iBayerStep * 3;
-      const int iBayerStep4 = iBayerStep * 4;
-
-      if (start_with_green) {
-        /* at green pixel */
-        pucRGBInterImg[0] = bayer[iBayerStep2 + 2];
-        t0 = pucRGBInterImg[0] * 5
-          + ((bayer[iBayerStep + 2] + bayer[iBayerStep3 + 2]) << 2)
-          - bayer[2]
-          - bayer[iBayerStep + 1]
-          - bayer[iBayerStep + 3]
-          - bayer[iBayerStep3 + 1]
-          - bayer[iBayerStep3 + 3]
-          - bayer[iBayerStep4 + 2]
-          + ((bayer[iBayerStep2] + bayer[iBayerStep2 + 4] + 1) >> 1);
-        t1 = pucRGBInterImg[0] * 5 +
-          ((bayer[iBayerStep2 + 1] + bayer[iBayerStep2 + 3]) << 2)
-          - bayer[iBayerStep2]
-          - bayer[iBayerStep + 1]
-          - bayer[iBayerStep + 3]
-          - bayer[iBayerStep3 + 1]
-          - bayer[iBayerStep3 + 3]
-          - bayer[iBayerStep2 + 4]
-          + ((bayer[2] + bayer[iBayerStep4 + 2] + 1) >> 1);
-        t0 = (t0 + 4) >> 3;
-        clip(&t0, &pucRGBInterImg[-blue]);
-        t1 = (t1 + 4) >> 3;
-        clip(&t1, &pucRGBInterImg[blue]);
-        bayer++;
-        pucRGBInterImg += 3;
-      }
-
-      if (blue > 0) {
-        for (; bayer <= bayerEnd - 2; bayer += 2, pucRGBInterImg += 6) {
-          /* B at B */
-          pucRGBInterImg[1] = bayer[iBayerStep2 + 2];
-          /* R at B */
-          t0 = ((bayer[iBayerStep + 1] + bayer[iBayerStep + 3] +
-                 bayer[iBayerStep3 + 1] + bayer[iBayerStep3 + 3]) << 1)
-            -
-            (((bayer[2] + bayer[iBayerStep2] +
-               bayer[iBayerStep2 + 4] + bayer[iBayerStep4 +
-                                             2]) * 3 + 1) >> 1)
-            + pucRGBInterImg[1] * 6;
-          /* G at B */
-          t1 = ((bayer[iBayerStep + 2] + bayer[iBayerStep2 + 1] +
-                 bayer[iBayerStep2 + 3] + bayer[iBayerStep3 + 2]) << 1)
-            - (bayer[2] + bayer[iBayerStep2] +
-               bayer[iBayerStep2 + 4] + bayer[iBayerStep4 + 2])
-            + (pucRGBInterImg[1] << 2);
-          t0 = (t0 + 4) >> 3;
-          clip(&t0, &pucRGBInterImg[-1]);
-          t1 = (t1 + 4) >> 3;
-          clip(&t1, &pucRGBInterImg[0]);
-          /* at green pixel */
-          pucRGBInterImg[3] = bayer[iBayerStep2 + 3];
-          t0 = pucRGBInterImg[3] * 5
-            + ((bayer[iBayerStep + 3] + bayer[iBayerStep3 + 3]) << 2)
-            - bayer[3]
-            - bayer[iBayerStep + 2]
-            - bayer[iBayerStep + 4]
-            - bayer[iBayerStep3 + 2]
-            - bayer[iBayerStep3 + 4]
-            - bayer[iBayerStep4 + 3]
-            +
-            ((bayer[iBayerStep2 + 1] + bayer[iBayerStep2 + 5] +
-              1) >> 1);
-          t1 = pucRGBInterImg[3] * 5 +
-            ((bayer[iBayerStep2 + 2] + bayer[iBayerStep2 + 4]) << 2)
-            - bayer[iBayerStep2 + 1]
-            - bayer[iBayerStep + 2]
-            - bayer[iBayerStep + 4]
-            - bayer[iBayerStep3 + 2]
-            - bayer[iBayerStep3 + 4]
-            - bayer[iBayerStep2 + 5]
-            + ((bayer[3] + bayer[iBayerStep4 + 3] + 1) >> 1);
-          t0 = (t0 + 4) >> 3;
-          clip(&t0, &pucRGBInterImg[2]);
-          t1 = (t1 + 4) >> 3;
-          clip(&t1, &pucRGBInterImg[4]);
-        }
-      } else {
-        for (; bayer <= bayerEnd - 2; bayer += 2, pucRGBInterImg += 6) {
-          /* R at R */
-          pucRGBInterImg[-1] = bayer[iBayerStep2 + 2];
-          /* B at R */
-          t0 = ((bayer[iBayerStep + 1] + bayer[iBayerStep + 3] +
-                 bayer[iBayerStep3 + 1] + bayer[iBayerStep3 + 3]) << 1)
-            -
-            (((bayer[2] + bayer[iBayerStep2] +
-               bayer[iBayerStep2 + 4] + bayer[iBayerStep4 +
-                                             2]) * 3 + 1) >> 1)
-            + pucRGBInterImg[-1] * 6;
-          /* G at R */
-          t1 = ((bayer[iBayerStep + 2] + bayer[iBayerStep2 + 1] +
-                 bayer[iBayerStep2 + 3] + bayer[iBayerStep * 3 +
-                                               2]) << 1)
-            - (bayer[2] + bayer[iBayerStep2] +
-               bayer[iBayerStep2 + 4] + bayer[iBayerStep4 + 2])
-            + (pucRGBInterImg[-1] << 2);
-          t0 = (t0 + 4) >> 3;
-          clip(&t0, &pucRGBInterImg[1]);
-          t1 = (t1 + 4) >> 3;
-          clip(&t1, &pucRGBInterImg[0]);
-
-          /* at green pixel */
-          pucRGBInterImg[3] = bayer[iBayerStep2 + 3];
-          t0 = pucRGBInterImg[3] * 5
-            + ((bayer[iBayerStep + 3] + bayer[iBayerStep3 + 3]) << 2)
-            - bayer[3]
-            - bayer[iBayerStep + 2]
-            - bayer[iBayerStep + 4]
-            - bayer[iBayerStep3 + 2]
-            - bayer[iBayerStep3 + 4]
-            - bayer[iBayerStep4 + 3]
-            +
-            ((bayer[iBayerStep2 + 1] + bayer[iBayerStep2 + 5] +
-              1) >> 1);
-          t1 = pucRGBInterImg[3] * 5 +
-            ((bayer[iBayerStep2 + 2] + bayer[iBayerStep2 + 4]) << 2)
-            - bayer[iBayerStep2 + 1]
-            - bayer[iBayerStep + 2]
-            - bayer[iBayerStep + 4]
-            - bayer[iBayerStep3 + 2]
-            - bayer[iBayerStep3 + 4]
-            - bayer[iBayerStep2 + 5]
-            + ((bayer[3] + bayer[iBayerStep4 + 3] + 1) >> 1);
-          t0 = (t0 + 4) >> 3;
-          clip(&t0, &pucRGBInterImg[4]);
-          t1 = (t1 + 4) >> 3;
-          clip(&t1, &pucRGBInterImg[2]);
-        }
-      }
-
-      if (bayer < bayerEnd) {
-        /* B at B */
-        pucRGBInterImg[blue] = bayer[iBayerStep2 + 2];
-        /* R at B */
-        t0 = ((bayer[iBayerStep + 1] + bayer[iBayerStep + 3] +
-               bayer[iBayerStep3 + 1] + bayer[iBayerStep3 + 3]) << 1)
-          -
-          (((bayer[2] + bayer[iBayerStep2] +
-             bayer[iBayerStep2 + 4] + bayer[iBayerStep4 +
-                                           2]) * 3 + 1) >> 1)
-          + pucRGBInterImg[blue] * 6;
-        /* G at B */
-        t1 = (((bayer[iBayerStep + 2] + bayer[iBayerStep2 + 1] +
-                bayer[iBayerStep2 + 3] + bayer[iBayerStep3 + 2])) << 1)
-          - (bayer[2] + bayer[iBayerStep2] +
-             bayer[iBayerStep2 + 4] + bayer[iBayerStep4 + 2])
-          + (pucRGBInterImg[blue] << 2);
-        t0 = (t0 + 4) >> 3;
-        clip(&t0, &pucRGBInterImg[-blue]);
-        t1 = (t1 + 4) >> 3;
-        clip(&t1, &pucRGBInterImg[0]);
-        bayer++;
-        pucRGBInterImg += 3;
-      }
-
-      bayer -= iWidth;
-      pucRGBInterImg -= iWidth * 3;
-
-      blue = -blue;
-      start_with_green = !start_with_green;
-    }
-  }
-  void BayerConverter::edgeSenseInterpolation(const Img<icl8u> *poBayerImg) {
-    icl8u *outR, *outG, *outB;
-    int iWidth = poBayerImg->getWidth();
-    int iHeight = poBayerImg->getHeight();
-    const icl8u *bayer = poBayerImg->getData(0);
-    icl8u *pucRGBInterImg = m_buffer.data();
-    int i3, j3, base;
-    int i, j, dh, dv, tmp;
-    int iWidth3 = iWidth*3;
-
-    // iWidth and iHeight should be even
-    switch (m_eBayerPattern) {
-      case bayerPattern_GRBG:
-      case bayerPattern_BGGR:
-        outR = &pucRGBInterImg[0];
-        outG = &pucRGBInterImg[1];
-        outB = &pucRGBInterImg[2];
-        break;
-      case bayerPattern_GBRG:
-      case bayerPattern_RGGB:
-        outR = &pucRGBInterImg[2];
-        outG = &pucRGBInterImg[1];
-        outB = &pucRGBInterImg[0];
-        break;
-      default:
-        ERROR_LOG("Bad bayer pattern ID:" << m_eBayerPattern);
-        return;
-        break;
-    }
-
-    switch (m_eBayerPattern) {
-      case bayerPattern_GRBG:
-      case bayerPattern_GBRG:
-        // copy original RGB data to output images
-        for (i = 0, i3=0;
-             i < iHeight*iWidth; i += (iWidth<<1), i3 += (iWidth3<<1)) {
-          for (j = 0, j3=0; j < iWidth; j += 2, j3+=6) {
-            base=i3+j3;
-            outG[base]           = bayer[i + j];
-            outG[base + iWidth3 + 3] = bayer[i + j + iWidth + 1];
-            outR[base + 3]       = bayer[i + j + 1];
-            outB[base + iWidth3]     = bayer[i + j + iWidth];
-          }
-        }
-        // process GREEN channel
-        for (i3= 3*iWidth3; i3 < (iHeight - 2)*iWidth3; i3 += (iWidth3<<1)) {
-          for (j3=6; j3 < iWidth3 - 9; j3+=6) {
-            base=i3+j3;
-            dh = abs(((outB[base - 6] +
-                       outB[base + 6]) >> 1) -
-                     outB[base]);
-            dv = abs(((outB[base - (iWidth3<<1)] +
-                       outB[base + (iWidth3<<1)]) >> 1) -
-                     outB[base]);
-            tmp = (((outG[base - 3]   + outG[base + 3]) >> 1) * (dh<=dv) +
-                   ((outG[base - iWidth3] + outG[base + iWidth3]) >> 1) *
-                   (dh>dv));
-            //tmp = (dh==dv) ? tmp>>1 : tmp;
-            clip(&tmp, &outG[base]);
-          }
-        }
-
-        for (i3=2*iWidth3; i3 < (iHeight - 3)*iWidth3; i3 += (iWidth3<<1)) {
-          for (j3=9; j3 < iWidth3 - 6; j3+=6) {
-            base=i3+j3;
-            dh = abs(((outR[base - 6] +
-                       outR[base + 6]) >>1 ) -
-                     outR[base]);
-            dv = abs(((outR[base - (iWidth3<<1)] +
-                       outR[base + (iWidth3<<1)]) >>1 ) -
-                     outR[base]);
-            tmp = (((outG[base - 3]   + outG[base + 3]) >> 1) * (dh<=dv) +
-                   ((outG[base - iWidth3] + outG[base + iWidth3]) >> 1) *
-                   (dh>dv));
-            //tmp = (dh==dv) ? tmp>>1 : tmp;
-            clip(&tmp, &outG[base]);
-          }
-        }
-        // process RED channel
-        for (i3=0; i3 < (iHeight - 1)*iWidth3; i3 += (iWidth3<<1)) {
-          for (j3=6; j3 < iWidth3 - 3; j3+=6) {
-            base=i3+j3;
-            tmp = outG[base] +
-              ((outR[base - 3] -
-                outG[base - 3] +
-                outR[base + 3] -
-                outG[base + 3]) >> 1);
-            clip(&tmp, &outR[base]);
-          }
-        }
-        for (i3=iWidth3; i3 < (iHeight - 2)*iWidth3; i3 += (iWidth3<<1)) {
-          for (j3=3; j3 < iWidth3; j3+=6) {
-            base=i3+j3;
-            tmp = outG[base] +
-              ((outR[base - iWidth3] -
-                outG[base - iWidth3] +
-                outR[base + iWidth3] -
-                outG[base + iWidth3]) >> 1);
-            clip(&tmp, &outR[base]);
-          }
-          for (j3=6; j3 < iWidth3 - 3; j3+=6) {
-            base=i3+j3;
-            tmp = outG[base] +
-              ((outR[base - iWidth3 - 3] -
-                outG[base - iWidth3 - 3] +
-                outR[base - iWidth3 + 3] -
-                outG[base - iWidth3 + 3] +
-                outR[base + iWidth3 - 3] -
-                outG[base + iWidth3 - 3] +
-                outR[base + iWidth3 + 3] -
-                outG[base + iWidth3 + 3]) >> 2);
-            clip(&tmp, &outR[base]);
-          }
-        }
-
-        // process BLUE channel
-        for (i3=iWidth3; i3 < iHeight*iWidth3; i3 += (iWidth3<<1)) {
-          for (j3=3; j3 < iWidth3 - 6; j3+=6) {
-            base=i3+j3;
-            tmp = outG[base] +
-              ((outB[base - 3] -
-                outG[base - 3] +
-                outB[base + 3] -
-                outG[base + 3]) >> 1);
-            clip(&tmp, &outB[base]);
-          }
-        }
-        for (i3=2*iWidth3; i3 < (iHeight - 1)*iWidth3; i3 += (iWidth3<<1)) {
-          for (j3=0; j3 < iWidth3 - 3; j3+=6) {
-            base=i3+j3;
-            tmp = outG[base] +
-              ((outB[base - iWidth3] -
-                outG[base - iWidth3] +
-                outB[base + iWidth3] -
-                outG[base + iWidth3]) >> 1);
-            clip(&tmp, &outB[base]);
-          }
-          for (j3=3; j3 < iWidth3 - 6; j3+=6) {
-            base=i3+j3;
-            tmp = outG[base] +
-              ((outB[base - iWidth3 - 3] -
-                outG[base - iWidth3 - 3] +
-                outB[base - iWidth3 + 3] -
-                outG[base - iWidth3 + 3] +
-                outB[base + iWidth3 - 3] -
-                outG[base + iWidth3 - 3] +
-                outB[base + iWidth3 + 3] -
-                outG[base + iWidth3 + 3]) >> 2);
-            clip(&tmp, &outB[base]);
-          }
-        }
-        break;
-
-      case bayerPattern_BGGR:
-      case bayerPattern_RGGB:
-        // copy original RGB data to output images
-        for (i = 0, i3=0;
-             i < iHeight*iWidth; i += (iWidth<<1), i3 += (iWidth3<<1)) {
-          for (j = 0, j3=0; j < iWidth; j += 2, j3+=6) {
-            base=i3+j3;
-            outB[base] = bayer[i + j];
-            outR[base + iWidth3 + 3] = bayer[i + iWidth + (j + 1)];
-            outG[base + 3] = bayer[i + j + 1];
-            outG[base + iWidth3] = bayer[i + iWidth + j];
-          }
-        }
-        // process GREEN channel
-        for (i3=2*iWidth3; i3 < (iHeight - 2)*iWidth3; i3 += (iWidth3<<1)) {
-          for (j3=6; j3 < iWidth3 - 9; j3+=6) {
-            base=i3+j3;
-            dh = abs(((outB[base - 6] +
-                       outB[base + 6]) >> 1) -
-                     outB[base]);
-            dv = abs(((outB[base - (iWidth3<<1)] +
-                       outB[base + (iWidth3<<1)]) >> 1) -
-                     outB[base]);
-            tmp = (((outG[base - 3]   + outG[base + 3]) >> 1) * (dh<=dv) +
-                   ((outG[base - iWidth3] + outG[base + iWidth3]) >> 1) *
-                   (dh>dv));
-            clip(&tmp, &outG[base]);
-          }
-        }
-        for (i3=3*iWidth3; i3 < (iHeight - 3)*iWidth3; i3 += (iWidth3<<1)) {
-          for (j3=9; j3 < iWidth3 - 6; j3+=6) {
-            base=i3+j3;
-            dh = abs(((outR[base - 6] +
-                       outR[base + 6]) >> 1) -
-                     outR[base]);
-            dv = abs(((outR[base - (iWidth3<<1)] +
-                       outR[base + (iWidth3<<1)]) >> 1) -
-                     outR[base]);
-            tmp = (((outG[base - 3]   + outG[base + 3]) >> 1) * (dh<=dv) +
-                   ((outG[base - iWidth3] + outG[base + iWidth3]) >> 1) *
-                   (dh>dv));
-            clip(&tmp, &outG[base]);
-          }
-        }
-        // process RED channel
-        for (i3=iWidth3; i3 < (iHeight - 1)*iWidth3; i3 += (iWidth3<<1)) {
-          for (j3=6; j3 < iWidth3 - 3; j3+=6) {
-            base=i3+j3;
-            tmp = outG[base] +
-              ((outR[base - 3] -
-                outG[base - 3] +
-                outR[base + 3] -
-                outG[base + 3]) >>1);
-            clip(&tmp, &outR[base]);
-          }
-        }
-        for (i3=2*iWidth3; i3 < (iHeight - 2)*iWidth3; i3 += (iWidth3<<1)) {
-          for (j3=3; j3 < iWidth3; j3+=6) {
-            base=i3+j3;
-            tmp = outG[base] +
-              ((outR[base - iWidth3] -
-                outG[base - iWidth3] +
-                outR[base + iWidth3] -
-                outG[base + iWidth3]) >> 1);
-            clip(&tmp, &outR[base]);
-          }
-          for (j3=6; j3 < iWidth3 - 3; j3+=6) {
-            base=i3+j3;
-            tmp = outG[base] +
-              ((outR[base - iWidth3 - 3] -
-                outG[base - iWidth3 - 3] +
-                outR[base - iWidth3 + 3] -
-                outG[base - iWidth3 + 3] +
-                outR[base + iWidth3 - 3] -
-                outG[base + iWidth3 - 3] +
-                outR[base + iWidth3 + 3] -
-                outG[base + iWidth3 + 3]) >> 2);
-            clip(&tmp, &outR[base]);
-          }
-        }
-
-        // process BLUE channel
-        for (i = 0,i3=0;
-             i < iHeight*iWidth; i += (iWidth<<1), i3 += (iWidth3<<1)) {
-          for (j = 1, j3=3; j < iWidth - 2; j += 2, j3+=6) {
-            base=i3+j3;
-            tmp = outG[base] +
-              ((outB[base - 3] -
-                outG[base - 3] +
-                outB[base + 3] -
-                outG[base + 3]) >> 1);
-            clip(&tmp, &outB[base]);
-          }
-        }
-        for (i3=iWidth3; i3 < (iHeight - 1)*iWidth3; i3 += (iWidth3<<1)) {
-          for (j3=0; j3 < iWidth3 - 3; j3+=6) {
-            base=i3+j3;
-            tmp = outG[base] +
-              ((outB[base - iWidth3] -
-                outG[base - iWidth3] +
-                outB[base + iWidth3] -
-                outG[base + iWidth3]) >> 1);
-            clip(&tmp, &outB[base]);
-          }
-          for (j3=3; j3 < iWidth3 - 6; j3+=6) {
-            base=i3+j3;
-            tmp = outG[base] +
-              ((outB[base - iWidth3 - 3] -
-                outG[base - iWidth3 - 3] +
-                outB[base - iWidth3 + 3] -
-                outG[base - iWidth3 + 3] +
-                outB[base + iWidth3 - 3] -
-                outG[base + iWidth3 - 3] +
-                outB[base + iWidth3 + 3] -
-                outG[base + iWidth3 + 3]) >> 2);
-            clip(&tmp, &outB[base]);
-          }
-        }
-        break;
-      default:
-        ERROR_LOG("Bad bayer pattern ID: " << m_eBayerPattern);
-        return;
-        break;
-    }
-
-    clearBorders(pucRGBInterImg, iWidth, iHeight, 3);
-  }
-
   void BayerConverter::simpleInterpolation(const Img<icl8u> *poBayerImg) {
     int iWidth = poBayerImg->getWidth();
     int iHeight = poBayerImg->getHeight();
@@ -787,27 +586,6 @@ namespace icl::core {
     }
   }
 
-  void BayerConverter::clearBorders(icl8u *rgb, int iWidth, int iHeight, int w) {
-    int i, j;
-
-    // black edges are added with a width w:
-    i = 3 * iWidth * w - 1;
-    j = 3 * iWidth * iHeight - 1;
-    while (i >= 0) {
-      rgb[i--] = 0;
-      rgb[j--] = 0;
-    }
-    i = iWidth * (iHeight - 1) * 3 - 1 + w * 3;
-    while (i > iWidth) {
-      j = 6 * w;
-      while (j > 0) {
-        rgb[i--] = 0;
-        j--;
-      }
-      i -= (iWidth - 2 * w) * 3;
-    }
-  }
-
   std::string BayerConverter::translateBayerConverterMethod(BayerConverter::bayerConverterMethod ebcm) {
 	switch(ebcm){
 		case nearestNeighbor: return "nearestNeighbor";
@@ -937,4 +715,5 @@ namespace icl::core {
     }
   }
 
-  } // namespace icl::core
\ No newline at end of file
+
+  } // namespace icl::core
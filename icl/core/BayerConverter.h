@@ -9,8 +9,38 @@
 
 namespace icl::core {
   /// Utiltity class for bayer pattern conversion
-  /** The internal implementation was basically taken from
-      the libdc files */
+  /** The nearestNeighbor and simple methods were basically taken from
+      the libdc files.
+
+      \section METH Methods
+      The bilinear, hqLinear (Malvar-He-Cutler gradient corrected
+      linear interpolation) and edgeSense methods are computed in a
+      single pass per output row: for each pixel, candidate values for
+      the horizontal, vertical and diagonal neighbours are computed and
+      assigned to the output channels depending on the pixel's position
+      in the bayer cell. These candidates are computed with SSE2 (or NEON
+      via sse2neon) for 8 pixels at once. edgeSense interpolates green
+      along the direction of the smaller gradient and red and blue from
+      the color differences to green, which avoids most of the zipper
+      artifacts of bilinear at a cost close to hqLinear.
+
+      Image borders are handled by mirroring the bayer image (without
+      changing the bayer cell), so the whole destination image is valid.
+
+      \section MT Multi-Threading
+      Images with at least 64K pixels are converted in horizontal bands
+      on utils::ThreadPool::global(). Each band reads the rows above and
+      below it directly from the source, so the result is identical to
+      the single-threaded conversion. This can be switched off with
+      setMultiThreaded(false). nearestNeighbor and simple are always
+      single-threaded.
+
+      \section OUT Output
+      Besides apply(const Img8u*,ImgBase**), the result can be written
+      to a given planar Img8u or directly into caller-provided planar or
+      interleaved RGB buffers (e.g. the memory of a display or video
+      encoder), which avoids any intermediate buffer.
+  */
   class ICLCore_API BayerConverter {
     public:
     BayerConverter(const BayerConverter&) = delete;
@@ -50,6 +80,26 @@ namespace icl::core {
     /** given destination image. Dst will become an Img8u */
     void apply(const Img8u *src, ImgBase **dst);
 
+    /// converts into the given planar image (adapted to src's size and formatRGB)
+    void apply(const Img8u &src, Img8u &dst);
+
+    /// converts into caller-provided planar channels of src.getDim() bytes each
+    void applyPlanar(const Img8u &src, icl8u *r, icl8u *g, icl8u *b);
+
+    /// converts into a caller-provided interleaved RGB buffer
+    /** lineStep is the distance of two rows in bytes; 0 means 3*width */
+    void applyInterleaved(const Img8u &src, icl8u *rgb, int lineStep=0);
+
+    /// enables or disables band-parallel conversion (enabled by default)
+    inline void setMultiThreaded(bool on) {
+      m_multiThreaded = on;
+    }
+
+    /// returns whether band-parallel conversion is enabled
+    inline bool getMultiThreaded() const {
+      return m_multiThreaded;
+    }
+
     inline void setBayerPattern(bayerPattern eBayerPattern) {
       m_eBayerPattern = eBayerPattern;
     }
@@ -90,18 +140,14 @@ namespace icl::core {
 
     bayerConverterMethod m_eConvMethod;
     bayerPattern m_eBayerPattern;
-    // Interpolation methods
+    bool m_multiThreaded = true;
+
+    /// converts into planes (r,g,b) if planes is given, into rgb otherwise
+    void convert(const Img8u &src, icl8u *const *planes, icl8u *rgb, int lineStep);
+
+    // Interpolation methods (interleaved into m_buffer)
     void nnInterpolation(const Img8u *poBayerImg);
-    void bilinearInterpolation(const Img8u *poBayerImg);
-    void hqLinearInterpolation(const Img8u *poBayerImg);
-    void edgeSenseInterpolation(const Img8u *poBayerImg);
     void simpleInterpolation(const Img8u *poBayerImg);
-
-    // Utility functions
-    void clearBorders(icl8u *rgb, int sx, int sy, int w);
-    inline void clip(int *iIn, icl8u *iOut) {
-      *iOut = *iIn = *iIn < 0 ? 0 : *iIn > 255 ? 255 : 0;
-    }
   };
 
   } // namespace icl::core
\ No newline at end of file
@@ -9,6 +9,8 @@
 #include <map>
 #include <icl/core/CCLUT.h>
 #include <icl/utils/SSEUtils.h>
+#include <icl/utils/ThreadPool.h>
+#include <atomic>
 
 using namespace icl::utils;
 
@@ -220,7 +222,7 @@ namespace icl::core {
 #endif
   }
 
-  inline void cc_util_yuv_to_rgb(const icl32f y,const icl32f u,const icl32f v, icl32f &r, icl32f &g, icl32f &b){
+  inline void cc_util_yuv_to_rgb_inline(const icl32f y,const icl32f u,const icl32f v, icl32f &r, icl32f &g, icl32f &b){
     // ipp compatible version using 32f values
     icl32f u2 = u-128.0f;
     icl32f v2 = v-128.0f;
@@ -234,6 +236,10 @@ namespace icl::core {
     b = utils::clip(b,0.0f,255.0f);
   }
 
+  void cc_util_yuv_to_rgb(const icl32f y,const icl32f u,const icl32f v, icl32f &r, icl32f &g, icl32f &b){
+    cc_util_yuv_to_rgb_inline(y,u,v,r,g,b);
+  }
+
   void cc_util_rgb_to_hls(const icl32f r255,const icl32f g255,const icl32f b255, icl32f &h, icl32f &l, icl32f &s){
 
     icl32f r = r255/255;
@@ -1169,12 +1175,13 @@ namespace icl::core {
     src->getROI(pROI, sROI);
 
     long offset  = pROI.y * src->getWidth() + pROI.x;
+    long dstOffset = dst->getROIOffset().y * dstW + dst->getROIOffset().x;
 
     const S *src0 = src->getData(0) + offset;
 
-    D *dst0      = dst->getData(0) + offset;
-    D *dst1      = dst->getData(1) + offset;
-    D *dst2      = dst->getData(2) + offset;
+    D *dst0      = dst->getData(0) + dstOffset;
+    D *dst1      = dst->getData(1) + dstOffset;
+    D *dst2      = dst->getData(2) + dstOffset;
     D *dstEnd    = dst0 + sROI.width + (sROI.height - 1) * dstW;
 
     sse_for(src0, dst0, dst1, dst2, dstEnd,
@@ -1194,12 +1201,13 @@ namespace icl::core {
     src->getROI(pROI, sROI);
 
     long offset  = pROI.y * src->getWidth() + pROI.x;
+    long dstOffset = dst->getROIOffset().y * dstW + dst->getROIOffset().x;
 
     const S *src0 = src->getData(0) + offset;
     const S *src1 = src->getData(1) + offset;
     const S *src2 = src->getData(2) + offset;
 
-    D *dst0   = dst->getData(0) + offset;
+    D *dst0   = dst->getData(0) + dstOffset;
     D *dstEnd = dst0 + sROI.width + (sROI.height - 1) * dstW;
 
     sse_for(src0, src1, src2, dst0, dstEnd,
@@ -1219,13 +1227,14 @@ namespace icl::core {
     src->getROI(pROI, sROI);
 
     long offset  = pROI.y * src->getWidth() + pROI.x;
+    long dstOffset = dst->getROIOffset().y * dstW + dst->getROIOffset().x;
 
     const S *src0 = src->getData(0) + offset;
     const S *src1 = src->getData(1) + offset;
     const S *src2 = src->getData(2) + offset;
 
-    D *dst0   = dst->getData(0) + offset;
-    D *dst1   = dst->getData(1) + offset;
+    D *dst0   = dst->getData(0) + dstOffset;
+    D *dst1   = dst->getData(1) + dstOffset;
     D *dstEnd = dst0 + sROI.width + (sROI.height - 1) * dstW;
 
     sse_for(src0, src1, src2, dst0, dst1, dstEnd,
@@ -1245,14 +1254,15 @@ namespace icl::core {
     src->getROI(pROI, sROI);
 
     long offset  = pROI.y * src->getWidth() + pROI.x;
+    long dstOffset = dst->getROIOffset().y * dstW + dst->getROIOffset().x;
 
     const S *src0 = src->getData(0) + offset;
     const S *src1 = src->getData(1) + offset;
     const S *src2 = src->getData(2) + offset;
 
-    D *dst0   = dst->getData(0) + offset;
-    D *dst1   = dst->getData(1) + offset;
-    D *dst2   = dst->getData(2) + offset;
+    D *dst0   = dst->getData(0) + dstOffset;
+    D *dst1   = dst->getData(1) + dstOffset;
+    D *dst2   = dst->getData(2) + dstOffset;
     D *dstEnd = dst0 + sROI.width + (sROI.height - 1) * dstW;
 
     sse_for(src0, src1, src2, dst0, dst1, dst2, dstEnd,
@@ -1891,9 +1901,11 @@ namespace icl::core {
     x *= icl512(1.0f/0.950455f);
     z *= icl512(1.0f/1.088753f);
 
-    icl512 fX = cbrt(x);
-    icl512 fY = cbrt(y);
-    icl512 fZ = cbrt(z);
+    // values below the threshold are replaced below; clamping them keeps
+    // cbrt from producing denormals (which are very slow) for dark pixels
+    icl512 fX = cbrt(max(x, icl512(0.008856f)));
+    icl512 fY = cbrt(max(y, icl512(0.008856f)));
+    icl512 fZ = cbrt(max(z, icl512(0.008856f)));
 
     icl512 ifX = (x > icl512(0.008856f));
     icl512 ifY = (y > icl512(0.008856f));
@@ -1938,9 +1950,9 @@ namespace icl::core {
     x *= icl128(1.0f/0.950455f);
     z *= icl128(1.0f/1.088753f);
 
-    icl128 fX = cbrt(x);
-    icl128 fY = cbrt(y);
-    icl128 fZ = cbrt(z);
+    icl128 fX = cbrt(max(x, icl128(0.008856f)));
+    icl128 fY = cbrt(max(y, icl128(0.008856f)));
+    icl128 fZ = cbrt(max(z, icl128(0.008856f)));
 
     icl128 ifX = (x > icl128(0.008856f));
     icl128 ifY = (y > icl128(0.008856f));
@@ -2577,9 +2589,9 @@ namespace icl::core {
     x *= icl512(1.0f/0.950455f);
     z *= icl512(1.0f/1.088753f);
 
-    icl512 fX = cbrt(x);
-    icl512 fY = cbrt(y);
-    icl512 fZ = cbrt(z);
+    icl512 fX = cbrt(max(x, icl512(0.008856f)));
+    icl512 fY = cbrt(max(y, icl512(0.008856f)));
+    icl512 fZ = cbrt(max(z, icl512(0.008856f)));
 
     icl512 ifX = (x > icl512(0.008856f));
     icl512 ifY = (y > icl512(0.008856f));
@@ -2669,9 +2681,9 @@ namespace icl::core {
     x *= icl128(1.0f/0.950455f);
     z *= icl128(1.0f/1.088753f);
 
-    icl128 fX = cbrt(x);
-    icl128 fY = cbrt(y);
-    icl128 fZ = cbrt(z);
+    icl128 fX = cbrt(max(x, icl128(0.008856f)));
+    icl128 fY = cbrt(max(y, icl128(0.008856f)));
+    icl128 fZ = cbrt(max(z, icl128(0.008856f)));
 
     icl128 ifX = (x > icl128(0.008856f));
     icl128 ifY = (y > icl128(0.008856f));
@@ -2707,7 +2719,7 @@ namespace icl::core {
   template<class S, class D>
   inline void subYUVtoRGB(const S *y, const S *u, const S *v, D *r, D *g, D *b) {
     icl32f reg_r, reg_g, reg_b;
-    cc_util_yuv_to_rgb(clipped_cast<S,icl32f>(*y),
+    cc_util_yuv_to_rgb_inline(clipped_cast<S,icl32f>(*y),
                        clipped_cast<S,icl32f>(*u),
                        clipped_cast<S,icl32f>(*v),
                        reg_r, reg_g, reg_b);
@@ -2719,7 +2731,7 @@ namespace icl::core {
   template<class S>
   inline void subYUVtoRGB(const S *y, const S *u, const S *v, icl8u *r, icl8u *g, icl8u *b) {
     icl32f reg_r, reg_g, reg_b;
-    cc_util_yuv_to_rgb(clipped_cast<S,icl32f>(*y),
+    cc_util_yuv_to_rgb_inline(clipped_cast<S,icl32f>(*y),
                        clipped_cast<S,icl32f>(*u),
                        clipped_cast<S,icl32f>(*v),
                        reg_r, reg_g, reg_b);
@@ -2819,7 +2831,7 @@ namespace icl::core {
   template<class S, class D>
   inline void subYUVtoHLS(const S *y, const S *u, const S *v, D *h, D *l, D *s) {
     icl32f reg_r, reg_g, reg_b, reg_h, reg_l, reg_s;
-    cc_util_yuv_to_rgb(clipped_cast<S,icl32f>(*y),
+    cc_util_yuv_to_rgb_inline(clipped_cast<S,icl32f>(*y),
                        clipped_cast<S,icl32f>(*u),
                        clipped_cast<S,icl32f>(*v),
                        reg_r, reg_g, reg_b);
@@ -2832,7 +2844,7 @@ namespace icl::core {
   template<class S>
   inline void subYUVtoHLS(const S *y, const S *u, const S *v, icl8u *h, icl8u *l, icl8u *s) {
     icl32f reg_r, reg_g, reg_b, reg_h, reg_l, reg_s;
-    cc_util_yuv_to_rgb(clipped_cast<S,icl32f>(*y),
+    cc_util_yuv_to_rgb_inline(clipped_cast<S,icl32f>(*y),
                        clipped_cast<S,icl32f>(*u),
                        clipped_cast<S,icl32f>(*v),
                        reg_r, reg_g, reg_b);
@@ -3016,7 +3028,7 @@ namespace icl::core {
   template<class S, class D>
   inline void subYUVtoLab(const S *y, const S *u, const S *v, D *l, D *a, D *b) {
     icl32f reg_r, reg_g, reg_b, reg_X, reg_Y, reg_Z;
-    cc_util_yuv_to_rgb(clipped_cast<S,icl32f>(*y),
+    cc_util_yuv_to_rgb_inline(clipped_cast<S,icl32f>(*y),
                        clipped_cast<S,icl32f>(*u),
                        clipped_cast<S,icl32f>(*v),
                        reg_r, reg_g, reg_b);
@@ -3031,7 +3043,7 @@ namespace icl::core {
   template<class S>
   inline void subYUVtoLab(const S *y, const S *u, const S *v, icl8u *l, icl8u *a, icl8u *b) {
     icl32f reg_r, reg_g, reg_b, reg_X, reg_Y, reg_Z;
-    cc_util_yuv_to_rgb(clipped_cast<S,icl32f>(*y),
+    cc_util_yuv_to_rgb_inline(clipped_cast<S,icl32f>(*y),
                        clipped_cast<S,icl32f>(*u),
                        clipped_cast<S,icl32f>(*v),
                        reg_r, reg_g, reg_b);
@@ -3079,9 +3091,9 @@ namespace icl::core {
     x *= icl512(1.0f/0.950455f);
     z *= icl512(1.0f/1.088753f);
 
-    icl512 fX = cbrt(x);
-    icl512 fY = cbrt(y);
-    icl512 fZ = cbrt(z);
+    icl512 fX = cbrt(max(x, icl512(0.008856f)));
+    icl512 fY = cbrt(max(y, icl512(0.008856f)));
+    icl512 fZ = cbrt(max(z, icl512(0.008856f)));
 
     icl512 ifX = (x > icl512(0.008856f));
     icl512 ifY = (y > icl512(0.008856f));
@@ -3141,9 +3153,9 @@ namespace icl::core {
     x *= icl128(1.0f/0.950455f);
     z *= icl128(1.0f/1.088753f);
 
-    icl128 fX = cbrt(x);
-    icl128 fY = cbrt(y);
-    icl128 fZ = cbrt(z);
+    icl128 fX = cbrt(max(x, icl128(0.008856f)));
+    icl128 fY = cbrt(max(y, icl128(0.008856f)));
+    icl128 fZ = cbrt(max(z, icl128(0.008856f)));
 
     icl128 ifX = (x > icl128(0.008856f));
     icl128 ifY = (y > icl128(0.008856f));
@@ -3740,7 +3752,7 @@ namespace icl::core {
 #endif
 
 
-  template<class S, class D> void cc_sd(const Img<S> *src, Img<D> *dst, bool roiOnly){
+  template<class S, class D> void cc_sd_band(const Img<S> *src, Img<D> *dst, bool roiOnly){
 
 
 #define INNER_CASE_LABEL(XXX,YYY) \
@@ -3773,6 +3785,60 @@ namespace icl::core {
 #undef CASE_LABEL
   }
 
+  namespace {
+    /// cc() runs on the ThreadPool for images with at least this number of pixels
+    constexpr int CC_PARALLEL_PIXELS = 1 << 16;
+
+    /// approximate number of pixels per band
+    constexpr int CC_BAND_PIXELS = 1 << 14;
+
+    std::atomic<bool> g_ccMultiThreaded{true};
+
+    /// Shallow view of the rows [y0,y1) of img
+    /** if roiOnly is set, rows are counted from the ROI's top and the view's
+        ROI covers the ROI columns; otherwise the view has a full ROI */
+    template<class T>
+    Img<T> band_view(const Img<T> *img, int y0, int y1, bool roiOnly){
+      const Rect roi = img->getROI();
+      const int offs = (roiOnly ? roi.y + y0 : y0) * img->getWidth();
+      std::vector<T*> data(img->getChannels());
+      for(int c = 0; c < img->getChannels(); ++c){
+        data[c] = const_cast<T*>(img->getData(c)) + offs;
+      }
+      Img<T> view(Size(img->getWidth(), y1 - y0), img->getChannels(), img->getFormat(), data);
+      if(roiOnly) view.setROI(Rect(roi.x, 0, roi.width, y1 - y0));
+      return view;
+    }
+  }
+
+  /// converts horizontal bands of the image concurrently
+  /** All conversions are pixel-wise, so each band can be processed by the
+      serial implementation independently. If the ROI spans complete rows,
+      bands of a roiOnly conversion have a full ROI and use the faster
+      whole-image loops. */
+  template<class S, class D> void cc_sd(const Img<S> *src, Img<D> *dst, bool roiOnly){
+    const Size size = roiOnly ? src->getROISize() : src->getSize();
+    if(!g_ccMultiThreaded || size.getDim() < CC_PARALLEL_PIXELS
+       || ThreadPool::global().getConcurrency() < 2){
+      cc_sd_band(src, dst, roiOnly);
+      return;
+    }
+    const int grain = std::max(1, CC_BAND_PIXELS / size.width);
+    parallelFor(0, size.height, grain, [&](int y0, int y1){
+      const Img<S> s = band_view(src, y0, y1, roiOnly);
+      Img<D> d = band_view(dst, y0, y1, roiOnly);
+      cc_sd_band(&s, &d, !(s.hasFullROI() && d.hasFullROI()));
+    });
+  }
+
+  void setCCMultiThreaded(bool on){
+    g_ccMultiThreaded = on;
+  }
+
+  bool getCCMultiThreaded(){
+    return g_ccMultiThreaded;
+  }
+
 
   template<class S> void cc_s(const Img<S> *src, ImgBase *dst, bool roiOnly){
 
@@ -401,6 +401,15 @@ namespace icl::core {
       images data arrays are 1D). Thus, the ROI-Support mode (roiOnly = true) runs approx. 20% (2%-50%) slower
       depended on the specific source and destination format.
 
+      \section MT Multi-Threading
+
+      Images with at least 64K pixels (resp. ROI pixels) are split into horizontal
+      bands that are converted concurrently on utils::ThreadPool::global(). Each band
+      uses the same (SSE-accelerated where available) kernels as the serial conversion,
+      so results do not depend on the number of threads. Multi-threading can be
+      switched off with setCCMultiThreaded(false) or by limiting the pool size
+      (e.g. ICL_NUM_THREADS=1).
+
 
       \section IPP IPP Acceleration
 
@@ -442,6 +451,12 @@ namespace icl::core {
   /// releases all lookup tables that were created with createLUT
   ICLCore_API void releaseAllLUTs();
 
+  /// Enables/disables banded multi-threaded execution of cc() (enabled by default)
+  ICLCore_API void setCCMultiThreaded(bool on);
+
+  /// Returns whether cc() may run on the ThreadPool
+  ICLCore_API bool getCCMultiThreaded();
+
   /// Internal used type, that describes an implementation type of a specific color conversion function
   enum ccimpl{
     ccAvailable   = 0, /**< conversion is supported natively/directly */
@@ -517,6 +532,11 @@ namespace icl::core {
   /// converts given (y,u,v) pixel into the rgb format
   ICLCore_API void cc_util_yuv_to_rgb(const icl32s y, const icl32s u, const icl32s v, icl32s &r, icl32s &g, icl32s &b);
 
+  /// converts given (y,u,v) pixel into the rgb format (float version, clipped to [0,255])
+  /** This is the formula of convertYUV420ToRGB8 and of the YUV to RGB
+      conversion of cc(); it differs slightly from the fixed point version */
+  ICLCore_API void cc_util_yuv_to_rgb(const icl32f y, const icl32f u, const icl32f v, icl32f &r, icl32f &g, icl32f &b);
+
   /// converts given (r,g,b) pixel into the hls format
   ICLCore_API void cc_util_rgb_to_hls(const icl32f r255, const icl32f g255, const icl32f b255, icl32f &h, icl32f &l, icl32f &s);
 
@@ -6,6 +6,10 @@
 
 #include <icl/utils/BackendDispatching.h>
 #include <icl/core/Image.h>
+#include <icl/core/ImgBase.h>
+
+#include <bit>
+#include <string>
 
 namespace icl::core {
   // Re-export general types into core namespace
@@ -33,4 +37,26 @@ namespace icl::core {
     depth d = p->getDepth();
     return ((d == getDepth<Ts>()) || ...);
   }
-  } // namespace icl::core
\ No newline at end of file
+  } // namespace icl::core
+
+namespace icl::utils {
+  /// Backend tuning buckets for image operations (see BackendTuning)
+  /** Contexts are grouped by depth, channel count and ROI pixel count
+      rounded down to a power of two, e.g. "8u,3ch,2^18px". */
+  template<>
+  struct BackendTuningTraits<core::Image> {
+    static constexpr bool enabled = true;
+
+    static std::string key(const core::Image& img) {
+      static const char* depths[] = {"8u", "16s", "32s", "32f", "64f"};
+      if(img.isNull()) return "null";
+      const unsigned dim = static_cast<unsigned>(img.getROISize().getDim());
+      return std::string(depths[img.getDepth()]) + "," + std::to_string(img.getChannels())
+             + "ch,2^" + std::to_string(dim ? std::bit_width(dim) - 1 : 0) + "px";
+    }
+
+    static const void* identity(const core::Image& img) {
+      return img.isNull() || !img.getChannels() ? nullptr : img.ptr()->getDataPtr(0);
+    }
+  };
+  } // namespace icl::utils
\ No newline at end of file
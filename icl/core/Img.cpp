@@ -3,6 +3,7 @@
 // Copyright (C) 2006-2026 Christof Elbrechter, Michael Goetting, Robert Haschke
 
 #include <icl/core/Img.h>
+#include <icl/core/ImgAllocator.h>
 #include <icl/core/ImgOps.h>
 #include <icl/core/CoreFunctions.h>
 #include <functional>
@@ -127,7 +128,7 @@ namespace icl::core {
     for(const auto &ch : channels) {
       ICLASSERT_THROW(static_cast<int>(ch.size()) == h,
         InvalidImgParamException("inconsistent channel heights in initializer list"));
-      m_vecChannels.push_back(std::shared_ptr<Type[]>(new Type[w * h]));
+      m_vecChannels.push_back(ImgAllocator::allocateChannel<Type>(w * h));
       Type *base = m_vecChannels.back().get();
       int y = 0;
       for(const auto &row : ch) {
@@ -763,13 +764,13 @@ namespace icl::core {
     int dim = getDim();
     if(!dim) return std::shared_ptr<Type[]>();
 
-    Type *ptNewData = new Type[dim];
+    std::shared_ptr<Type[]> data = ImgAllocator::allocateChannel<Type>(dim);
     if(ptDataToCopy){
-      memcpy(ptNewData,ptDataToCopy,dim*sizeof(Type));
+      memcpy(data.get(),ptDataToCopy,dim*sizeof(Type));
     }else{
-      std::fill(ptNewData,ptNewData+dim,0);
+      std::fill(data.get(),data.get()+dim,0);
     }
-    return std::shared_ptr<Type[]>(ptNewData);
+    return data;
   }
 
 
@@ -0,0 +1,294 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// ICL - Image Component Library (https://github.com/iclcv/icl)
+// Copyright (C) 2006-2026 Christof Elbrechter
+
+#include <icl/core/ImgAllocator.h>
+
+#include <atomic>
+#include <bit>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#ifdef ICL_SYSTEM_WINDOWS
+  #include <malloc.h>
+#endif
+#ifdef ICL_SYSTEM_LINUX
+  #include <sys/mman.h>
+#endif
+
+namespace icl::core {
+  namespace {
+    constexpr std::size_t MIN_BLOCK = 64;          ///< smallest size class and minimal alignment
+    constexpr std::size_t PAGE_SIZE = 4096;
+    constexpr std::size_t HUGE_PAGE_SIZE = 2 << 20;
+
+    /// 64 byte class + 4 classes per power of two up to 2^63
+    constexpr int NUM_CLASSES = 1 + (64 - 6) * 4;
+
+    /// per-thread cache limits
+    constexpr std::size_t THREAD_CACHE_BLOCKS = 4;      ///< per size class
+    constexpr std::size_t THREAD_CACHE_BYTES = 16 << 20;
+
+    /// size classes: 64, then 2^k * {1.25, 1.5, 1.75, 2} for k >= 6
+    int size_class(std::size_t bytes){
+      if(bytes <= MIN_BLOCK) return 0;
+      const std::size_t v = bytes - 1;                  // 2^k <= v < 2^(k+1)
+      const int k = static_cast<int>(std::bit_width(v)) - 1;
+      return 1 + (k - 6) * 4 + static_cast<int>((v >> (k - 2)) & 3);
+    }
+
+    std::size_t class_capacity(int c){
+      if(!c) return MIN_BLOCK;
+      const int k = (c - 1) / 4 + 6;
+      return static_cast<std::size_t>(5 + (c - 1) % 4) << (k - 2);
+    }
+
+    struct Settings {
+      std::atomic<bool> enabled{[] {
+        const char *v = std::getenv("ICL_IMG_POOL");
+        return v && *v && std::string(v) != "0";
+      }()};
+      std::atomic<bool> hugePages{false};
+      std::atomic<std::size_t> maxCachedBytes{std::size_t(512) << 20};
+    };
+
+    Settings &settings(){
+      static Settings s;
+      return s;
+    }
+
+    struct Counters {
+      std::atomic<uint64_t> allocations{0}, deallocations{0}, poolHits{0};
+      std::atomic<uint64_t> heapAllocations{0}, heapReleases{0};
+      std::atomic<int64_t> bytesInUse{0}, bytesCached{0};
+    };
+
+    Counters &counters(){
+      static Counters c;
+      return c;
+    }
+
+    void *heap_alloc(std::size_t cap){
+      const bool huge = cap >= HUGE_PAGE_SIZE && settings().hugePages;
+      const std::size_t align = huge ? HUGE_PAGE_SIZE : cap >= PAGE_SIZE ? PAGE_SIZE : MIN_BLOCK;
+      const std::size_t size = (cap + align - 1) / align * align;
+      void *p = nullptr;
+#ifdef ICL_SYSTEM_WINDOWS
+      p = _aligned_malloc(size, align);
+#else
+      if(posix_memalign(&p, align, size)) p = nullptr;
+#endif
+      if(!p) throw std::bad_alloc();
+#ifdef ICL_SYSTEM_LINUX
+      if(huge) madvise(p, size, MADV_HUGEPAGE);
+#endif
+      ++counters().heapAllocations;
+      return p;
+    }
+
+    void heap_free(void *p){
+#ifdef ICL_SYSTEM_WINDOWS
+      _aligned_free(p);
+#else
+      std::free(p);
+#endif
+      ++counters().heapReleases;
+    }
+
+    /// Blocks shared by all threads (never destroyed, as thread caches of
+    /// late exiting threads still flush into it)
+    struct GlobalPool {
+      std::mutex mutex;
+      std::vector<void*> blocks[NUM_CLASSES];
+      std::size_t bytes = 0;
+
+      /// stores the block if the size limit allows it (mutex must be locked)
+      bool put(void *p, int c){
+        const std::size_t cap = class_capacity(c);
+        if(bytes + cap > settings().maxCachedBytes) return false;
+        blocks[c].push_back(p);
+        bytes += cap;
+        counters().bytesCached += cap;
+        return true;
+      }
+
+      /// frees blocks until at most maxBytes are cached (mutex must be locked)
+      void trim(std::size_t maxBytes){
+        for(int c = NUM_CLASSES - 1; c >= 0 && bytes > maxBytes; --c){
+          const std::size_t cap = class_capacity(c);
+          while(!blocks[c].empty() && bytes > maxBytes){
+            heap_free(blocks[c].back());
+            blocks[c].pop_back();
+            bytes -= cap;
+            counters().bytesCached -= cap;
+          }
+        }
+      }
+    };
+
+    GlobalPool &global_pool(){
+      static GlobalPool *pool = new GlobalPool;
+      return *pool;
+    }
+
+    struct ThreadCache {
+      std::vector<void*> blocks[NUM_CLASSES];
+      std::size_t bytes = 0;
+
+      ~ThreadCache();
+
+      /// moves all blocks to the global pool (or frees them if toHeap)
+      void flush(bool toHeap){
+        GlobalPool &g = global_pool();
+        std::scoped_lock lock(g.mutex);
+        for(int c = 0; c < NUM_CLASSES; ++c){
+          for(void *p : blocks[c]){
+            counters().bytesCached -= class_capacity(c);
+            if(toHeap || !g.put(p, c)) heap_free(p);
+          }
+          blocks[c].clear();
+        }
+        bytes = 0;
+      }
+    };
+
+    thread_local ThreadCache t_cache;
+    /// set when t_cache was destroyed (other thread_local destructors may
+    /// still release images afterwards)
+    thread_local bool t_cacheDestroyed = false;
+
+    ThreadCache::~ThreadCache(){
+      flush(false);
+      t_cacheDestroyed = true;
+    }
+  }
+
+  void *ImgAllocator::allocate(std::size_t bytes){
+    Counters &cnt = counters();
+    ++cnt.allocations;
+    const int c = size_class(bytes);
+    const std::size_t cap = class_capacity(c);
+    cnt.bytesInUse += cap;
+    if(settings().enabled){
+      if(!t_cacheDestroyed && !t_cache.blocks[c].empty()){
+        void *p = t_cache.blocks[c].back();
+        t_cache.blocks[c].pop_back();
+        t_cache.bytes -= cap;
+        cnt.bytesCached -= cap;
+        ++cnt.poolHits;
+        return p;
+      }
+      GlobalPool &g = global_pool();
+      std::scoped_lock lock(g.mutex);
+      if(!g.blocks[c].empty()){
+        void *p = g.blocks[c].back();
+        g.blocks[c].pop_back();
+        g.bytes -= cap;
+        cnt.bytesCached -= cap;
+        ++cnt.poolHits;
+        return p;
+      }
+    }
+    return heap_alloc(cap);
+  }
+
+  void ImgAllocator::deallocate(void *p, std::size_t bytes){
+    if(!p) return;
+    Counters &cnt = counters();
+    ++cnt.deallocations;
+    const int c = size_class(bytes);
+    const std::size_t cap = class_capacity(c);
+    cnt.bytesInUse -= cap;
+    if(settings().enabled){
+      if(!t_cacheDestroyed && t_cache.blocks[c].size() < THREAD_CACHE_BLOCKS
+         && t_cache.bytes + cap <= THREAD_CACHE_BYTES){
+        if(t_cache.blocks[c].empty()) t_cache.blocks[c].reserve(THREAD_CACHE_BLOCKS);
+        t_cache.blocks[c].push_back(p);
+        t_cache.bytes += cap;
+        cnt.bytesCached += cap;
+        return;
+      }
+      GlobalPool &g = global_pool();
+      std::scoped_lock lock(g.mutex);
+      if(g.put(p, c)) return;
+    }
+    heap_free(p);
+  }
+
+  std::size_t ImgAllocator::getCapacity(std::size_t bytes){
+    return class_capacity(size_class(bytes));
+  }
+
+  void ImgAllocator::setEnabled(bool on){
+    settings().enabled = on;
+    if(!on) release();
+  }
+
+  bool ImgAllocator::isEnabled(){
+    return settings().enabled;
+  }
+
+  void ImgAllocator::setHugePages(bool on){
+    settings().hugePages = on;
+  }
+
+  bool ImgAllocator::getHugePages(){
+    return settings().hugePages;
+  }
+
+  void ImgAllocator::setMaxCachedBytes(std::size_t bytes){
+    settings().maxCachedBytes = bytes;
+    GlobalPool &g = global_pool();
+    std::scoped_lock lock(g.mutex);
+    g.trim(bytes);
+  }
+
+  std::size_t ImgAllocator::getMaxCachedBytes(){
+    return settings().maxCachedBytes;
+  }
+
+  void ImgAllocator::release(){
+    if(!t_cacheDestroyed) t_cache.flush(true);
+    GlobalPool &g = global_pool();
+    std::scoped_lock lock(g.mutex);
+    g.trim(0);
+  }
+
+  ImgAllocator::Stats ImgAllocator::getStats(){
+    const Counters &c = counters();
+    Stats s;
+    s.allocations = c.allocations;
+    s.deallocations = c.deallocations;
+    s.poolHits = c.poolHits;
+    s.heapAllocations = c.heapAllocations;
+    s.heapReleases = c.heapReleases;
+    s.bytesInUse = c.bytesInUse;
+    s.bytesCached = c.bytesCached;
+    return s;
+  }
+
+  void ImgAllocator::resetStats(){
+    Counters &c = counters();
+    c.allocations = 0;
+    c.deallocations = 0;
+    c.poolHits = 0;
+    c.heapAllocations = 0;
+    c.heapReleases = 0;
+  }
+
+  void ImgAllocator::dump(std::ostream &s){
+    const Stats st = getStats();
+    s << "image allocator (" << (isEnabled() ? "pooled" : "disabled")
+      << (getHugePages() ? ", huge pages" : "") << ")\n"
+      << "  allocations:      " << st.allocations << " (" << st.poolHits << " from pool, "
+      << st.heapAllocations << " from heap)\n"
+      << "  deallocations:    " << st.deallocations << " (" << st.heapReleases << " returned to heap)\n"
+      << "  bytes in use:     " << st.bytesInUse << '\n'
+      << "  bytes cached:     " << st.bytesCached << " (max. " << getMaxCachedBytes() << " in global pool)\n";
+  }
+
+  } // namespace icl::core
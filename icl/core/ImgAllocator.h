@@ -0,0 +1,130 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// ICL - Image Component Library (https://github.com/iclcv/icl)
+// Copyright (C) 2006-2026 Christof Elbrechter
+
+#pragma once
+
+#include <icl/utils/CompatMacros.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+
+namespace icl::core {
+  /// Pooled memory allocator for image channel data \ingroup IMAGE
+  /** All Img<T> channels (and their shared_ptr control blocks) are
+      allocated here. Requested sizes are rounded up to one of a set of
+      size classes (four per power of two, so at most 25% is wasted). If
+      pooling is enabled (see below), released blocks are kept for reuse
+      instead of being returned to the heap. A video pipeline that processes frames of constant size
+      therefore stops allocating heap memory after the first frames, no
+      matter whether the images are created by grabbers, by
+      UnaryOp::prepare or as temporaries.
+
+      Released blocks first go to a small per-thread cache (at most 4
+      blocks per size class and 16MB), which serves subsequent allocations
+      of the same thread without locking; overflow and blocks of exiting
+      threads are moved to a global pool. The global pool holds at most
+      getMaxCachedBytes() bytes, further blocks are freed. A thread cache
+      is only emptied when its thread exits or calls release().
+
+      Blocks are aligned to 64 bytes (cache lines), blocks of at least
+      4KB to the page size. If huge pages are enabled (Linux only), blocks
+      of at least 2MB are aligned to 2MB and advised to be backed by
+      transparent huge pages.
+
+      As cached blocks stay allocated, pooling increases the memory
+      footprint of the process by up to getMaxCachedBytes() plus 16MB per
+      thread that released image memory. It is therefore disabled by
+      default (all blocks are freed immediately, only the alignment
+      applies) and must be enabled explicitly with setEnabled(true) or by
+      setting the environment variable ICL_IMG_POOL=1.
+
+      \code
+      ImgAllocator::setEnabled(true);
+      ImgAllocator::resetStats();
+      for(int i=0;i<100;++i) process(grabber.grab());
+      ImgAllocator::Stats s = ImgAllocator::getStats();
+      std::cout << s.heapAllocations << " heap allocations\n";
+      \endcode
+  */
+  class ICLCore_API ImgAllocator {
+    public:
+    /// Allocation counters (since the last resetStats())
+    struct Stats {
+      uint64_t allocations = 0;     ///< calls to allocate()
+      uint64_t deallocations = 0;   ///< calls to deallocate()
+      uint64_t poolHits = 0;        ///< allocations served from a cache
+      uint64_t heapAllocations = 0; ///< allocations that hit the heap
+      uint64_t heapReleases = 0;    ///< blocks returned to the heap
+      int64_t bytesInUse = 0;       ///< capacity of all blocks in use (not reset)
+      int64_t bytesCached = 0;      ///< capacity of all cached blocks (not reset)
+    };
+
+    /// std-compatible allocator that draws from the pool
+    template<class T>
+    struct Allocator {
+      using value_type = T;
+      Allocator() = default;
+      template<class U> Allocator(const Allocator<U>&) {}
+      T *allocate(std::size_t n) { return static_cast<T*>(ImgAllocator::allocate(n * sizeof(T))); }
+      void deallocate(T *p, std::size_t n) { ImgAllocator::deallocate(p, n * sizeof(T)); }
+      template<class U> bool operator==(const Allocator<U>&) const { return true; }
+      template<class U> bool operator!=(const Allocator<U>&) const { return false; }
+    };
+
+    /// Allocates a block of at least bytes bytes (uninitialized)
+    static void *allocate(std::size_t bytes);
+
+    /// Returns a block; bytes must be the size passed to allocate()
+    static void deallocate(void *p, std::size_t bytes);
+
+    /// Allocates uninitialized channel data for dim values of type T
+    /** The returned pointer returns its memory to the pool when the last
+        reference is gone; its control block is pooled as well. */
+    template<class T>
+    static std::shared_ptr<T[]> allocateChannel(int dim) {
+      const std::size_t bytes = static_cast<std::size_t>(dim) * sizeof(T);
+      T *p = static_cast<T*>(allocate(bytes));
+      return std::shared_ptr<T[]>(p, [bytes](T *q){ deallocate(q, bytes); }, Allocator<T>());
+    }
+
+    /// Returns the capacity of the size class a request of bytes bytes uses
+    static std::size_t getCapacity(std::size_t bytes);
+
+    /// Enables or disables pooling (disabled by default, see ICL_IMG_POOL)
+    /** Blocks allocated while pooling was enabled can still be returned
+        after disabling it; they are freed then. */
+    static void setEnabled(bool on);
+
+    /// Returns whether pooling is enabled
+    static bool isEnabled();
+
+    /// Enables 2MB alignment and transparent huge pages for large blocks
+    /** Only has an effect on Linux; affects blocks allocated afterwards. */
+    static void setHugePages(bool on);
+
+    /// Returns whether huge pages are used for large blocks
+    static bool getHugePages();
+
+    /// Sets the maximum number of bytes kept in the global pool (default 512MB)
+    static void setMaxCachedBytes(std::size_t bytes);
+
+    /// Returns the maximum number of bytes kept in the global pool
+    static std::size_t getMaxCachedBytes();
+
+    /// Frees all blocks of the global pool and the calling thread's cache
+    static void release();
+
+    /// Returns the current counters
+    static Stats getStats();
+
+    /// Resets the event counters (bytesInUse and bytesCached are kept)
+    static void resetStats();
+
+    /// Writes the counters to the given stream
+    static void dump(std::ostream &s);
+  };
+
+  } // namespace icl::core
@@ -5,6 +5,8 @@
 #pragma once
 
 #include <icl/core/Img.h>
+#include <icl/utils/ThreadPool.h>
+#include <algorithm>
 
 /// @file Visitors.h
 /// Optimized line-based ROI visitors for Img<T>.
@@ -25,6 +27,15 @@
 ///   visitROILinesWith        — src + dst, one channel each
 ///   ...PerChannel            — loop over all channels, one image
 ///   ...PerChannelWith        — loop over all channels, src + dst
+///   ...MT                    — same callback contract, but the ROI is cut
+///                              into row bands (and channels) that run
+///                              concurrently on utils::ThreadPool::global()
+///
+/// The MT variants take an optional grain (rows per band). With the
+/// default grain of 0, bands hold about detail::MT_BAND_PIXELS pixels
+/// and images below that size are visited serially. The callback may
+/// be called concurrently and must therefore only write to the line it
+/// was given. In the contiguous case, each band is passed as one block.
 
 namespace icl::core {
   // =================================================================
@@ -179,4 +190,131 @@ namespace icl::core {
     }
   }
 
+  // =================================================================
+  //  Multi-threaded variants — row bands on the shared ThreadPool
+  // =================================================================
+
+  namespace detail {
+    /// Default minimum number of pixels per band of the ...MT visitors
+    constexpr int MT_BAND_PIXELS = 16384;
+
+    /// Rows per band: the given grain, or enough rows for MT_BAND_PIXELS
+    inline int mt_band_rows(int w, int grain) {
+      if(grain > 0) return grain;
+      return std::max(1, (MT_BAND_PIXELS + w - 1) / std::max(1, w));
+    }
+
+    /// Calls band(ch, y0, y1) for all channel/row-band pairs concurrently.
+    /// Returns false (without calling band) if there would be only one task.
+    template<class B>
+    bool mt_visit_bands(int nc, int w, int h, int grain, B &&band) {
+      if(w <= 0 || h <= 0 || nc <= 0) return true;
+      if(grain <= 0 && static_cast<long>(w) * h * nc < 2L * MT_BAND_PIXELS) return false;
+      const int rows = mt_band_rows(w, grain);
+      const int nb = (h + rows - 1) / rows;
+      if(nb * nc == 1) return false;
+      utils::ThreadPool::global().parallelFor(0, nb * nc, 1, [&](int i0, int i1) {
+        for(int i = i0; i < i1; ++i) {
+          const int y0 = (i % nb) * rows;
+          band(i / nb, y0, std::min(h, y0 + rows));
+        }
+      });
+      return true;
+    }
+  } // namespace detail
+
+  /// Parallel visitROILines: f(const T* data, int width) per ROI line / band.
+  template<class T, class F>
+  void visitROILinesMT(const Img<T> &img, int ch, F &&f, int grain = 0) {
+    const int w = img.getROIWidth();
+    const int stride = img.getWidth();
+    const T *p0 = img.getROIData(ch);
+    if(!detail::mt_visit_bands(1, w, img.getROIHeight(), grain, [&](int, int y0, int y1) {
+      const T *p = p0 + y0 * stride;
+      if(w == stride) f(p, w * (y1 - y0));
+      else for(int y = y0; y < y1; ++y, p += stride) f(p, w);
+    })) visitROILines(img, ch, f);
+  }
+
+  /// Parallel mutable visitROILines: f(T* data, int width).
+  template<class T, class F>
+  void visitROILinesMT(Img<T> &img, int ch, F &&f, int grain = 0) {
+    const int w = img.getROIWidth();
+    const int stride = img.getWidth();
+    T *p0 = img.getROIData(ch);
+    if(!detail::mt_visit_bands(1, w, img.getROIHeight(), grain, [&](int, int y0, int y1) {
+      T *p = p0 + y0 * stride;
+      if(w == stride) f(p, w * (y1 - y0));
+      else for(int y = y0; y < y1; ++y, p += stride) f(p, w);
+    })) visitROILines(img, ch, f);
+  }
+
+  /// Parallel visitROILinesWith: f(const S* srcData, D* dstData, int width).
+  template<class S, class D, class F>
+  void visitROILinesWithMT(const Img<S> &src, int srcCh,
+                           Img<D> &dst, int dstCh, F &&f, int grain = 0) {
+    const int w = src.getROIWidth();
+    const int srcStride = src.getWidth();
+    const int dstStride = dst.getWidth();
+    const bool contiguous = w == srcStride && w == dstStride;
+    const S *s0 = src.getROIData(srcCh);
+    D *d0 = dst.getROIData(dstCh);
+    if(!detail::mt_visit_bands(1, w, src.getROIHeight(), grain, [&](int, int y0, int y1) {
+      const S *s = s0 + y0 * srcStride;
+      D *d = d0 + y0 * dstStride;
+      if(contiguous) f(s, d, w * (y1 - y0));
+      else for(int y = y0; y < y1; ++y, s += srcStride, d += dstStride) f(s, d, w);
+    })) visitROILinesWith(src, srcCh, dst, dstCh, f);
+  }
+
+  /// Parallel visitROILinesPerChannelWith: f(const S* src, D* dst, int channel, int width).
+  /// Channels and row bands are processed concurrently.
+  template<class S, class D, class F>
+  void visitROILinesPerChannelWithMT(const Img<S> &src, Img<D> &dst, F &&f, int grain = 0) {
+    const int w = src.getROIWidth();
+    const int srcStride = src.getWidth();
+    const int dstStride = dst.getWidth();
+    const bool contiguous = w == srcStride && w == dstStride;
+    if(!detail::mt_visit_bands(src.getChannels(), w, src.getROIHeight(), grain,
+                               [&](int ch, int y0, int y1) {
+      const S *s = src.getROIData(ch) + y0 * srcStride;
+      D *d = dst.getROIData(ch) + y0 * dstStride;
+      if(contiguous) f(s, d, ch, w * (y1 - y0));
+      else for(int y = y0; y < y1; ++y, s += srcStride, d += dstStride) f(s, d, ch, w);
+    })) visitROILinesPerChannelWith(src, dst, f);
+  }
+
+  /// Parallel mutable visitROILinesPerChannel: f(T* data, int channel, int width).
+  template<class T, class F>
+  void visitROILinesPerChannelMT(Img<T> &img, F &&f, int grain = 0) {
+    const int w = img.getROIWidth();
+    const int stride = img.getWidth();
+    if(!detail::mt_visit_bands(img.getChannels(), w, img.getROIHeight(), grain,
+                               [&](int ch, int y0, int y1) {
+      T *p = img.getROIData(ch) + y0 * stride;
+      if(w == stride) f(p, ch, w * (y1 - y0));
+      else for(int y = y0; y < y1; ++y, p += stride) f(p, ch, w);
+    })) visitROILinesPerChannel(img, f);
+  }
+
+  /// Parallel visitROILinesPerChannel2With:
+  /// f(const S* src1, const S* src2, D* dst, int channel, int width).
+  template<class S, class D, class F>
+  void visitROILinesPerChannel2WithMT(const Img<S> &src1, const Img<S> &src2,
+                                      Img<D> &dst, F &&f, int grain = 0) {
+    const int w = src1.getROIWidth();
+    const int s1Stride = src1.getWidth();
+    const int s2Stride = src2.getWidth();
+    const int dStride = dst.getWidth();
+    const bool contiguous = w == s1Stride && w == s2Stride && w == dStride;
+    if(!detail::mt_visit_bands(src1.getChannels(), w, src1.getROIHeight(), grain,
+                               [&](int ch, int y0, int y1) {
+      const S *s1 = src1.getROIData(ch) + y0 * s1Stride;
+      const S *s2 = src2.getROIData(ch) + y0 * s2Stride;
+      D *d = dst.getROIData(ch) + y0 * dStride;
+      if(contiguous) f(s1, s2, d, ch, w * (y1 - y0));
+      else for(int y = y0; y < y1; ++y, s1 += s1Stride, s2 += s2Stride, d += dStride) f(s1, s2, d, ch, w);
+    })) visitROILinesPerChannel2With(src1, src2, dst, f);
+  }
+
   } // namespace icl::core
\ No newline at end of file
@@ -25,6 +25,9 @@
 /// When the ROI spans the full image width, the line loop is elided
 /// and the callback receives the entire channel as a single contiguous
 /// block (width * height), maximizing SIMD throughput.
+///
+/// visitROILinesNMT / visitROILinesNWithMT are the multi-threaded
+/// counterparts (see the ...MT visitors in Visitors.h).
 
 namespace icl::core {
   namespace detail {
@@ -100,4 +103,52 @@ namespace icl::core {
     }
   }
 
+  // =================================================================
+  //  Multi-threaded variants — row bands on the shared ThreadPool
+  // =================================================================
+
+  /// Parallel visitROILinesN: f(const T* ch0, ..., int width) per line / band.
+  template<int N, class T, class F>
+  void visitROILinesNMT(const Img<T> &img, F &&f, int grain = 0) {
+    const int w = img.getROIWidth();
+    const int stride = img.getWidth();
+    if(!detail::mt_visit_bands(1, w, img.getROIHeight(), grain, [&](int, int y0, int y1) {
+      std::array<const T*, N> ptrs;
+      for(int i = 0; i < N; ++i) ptrs[i] = img.getROIData(i) + y0 * stride;
+      if(w == stride){
+        detail::call_n<T, N>(f, ptrs, w * (y1 - y0), std::make_index_sequence<N>{});
+        return;
+      }
+      for(int y = y0; y < y1; ++y) {
+        detail::call_n<T, N>(f, ptrs, w, std::make_index_sequence<N>{});
+        for(auto &p : ptrs) p += stride;
+      }
+    })) visitROILinesN<N>(img, f);
+  }
+
+  /// Parallel visitROILinesNWith: f(const S* sCh0, ..., D* dCh0, ..., int width).
+  template<int N, int M, class S, class D, class F>
+  void visitROILinesNWithMT(const Img<S> &src, Img<D> &dst, F &&f, int grain = 0) {
+    const int w = src.getROIWidth();
+    const int srcStride = src.getWidth();
+    const int dstStride = dst.getWidth();
+    if(!detail::mt_visit_bands(1, w, src.getROIHeight(), grain, [&](int, int y0, int y1) {
+      std::array<const S*, N> sp;
+      std::array<D*, M> dp;
+      for(int i = 0; i < N; ++i) sp[i] = src.getROIData(i) + y0 * srcStride;
+      for(int i = 0; i < M; ++i) dp[i] = dst.getROIData(i) + y0 * dstStride;
+      if(w == srcStride && w == dstStride){
+        detail::call_nm<S, D, N, M>(f, sp, dp, w * (y1 - y0),
+          std::make_index_sequence<N>{}, std::make_index_sequence<M>{});
+        return;
+      }
+      for(int y = y0; y < y1; ++y) {
+        detail::call_nm<S, D, N, M>(f, sp, dp, w,
+          std::make_index_sequence<N>{}, std::make_index_sequence<M>{});
+        for(auto &p : sp) p += srcStride;
+        for(auto &p : dp) p += dstStride;
+      }
+    })) visitROILinesNWith<N, M>(src, dst, f);
+  }
+
   } // namespace icl::core
\ No newline at end of file
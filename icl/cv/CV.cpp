@@ -3,10 +3,18 @@
 // Copyright (C) 2006-2026 Christof Elbrechter
 
 #include <icl/io/FileList.h>
-#include <icl/filter/ProximityOp.h>
 #include <icl/cv/CV.h>
 #include <icl/filter/BinaryLogicalOp.h>
 #include <icl/core/Img.h>
+#include <icl/math/FFTUtils.h>
+#include <icl/utils/SSETypes.h>
+#include <icl/utils/ThreadPool.h>
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <vector>
 
 namespace icl{
 
@@ -23,6 +31,267 @@ namespace icl{
       icl::io::FileList l;
     }
 
+    namespace {
+      /// contiguous copy of one channel (ROI) of an image
+      struct Plane{
+        int w = 0, h = 0;
+        std::vector<icl8u> v;
+        Plane() = default;
+        Plane(const Img8u &img, int c) : w(img.getROIWidth()), h(img.getROIHeight()), v(w*h){
+          const Rect r = img.getROI();
+          for(int y=0;y<h;++y){
+            const icl8u *src = img.getData(c) + (r.y+y)*img.getWidth() + r.x;
+            std::copy(src, src+w, v.data() + y*w);
+          }
+        }
+        /// 2x2 mean downscaled copy
+        Plane half() const{
+          Plane p;
+          p.w = w/2;
+          p.h = h/2;
+          p.v.resize(p.w*p.h);
+          for(int y=0;y<p.h;++y){
+            const icl8u *a = v.data() + 2*y*w, *b = a + w;
+            for(int x=0;x<p.w;++x){
+              p.v[y*p.w+x] = static_cast<icl8u>((a[2*x] + a[2*x+1] + b[2*x] + b[2*x+1] + 2) >> 2);
+            }
+          }
+          return p;
+        }
+      };
+
+      /// correlations of the template T (h rows of wp values, wp multiple of 8) at the N positions p..p+N-1 of I
+      /** flushRows: number of rows whose products can be summed up in 32 bit */
+      template<int N>
+      inline void correlate16(const icl16s *p, int stride, const icl16s *T, int wp, int h,
+                              int flushRows, std::int64_t *sums){
+        for(int j=0;j<N;++j) sums[j] = 0;
+#ifdef ICL_HAVE_SSE2
+        for(int v0=0;v0<h;v0+=flushRows){
+          __m128i acc[N];
+          for(int j=0;j<N;++j) acc[j] = _mm_setzero_si128();
+          for(int v=v0;v<std::min(h,v0+flushRows);++v){
+            const icl16s *a = p + v*stride, *b = T + v*wp;
+            for(int i=0;i<wp;i+=8){
+              const __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b+i));
+              for(int j=0;j<N;++j){
+                acc[j] = _mm_add_epi32(acc[j], _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a+i+j)), t));
+              }
+            }
+          }
+          for(int j=0;j<N;++j){
+            acc[j] = _mm_add_epi32(acc[j], _mm_shuffle_epi32(acc[j], 0x4E));
+            acc[j] = _mm_add_epi32(acc[j], _mm_shuffle_epi32(acc[j], 0xB1));
+            sums[j] += static_cast<std::uint32_t>(_mm_cvtsi128_si32(acc[j]));
+          }
+        }
+#else
+        (void)flushRows;
+        for(int v=0;v<h;++v){
+          const icl16s *a = p + v*stride, *b = T + v*wp;
+          for(int j=0;j<N;++j){
+            int row = 0;
+            for(int i=0;i<wp;++i) row += a[i+j]*b[i];
+            sums[j] += row;
+          }
+        }
+#endif
+      }
+
+      /// correlation Σ I(x+u,y+v)T(u,v) for all valid positions via the correlation theorem
+      /** The image and the template are transformed at once as real and
+          imaginary part of one complex matrix Z, using
+          F(I)[k] = (Z[k] + conj(Z[-k]))/2 and F(T)[k] = (Z[k] - conj(Z[-k]))/2i */
+      void fft_correlation(const Plane &I, const Plane &T, std::vector<double> &corr){
+        typedef std::complex<icl64f> C;
+        const int P = fft::nextPowerOf2(I.w), Q = fft::nextPowerOf2(I.h);
+        const int rw = I.w-T.w+1, rh = I.h-T.h+1;
+        DynMatrix<C> z(P,Q,C(0,0)), f, buf;
+        for(int y=0;y<I.h;++y){
+          for(int x=0;x<I.w;++x) z.data()[y*P+x].real(I.v[y*I.w+x]);
+        }
+        for(int y=0;y<T.h;++y){
+          for(int x=0;x<T.w;++x) z.data()[y*P+x].imag(T.v[y*T.w+x]);
+        }
+        fft::fft2D(z, f, buf);
+        const C *pf = f.data();
+        C *pz = z.data();
+        for(int ky=0;ky<Q;++ky){
+          const C *mirrorRow = pf + ((Q-ky)%Q)*P;
+          for(int kx=0;kx<P;++kx){
+            const C a = pf[ky*P+kx], b = std::conj(mirrorRow[(P-kx)%P]);
+            // F(I) * conj(F(T)) = (a+b)/2 * conj((a-b)/2i)
+            pz[ky*P+kx] = (a+b) * std::conj((a-b) * C(0,-1)) * 0.25;
+          }
+        }
+        fft::ifft2D(z, f, buf);
+        corr.resize(rw*rh);
+        for(int y=0;y<rh;++y){
+          for(int x=0;x<rw;++x) corr[y*rw+x] = f.data()[y*P+x].real();
+        }
+      }
+
+      /// whether the FFT is expected to be faster than the direct correlation
+      bool prefer_fft(const Plane &I, const Plane &T){
+        const double rw = I.w-T.w+1, rh = I.h-T.h+1;
+        const double direct = rw * rh * ((T.w+7)/8*8) * T.h;
+        const double n = double(fft::nextPowerOf2(I.w)) * fft::nextPowerOf2(I.h);
+        // two FFTs; measured with the C++ FFT backend, one butterfly costs
+        // about as much as 150 (SIMD) products of the direct correlation
+        return direct > 300 * n * std::log2(n);
+      }
+
+      /// proximity map of one channel (see computeTemplateProximity)
+      /** if mask is given, only positions with mask != 0 are computed */
+      void proximity(const Plane &I, const Plane &T, bool crossCorr, TemplateMatchingAlgorithm algorithm,
+                     const icl8u *mask, icl8u *dst, int dstStride){
+        const int w = T.w, h = T.h, rw = I.w-w+1, rh = I.h-h+1;
+        const icl8u worst = crossCorr ? 0 : 255;
+
+        double tt = 0;
+        for(const icl8u t : T.v) tt += t*t;
+
+        // integral image of the squared values
+        const int sw = I.w+1;
+        std::vector<std::uint64_t> S(static_cast<std::size_t>(sw)*(I.h+1), 0);
+        for(int y=0;y<I.h;++y){
+          std::uint64_t row = 0;
+          for(int x=0;x<I.w;++x){
+            row += I.v[y*I.w+x] * I.v[y*I.w+x];
+            S[(y+1)*sw+x+1] = S[y*sw+x+1] + row;
+          }
+        }
+
+        const bool useFFT = algorithm == tmFFT || (algorithm == tmAuto && !mask && prefer_fft(I,T));
+        std::vector<double> corr;
+        std::vector<icl16s> I16, T16;
+        const int wp = (w+7)/8*8, stride = I.w + wp;
+        // the 32 bit (unsigned) sum of all products must not overflow
+        const int flushRows = std::max<std::int64_t>(1, 0xffffffffLL / (255*255*wp));
+        if(useFFT){
+          fft_correlation(I, T, corr);
+        }else{
+          // 16 bit copies; zero padded template rows allow for SIMD only dot products
+          T16.assign(wp*h, 0);
+          for(int y=0;y<h;++y) std::copy(T.v.begin()+y*w, T.v.begin()+(y+1)*w, T16.begin()+y*wp);
+          I16.assign(stride*I.h, 0);
+          for(int y=0;y<I.h;++y) std::copy(I.v.begin()+y*I.w, I.v.begin()+(y+1)*I.w, I16.begin()+y*stride);
+        }
+
+        parallelFor(0, rh, 4, [&](int y0, int y1){
+          for(int y=y0;y<y1;++y){
+            icl8u *d = dst + y*dstStride;
+            const std::uint64_t *s0 = S.data() + y*sw, *s1 = S.data() + (y+h)*sw;
+            std::int64_t sums[4];
+            for(int x=0;x<rw;++x){
+              if(mask && !mask[y*rw+x]){
+                d[x] = worst;
+                continue;
+              }
+              double c;
+              if(useFFT){
+                c = corr[y*rw+x];
+              }else if(mask){
+                correlate16<1>(I16.data() + y*stride + x, stride, T16.data(), wp, h, flushRows, sums);
+                c = static_cast<double>(sums[0]);
+              }else{
+                // without mask, 4 positions are computed at once (sharing the template loads)
+                if(x % 4 == 0){
+                  if(x+4 <= rw) correlate16<4>(I16.data() + y*stride + x, stride, T16.data(), wp, h, flushRows, sums);
+                  else for(int j=0;x+j<rw;++j) correlate16<1>(I16.data() + y*stride + x+j, stride, T16.data(), wp, h, flushRows, sums+j);
+                }
+                c = static_cast<double>(sums[x%4]);
+              }
+              const double ii = static_cast<double>(s1[x+w] - s1[x] - s0[x+w] + s0[x]);
+              const double n = std::sqrt(ii*tt);
+              double p;
+              if(crossCorr){
+                p = n > 0 ? c/n : 0;
+              }else{
+                const double ssd = std::max(0.0, ii + tt - 2*c);
+                p = n > 0 ? ssd/n : (ssd > 0.5 ? 1 : 0);
+              }
+              d[x] = static_cast<icl8u>(std::clamp(std::lround(255*p), 0L, 255L));
+            }
+          }
+        });
+      }
+
+      /// coarse-to-fine proximity computation for all channels
+      /** The positions are pruned using the channel mean of the coarse
+          result (like matchTemplate's threshold), and all channels are
+          refined at the same positions. dst[c] is the result of channel c. */
+      void proximity_pyramid(const std::vector<Plane> &I, const std::vector<Plane> &T, bool crossCorr,
+                             TemplateMatchingAlgorithm algorithm, int levels, float significance,
+                             const std::vector<icl8u*> &dst, int dstStride){
+        const int nc = I.size();
+        const int rw = I[0].w-T[0].w+1, rh = I[0].h-T[0].h+1;
+        auto evaluate = [&](const icl8u *mask){
+          ThreadPool::global().parallelForEach(nc, [&](int c){
+            proximity(I[c], T[c], crossCorr, algorithm, mask, dst[c], dstStride);
+          });
+        };
+        if(levels <= 0 || T[0].w < 8 || T[0].h < 8){
+          evaluate(nullptr);
+          return;
+        }
+        std::vector<Plane> I2(nc), T2(nc);
+        for(int c=0;c<nc;++c){
+          I2[c] = I[c].half();
+          T2[c] = T[c].half();
+        }
+        const int rw2 = I2[0].w-T2[0].w+1, rh2 = I2[0].h-T2[0].h+1;
+        std::vector<icl8u> coarse(nc*rw2*rh2);
+        std::vector<icl8u*> coarseDst(nc);
+        for(int c=0;c<nc;++c) coarseDst[c] = coarse.data() + c*rw2*rh2;
+        proximity_pyramid(I2, T2, crossCorr, algorithm, levels-1, significance, coarseDst, rw2);
+
+        // the coarse significance level is relaxed by 0.1
+        const float sig = std::max(0.0f, significance - 0.1f);
+        const int t = nc * static_cast<int>(crossCorr ? 255*sig : 255*(1-sig));
+        std::vector<icl8u> mask(rw*rh, 0);
+        int n = 0;
+        for(int y=0;y<rh2;++y){
+          for(int x=0;x<rw2;++x){
+            int v = 0;
+            for(int c=0;c<nc;++c) v += coarseDst[c][y*rw2+x];
+            if(crossCorr ? v <= t : v >= t) continue;
+            for(int yy=std::max(0,2*y-2);yy<std::min(rh,2*y+4);++yy){
+              for(int xx=std::max(0,2*x-2);xx<std::min(rw,2*x+4);++xx){
+                n += !mask[yy*rw+xx];
+                mask[yy*rw+xx] = 1;
+              }
+            }
+          }
+        }
+        // for dense candidates, a full evaluation (possibly via FFT) is cheaper
+        evaluate(4*n < rw*rh ? mask.data() : nullptr);
+      }
+    }
+
+    void computeTemplateProximity(const Img8u &src, const Img8u &templ, Img8u &dst,
+                                  bool crossCorrelation, TemplateMatchingAlgorithm algorithm,
+                                  int pyramidLevels, float significance){
+      const Size resultSize = src.getROISize() - templ.getROISize() + Size(1,1);
+      ICLASSERT_THROW(resultSize.width > 0 && resultSize.height > 0,
+                      ICLException("computeTemplateProximity: template is larger than the source image ROI"));
+      ICLASSERT_THROW(dst.getROISize() == resultSize && dst.getChannels() == src.getChannels(),
+                      ICLException("computeTemplateProximity: invalid destination image"));
+      ICLASSERT_THROW(templ.getChannels() == src.getChannels(),
+                      ICLException("computeTemplateProximity: source and template channel count differ"));
+      const int nc = src.getChannels();
+      if(!nc) return;
+      const Rect r = dst.getROI();
+      std::vector<Plane> I(nc), T(nc);
+      std::vector<icl8u*> d(nc);
+      for(int c=0;c<nc;++c){
+        I[c] = Plane(src,c);
+        T[c] = Plane(templ,c);
+        d[c] = dst.getData(c) + r.y*dst.getWidth() + r.x;
+      }
+      proximity_pyramid(I, T, crossCorrelation, algorithm, pyramidLevels, significance, d, dst.getWidth());
+    }
+
     template<int N,typename BinaryCompare>
     inline void apply_inplace_threshold(Img8u &image,int dim, icl8u thresh, BinaryCompare cmp){
       int threshN = N*thresh;
@@ -72,7 +341,9 @@ namespace icl{
                                     Img8u *bufferGiven,
                                     bool clipBuffersToROI,
                                     RegionDetector *rdGiven,
-                                    bool useCrossCorrCoeffInsteadOfSqrDistance){
+                                    bool useCrossCorrCoeffInsteadOfSqrDistance,
+                                    TemplateMatchingAlgorithm algorithm,
+                                    int pyramidLevels){
 
       //DEBUG_LOG("src:" << src << "\ntempl:" << templ);
       Size bufSize = src.getROISize()-templ.getROISize()+Size(1,1);
@@ -92,11 +363,8 @@ namespace icl{
         bufOffs.y += templ.getROISize().height/2;
         useBuffer->setROI(Rect(bufOffs,bufSize));
       }
-      for(int i=0;i<src.getChannels();i++){
-        // ippiCrossCorrValid_Norm / ippiSqrDistanceValid_Norm removed in modern oneAPI IPP
-        // TODO: implement C++ fallback or use modern ippiSqrDistanceNorm API
-        ERROR_LOG("proximity matching not yet supported (deprecated IPP API removed)");
-      }
+      computeTemplateProximity(src, templ, *useBuffer, useCrossCorrCoeffInsteadOfSqrDistance,
+                               algorithm, pyramidLevels, significance);
 
       Img8u &m = *useBuffer;
 
@@ -188,7 +456,9 @@ namespace icl{
                                     Img8u *buffer,
                                     bool clipBuffersToROI,
                                     RegionDetector *rd,
-                                    bool useCrossCorrCoeffInsteadOfSqrDistance){
+                                    bool useCrossCorrCoeffInsteadOfSqrDistance,
+                                    TemplateMatchingAlgorithm algorithm,
+                                    int pyramidLevels){
       Img8u *useSrcBuffer = 0;
       Img8u *useTemplBuffer = 0;
       if(srcMask){
@@ -224,7 +494,9 @@ namespace icl{
                                                 buffer,
                                                 clipBuffersToROI,
                                                 rd,
-                                                useCrossCorrCoeffInsteadOfSqrDistance);
+                                                useCrossCorrCoeffInsteadOfSqrDistance,
+                                                algorithm,
+                                                pyramidLevels);
 
       if(clipBuffersToROI && srcMask){
         DEBUG_LOG("");
@@ -152,6 +152,49 @@ int main(int n,char **v){
 */
 
 namespace icl::cv {
+  /// algorithms for computing the correlation part of a template proximity map
+  enum TemplateMatchingAlgorithm{
+    tmAuto,   ///< chooses tmDirect or tmFFT by the estimated number of operations
+    tmDirect, ///< direct evaluation for every position (SIMD dot products)
+    tmFFT     ///< correlation theorem (FFT of the zero padded image and template)
+  };
+
+  /// computes the normalized proximity map of src and templ
+  /** For every position (x,y) where the template's ROI fits completely
+      into the ROI of src, the proximity of each channel is written to the
+      ROI of dst (whose ROI size must be src.ROI - templ.ROI + (1,1), and
+      whose channel count must be the one of src):
+      - cross correlation:
+        \f$ 255 \cdot \sum I T / \sqrt{\sum I^2 \sum T^2} \f$
+      - square distance:
+        \f$ 255 \cdot \min(1, \sum (I-T)^2 / \sqrt{\sum I^2 \sum T^2}) \f$
+
+      The window energies \f$\sum I^2\f$ are taken from an integral image,
+      so only the correlation \f$\sum I T\f$ depends on the template size.
+      It is evaluated directly for small templates and via FFT for large
+      ones (see TemplateMatchingAlgorithm). The result rows are computed
+      in parallel using the global utils::ThreadPool.
+
+      If pyramidLevels is larger than 0, a coarse-to-fine search is used:
+      the map is first computed for image and template downscaled by
+      2^pyramidLevels, and at full resolution, only the neighbourhoods of
+      positions whose coarse proximity, averaged over the channels like in
+      matchTemplate, passes the significance level (relaxed by 0.1) are
+      evaluated in all channels. All other positions get the worst
+      proximity value (0 for cross correlation, 255 for square distance).
+      This is much faster, but may miss matches that only appear at full
+      resolution (e.g. for templates with fine texture). Since the cross
+      correlation is not mean-free, it is high for most positions of
+      natural images, so the coarse-to-fine search mainly pays off for the
+      square distance. */
+  void ICLCV_API computeTemplateProximity(const core::Img8u &src,
+                                          const core::Img8u &templ,
+                                          core::Img8u &dst,
+                                          bool crossCorrelation,
+                                          TemplateMatchingAlgorithm algorithm=tmAuto,
+                                          int pyramidLevels=0,
+                                          float significance=0.9);
+
   /// template matching using proximity measurement
   /** \section OV Overview
 
@@ -167,7 +210,7 @@ namespace icl::cv {
       -# create a proximity-map of all channels of the src image with
          the according channels in the template image (result is
          buffered in the optionally given image buffer) Range of this
-         map is [0,255]
+         map is [0,255] (see computeTemplateProximity)
       -# create a single channel binary image from the proximity-map
          using the following rule
          \f[
@@ -179,21 +222,13 @@ namespace icl::cv {
          image rect) into the result list
       -# return the result list
 
-      \section BENCH Performance / Benchmarks
-      I applied some exemplary Benchmarks on a 2GHz Core2Duo with the following results:
-
-      - source image size 640x480, template size 100x100, 3-channel RGB image\n
-        <b>about: 37ms</b>
-      - source image size 640x480, template size 100x100, 1-channel gray image\n
-        <b>about: 13ms</b>
-      - source image size 640x480, template size 10x10, 3-channel RGB image\n
-        <b>about: 25ms</b> (not much faster)
-      - source image size 640x480, template size 200x200, 3-channel RGB image\n
-        <b>about: 35ms</b> (faster than 100x100 because of more omitted border pixels)
-
-      The internally used Ipp-Function uses several Threads to apply the proximity
-      measurement call, which means that the function might become much slower on a
-      single core machine.
+      \section BENCH Performance
+      The correlation is evaluated directly (with SSE2 dot products) for
+      small templates and using the FFT for large ones, and the result
+      rows are processed in parallel. On a single core, matching a
+      16x16 template in a 640x480 gray image takes about 20ms, a 100x100
+      template about 260ms. With square distance and 3 pyramid levels,
+      the latter takes about 40ms.
 
       @param src source image where the template should be found in
       @param templ template to search int the src image
@@ -207,6 +242,8 @@ namespace icl::cv {
              this region detector is used, which can speed up Performance in successive calls
              to matchTemplate
 	@param useCrossCorrCoeffInsteadOfSqrDistance
+      @param algorithm correlation algorithm (see computeTemplateProximity)
+      @param pyramidLevels number of coarse-to-fine levels (see computeTemplateProximity)
   **/
   std::vector<utils::Rect> ICLCV_API matchTemplate(const core::Img8u &src,
                                          const core::Img8u &templ,
@@ -214,7 +251,9 @@ namespace icl::cv {
                                          core::Img8u *buffer=0,
                                          bool clipBuffersToROI=true,
                                          RegionDetector *rd=0,
-                                         bool useCrossCorrCoeffInsteadOfSqrDistance=false);
+                                         bool useCrossCorrCoeffInsteadOfSqrDistance=false,
+                                         TemplateMatchingAlgorithm algorithm=tmAuto,
+                                         int pyramidLevels=0);
 
 
   /// more general matchTemplate implementation
@@ -228,7 +267,9 @@ namespace icl::cv {
                                          core::Img8u *buffer=0,
                                          bool clipBuffersToROI=true,
                                          RegionDetector *rd=0,
-                                         bool useCrossCorrCoeffInsteadOfSqrDistance=false);
+                                         bool useCrossCorrCoeffInsteadOfSqrDistance=false,
+                                         TemplateMatchingAlgorithm algorithm=tmAuto,
+                                         int pyramidLevels=0);
 
 
 
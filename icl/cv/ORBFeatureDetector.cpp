@@ -3,13 +3,20 @@
 // Copyright (C) 2006-2026 Christof Elbrechter
 
 #include <icl/cv/ORBFeatureDetector.h>
-#include <icl/core/OpenCV.h>
-
+#include <icl/core/CCFunctions.h>
 #include <icl/filter/LocalThresholdOp.h>
-
-#include <opencv2/features2d.hpp>
-
-namespace ocv = ::cv;
+#include <icl/utils/SSETypes.h>
+#include <icl/utils/StringUtils.h>
+#include <icl/utils/ThreadPool.h>
+#include <icl/utils/Time.h>
+
+#include <algorithm>
+#include <bit>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
 
 namespace icl{
   using namespace core;
@@ -19,112 +26,454 @@ namespace icl{
 
   namespace cv{
 
-    struct ORBFeatureDetector::Data{
-      std::shared_ptr<ocv::ORB> orb;
-      ocv::Ptr<ocv::ORB> orbp;
+    namespace {
+      /// pixel offsets of the 16 pixel Bresenham circle (radius 3, clockwise from the top)
+      const int CIRCLE[16][2] = { {0,-3},{1,-3},{2,-2},{3,-1},{3,0},{3,1},{2,2},{1,3},
+                                  {0,3},{-1,3},{-2,2},{-3,1},{-3,0},{-3,-1},{-2,-2},{-1,-3} };
+
+      /// number of point pairs (i.e. bits) of a descriptor
+      constexpr int NUM_PAIRS = ORBFeatureDetector::DESCRIPTOR_SIZE * 8;
+
+      /// FAST score: max over all 9 pixel arcs of the min. difference to the center
+      /** p is a FAST-9 corner for threshold t, if the score is larger than t */
+      inline int fast_score(const icl8u *p, const int *offs){
+        int d[16];
+        for(int k=0;k<16;++k) d[k] = int(p[offs[k]]) - int(*p);
+        int best = 0;
+        for(int k=0;k<16;++k){
+          int brighter = 255, darker = 255;
+          for(int j=0;j<9;++j){
+            const int v = d[(k+j)&15];
+            brighter = std::min(brighter, v);
+            darker = std::min(darker, -v);
+          }
+          best = std::max(best, std::max(brighter, darker));
+        }
+        return best;
+      }
 
-      MatWrapper inputBuffer;
-      ocv::Ptr<ocv::DescriptorMatcher> matcher;
+      inline int fast_score_if_corner(const icl8u *p, const int *offs, int t){
+        // a 9 pixel arc always contains two neighbouring compass points
+        const int hi = *p + t, lo = *p - t;
+        int b = 0, d = 0;
+        for(int k=0;k<4;++k){
+          const int v = p[offs[4*k]];
+          b |= (v > hi) << k;
+          d |= (v < lo) << k;
+        }
+        const auto pair = [](int m){ return m & ((m << 1 | m >> 3) & 15); };
+        if(!pair(b) && !pair(d)) return 0;
+        const int s = fast_score(p, offs);
+        return s > t ? s : 0;
+      }
 
-      LocalThresholdOp lt;
-      Img8u ltBuffer;
-      const ImgBase *lastInputImage;
-      Img8u grayInputBuffer;
+      /// FAST scores (0 for no corner) of the pixels [x0,x1) of the row at p
+      void fast_row(const icl8u *p, int x0, int x1, int t, const int *offs, icl8u *scores){
+        int x = x0;
+#ifdef ICL_HAVE_SSE2
+        const __m128i tv = _mm_set1_epi8(static_cast<char>(t));
+        const __m128i zero = _mm_setzero_si128(), ones = _mm_set1_epi8(-1);
+        const __m128i eight = _mm_set1_epi8(8);
+        for(; x+16 <= x1; x += 16){
+          const icl8u *c = p + x;
+          const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c));
+          const __m128i hi = _mm_adds_epu8(v, tv), lo = _mm_subs_epu8(v, tv);
+          __m128i b[16], d[16];
+          auto classify = [&](int k){
+            const __m128i n = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c + offs[k]));
+            b[k] = _mm_andnot_si128(_mm_cmpeq_epi8(_mm_subs_epu8(n, hi), zero), ones);
+            d[k] = _mm_andnot_si128(_mm_cmpeq_epi8(_mm_subs_epu8(lo, n), zero), ones);
+          };
+          for(int k=0;k<16;k+=4) classify(k);
+          const __m128i cand = _mm_or_si128(
+            _mm_or_si128(_mm_or_si128(_mm_and_si128(b[0],b[4]), _mm_and_si128(b[4],b[8])),
+                         _mm_or_si128(_mm_and_si128(b[8],b[12]), _mm_and_si128(b[12],b[0]))),
+            _mm_or_si128(_mm_or_si128(_mm_and_si128(d[0],d[4]), _mm_and_si128(d[4],d[8])),
+                         _mm_or_si128(_mm_and_si128(d[8],d[12]), _mm_and_si128(d[12],d[0]))));
+          std::memset(scores + x, 0, 16);
+          if(!_mm_movemask_epi8(cand)) continue;
+          for(int k=0;k<16;++k) if(k & 3) classify(k);
+
+          // longest run of brighter/darker pixels (runs may wrap around)
+          __m128i rb = zero, rd = zero, longest = zero;
+          for(int k=0;k<24;++k){
+            rb = _mm_and_si128(_mm_sub_epi8(rb, b[k&15]), b[k&15]);
+            rd = _mm_and_si128(_mm_sub_epi8(rd, d[k&15]), d[k&15]);
+            longest = _mm_max_epu8(longest, _mm_max_epu8(rb, rd));
+          }
+          int corners = ~_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_subs_epu8(longest, eight), zero)) & 0xffff;
+          while(corners){
+            const int i = std::countr_zero(static_cast<unsigned>(corners));
+            scores[x+i] = static_cast<icl8u>(fast_score(c+i, offs));
+            corners &= corners - 1;
+          }
+        }
+#endif
+        for(; x < x1; ++x) scores[x] = static_cast<icl8u>(fast_score_if_corner(p+x, offs, t));
+      }
+
+      /// Harris corner response (7x7 window of Sobel gradients) at p
+      float harris_response(const icl8u *p, int w){
+        const float scale = 1.0f/(4*7*255);
+        float a = 0, b = 0, c = 0;
+        for(int dy=-3;dy<=3;++dy){
+          for(int dx=-3;dx<=3;++dx){
+            const icl8u *q = p + dy*w + dx;
+            const float ix = ((q[-w+1] + 2*q[1] + q[w+1]) - (q[-w-1] + 2*q[-1] + q[w-1])) * scale;
+            const float iy = ((q[w-1] + 2*q[w] + q[w+1]) - (q[-w-1] + 2*q[-w] + q[-w+1])) * scale;
+            a += ix*ix;
+            b += iy*iy;
+            c += ix*iy;
+          }
+        }
+        return a*b - c*c - 0.04f*(a+b)*(a+b);
+      }
+
+      /// separable 7-tap Gaussian (sigma ~ 2) with clamped borders
+      void gaussian_blur(const Img8u &src, Img8u &dst, std::vector<icl16u> &tmp){
+        static const int K[7] = { 18, 34, 49, 54, 49, 34, 18 }; // sum 256
+        const int w = src.getWidth(), h = src.getHeight();
+        dst.setSize(src.getSize());
+        dst.setChannels(1);
+        tmp.resize(static_cast<std::size_t>(w)*h);
+        const icl8u *s = src.getData(0);
+        for(int y=0;y<h;++y){
+          const icl8u *r = s + y*w;
+          icl16u *t = tmp.data() + y*w;
+          for(int x=0;x<w;++x){
+            int sum = 0;
+            for(int k=0;k<7;++k) sum += K[k] * r[std::clamp(x+k-3, 0, w-1)];
+            t[x] = static_cast<icl16u>(sum);
+          }
+        }
+        icl8u *d = dst.getData(0);
+        for(int y=0;y<h;++y){
+          const icl16u *rows[7];
+          for(int k=0;k<7;++k) rows[k] = tmp.data() + std::clamp(y+k-3, 0, h-1)*w;
+          for(int x=0;x<w;++x){
+            int sum = 0;
+            for(int k=0;k<7;++k) sum += K[k] * rows[k][x];
+            d[y*w+x] = static_cast<icl8u>((sum + 32768) >> 16);
+          }
+        }
+      }
 
-      struct ParamSet{
-        ParamSet() : scoreType(-1){}
-        ParamSet(Configurable &c){
-          scoreType = c.getPropertyValue("score type").as<int>();
-          maxFeatures = c.getPropertyValue("max features").as<int>();
-          patchSize = c.getPropertyValue("patch size").as<int>();
-          WTA_K = c.getPropertyValue("WTA_K").as<int>();
-          pyLevels = c.getPropertyValue("pyramid.levels").as<int>();
-          pyScale = c.getPropertyValue("pyramid.scale factor").as<float>();
-          pyLevel0 = c.getPropertyValue("pyramid.first level").as<int>();
+      /// deterministic BRIEF point pairs (x1,y1,x2,y2), Gaussian distributed within the patch
+      std::vector<float> create_pattern(int patchSize){
+        const float sigma = patchSize / 5.0f;
+        const float radius = patchSize/2 - 1;
+        std::uint64_t state = 0x2545f4914f6cdd1dULL;
+        auto uniform = [&state](){
+          state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+          return ((state >> 11) + 0.5) * (1.0/9007199254740992.0);
+        };
+        auto gaussian = [&](){
+          return static_cast<float>(sigma * std::sqrt(-2*std::log(uniform())) * std::cos(2*M_PI*uniform()));
+        };
+        std::vector<float> pattern(NUM_PAIRS*4);
+        for(int i=0;i<NUM_PAIRS*2;++i){
+          float x, y;
+          do{ x = gaussian(); y = gaussian(); } while(x*x + y*y > radius*radius);
+          pattern[2*i] = x;
+          pattern[2*i+1] = y;
         }
-        int scoreType;
-        int maxFeatures;
-        int patchSize;
-        int WTA_K;
-        int pyLevels;
-        float pyScale;
-        int pyLevel0;
-        bool operator !=(const ParamSet &other) const{
-          return (scoreType != other.scoreType ||
-                  maxFeatures != other.maxFeatures ||
-                  patchSize != other.patchSize ||
-                  WTA_K != other.WTA_K ||
-                  pyLevels != other.pyLevels ||
-                  pyScale != other.pyScale ||
-                  pyLevel0 != other.pyLevel0);
+        return pattern;
+      }
 
+      struct Candidate{
+        int x, y;
+        float score;
+        bool operator<(const Candidate &o) const {  // better first, deterministic for ties
+          if(score != o.score) return score > o.score;
+          return y != o.y ? y < o.y : x < o.x;
         }
-      } params;
+      };
 
-      void updateORB(ParamSet p){
-        if(p != params){
-          if(p.patchSize/pow(p.pyScale,p.pyLevels) < 2){
-            p.patchSize = 2*pow(p.pyScale,p.pyLevels);
-            WARNING_LOG("patch size was increased to " << p.patchSize << " to ensure proper operation");
+      /// keeps the best n candidates (in quality order)
+      void keep_best(std::vector<Candidate> &c, std::size_t n){
+        if(c.size() > n){
+          std::nth_element(c.begin(), c.begin()+n, c.end());
+          c.resize(n);
+        }
+        std::sort(c.begin(), c.end());
+      }
+
+      inline std::uint16_t chunk(const icl8u *d, int c){
+        return static_cast<std::uint16_t>(d[2*c] | (d[2*c+1] << 8));
+      }
+
+      /// nearest neighbour index and distance in t for each descriptor of q (-1 if t is empty)
+      void match_brute_force(const std::vector<icl8u> &q, const std::vector<icl8u> &t,
+                             std::vector<int> &idx, std::vector<int> &dist){
+        const int D = ORBFeatureDetector::DESCRIPTOR_SIZE;
+        const int nq = q.size()/D, nt = t.size()/D;
+        idx.assign(nq, -1);
+        dist.assign(nq, INT_MAX);
+        parallelFor(0, nq, 16, [&](int i0, int i1){
+          for(int i=i0;i<i1;++i){
+            const icl8u *a = q.data() + i*D;
+            for(int j=0;j<nt;++j){
+              const int d = ORBFeatureDetector::hammingDistance(a, t.data() + j*D);
+              if(d < dist[i]){
+                dist[i] = d;
+                idx[i] = j;
+              }
+            }
           }
-          params = p;
-
-          // todo is this the point in development where this was adapted?
-#if CV_MAJOR_VERSION >= 3
-          int edgeThreshold = 31;
-          int fastThreshold = 20;
-          orbp = ocv::ORB::create(p.maxFeatures, p.pyScale, p.pyLevels, edgeThreshold, p.pyLevel0, p.WTA_K,
-                                  p.scoreType == 0 ? ocv::ORB::HARRIS_SCORE : ocv::ORB::FAST_SCORE,
-                                  p.patchSize, fastThreshold);
-#else
-          orb = new ocv::ORB(p.maxFeatures,
-                             p.pyScale,
-                             p.pyLevels,
-                             p.patchSize, p.pyLevel0, p.WTA_K,
-                             ( p.scoreType == 0 ?
-                               ocv::ORB::HARRIS_SCORE :
-                               ocv::ORB::FAST_SCORE ),
-                             p.patchSize);
-#endif
+        });
+      }
+    }
+
+    /// multi-index hash of a descriptor set
+    /** For each of the 16 bit chunks c, the indices of all descriptors are
+        sorted into 65536 buckets by their chunk value (bucket k of chunk c
+        is indices[c][offsets[c][k] .. offsets[c][k+1]-1]) */
+    struct MultiIndexHash{
+      static constexpr int CHUNKS = ORBFeatureDetector::DESCRIPTOR_SIZE/2;
+      /// maximum number of bit flips per chunk that is probed (137 buckets per chunk)
+      /** Larger radii need more bucket probes per query than brute force
+          matching of typical feature sets needs distance computations */
+      static constexpr int MAX_RADIUS = 2;
+      /// largest max. distance the hash can be used for
+      static constexpr int MAX_DIST = (MAX_RADIUS+1)*CHUNKS - 1;
+
+      std::vector<std::uint32_t> offsets[CHUNKS];
+      std::vector<std::uint32_t> indices[CHUNKS];
+
+      void build(const std::vector<icl8u> &desc){
+        const int D = ORBFeatureDetector::DESCRIPTOR_SIZE, n = desc.size()/D;
+        for(int c=0;c<CHUNKS;++c){
+          std::vector<std::uint32_t> &o = offsets[c];
+          o.assign(65537, 0);
+          for(int i=0;i<n;++i) ++o[chunk(desc.data() + i*D, c) + 1];
+          for(int k=0;k<65536;++k) o[k+1] += o[k];
+          indices[c].resize(n);
+          std::vector<std::uint32_t> pos(o.begin(), o.end()-1);
+          for(int i=0;i<n;++i) indices[c][pos[chunk(desc.data() + i*D, c)]++] = i;
         }
       }
+
+      /// like match_brute_force, but only finds neighbours with distance <= maxDist
+      /** maxDist/CHUNKS must not be larger than MAX_RADIUS */
+      void match(const std::vector<icl8u> &q, const std::vector<icl8u> &t, int maxDist,
+                 std::vector<int> &idx, std::vector<int> &dist) const{
+        const int D = ORBFeatureDetector::DESCRIPTOR_SIZE;
+        const int nq = q.size()/D, nt = t.size()/D;
+        // pigeonhole: a neighbour within maxDist differs in at most maxDist/16 bits in some chunk
+        const int radius = maxDist/CHUNKS;
+        std::vector<std::uint16_t> flips;
+        for(int f=0;f<65536;++f){
+          if(std::popcount(static_cast<unsigned>(f)) <= radius) flips.push_back(f);
+        }
+        idx.assign(nq, -1);
+        dist.assign(nq, INT_MAX);
+        parallelFor(0, nq, 16, [&](int i0, int i1){
+          std::vector<int> visited(nt, -1);
+          for(int i=i0;i<i1;++i){
+            const icl8u *a = q.data() + i*D;
+            int best = maxDist+1, bestIdx = -1;
+            for(int c=0;c<CHUNKS;++c){
+              const std::uint32_t *o = offsets[c].data(), *ind = indices[c].data();
+              const std::uint16_t key = chunk(a, c);
+              for(const std::uint16_t f : flips){
+                const int k = key ^ f;
+                for(std::uint32_t e = o[k]; e < o[k+1]; ++e){
+                  const int j = ind[e];
+                  if(visited[j] == i) continue;
+                  visited[j] = i;
+                  const int d = ORBFeatureDetector::hammingDistance(a, t.data() + j*D);
+                  if(d < best || (d == best && j < bestIdx)){
+                    best = d;
+                    bestIdx = j;
+                  }
+                }
+              }
+            }
+            if(bestIdx >= 0){
+              idx[i] = bestIdx;
+              dist[i] = best;
+            }
+          }
+        });
+      }
     };
+
     struct ORBFeatureDetector::FeatureSetClass::Impl{
-      std::vector<ocv::KeyPoint> keyPoints;
-      MatWrapper descriptors;
+      std::vector<KeyPoint> keyPoints;
+      std::vector<icl8u> descriptors;
+
+      std::once_flag hashBuilt;   //!< the hash index is only built if needed
+      MultiIndexHash hash;
+
+      const MultiIndexHash &getHash(){
+        std::call_once(hashBuilt, [this](){ hash.build(descriptors); });
+        return hash;
+      }
     };
 
-    ORBFeatureDetector::ORBFeatureDetector() : m_data(new Data){
+    struct ORBFeatureDetector::Data{
+      /// buffers and results of one pyramid level
+      struct Level{
+        Img8u buf;                 //!< scaled image (unused for level 0)
+        const Img8u *img = nullptr;
+        Img8u blurred;
+        std::vector<icl16u> blurTmp;
+        std::vector<icl8u> scores;
+        std::vector<Candidate> candidates;
+        std::vector<KeyPoint> keyPoints;
+        std::vector<icl8u> descriptors;
+        float scale = 1;
+        int quota = 0;
+      };
+      std::vector<Level> levels;
+
+      int patternPatchSize = -1;
+      std::vector<float> pattern;
+      std::vector<int> umax;      //!< half width of the circular patch for each row offset
+
+      LocalThresholdOp lt;
+      ImgBase *ltResult = nullptr;
+      Img8u ltBuffer;
+      const ImgBase *lastInputImage = nullptr;
+      const Img8u *lastGrayImage = nullptr;
+      Img8u grayInputBuffer;
+
+      ~Data(){
+        ICL_DELETE(ltResult);
+      }
+
+      void updatePattern(int patchSize){
+        if(patchSize == patternPatchSize) return;
+        patternPatchSize = patchSize;
+        pattern = create_pattern(patchSize);
+        const int half = patchSize/2;
+        umax.resize(half+1);
+        for(int v=0;v<=half;++v) umax[v] = static_cast<int>(std::floor(std::sqrt(float(half*half - v*v)) + 0.01f));
+      }
+
+      void processLevel(Level &l, int patchSize, int fastThreshold, bool harris, int border);
+    };
 
-      m_data->matcher = ocv::DescriptorMatcher::create("BruteForce");
+    void ORBFeatureDetector::Data::processLevel(Level &l, int patchSize, int fastThreshold,
+                                                bool harris, int border){
+      l.keyPoints.clear();
+      l.descriptors.clear();
+      l.candidates.clear();
+      const Img8u &img = *l.img;
+      const int w = img.getWidth(), h = img.getHeight();
+      if(l.quota <= 0 || w < 2*border+1 || h < 2*border+1) return;
+      const icl8u *data = img.getData(0);
+
+      // FAST corners
+      int offs[16];
+      for(int k=0;k<16;++k) offs[k] = CIRCLE[k][0] + CIRCLE[k][1]*w;
+      l.scores.assign(static_cast<std::size_t>(w)*h, 0);
+      for(int y=border;y<h-border;++y){
+        fast_row(data + y*w, border, w-border, fastThreshold, offs, l.scores.data() + y*w);
+      }
 
+      // 3x3 non-maximum suppression (ties are resolved in favour of the first pixel)
+      for(int y=border;y<h-border;++y){
+        const icl8u *s = l.scores.data() + y*w;
+        for(int x=border;x<w-border;++x){
+          const int v = s[x];
+          if(!v) continue;
+          if(v <= s[x-w-1] || v <= s[x-w] || v <= s[x-w+1] || v <= s[x-1] ||
+             v < s[x+1] || v < s[x+w-1] || v < s[x+w] || v < s[x+w+1]) continue;
+          l.candidates.push_back({x, y, static_cast<float>(v)});
+        }
+      }
+
+      if(harris){
+        keep_best(l.candidates, 2*l.quota);
+        for(Candidate &c : l.candidates) c.score = harris_response(data + c.y*w + c.x, w);
+      }
+      keep_best(l.candidates, l.quota);
+
+      // orientation (intensity centroid) and rotated BRIEF descriptor
+      gaussian_blur(img, l.blurred, l.blurTmp);
+      const icl8u *blurred = l.blurred.getData(0);
+      const int half = patchSize/2;
+      const float sx = float(levels[0].img->getWidth())/w, sy = float(levels[0].img->getHeight())/h;
+      l.keyPoints.resize(l.candidates.size());
+      l.descriptors.assign(l.candidates.size() * DESCRIPTOR_SIZE, 0);
+      for(std::size_t i=0;i<l.candidates.size();++i){
+        const Candidate &c = l.candidates[i];
+        const icl8u *center = data + c.y*w + c.x;
+        int m01 = 0, m10 = 0;
+        for(int u=-half;u<=half;++u) m10 += u * center[u];
+        for(int v=1;v<=half;++v){
+          int vsum = 0;
+          for(int u=-umax[v];u<=umax[v];++u){
+            const int p = center[u + v*w], m = center[u - v*w];
+            vsum += p - m;
+            m10 += u * (p + m);
+          }
+          m01 += v * vsum;
+        }
+        const float angle = std::atan2(float(m01), float(m10));
+        const float ca = std::cos(angle), sa = std::sin(angle);
+
+        const icl8u *bc = blurred + c.y*w + c.x;
+        icl8u *desc = l.descriptors.data() + i*DESCRIPTOR_SIZE;
+        auto sample = [&](const float *pt){
+          const int x = static_cast<int>(std::lround(ca*pt[0] - sa*pt[1]));
+          const int y = static_cast<int>(std::lround(sa*pt[0] + ca*pt[1]));
+          return bc[x + y*w];
+        };
+        for(int b=0;b<NUM_PAIRS;++b){
+          const float *pp = pattern.data() + 4*b;
+          if(sample(pp) < sample(pp+2)) desc[b/8] |= 1 << (b%8);
+        }
+
+        KeyPoint &k = l.keyPoints[i];
+        k.pos = Point32f(c.x*sx, c.y*sy);
+        k.size = patchSize * l.scale;
+        k.angle = angle * float(180/M_PI);
+        if(k.angle < 0) k.angle += 360;
+        k.response = c.score;
+        k.level = static_cast<int>(&l - levels.data());
+      }
+    }
+
+    ORBFeatureDetector::ORBFeatureDetector() : m_data(new Data){
       addProperty("contrast adjustment.on","flag","",false);
       addProperty("contrast adjustment.slope","range","[0.05,20]",1);
       addProperty("contrast adjustment.mask size","range","[3,100]:1",10);
       addProperty("contrast adjustment.threshold","range", "[-50,50]", 0);
 
       addProperty("score type","menu","fast,harris","harris",0, "Score type o use: harris is slightly slower but more accurate");
+      addProperty("fast threshold","range","[1,100]:1","20",0,
+                  "Minimum intensity difference between a corner and the\n"
+                  "pixels of its FAST circle");
       addProperty("max features","range:spinbox","[1,100000]:1","500",0, "Maximum number of features to detect");
-      addProperty("patch size","range","[1,1001]:1","31",0,
+      addProperty("patch size","range","[7,1001]:1","31",0,
                   "Minimum patch size that is used compute BRIF discriptors on. Since\n"
                   "the logical patch size is larger in smaller pyramid layers, the\n"
                   "maximum feature size is distinguished by 'patch size', the pyramid\n"
                   "scale factor and the number of pyramid levels. Note that features\n"
                   "will only be detected at positions, where the full patch fits into\n"
                   "the image.");
-      addProperty("WTA_K","menu","2,3,4","2",0,"Number of random points used for computing elements of the ORB descriptors");
       addProperty("pyramid.levels","range","[1,100]:1","8",0, "Number of pyramid levels to use for key-point detection");
       addProperty("pyramid.scale factor","range","[1,4]","1.4",0,"Scale down factor between consecutive pyramid layers");
       addProperty("pyramid.first level","menu","0","0",0,"First pyramid level to actually use (non-0 values are not supported yet");
 
+      addProperty("matcher","menu","brute force,multi-index hash","brute force",0,
+                  "Descriptor matching algorithm: both find the same matches, the\n"
+                  "multi-index hash is faster for large feature sets and small\n"
+                  "max. distances (it falls back to brute force for max. distances\n"
+                  "above 47)");
+      addProperty("matcher.cross check","flag","",true,0,"Only return matches that are mutual nearest neighbours");
+      addProperty("matcher.max distance","range","[0,256]:1","47",0,
+                  "Maximum Hamming distance of matched descriptors (256: no limit);\n"
+                  "the multi-index hash matcher is only used for values up to 47");
+
       addProperty("bench.enable","flag","",false,0,"Enable/Disable time benchmarks");
       addProperty("bench.preprocessing time","info","","??? ms",0,"Last time for preprocessing");
       addProperty("bench.ORB extraction time","info","","??? ms",0,"Time for the last time ORB features were detecdted");
       addProperty("bench.detection time","info","","??? ms",0,"Time for the whole last detection cycle");
       addProperty("bench.matching time","info","","??? ms",0,"Last feature matching step");
 
-      m_data->updateORB(Data::ParamSet(*this));
-
       m_data->ltBuffer = Img8u(Size(1,1),1);
       m_data->grayInputBuffer = Img8u(Size(1,1),formatGray);
     }
@@ -140,9 +489,21 @@ namespace icl{
       delete impl;
     }
 
+    const std::vector<ORBFeatureDetector::KeyPoint> &ORBFeatureDetector::FeatureSetClass::getKeyPoints() const{
+      return impl->keyPoints;
+    }
+
+    const std::vector<icl8u> &ORBFeatureDetector::FeatureSetClass::getDescriptors() const{
+      return impl->descriptors;
+    }
+
+    int ORBFeatureDetector::FeatureSetClass::size() const{
+      return static_cast<int>(impl->keyPoints.size());
+    }
+
     const ImgBase * ORBFeatureDetector::getIntermediateImage(const std::string &id){
       if(id == "input") return m_data->lastInputImage;
-      if(id == "gray") return &m_data->grayInputBuffer;
+      if(id == "gray") return m_data->lastGrayImage;
       if(id == "contrast enhanced") return &m_data->ltBuffer;
       else return 0;
     }
@@ -151,21 +512,19 @@ namespace icl{
       VisualizationDescription d;
       d.color(255,0,0,255);
       for(size_t i=0;i<impl->keyPoints.size();++i){
-        const ocv::KeyPoint &k = impl->keyPoints[i];
+        const KeyPoint &k = impl->keyPoints[i];
         float s = k.size / 2;
 
-        float cx = k.pt.x;
-        float cy = k.pt.y;
+        float cx = k.pos.x;
+        float cy = k.pos.y;
 
         d.color(0,255,0,255);
 
-        if(k.angle != -1){
-          float angle = k.angle*M_PI/180.0;
-          int cx2 = cx + cos(angle) * s;
-          int cy2 = cy + sin(angle) * s;
-          d.linewidth(2);
-          d.line(cx,cy,cx2,cy2);
-        }
+        float angle = k.angle*M_PI/180.0;
+        int cx2 = cx + cos(angle) * s;
+        int cy2 = cy + sin(angle) * s;
+        d.linewidth(2);
+        d.line(cx,cy,cx2,cy2);
 
         d.linewidth(1);
         d.color(0,100,255,255);
@@ -184,18 +543,18 @@ namespace icl{
     ORBFeatureDetector::FeatureSet ORBFeatureDetector::detect(const core::Img8u &image){
       bool bench = getPropertyValue("bench.enable");
 
-      m_data->updateORB(Data::ParamSet(*this));
-
       Time t = Time::now();
 
       m_data->lastInputImage = &image;
 
-      if(image.getFormat() != formatGray){
+      if(image.getChannels() != 1){
         cc(&image, &m_data->grayInputBuffer);
+        m_data->lastGrayImage = &m_data->grayInputBuffer;
       }else{
-        m_data->grayInputBuffer = image;
+        m_data->lastGrayImage = &image;
       }
 
+      const Img8u *src = m_data->lastGrayImage;
       if(getPropertyValue("contrast adjustment.on")){
         float slope = getPropertyValue("contrast adjustment.slope");
         int maskSize = getPropertyValue("contrast adjustment.mask size");
@@ -203,12 +562,9 @@ namespace icl{
         m_data->lt.setMaskSize(maskSize);
         m_data->lt.setGammaSlope(slope);
         m_data->lt.setGlobalThreshold(threshold);
-        static ImgBase *ltResult = nullptr;
-        m_data->lt.apply(&m_data->grayInputBuffer, &ltResult);
-        ltResult->convert(&m_data->ltBuffer);
-        m_data->inputBuffer = m_data->ltBuffer;
-      }else{
-        m_data->inputBuffer = m_data->grayInputBuffer;
+        m_data->lt.apply(src, &m_data->ltResult);
+        m_data->ltResult->convert(&m_data->ltBuffer);
+        src = &m_data->ltBuffer;
       }
 
       if(bench){
@@ -217,18 +573,54 @@ namespace icl{
 
       Time tOrb = Time::now();
 
+      const int patchSize = getPropertyValue("patch size");
+      const int fastThreshold = getPropertyValue("fast threshold");
+      const bool harris = getPropertyValue("score type").as<std::string>() == "harris";
+      const int maxFeatures = getPropertyValue("max features");
+      const int numLevels = getPropertyValue("pyramid.levels");
+      const float scaleFactor = getPropertyValue("pyramid.scale factor");
+      // FAST/Harris need 4 pixels, orientation and descriptor half a patch
+      const int border = std::max(4, patchSize/2 + 1);
+
+      m_data->updatePattern(patchSize);
+
+      // pyramid, and the number of features per level (decreasing with the level's area)
+      std::vector<Data::Level> &levels = m_data->levels;
+      levels.resize(numLevels);
+      const float f = 1.0f / scaleFactor;
+      float n = f < 1 ? maxFeatures * (1 - f) / (1 - std::pow(f, numLevels)) : float(maxFeatures) / numLevels;
+      int remaining = maxFeatures;
+      for(int i=0;i<numLevels;++i){
+        Data::Level &l = levels[i];
+        l.scale = std::pow(scaleFactor, i);
+        if(i == 0){
+          l.img = src;
+        }else{
+          const Size s(static_cast<int>(std::lround(src->getWidth() / l.scale)),
+                       static_cast<int>(std::lround(src->getHeight() / l.scale)));
+          if(s.width < 2*border+1 || s.height < 2*border+1){
+            levels.resize(i);
+            break;
+          }
+          l.buf.setChannels(1);
+          l.buf.setSize(s);
+          levels[i-1].img->scaledCopy(&l.buf, interpolateLIN);
+          l.img = &l.buf;
+        }
+        l.quota = i == numLevels-1 ? remaining : std::min(remaining, static_cast<int>(std::lround(n)));
+        remaining -= l.quota;
+        n *= f;
+      }
+
+      ThreadPool::global().parallelForEach(levels.size(), [&](int i){
+        m_data->processLevel(levels[i], patchSize, fastThreshold, harris, border);
+      });
+
       FeatureSetClass *ret = new FeatureSetClass;
-#if CV_MAJOR_VERSION >= 3
-      m_data->orbp->detectAndCompute(m_data->inputBuffer.mat,
-                                     ocv::noArray(),
-                                     ret->impl->keyPoints,
-                                     ret->impl->descriptors.mat);
-#else
-      m_data->orb->operator()(m_data->inputBuffer.mat,
-                              ocv::noArray(),
-                              ret->impl->keyPoints,
-                              ret->impl->descriptors.mat);
-#endif
+      for(const Data::Level &l : levels){
+        ret->impl->keyPoints.insert(ret->impl->keyPoints.end(), l.keyPoints.begin(), l.keyPoints.end());
+        ret->impl->descriptors.insert(ret->impl->descriptors.end(), l.descriptors.begin(), l.descriptors.end());
+      }
 
       if(bench){
         setPropertyValue("bench.ORB extraction time",bench_time_string(tOrb.age()));
@@ -238,6 +630,33 @@ namespace icl{
       return std::shared_ptr<FeatureSetClass>(ret);
     }
 
+    int ORBFeatureDetector::hammingDistance(const icl8u *a, const icl8u *b){
+#ifdef ICL_HAVE_SSSE3
+      // popcount via a 4 bit lookup table
+      const __m128i lut = _mm_setr_epi8(0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4);
+      const __m128i low = _mm_set1_epi8(0x0f);
+      auto count = [&](__m128i x){
+        return _mm_add_epi8(_mm_shuffle_epi8(lut, _mm_and_si128(x, low)),
+                            _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(x, 4), low)));
+      };
+      const __m128i x0 = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a)),
+                                       _mm_loadu_si128(reinterpret_cast<const __m128i*>(b)));
+      const __m128i x1 = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a+16)),
+                                       _mm_loadu_si128(reinterpret_cast<const __m128i*>(b+16)));
+      const __m128i s = _mm_sad_epu8(_mm_add_epi8(count(x0), count(x1)), _mm_setzero_si128());
+      return _mm_cvtsi128_si32(s) + _mm_extract_epi16(s, 4);
+#else
+      int d = 0;
+      for(int i=0;i<DESCRIPTOR_SIZE;i+=8){
+        std::uint64_t u, v;
+        std::memcpy(&u, a+i, 8);
+        std::memcpy(&v, b+i, 8);
+        d += std::popcount(u ^ v);
+      }
+      return d;
+#endif
+    }
+
     std::vector<ORBFeatureDetector::Match>
     ORBFeatureDetector::match(const ORBFeatureDetector::FeatureSet &a,
                               const ORBFeatureDetector::FeatureSet &b){
@@ -245,29 +664,31 @@ namespace icl{
       bool bench = getPropertyValue("bench.enable");
       Time t = Time::now();
 
-      std::vector<ocv::DMatch> matches;
-      m_data->matcher->match(a->impl->descriptors.mat, b->impl->descriptors.mat,
-                             matches);
-
-      const std::vector<ocv::KeyPoint> &k1 = a->impl->keyPoints;
-      const std::vector<ocv::KeyPoint> &k2 = b->impl->keyPoints;
-
-      std::vector<Match> ret(matches.size());
-      for(size_t i=0;i<ret.size();++i){
-        const ocv::DMatch &m = matches[i];
-        int i1 = matches[i].queryIdx;
-        int i2 = matches[i].trainIdx;
-        if(static_cast<unsigned>(i1) >= k1.size()){
-          ERROR_LOG("invalid key point index k1");
-          continue;
-        }
-        if(static_cast<unsigned>(i2) >= k2.size()){
-          ERROR_LOG("invalid key point index k2");
-          continue;
-        }
-        ret[i].a.x = k1[i1].pt.x;
-        ret[i].a.y = k1[i1].pt.y;
-        ret[i].distance = m.distance;
+      const bool crossCheck = getPropertyValue("matcher.cross check");
+      const int maxDist = getPropertyValue("matcher.max distance");
+      // the number of hash probes explodes for more bit flips per chunk
+      const bool hashed = getPropertyValue("matcher").as<std::string>() == "multi-index hash"
+                          && maxDist <= MultiIndexHash::MAX_DIST;
+
+      const std::vector<icl8u> &da = a->impl->descriptors, &db = b->impl->descriptors;
+      std::vector<int> ab, dist, ba, distBA;
+      if(hashed){
+        b->impl->getHash().match(da, db, maxDist, ab, dist);
+        if(crossCheck) a->impl->getHash().match(db, da, maxDist, ba, distBA);
+      }else{
+        match_brute_force(da, db, ab, dist);
+        if(crossCheck) match_brute_force(db, da, ba, distBA);
+      }
+
+      const std::vector<KeyPoint> &k1 = a->impl->keyPoints;
+      const std::vector<KeyPoint> &k2 = b->impl->keyPoints;
+
+      std::vector<Match> ret;
+      for(size_t i=0;i<ab.size();++i){
+        const int j = ab[i];
+        if(j < 0 || dist[i] > maxDist) continue;
+        if(crossCheck && ba[j] != static_cast<int>(i)) continue;
+        ret.push_back({k1[i].pos, k2[j].pos, static_cast<float>(dist[i]), static_cast<int>(i), j});
       }
 
       if(bench){
@@ -282,36 +703,3 @@ namespace icl{
 
   }
 }
-
-
-#if 0
-void crossCheckMatching( Ptr<DescriptorMatcher>& descriptorMatcher,
-                         const Mat& descriptors1, const Mat& descriptors2,
-                         vector<DMatch>& filteredMatches12, int knn=1 )
-{
-    filteredMatches12.clear();
-    vector<vector<DMatch> > matches12, matches21;
-    descriptorMatcher->knnMatch( descriptors1, descriptors2, matches12, knn );
-    descriptorMatcher->knnMatch( descriptors2, descriptors1, matches21, knn );
-    for( size_t m = 0; m < matches12.size(); m++ )
-    {
-        bool findCrossCheck = false;
-        for( size_t fk = 0; fk < matches12[m].size(); fk++ )
-        {
-            DMatch forward = matches12[m][fk];
-
-            for( size_t bk = 0; bk < matches21[forward.trainIdx].size(); bk++ )
-            {
-                DMatch backward = matches21[forward.trainIdx][bk];
-                if( backward.trainIdx == forward.queryIdx )
-                {
-                    filteredMatches12.push_back(forward);
-                    findCrossCheck = true;
-                    break;
-                }
-            }
-            if( findCrossCheck ) break;
-        }
-    }
-}
-#endif
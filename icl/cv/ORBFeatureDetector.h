@@ -4,47 +4,109 @@
 
 #pragma once
 
-#ifndef ICL_HAVE_OPENCV_FEATURES_2D
-#warning "This header must not be included without ICL_HAVE_OPENCV_FEATURES_2D defined"
-#endif
-
 #include <icl/core/Img.h>
 #include <icl/utils/Configurable.h>
 #include <icl/utils/Point.h>
 #include <icl/utils/VisualizationDescription.h>
 
+#include <memory>
+#include <vector>
+
 namespace icl::cv {
-    class ICLCV_API ORBFeatureDetector : public utils::Configurable{
-      struct Data;
-      Data *m_data;
+  /// ORB (oriented FAST and rotated BRIEF) feature detector and matcher
+  /** The detector is implemented natively (no OpenCV needed):
+      - key points are FAST-9 corners (16 pixel Bresenham circle, the
+        segment test is evaluated for 16 pixels at once if SSE2 is
+        available), that are detected on every level of an image
+        pyramid and thinned by a 3x3 non-maximum suppression
+      - the best key points of each level are selected by their FAST
+        or Harris score ("score type"); the number of features per level
+        decreases geometrically with the level's scale
+      - the key point orientation is given by the intensity centroid of
+        the circular patch around it
+      - the 256 bit descriptor (rotated BRIEF) compares 256 fixed point
+        pairs of a Gaussian smoothed patch, that are rotated by the key
+        point's orientation. The point pairs are generated
+        deterministically, so descriptors computed by different
+        detector instances with the same patch size are comparable
+
+      The pyramid levels are processed in parallel using the global
+      utils::ThreadPool.
+
+      \section MATCH Matching
+      match() returns, for each feature of the first set, its nearest
+      neighbour (Hamming distance) in the second set. Matches with a
+      distance larger than "matcher.max distance" are dropped, and if
+      "matcher.cross check" is set, only mutual nearest neighbours are
+      returned. Two matchers are available, both return exactly the same
+      result:
+      - <b>brute force</b>: compares all pairs of descriptors (with a
+        SIMD popcount if SSSE3 is available)
+      - <b>multi-index hash</b>: splits the descriptors into 16 chunks of
+        16 bits and indexes each chunk separately. If two descriptors
+        have a distance of at most d, at least one of their chunks
+        differs in at most d/16 bits, so only the entries in the chunk
+        buckets around the query need to be compared. This is much faster
+        for large feature sets (thousands of features) and small max
+        distances; for max distances of 48 or more, brute force matching
+        is used instead. The default max distance is 47, so both matchers
+        drop matches with larger distances unless it is set to 256. */
+  class ICLCV_API ORBFeatureDetector : public utils::Configurable{
+    struct Data;
+    Data *m_data;
+
+    public:
+    ORBFeatureDetector();
+
+    ~ORBFeatureDetector();
 
-      public:
-      ORBFeatureDetector();
+    /// number of bytes of a descriptor
+    static constexpr int DESCRIPTOR_SIZE = 32;
 
-      ~ORBFeatureDetector();
+    /// detected key point
+    struct KeyPoint{
+      utils::Point32f pos; //!< position in the input image
+      float size;          //!< patch diameter in input image pixels
+      float angle;         //!< orientation in degrees (clockwise, as the y-axis points down)
+      float response;      //!< FAST or Harris score
+      int level;           //!< pyramid level the key point was detected in
+    };
 
-      struct ICLCV_API FeatureSetClass {
-        FeatureSetClass(const FeatureSetClass&) = delete;
-        FeatureSetClass& operator=(const FeatureSetClass&) = delete;
-        struct Impl;
-        Impl *impl;
-        FeatureSetClass();
-        ~FeatureSetClass();
-        utils::VisualizationDescription vis() const;
-      };
+    struct ICLCV_API FeatureSetClass {
+      FeatureSetClass(const FeatureSetClass&) = delete;
+      FeatureSetClass& operator=(const FeatureSetClass&) = delete;
+      struct Impl;
+      Impl *impl;
+      FeatureSetClass();
+      ~FeatureSetClass();
+      utils::VisualizationDescription vis() const;
 
-      using FeatureSet = std::shared_ptr<FeatureSetClass>;
+      /// detected key points
+      const std::vector<KeyPoint> &getKeyPoints() const;
 
+      /// descriptors of all key points (DESCRIPTOR_SIZE bytes each, in key point order)
+      const std::vector<icl8u> &getDescriptors() const;
 
-      struct Match{
-        utils::Point32f a,b;
-        float distance;
-      };
+      /// number of features
+      int size() const;
+    };
 
-      FeatureSet detect(const core::Img8u &image);
+    using FeatureSet = std::shared_ptr<FeatureSetClass>;
 
-      const core::ImgBase *getIntermediateImage(const std::string &id);
 
-      std::vector<Match> match(const FeatureSet &a, const FeatureSet &b);
+    struct Match{
+      utils::Point32f a,b;  //!< key point positions in the first and second set
+      float distance;       //!< Hamming distance of the descriptors
+      int indexA, indexB;   //!< key point indices in the first and second set
     };
-  }
\ No newline at end of file
+
+    FeatureSet detect(const core::Img8u &image);
+
+    const core::ImgBase *getIntermediateImage(const std::string &id);
+
+    std::vector<Match> match(const FeatureSet &a, const FeatureSet &b);
+
+    /// Hamming distance of two descriptors
+    static int hammingDistance(const icl8u *a, const icl8u *b);
+  };
+}
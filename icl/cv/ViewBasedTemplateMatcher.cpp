@@ -9,7 +9,8 @@ using namespace icl::core;
 
 namespace icl::cv {
   ViewBasedTemplateMatcher::ViewBasedTemplateMatcher(float significance, mode m, bool clipBuffersToROI):
-    m_fSignificance(significance),m_eMode(m),m_bClipBuffersToROI(clipBuffersToROI){}
+    m_fSignificance(significance),m_eMode(m),m_bClipBuffersToROI(clipBuffersToROI),
+    m_eAlgorithm(tmAuto),m_iPyramidLevels(0){}
 
   void ViewBasedTemplateMatcher::setSignificance(float significance){
     m_fSignificance = significance;
@@ -23,6 +24,14 @@ namespace icl::cv {
     m_bClipBuffersToROI = flag;
   }
 
+  void ViewBasedTemplateMatcher::setAlgorithm(TemplateMatchingAlgorithm algorithm){
+    m_eAlgorithm = algorithm;
+  }
+
+  void ViewBasedTemplateMatcher::setPyramidLevels(int levels){
+    m_iPyramidLevels = levels;
+  }
+
   const std::vector<Rect> &ViewBasedTemplateMatcher::match(const Img8u &image,
                                                            const Img8u &templ,
                                                            const Img8u &imageMask,
@@ -38,7 +47,9 @@ namespace icl::cv {
                                   m_aoBuffers+2,
                                   m_bClipBuffersToROI,
                                   &m_oRD,
-                                  m_eMode == sqrtDistance ? false : true);
+                                  m_eMode == sqrtDistance ? false : true,
+                                  m_eAlgorithm,
+                                  m_iPyramidLevels);
 
     return m_vecResults;
   }
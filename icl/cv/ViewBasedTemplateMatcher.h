@@ -42,6 +42,12 @@ namespace icl::cv {
     /// set buffer clipping mode (see constructor description)
     void setClipBuffersToROI(bool flag);
 
+    /// set the correlation algorithm (tmAuto by default, see computeTemplateProximity)
+    void setAlgorithm(TemplateMatchingAlgorithm algorithm);
+
+    /// set the number of coarse-to-fine search levels (0 by default, see computeTemplateProximity)
+    void setPyramidLevels(int levels);
+
     /// apply matching with given image and template (optionally image and template masks can be given)
     const std::vector<utils::Rect> &match(const core::Img8u &image, const core::Img8u &templ, const core::Img8u &imageMask=core::Img8u::null, const core::Img8u &templMask=core::Img8u::null);
 
@@ -52,6 +58,8 @@ namespace icl::cv {
     float m_fSignificance;          ///< significance level
     mode m_eMode;                   ///< matching mode
     bool m_bClipBuffersToROI;       ///< buffer clipping mode
+    TemplateMatchingAlgorithm m_eAlgorithm; ///< correlation algorithm
+    int m_iPyramidLevels;           ///< number of coarse-to-fine levels
     utils::UncopiedInstance<RegionDetector> m_oRD;           ///< internally recycled RegionDetector instance
     utils::UncopiedInstance<core::Img8u> m_aoBuffers[3];           ///< interanlly used buffers
     std::vector<utils::Rect> m_vecResults; ///< internal result buffer
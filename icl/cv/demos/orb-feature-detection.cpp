@@ -4,7 +4,6 @@
 
 #define ICL_NO_USING_NAMESPACES
 
-#include <icl/core/OpenCV.h>
 #include <icl/qt/Common2.h>
 #include <icl/cv/ORBFeatureDetector.h>
 
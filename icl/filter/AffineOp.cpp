@@ -154,8 +154,10 @@ namespace icl::filter {
                  src.getFormat(), src.getChannels(),
                  Rect(Point::null, oSize), src.getTime())) return;
 
-     getSelector<AffineSig>(Op::apply).resolve(src)->apply(
-       src, dst, &m_aadT[0][0], m_eInterpolate);
+     applyBands(getSelector<AffineSig>(Op::apply).resolve(src), dst,
+                [&](auto &impl, Image &band, int){
+                  impl.apply(src, band, &m_aadT[0][0], m_eInterpolate);
+                });
 
      if(m_adaptResultImage){
        translate(xShift, yShift);
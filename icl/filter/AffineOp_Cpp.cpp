@@ -2,6 +2,12 @@
 #include <icl/core/Image.h>
 #include <icl/core/Img.h>
 #include <icl/math/FixedMatrix.h>
+#include <icl/filter/detail/AffineRows.h>
+
+#include <algorithm>
+#include <cmath>
+
+ICL_NO_FP_CONTRACT
 
 using namespace icl;
 using namespace icl::utils;
@@ -12,6 +18,42 @@ namespace {
 
   using AOp = filter::AffineOp;
 
+  using filter::detail::RowMapping;
+  using filter::detail::row_mapping;
+  using filter::detail::safe_span;
+  using filter::detail::affine_nn;
+
+  template<class T>
+  void affine_rows(const Img<T> &s, Img<T> &d, const double inv[3][3], scalemode interp){
+    const Rect dr = d.getROI();
+    const int sx = dr.x, ex = dr.right();
+    const Rect r = s.getROI();
+    // subPixelLIN reads a 2x2 neighborhood starting at (floor(x2), floor(y2)),
+    // so we need floor(x2)+1 < width and floor(y2)+1 < height.
+    // Edge pixels that are in-bounds but outside the safe bilinear zone
+    // fall back to nearest-neighbor.
+    const float maxX = s.getWidth() - 1;
+    const float maxY = s.getHeight() - 1;
+
+    for(int ch = 0; ch < s.getChannels(); ch++) {
+      const Channel<T> srcCh = s[ch];
+      Channel<T> dstCh = d[ch];
+      for(int y = dr.y; y < dr.bottom(); ++y){
+        const RowMapping m = row_mapping(inv, y);
+        T *dstRow = &dstCh(0,y);
+        if(interp == interpolateLIN){
+          int x0, x1;
+          safe_span(m, maxX, maxY, sx, ex, x0, x1);
+          for(int x = sx; x < x0; ++x) dstRow[x] = affine_nn(m, x, srcCh, r);
+          for(int x = x0; x < x1; ++x) dstRow[x] = s.subPixelLIN(m.x(x), m.y(x), ch);
+          for(int x = x1; x < ex; ++x) dstRow[x] = affine_nn(m, x, srcCh, r);
+        }else{
+          for(int x = sx; x < ex; ++x) dstRow[x] = affine_nn(m, x, srcCh, r);
+        }
+      }
+    }
+  }
+
   // C++ fallback: inverse-map destination pixels to source via inverse matrix
   void cpp_affine(const Image &src, Image &dst, const double* fwd, scalemode interp) {
     // Compute inverse of the 2x3 forward transform (extended to 3x3)
@@ -25,51 +67,7 @@ namespace {
         inv[i][j] = M(j, i);
 
     src.visitWith(dst, [&](const auto &s, auto &d) {
-      using T = typename std::remove_reference_t<decltype(s)>::type;
-      Rect dr = d.getROI();
-      int sx = dr.x, sy = dr.y, ex = dr.right(), ey = dr.bottom();
-      Rect r = s.getROI();
-
-      for(int ch = 0; ch < s.getChannels(); ch++) {
-        const Channel<T> srcCh = s[ch];
-        Channel<T> dstCh = d[ch];
-
-        if(interp == interpolateLIN){
-          // subPixelLIN reads a 2x2 neighborhood starting at (floor(x2), floor(y2)),
-          // so we need floor(x2)+1 < width and floor(y2)+1 < height.
-          // Edge pixels that are in-bounds but outside the safe bilinear zone
-          // fall back to nearest-neighbor.
-          float maxX = s.getWidth() - 1;
-          float maxY = s.getHeight() - 1;
-          for(int x = sx; x < ex; ++x){
-            for(int y = sy; y < ey; ++y){
-              float x2 = inv[0][0]*x + inv[1][0]*y + inv[2][0];
-              float y2 = inv[0][1]*x + inv[1][1]*y + inv[2][1];
-              if(x2 >= 0 && x2 < maxX && y2 >= 0 && y2 < maxY){
-                dstCh(x,y) = s.subPixelLIN(x2,y2,ch);
-              }else{
-                int x3 = round(x2);
-                int y3 = round(y2);
-                dstCh(x,y) = r.contains(x3,y3) ? srcCh(x3,y3) : T(0);
-              }
-            }
-          }
-        }else{
-          for(int x = sx; x < ex; ++x){
-            for(int y = sy; y < ey; ++y){
-              float x2 = inv[0][0]*x + inv[1][0]*y + inv[2][0];
-              float y2 = inv[0][1]*x + inv[1][1]*y + inv[2][1];
-              int x3 = round(x2);
-              int y3 = round(y2);
-              if(r.contains(x3,y3)){
-                dstCh(x,y) = srcCh(x3,y3);
-              }else{
-                dstCh(x,y) = 0;
-              }
-            }
-          }
-        }
-      }
+      affine_rows(s, d, inv, interp);
     });
   }
 
@@ -0,0 +1,142 @@
+#include <icl/core/ImageBackendDispatching.h>
+#include <icl/core/Img.h>
+#include <icl/core/Image.h>
+#include <icl/utils/SSETypes.h>
+#include <icl/filter/AffineOp.h>
+#include <icl/math/FixedMatrix.h>
+#include <icl/filter/detail/AffineRows.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+ICL_NO_FP_CONTRACT
+
+#ifdef ICL_HAVE_SSE2
+
+using namespace icl;
+using namespace icl::utils;
+using namespace icl::math;
+using namespace icl::core;
+
+namespace {
+
+  using AOp = filter::AffineOp;
+
+  using filter::detail::RowMapping;
+  using filter::detail::row_mapping;
+  using filter::detail::safe_span;
+  using filter::detail::affine_nn;
+
+  // ================================================================
+  // Bilinear interpolation of 4 destination pixels
+  // ================================================================
+
+  /// source coordinates of pixels x..x+3 (double precision, rounded to float)
+  inline __m128 map4(double b, double d, int x){
+    const __m128d vb = _mm_set1_pd(b), vd = _mm_set1_pd(d);
+    const __m128d lo = _mm_add_pd(vb, _mm_mul_pd(vd, _mm_set_pd(x+1, x)));
+    const __m128d hi = _mm_add_pd(vb, _mm_mul_pd(vd, _mm_set_pd(x+3, x+2)));
+    return _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi));
+  }
+
+  /// Img::subPixelLIN for 4 pixels; coordinates are known to be >= 0, so
+  /// truncation equals floor
+  template<class T>
+  inline icl32fx4 lin4(const T *data, int w, __m128 xs, __m128 ys){
+    const __m128i xi = _mm_cvttps_epi32(xs), yi = _mm_cvttps_epi32(ys);
+    const icl32fx4 fX0 = _mm_sub_ps(xs, _mm_cvtepi32_ps(xi));
+    const icl32fx4 fY0 = _mm_sub_ps(ys, _mm_cvtepi32_ps(yi));
+    const icl32fx4 one(1.0f);
+    const icl32fx4 fX1 = one - fX0, fY1 = one - fY0;
+
+    alignas(16) int ix[4], iy[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(ix), xi);
+    _mm_store_si128(reinterpret_cast<__m128i*>(iy), yi);
+    alignas(16) float a[4], b[4], c[4], d[4];
+    for(int i = 0; i < 4; ++i){
+      const T *p = data + ix[i] + iy[i] * w;
+      a[i] = p[0]; b[i] = p[1];
+      c[i] = p[w]; d[i] = p[w+1];
+    }
+    return fX1 * (fY1*icl32fx4(a) + fY0*icl32fx4(c)) + fX0 * (fY1*icl32fx4(b) + fY0*icl32fx4(d));
+  }
+
+  inline void store4(const icl32fx4 &v, icl32f *dst){
+    v.storeu(dst);
+  }
+
+  inline void store4(const icl32fx4 &v, icl8u *dst){
+    const __m128i i = _mm_cvttps_epi32(v);
+    const __m128i p = _mm_packus_epi16(_mm_packs_epi32(i, i), _mm_setzero_si128());
+    const int packed = _mm_cvtsi128_si32(p);
+    std::memcpy(dst, &packed, 4);
+  }
+
+  template<class T>
+  void affine_lin_rows(const Img<T> &s, Img<T> &d, const double inv[3][3]){
+    const Rect dr = d.getROI();
+    const int sx = dr.x, ex = dr.right();
+    const Rect r = s.getROI();
+    const int w = s.getWidth();
+    const float maxX = s.getWidth() - 1;
+    const float maxY = s.getHeight() - 1;
+
+    for(int ch = 0; ch < s.getChannels(); ch++) {
+      const Channel<T> srcCh = s[ch];
+      Channel<T> dstCh = d[ch];
+      const T *data = s.getData(ch);
+      for(int y = dr.y; y < dr.bottom(); ++y){
+        const RowMapping m = row_mapping(inv, y);
+        T *dstRow = &dstCh(0,y);
+        int x0, x1;
+        safe_span(m, maxX, maxY, sx, ex, x0, x1);
+        for(int x = sx; x < x0; ++x) dstRow[x] = affine_nn(m, x, srcCh, r);
+        int x = x0;
+        for(; x <= x1 - 4; x += 4){
+          store4(lin4(data, w, map4(m.bx, m.dx, x), map4(m.by, m.dy, x)), dstRow + x);
+        }
+        for(; x < x1; ++x) dstRow[x] = s.subPixelLIN(m.x(x), m.y(x), ch);
+        for(x = x1; x < ex; ++x) dstRow[x] = affine_nn(m, x, srcCh, r);
+      }
+    }
+  }
+
+  // ================================================================
+  // SIMD backend entry point
+  // ================================================================
+
+  void simd_affine(const Image &src, Image &dst, const double* fwd, scalemode interp) {
+    if(interp != interpolateLIN){
+      auto* cpp = AOp::prototype()
+          .template getSelector<AOp::AffineSig>(AOp::Op::apply)
+          .get(Backend::Cpp);
+      cpp->apply(src, dst, fwd, interp);
+      return;
+    }
+    FixedMatrix<double,3,3> M(fwd[0], fwd[1], fwd[2],
+                               fwd[3], fwd[4], fwd[5],
+                               0, 0, 1);
+    M = M.inv();
+    double inv[3][3];
+    for(int i = 0; i < 3; ++i)
+      for(int j = 0; j < 3; ++j)
+        inv[i][j] = M(j, i);
+
+    if(src.getDepth() == depth8u){
+      affine_lin_rows(src.as8u(), dst.as8u(), inv);
+    }else{
+      affine_lin_rows(src.as32f(), dst.as32f(), inv);
+    }
+  }
+
+  static int _reg = [] {
+    auto simd = AOp::prototype().backends(Backend::Simd);
+    simd.add<AOp::AffineSig>(AOp::Op::apply, simd_affine,
+      applicableTo<icl8u, icl32f>, "SSE2/NEON bilinear affine warp");
+    return 0;
+  }();
+
+} // anonymous namespace
+
+#endif // ICL_HAVE_SSE2
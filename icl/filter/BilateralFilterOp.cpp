@@ -53,7 +53,10 @@ void BilateralFilterOp::apply(const Image &src, Image &dst) {
     ERROR_LOG("no applicable backend for BilateralFilterOp");
     return;
   }
-  impl->apply(src, dst, m_radius, m_sigmaS, m_sigmaR, m_useLAB);
+  // bands share the complete source image, backends only fill dst's ROI
+  applyBands(impl, dst, [&](auto &bandImpl, Image &band, int){
+    bandImpl.apply(src, band, m_radius, m_sigmaS, m_sigmaR, m_useLAB);
+  });
 }
 
 REGISTER_CONFIGURABLE_DEFAULT(BilateralFilterOp);
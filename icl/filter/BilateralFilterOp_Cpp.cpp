@@ -28,11 +28,13 @@ namespace {
   //   O(1) per pixel at the cost of accuracy. Suitable for large radii.
   // - SIMD inner loop: the per-neighbor multiply-accumulate is a good target for
   //   SSE2/NEON vectorization, especially the mono path.
-  // - OpenMP parallelization: the outer pixel loop is embarrassingly parallel.
-  //   Could use #pragma omp parallel for on the y-loop.
   // - Tiled/cache-friendly traversal: for large images and large radii, blocking
   //   the image into tiles that fit in L1/L2 improves memory access patterns.
 
+  // All variants only fill dst's ROI (in src coordinates; src and dst have
+  // the same size), so BilateralFilterOp can split the image into row bands
+  // that read the complete source.
+
   // Round-to-nearest for integer types, direct cast for float/double
   template<class T>
   inline T roundCast(float v) {
@@ -66,13 +68,14 @@ namespace {
     const float inv2rr = -1.f / (2.f * sigma_r * sigma_r);
     const auto spatialLUT = buildSpatialLUT(radius, sigma_s);
     const int side = 2 * radius + 1;
+    const Rect roi = dst.getROI();
 
     for(int c = 0; c < ch; ++c) {
       const T* sdata = src.getData(c);
       T* ddata = dst.getData(c);
 
-      for(int y = 0; y < h; ++y) {
-        for(int x = 0; x < w; ++x) {
+      for(int y = roi.y; y < roi.bottom(); ++y) {
+        for(int x = roi.x; x < roi.right(); ++x) {
           float center = static_cast<float>(sdata[y * w + x]);
           float sum = 0.f, wsum = 0.f;
 
@@ -105,21 +108,25 @@ namespace {
                            int radius, float sigma_s, float sigma_r) {
     const int w = src.getWidth();
     const int h = src.getHeight();
-    const int n = w * h;
     const float inv2rr = -1.f / (2.f * sigma_r * sigma_r);
     const auto spatialLUT = buildSpatialLUT(radius, sigma_s);
     const int side = 2 * radius + 1;
+    const Rect roi = dst.getROI();
 
-    // Convert src to LAB (all in float)
+    // Convert the rows of src within reach of the ROI to LAB (all in float)
+    const int labY0 = std::max(0, roi.y - radius);
+    const int labY1 = std::min(h, roi.bottom() + radius);
+    const int labOffset = labY0 * w;
+    const int n = (labY1 - labY0) * w;
     std::vector<float> labL(n), labA(n), labB(n);
     const T* r = src.getData(0);
     const T* g = src.getData(1);
     const T* b = src.getData(2);
 
     for(int i = 0; i < n; ++i) {
-      icl32f rf = static_cast<icl32f>(r[i]);
-      icl32f gf = static_cast<icl32f>(g[i]);
-      icl32f bf = static_cast<icl32f>(b[i]);
+      icl32f rf = static_cast<icl32f>(r[labOffset + i]);
+      icl32f gf = static_cast<icl32f>(g[labOffset + i]);
+      icl32f bf = static_cast<icl32f>(b[labOffset + i]);
       cc_util_rgb_to_lab(rf, gf, bf, labL[i], labA[i], labB[i]);
     }
 
@@ -127,10 +134,11 @@ namespace {
     T* dg = dst.getData(1);
     T* db = dst.getData(2);
 
-    for(int y = 0; y < h; ++y) {
-      for(int x = 0; x < w; ++x) {
+    for(int y = roi.y; y < roi.bottom(); ++y) {
+      for(int x = roi.x; x < roi.right(); ++x) {
         const int idx = y * w + x;
-        float cL = labL[idx], cA = labA[idx], cB = labB[idx];
+        const int lidx = idx - labOffset;
+        float cL = labL[lidx], cA = labA[lidx], cB = labB[lidx];
         float sumR = 0, sumG = 0, sumB = 0, wsum = 0;
 
         const int y0 = std::max(0, y - radius);
@@ -141,9 +149,9 @@ namespace {
         for(int ny = y0; ny <= y1; ++ny) {
           for(int nx = x0; nx <= x1; ++nx) {
             const int nidx = ny * w + nx;
-            float dL = cL - labL[nidx];
-            float dA = cA - labA[nidx];
-            float dB = cB - labB[nidx];
+            float dL = cL - labL[nidx - labOffset];
+            float dA = cA - labA[nidx - labOffset];
+            float dB = cB - labB[nidx - labOffset];
             float range_w = std::exp((dL*dL + dA*dA + dB*dB) * inv2rr);
             float spatial_w = spatialLUT[(ny - y + radius) * side + (nx - x + radius)];
             float weight = spatial_w * range_w;
@@ -180,9 +188,10 @@ namespace {
       ddata[c] = dst.getData(c);
     }
 
+    const Rect roi = dst.getROI();
     std::vector<float> sums(ch);
-    for(int y = 0; y < h; ++y) {
-      for(int x = 0; x < w; ++x) {
+    for(int y = roi.y; y < roi.bottom(); ++y) {
+      for(int x = roi.x; x < roi.right(); ++x) {
         const int idx = y * w + x;
         std::fill(sums.begin(), sums.end(), 0.f);
         float wsum = 0.f;
@@ -16,7 +16,7 @@ namespace {
   void acc_binary_arith(const Image &src1, const Image &src2, Image &dst, int optype) {
     // vDSP note: vsub(B,stride,A,stride,C,stride,N) → C=A-B
     //            vdiv(B,stride,A,stride,C,stride,N) → C=A/B
-    visitROILinesPerChannel2With(src1.as32f(), src2.as32f(), dst.as32f(),
+    visitROILinesPerChannel2WithMT(src1.as32f(), src2.as32f(), dst.as32f(),
       [optype](const icl32f *a, const icl32f *b, icl32f *d, int, int w) {
         vImagePixelCount n = static_cast<vImagePixelCount>(w);
         switch(optype) {
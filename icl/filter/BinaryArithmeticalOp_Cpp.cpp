@@ -14,7 +14,7 @@ namespace {
 
   template<BOp::optype OT, class T>
   void arithOp(const Img<T> &s1, const Img<T> &s2, Img<T> &dst) {
-    visitROILinesPerChannel2With(s1, s2, dst, [](const T *a, const T *b, T *d, int, int w) {
+    visitROILinesPerChannel2WithMT(s1, s2, dst, [](const T *a, const T *b, T *d, int, int w) {
       for(int i = 0; i < w; ++i) {
         if constexpr (OT == BOp::addOp)    d[i] = a[i] + b[i];
         else if constexpr (OT == BOp::subOp)    d[i] = a[i] - b[i];
@@ -22,7 +22,7 @@ namespace {
       using T = typename std::remove_reference_t<decltype(s1)>::type;
       if constexpr (std::is_same_v<T, icl32f>) {
         const auto &s2 = src2.as<T>();
-        visitROILinesPerChannel2With(s1, s2, d,
+        visitROILinesPerChannel2WithMT(s1, s2, d,
           [](const icl32f *a, const icl32f *b, icl32f *dp, int, int w) {
             int i = 0;
             for(; i <= w - 4; i += 4) {
@@ -13,7 +13,7 @@ namespace {
 
   template<BCOp::optype OT, class T>
   void cmpTyped(const Img<T> &s1, const Img<T> &s2, Img8u &dst) {
-    visitROILinesPerChannel2With(s1, s2, dst,
+    visitROILinesPerChannel2WithMT(s1, s2, dst,
       [](const T *a, const T *b, icl8u *d, int, int w) {
         for(int i = 0; i < w; ++i) {
           if constexpr (OT == BCOp::lt)   d[i] = a[i] < b[i] ? 255 : 0;
@@ -45,7 +45,7 @@ namespace {
     s1.visit([&](const auto &a) {
       using T = typename std::remove_reference_t<decltype(a)>::type;
       T tol = clipped_cast<double,T>(tolerance);
-      visitROILinesPerChannel2With(a, s2.as<T>(), d,
+      visitROILinesPerChannel2WithMT(a, s2.as<T>(), d,
         [tol](const T *ap, const T *bp, icl8u *dp, int, int w) {
           for(int i = 0; i < w; ++i)
             dp[i] = std::abs(ap[i] - bp[i]) <= tol ? 255 : 0;
@@ -33,7 +33,7 @@ namespace {
       auto &d = dst.as8u();
 
       if constexpr (std::is_same_v<T, icl32f>) {
-        visitROILinesPerChannel2With(s1, s2, d,
+        visitROILinesPerChannel2WithMT(s1, s2, d,
           [](const icl32f *a, const icl32f *b, icl8u *dp, int, int w) {
             int i = 0;
             for(; i <= w - 4; i += 4) {
@@ -62,7 +62,7 @@ namespace {
             }
           });
       } else if constexpr (std::is_same_v<T, icl8u>) {
-        visitROILinesPerChannel2With(s1, s2, d,
+        visitROILinesPerChannel2WithMT(s1, s2, d,
           [](const icl8u *a, const icl8u *b, icl8u *dp, int, int w) {
             int i = 0;
             for(; i <= w - 16; i += 16) {
@@ -22,7 +22,7 @@ namespace {
       if constexpr (std::is_integral_v<T>) {
         const auto &s2 = src2.as<T>();
         constexpr int step = 16 / sizeof(T);
-        visitROILinesPerChannel2With(s1, s2, d, [](const T *a, const T *b, T *dp, int, int w) {
+        visitROILinesPerChannel2WithMT(s1, s2, d, [](const T *a, const T *b, T *dp, int, int w) {
           int i = 0;
           for(; i <= w - step; i += step) {
             __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a+i));
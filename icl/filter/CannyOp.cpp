@@ -6,12 +6,33 @@
 #include <icl/core/Img.h>
 #include <icl/core/Image.h>
 #include <icl/filter/ConvolutionOp.h>
+#include <icl/filter/detail/CannyFused.h>
 #include <icl/utils/SSEUtils.h>
+#include <icl/utils/ClippedCast.h>
+
+#include <algorithm>
+#include <mutex>
 
 using namespace icl::utils;
 using namespace icl::core;
 
 namespace icl::filter {
+  const char* toString(CannyOp::Op op) {
+    switch(op) {
+      case CannyOp::Op::fused: return "fused";
+    }
+    return "?";
+  }
+
+  core::ImageBackendDispatching& CannyOp::prototype() {
+    static core::ImageBackendDispatching proto;
+    [[maybe_unused]] static bool init = [&] {
+      proto.addSelector<FusedSig>(Op::fused);
+      return true;
+    }();
+    return proto;
+  }
+
   void CannyOp::property_callback(const Property &p){
     // Keep inner-loop caches in sync with the property store.
     if(p.name == "low threshold"){
@@ -22,6 +43,8 @@ namespace icl::filter {
       m_preBlurRadius = parse<int>(p.value);
       ICL_DELETE(m_preBlurOp);
       setUpPreBlurOp();
+    }else if(p.name == "mode"){
+      m_mode = p.value == "fused 8u" ? fused8u : separateDerivatives;
     }
   }
 
@@ -29,10 +52,13 @@ namespace icl::filter {
     addProperty("low threshold","range:slider","[0,2000]",str(lowThresh));
     addProperty("high threshold","range:slider","[0,2000]",str(highThresh));
     addProperty("pre-blur radius","range:spinbox","[0,10]",str(preBlurRadius));
+    addProperty("mode","menu","separate derivatives,fused 8u","separate derivatives");
   }
 
   CannyOp::CannyOp(icl32f lowThresh, icl32f highThresh,int preBlurRadius):
-    m_lowT(lowThresh),m_highT(highThresh),m_ownOps(true),m_preBlurRadius(preBlurRadius){
+    ImageBackendDispatching(prototype()),
+    m_lowT(lowThresh),m_highT(highThresh),m_ownOps(true),m_preBlurRadius(preBlurRadius),
+    m_mode(separateDerivatives){
     FUNCTION_LOG("");
     m_ops[0] = new ConvolutionOp(ConvolutionKernel(ConvolutionKernel::sobelX3x3));
     m_ops[1] = new ConvolutionOp(ConvolutionKernel(ConvolutionKernel::sobelY3x3));
@@ -44,7 +70,9 @@ namespace icl::filter {
   }
 
   CannyOp::CannyOp(UnaryOp *dxOp, UnaryOp *dyOp,icl32f lowThresh, icl32f highThresh, bool deleteOps, int preBlurRadius):
-    m_lowT(lowThresh),m_highT(highThresh),m_ownOps(deleteOps),m_preBlurRadius(preBlurRadius){
+    ImageBackendDispatching(prototype()),
+    m_lowT(lowThresh),m_highT(highThresh),m_ownOps(deleteOps),m_preBlurRadius(preBlurRadius),
+    m_mode(separateDerivatives){
     FUNCTION_LOG("");
     m_ops[0] = dxOp;
     m_ops[1] = dyOp;
@@ -106,29 +134,6 @@ namespace icl::filter {
   }
 #endif
 
-  // Iterative 8-connected flood fill (hysteresis propagation from strong=2
-  // pixels through connected weak=1 pixels). A recursive version blows the
-  // thread stack when the weak-edge component is large — e.g. low threshold
-  // near 0 on a VGA image, where almost every pixel ends up in state 1.
-  static void followEdge(icl8u *seed, int w) {
-    const int offsets[8] = { -w-1, -w, -w+1, -1, 1, w-1, w, w+1 };
-    std::vector<icl8u*> stack;
-    stack.reserve(64);
-    *seed = 255;
-    stack.push_back(seed);
-    while (!stack.empty()) {
-      icl8u *p = stack.back();
-      stack.pop_back();
-      for (int off : offsets) {
-        icl8u *q = p + off;
-        if (*q == 1) {
-          *q = 255;
-          stack.push_back(q);
-        }
-      }
-    }
-  }
-
   void CannyOp::applyCanny32f(const Img32f &dx, const Img32f &dy, Img8u &dst, int c) {
     icl32f low  = m_lowT;
     icl32f high = m_highT;
@@ -183,14 +188,6 @@ namespace icl::filter {
         }
       }
     }
-
-    // hysteresis thresholding (followEdge uses dst stride for neighbor access)
-    for (int y = 0; y < dxH; ++y) {
-      for (int x = 0; x < dxW; ++x) {
-        icl8u &px = dstBase[y * dstStride + x];
-        if (px == 2) followEdge(&px, dstStride);
-      }
-    }
   }
 
   void CannyOp::applyCanny16s(const Img16s &dx, const Img16s &dy, Img8u &dst, int c) {
@@ -247,37 +244,141 @@ namespace icl::filter {
         }
       }
     }
+  }
 
-    // hysteresis thresholding (followEdge uses dst stride for neighbor access)
-    for (int y = 0; y < dxH; ++y) {
-      for (int x = 0; x < dxW; ++x) {
-        icl8u &px = dstBase[y * dstStride + x];
-        if (px == 2) followEdge(&px, dstStride);
+  namespace {
+    // union-find on pixel indices; a root is the smallest index of its
+    // component, so parent[i] <= i always holds
+    inline int canny_find(int *parent, int i){
+      while(parent[i] != i){
+        parent[i] = parent[parent[i]];
+        i = parent[i];
       }
+      return i;
+    }
+
+    inline void canny_unite(int *parent, int a, int b){
+      a = canny_find(parent, a);
+      b = canny_find(parent, b);
+      if(a < b) parent[b] = a;
+      else if(b < a) parent[a] = b;
+    }
+
+    // true if the fused mode reproduces the derivatives of op
+    bool is_sobel(UnaryOp *op, ConvolutionKernel::fixedType t){
+      const ConvolutionOp *conv = dynamic_cast<const ConvolutionOp*>(op);
+      return conv && conv->getKernel().getFixedType() == t;
     }
   }
 
+  void CannyOp::applyHysteresis(Image &dst, int c) {
+    Img8u &d = dst.as8u();
+    const Rect roi = d.getROI();
+    const int w = roi.width, h = roi.height, stride = d.getWidth();
+    if(w <= 0 || h <= 0) return;
+    m_parents.resize(w * h);
+    m_strong.resize(w * h);
+    int *parent = m_parents.data();
+    icl8u *strong = m_strong.data();
+    icl8u *base = d.getROIData(c);
+
+    // label each band independently: parents never leave the band. A new
+    // pixel joins the set of one of its already visited neighbours, and a
+    // union is only needed if it connects two of them that are not adjacent
+    std::vector<int> bandStarts;
+    std::mutex bandMutex;
+    applyBands(dst, [&](Image &band, int y0){
+      {
+        std::lock_guard<std::mutex> lock(bandMutex);
+        bandStarts.push_back(y0);
+      }
+      const int y1 = y0 + band.getROI().height;
+      for(int y = y0; y < y1; ++y){
+        const icl8u *row = base + y * stride;
+        const icl8u *up = y > y0 ? row - stride : nullptr;
+        for(int x = 0, i = y * w; x < w; ++x, ++i){
+          if(!row[x]) continue;
+          strong[i] = 0;
+          const bool left = x && row[x-1];
+          if(!up){
+            parent[i] = left ? parent[i-1] : i;
+          }else if(up[x]){
+            // left, up-left and up-right are adjacent to up
+            parent[i] = parent[i-w];
+          }else{
+            const bool upLeft = x && up[x-1], upRight = x + 1 < w && up[x+1];
+            if(left || upLeft){
+              // the up-left pixel is the left pixel's up neighbour
+              parent[i] = left ? parent[i-1] : parent[i-w-1];
+              if(upRight) canny_unite(parent, i, i - w + 1);
+            }else{
+              parent[i] = upRight ? parent[i-w+1] : i;
+            }
+          }
+        }
+      }
+    });
+
+    // merge the bands across their first rows
+    for(int y0 : bandStarts){
+      if(!y0) continue;
+      const icl8u *row = base + y0 * stride, *up = row - stride;
+      for(int x = 0, i = y0 * w; x < w; ++x, ++i){
+        if(!row[x]) continue;
+        for(int k = std::max(x - 1, 0); k <= std::min(x + 1, w - 1); ++k){
+          if(up[k]) canny_unite(parent, i, i - w + (k - x));
+        }
+      }
+    }
+
+    // as parent[i] <= i, a single pass in index order points every pixel
+    // to its root; the roots collect the strong pixels
+    for(int y = 0, i = 0; y < h; ++y){
+      const icl8u *row = base + y * stride;
+      for(int x = 0; x < w; ++x, ++i){
+        if(!row[x]) continue;
+        parent[i] = parent[parent[i]];
+        strong[parent[i]] |= row[x] == 2;
+      }
+    }
 
-  void CannyOp::applyCannyCore(const Image &derivX, const Image &derivY,
-                               Image &dst, const Image &srcForMeta) {
+    // components with a strong pixel become edges
+    applyBands(dst, [&](Image &band, int y0){
+      const int y1 = y0 + band.getROI().height;
+      for(int y = y0; y < y1; ++y){
+        icl8u *row = base + y * stride;
+        for(int x = 0, i = y * w; x < w; ++x, ++i){
+          if(row[x]) row[x] = strong[parent[i]] ? 255 : 0;
+        }
+      }
+    });
+  }
+
+  bool CannyOp::prepareResult(const Size &size, const Image &meta,
+                              Image &dst, const Image &srcForMeta) {
     Size dstSize;
     Rect dstROI;
     format dstFmt;
     int dstCh;
     if(getClipToROI()) {
-      dstSize = derivX.getSize();
+      dstSize = size;
       dstROI = Rect(Point::null, dstSize);
-      dstFmt = derivX.getFormat();
-      dstCh = derivX.getChannels();
+      dstFmt = meta.getFormat();
+      dstCh = meta.getChannels();
     } else {
       dstSize = srcForMeta.getSize();
-      dstROI = Rect(Point(1,1), derivX.getSize());
-      const Image &metaSrc = m_use_derivatives_info ? derivX : srcForMeta;
+      dstROI = Rect(Point(1,1), size);
+      const Image &metaSrc = m_use_derivatives_info ? meta : srcForMeta;
       dstFmt = metaSrc.getFormat();
       dstCh = metaSrc.getChannels();
     }
-    if(!prepare(dst, depth8u, dstSize, dstFmt, dstCh, dstROI,
-                srcForMeta.getTime())) return;
+    return prepare(dst, depth8u, dstSize, dstFmt, dstCh, dstROI,
+                   srcForMeta.getTime());
+  }
+
+  void CannyOp::applyCannyCore(const Image &derivX, const Image &derivY,
+                               Image &dst, const Image &srcForMeta) {
+    if(!prepareResult(derivX.getSize(), derivX, dst, srcForMeta)) return;
 
     Img8u &d = dst.as8u();
 
@@ -291,17 +392,47 @@ namespace icl::filter {
           break;
         default: ICL_INVALID_DEPTH;
       }
+      applyHysteresis(dst, c);
+    }
+  }
+
+  void CannyOp::applyFused(const Image &src, Image &dst) {
+    if(!prepareResult(detail::canny_result_rect(src).getSize(), src, dst, src)) return;
+
+    // same conversion as in applyCanny16s
+    const int low = icl16s(clip<icl32f>(m_lowT, -32768, 32767));
+    const int high = icl16s(clip<icl32f>(m_highT, -32768, 32767));
+    applyBands(getSelector<FusedSig>(Op::fused).resolve(src), dst,
+               [&](auto &impl, Image &band, int y0){
+                 impl.apply(src, band, y0, low, high);
+               });
+
+    for(int c = 0; c < dst.getChannels(); ++c){
+      applyHysteresis(dst, c);
     }
   }
 
   void CannyOp::apply(const Image &src, Image &dst) {
     ICLASSERT_RETURN(!src.isNull());
 
+    // pre-blur radii > 2 use a custom kernel whose 8u result may be clipped
+    const bool fused = m_mode == fused8u && src.getDepth() == depth8u && m_preBlurRadius <= 2
+                       && is_sobel(m_ops[0], ConvolutionKernel::sobelX3x3)
+                       && is_sobel(m_ops[1], ConvolutionKernel::sobelY3x3);
+
     const Image *input = &src;
     if(m_preBlurRadius > 0) {
+      // the fused mode needs the blurred image as 8u
+      ConvolutionOp *blur = static_cast<ConvolutionOp*>(m_preBlurOp);
+      if(blur->getForceUnsignedOutput() != fused) blur->setForceUnsignedOutput(fused);
       input = &m_preBlurOp->apply(src);
     }
 
+    if(fused && detail::canny_result_rect(*input).getDim() > 0){
+      applyFused(*input, dst);
+      return;
+    }
+
     for(int i = 0; i < 2; i++){
       m_ops[i]->setClipToROI(true);
       m_ops[i]->apply(*input, m_derivatives[i]);
@@ -356,6 +487,14 @@ namespace icl::filter {
 
   void CannyOp::setPreBlurRadius(int r){ setPropertyValue("pre-blur radius", r); }
 
+  void CannyOp::setMode(mode m){
+    setPropertyValue("mode", m == fused8u ? "fused 8u" : "separate derivatives");
+  }
+
+  CannyOp::mode CannyOp::getMode() const {
+    return prop("mode").value == "fused 8u" ? fused8u : separateDerivatives;
+  }
+
   bool CannyOp::getPreBlurRadius() const {
     // name retained for ABI — semantic is "pre-blur feature active"
     return parse<int>(prop("pre-blur radius").value) > 0;
@@ -8,6 +8,7 @@
 #include <icl/core/Img.h>
 #include <icl/filter/UnaryOp.h>
 #include <icl/core/Image.h>
+#include <icl/core/ImageBackendDispatching.h>
 
 namespace icl::filter {
   /// Class for the canny edge detector \ingroup UNARY
@@ -41,13 +42,48 @@ namespace icl::filter {
       has too hard edges (e.g. from edges from black to white). In this case, the canny edge
       detector implementation overlooks these borders independent on the given threshold values.
 
-
+      @section MODE Modes
+      By default (separateDerivatives), the x and y derivatives are computed by the
+      derivative operators (3x3 Sobel unless given to the constructor) into 16s or 32f
+      images, which are then used for non-maximum suppression.
+
+      For 8u images and the default Sobel operators, the fused8u mode computes the
+      gradient, the quantized gradient direction and the non-maximum suppression in a
+      single pass over the image rows using integer arithmetic (SSE2 if available),
+      so no derivative images are created. Its result is identical to the one of the
+      separateDerivatives mode. For other depths, custom derivative operators or
+      pre-blur radii larger than 2, the fused8u mode falls back to separateDerivatives.
+
+      In both modes, the hysteresis thresholding labels the connected (8-neighborhood)
+      candidate pixels with a non-recursive union-find in row bands, which are merged
+      afterwards. Bands run in parallel according to the UnaryOp thread settings.
   */
-  class ICLFilter_API CannyOp : public UnaryOp{
+  class ICLFilter_API CannyOp : public UnaryOp, public core::ImageBackendDispatching{
     public:
     CannyOp(const CannyOp&) = delete;
     CannyOp& operator=(const CannyOp&) = delete;
 
+    /// computation modes (see \ref MODE)
+    enum mode {
+      separateDerivatives, //!< derivative images and separate non-maximum suppression
+      fused8u              //!< fused single pass computation for 8u images
+    };
+
+    /// Backend selector keys
+    enum class Op : int { fused };
+
+    /// Dispatch signature of the fused8u mode: src, dst, y0, low, high
+    /** Writes the edge candidate states (0: none, 1: weak, 2: strong) of the
+        3x3 Sobel gradient of src's ROI into dst's ROI. As for the derivative
+        operators, src's ROI is clipped to the pixels with a complete 3x3
+        neighbourhood. dst may be a horizontal band of the result that
+        starts at result row y0. low and high are the thresholds as applied
+        to the 16s gradient magnitude |dx|+|dy| */
+    using FusedSig = void(const core::Image&, core::Image&, int, int, int);
+
+    /// Class-level prototype — owns selectors, populated during static init
+    static core::ImageBackendDispatching& prototype();
+
       /// Constructor
       /**
         With this Constructor the derivations are computed within the CannyOp.
@@ -116,6 +152,13 @@ namespace icl::filter {
     /// returns current pre-blur feature state (true if radius > 0)
     bool getPreBlurRadius() const;
 
+    /// sets the computation mode
+    /** Forwards to the Configurable property "mode" */
+    void setMode(mode m);
+
+    /// returns the computation mode
+    mode getMode() const;
+
     private:
 
     void property_callback(const Property &p);
@@ -133,8 +176,22 @@ namespace icl::filter {
     void applyCannyCore(const core::Image &derivX, const core::Image &derivY,
                         core::Image &dst, const core::Image &srcForMeta);
 
-    /// buffer for ippiCanny
-    std::vector<icl8u> m_cannyBuf;
+    /// prepares dst for a result of the given size (the derivative images' size)
+    bool prepareResult(const utils::Size &size, const core::Image &meta,
+                       core::Image &dst, const core::Image &srcForMeta);
+
+    /// fused8u mode for an 8u image
+    void applyFused(const core::Image &src, core::Image &dst);
+
+    /// hysteresis thresholding of the candidate states in dst's ROI of channel c
+    /** Components of weak and strong pixels become 255 if they contain a
+        strong pixel, and 0 otherwise */
+    void applyHysteresis(core::Image &dst, int c);
+
+    /// union-find parents for the hysteresis (index of the parent pixel)
+    std::vector<int> m_parents;
+    /// per union-find root: whether the component contains a strong pixel
+    std::vector<icl8u> m_strong;
     core::Image m_derivatives[2];
     core::Image m_legacyResult;  ///< keeps 3-arg apply result alive
     UnaryOp *m_ops[2];
@@ -143,5 +200,10 @@ namespace icl::filter {
     bool m_ownOps;
     bool m_use_derivatives_info;
     int m_preBlurRadius;
+    mode m_mode;
   };
+
+  /// ADL-visible toString for CannyOp::Op (defined in CannyOp.cpp)
+  ICLFilter_API const char* toString(CannyOp::Op op);
+
   } // namespace icl::filter
\ No newline at end of file
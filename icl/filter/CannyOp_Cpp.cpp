@@ -0,0 +1,27 @@
+#include <icl/filter/CannyOp.h>
+#include <icl/filter/detail/CannyFused.h>
+#include <icl/core/Img.h>
+#include <icl/core/Image.h>
+
+using namespace icl;
+using namespace icl::utils;
+using namespace icl::core;
+
+namespace {
+
+  using COp = filter::CannyOp;
+
+  void cpp_canny_fused(const Image &src, Image &dst, int y0, int low, int high) {
+    filter::detail::canny_fused_band(src.as8u(), dst.as8u(), y0, low, high,
+                                     filter::detail::canny_gradient_row,
+                                     filter::detail::canny_nms_row);
+  }
+
+  static int _reg = [] {
+    auto cpp = COp::prototype().backends(Backend::Cpp);
+    cpp.add<COp::FusedSig>(COp::Op::fused, cpp_canny_fused,
+      applicableTo<icl8u>, "C++ fused 8u canny");
+    return 0;
+  }();
+
+} // anonymous namespace
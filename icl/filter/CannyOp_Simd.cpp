@@ -0,0 +1,113 @@
+#include <icl/core/ImageBackendDispatching.h>
+#include <icl/core/Img.h>
+#include <icl/core/Image.h>
+#include <icl/utils/SSETypes.h>
+#include <icl/filter/CannyOp.h>
+#include <icl/filter/detail/CannyFused.h>
+
+#ifdef ICL_HAVE_SSE2
+
+using namespace icl;
+using namespace icl::utils;
+using namespace icl::core;
+using namespace icl::filter::detail;
+
+namespace {
+
+  using COp = filter::CannyOp;
+
+  inline __m128i load8(const icl8u *p){
+    return _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)), _mm_setzero_si128());
+  }
+
+  inline __m128i load16(const icl16s *p){
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+  }
+
+  inline __m128i abs16(__m128i v){
+    return _mm_max_epi16(v, _mm_sub_epi16(_mm_setzero_si128(), v));
+  }
+
+  /// 16 bit mask of ax*f - ay*g > t (int32 products of interleaved pairs)
+  inline __m128i ratio_test(__m128i ax, __m128i ay, __m128i fg, __m128i t){
+    const __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi16(ax, ay), fg);
+    const __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi16(ax, ay), fg);
+    return _mm_packs_epi32(_mm_cmpgt_epi32(lo, t), _mm_cmpgt_epi32(hi, t));
+  }
+
+  inline __m128i select16(__m128i mask, __m128i a, __m128i b){
+    return _mm_or_si128(_mm_andnot_si128(mask, a), _mm_and_si128(mask, b));
+  }
+
+  // ================================================================
+  // 8 result pixels per iteration in 16 bit lanes; the direction tests
+  // use _mm_madd_epi16 on interleaved (|dx|,|dy|) pairs
+  // ================================================================
+
+  void simd_gradient_row(const icl8u *r0, const icl8u *r1, const icl8u *r2,
+                         int x0, int x1, icl16s *mag, icl8u *dir){
+    const __m128i steep = _mm_set1_epi32(int(std::uint32_t(std::uint16_t(-CANNY_STEEP_DY)) << 16) | CANNY_STEEP_DX);
+    const __m128i diag = _mm_set1_epi32(int(std::uint32_t(std::uint16_t(-CANNY_STEEP_DX)) << 16) | CANNY_STEEP_DY);
+    const __m128i zero = _mm_setzero_si128(), minusOne = _mm_set1_epi32(-1);
+    const __m128i one = _mm_set1_epi16(1), three = _mm_set1_epi16(3);
+    int x = x0;
+    for(; x + 8 <= x1; x += 8){
+      const __m128i a0 = load8(r0+x), a1 = load8(r0+x+1), a2 = load8(r0+x+2);
+      const __m128i b0 = load8(r1+x), b2 = load8(r1+x+2);
+      const __m128i c0 = load8(r2+x), c1 = load8(r2+x+1), c2 = load8(r2+x+2);
+      const __m128i dx = _mm_sub_epi16(_mm_add_epi16(_mm_add_epi16(a0, c0), _mm_add_epi16(b0, b0)),
+                                       _mm_add_epi16(_mm_add_epi16(a2, c2), _mm_add_epi16(b2, b2)));
+      const __m128i dy = _mm_sub_epi16(_mm_add_epi16(_mm_add_epi16(a0, a2), _mm_add_epi16(a1, a1)),
+                                       _mm_add_epi16(_mm_add_epi16(c0, c2), _mm_add_epi16(c1, c1)));
+      const __m128i ax = abs16(dx), ay = abs16(dy);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(mag+x), _mm_add_epi16(ax, ay));
+
+      const __m128i nonZero = _mm_xor_si128(_mm_cmpeq_epi16(_mm_or_si128(dx, dy), zero), _mm_set1_epi16(-1));
+      const __m128i isH = _mm_and_si128(ratio_test(ax, ay, steep, minusOne), nonZero);
+      const __m128i isD = _mm_andnot_si128(isH, ratio_test(ax, ay, diag, zero));
+      // equal signs: diagonal (2), otherwise anti-diagonal (3)
+      const __m128i same = _mm_cmpgt_epi16(_mm_xor_si128(dx, dy), _mm_set1_epi16(-1));
+      const __m128i d = _mm_or_si128(_mm_and_si128(isH, one),
+                                     _mm_and_si128(isD, _mm_sub_epi16(three, _mm_and_si128(same, one))));
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(dir+x), _mm_packus_epi16(d, d));
+    }
+    canny_gradient_row(r0, r1, r2, x, x1, mag, dir);
+  }
+
+  void simd_nms_row(const icl16s *m0, const icl16s *m1, const icl16s *m2,
+                    const icl8u *dir, int x0, int x1, int low, int high, icl8u *dst){
+    const __m128i lowV = _mm_set1_epi16(icl16s(low)), highV = _mm_set1_epi16(icl16s(high));
+    const __m128i one = _mm_set1_epi16(1);
+    int x = x0;
+    for(; x + 8 <= x1; x += 8){
+      const __m128i m = load16(m1+x);
+      const __m128i d = load8(dir+x);
+      __m128i n = _mm_max_epi16(load16(m0+x), load16(m2+x));
+      n = select16(_mm_cmpeq_epi16(d, _mm_set1_epi16(cannyHorizontal)), n,
+                   _mm_max_epi16(load16(m1+x-1), load16(m1+x+1)));
+      n = select16(_mm_cmpeq_epi16(d, _mm_set1_epi16(cannyDiagonal)), n,
+                   _mm_max_epi16(load16(m0+x-1), load16(m2+x+1)));
+      n = select16(_mm_cmpeq_epi16(d, _mm_set1_epi16(cannyAntiDiagonal)), n,
+                   _mm_max_epi16(load16(m2+x-1), load16(m0+x+1)));
+      const __m128i suppressed = _mm_or_si128(_mm_cmplt_epi16(m, n), _mm_cmplt_epi16(m, lowV));
+      // 1 for weak, 1 - (-1) = 2 for strong pixels
+      const __m128i state = _mm_andnot_si128(suppressed, _mm_sub_epi16(one, _mm_cmpgt_epi16(m, highV)));
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(dst+x), _mm_packus_epi16(state, state));
+    }
+    canny_nms_row(m0, m1, m2, dir, x, x1, low, high, dst);
+  }
+
+  void simd_canny_fused(const Image &src, Image &dst, int y0, int low, int high) {
+    canny_fused_band(src.as8u(), dst.as8u(), y0, low, high, simd_gradient_row, simd_nms_row);
+  }
+
+  static int _reg = [] {
+    auto simd = COp::prototype().backends(Backend::Simd);
+    simd.add<COp::FusedSig>(COp::Op::fused, simd_canny_fused,
+      applicableTo<icl8u>, "SSE2 fused 8u canny");
+    return 0;
+  }();
+
+} // anonymous namespace
+
+#endif // ICL_HAVE_SSE2
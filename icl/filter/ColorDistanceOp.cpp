@@ -17,8 +17,8 @@ namespace icl::filter {
     if(threshold >= 0){
       Img8u &d = dst.as8u();
       double t2 = threshold * threshold;
-      visitROILinesNWith<3,1>(src, d, [&](const S *r, const S *g, const S *b,
-                                          icl8u *out, int w) {
+      visitROILinesNWithMT<3,1>(src, d, [&](const S *r, const S *g, const S *b,
+                                            icl8u *out, int w) {
         for(int i = 0; i < w; ++i){
           double dr = ref[0] - r[i], dg = ref[1] - g[i], db = ref[2] - b[i];
           out[i] = (dr*dr + dg*dg + db*db < t2) ? 255 : 0;
@@ -26,8 +26,8 @@ namespace icl::filter {
       });
     }else{
       dst.visit([&](auto &out) {
-        visitROILinesNWith<3,1>(src, out, [&](const S *r, const S *g, const S *b,
-                                              auto *d, int w) {
+        visitROILinesNWithMT<3,1>(src, out, [&](const S *r, const S *g, const S *b,
+                                                auto *d, int w) {
           for(int i = 0; i < w; ++i){
             double dr = ref[0] - r[i], dg = ref[1] - g[i], db = ref[2] - b[i];
             d[i] = std::sqrt(dr*dr + dg*dg + db*db);
@@ -307,8 +307,8 @@ namespace icl::filter {
   static void apply_lookup_lines(const Img8u &src, Img8u &dst,
                                  const ColorSegmentationOp::LUT3D &lut) {
     ShiftedLUT3D_T<xShift,yShift,zShift> slut(lut);
-    visitROILinesNWith<3,1>(src, dst, [&](const icl8u *a, const icl8u *b, const icl8u *c,
-                                           icl8u *d, int w) {
+    visitROILinesNWithMT<3,1>(src, dst, [&](const icl8u *a, const icl8u *b, const icl8u *c,
+                                             icl8u *d, int w) {
       for(int i = 0; i < w; ++i) {
         d[i] = slut(a[i], b[i], c[i]);
       }
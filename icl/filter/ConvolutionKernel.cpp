@@ -6,6 +6,8 @@
 #include <icl/utils/Macros.h>
 #include <cmath>
 #include <algorithm>
+#include <cstdlib>
+#include <numeric>
 
 #ifdef WIN32
   #include <functional>
@@ -207,5 +209,51 @@ namespace icl::filter {
     }
   }
 
+  bool ConvolutionKernel::separate(std::vector<int> &col, std::vector<int> &row) const{
+    if(!idata) return false;
+    const int w = getWidth(), h = getHeight();
+    const int *pivot = std::max_element(idata, idata+getDim(), [](int a, int b){ return std::abs(a) < std::abs(b); });
+    if(!*pivot) return false;
+    const int py = static_cast<int>(pivot - idata) / w, px = static_cast<int>(pivot - idata) % w;
+
+    // the primitive (gcd-free) pivot row: every row of an integer rank-1
+    // kernel is an integer multiple of it
+    row.assign(idata + py*w, idata + (py+1)*w);
+    int g = 0;
+    for(int v : row) g = std::gcd(g, v);
+    for(int &v : row) v /= g;
+
+    col.resize(h);
+    for(int y=0;y<h;++y){
+      const int *k = idata + y*w;
+      if(k[px] % row[px]) return false;
+      col[y] = k[px] / row[px];
+      for(int x=0;x<w;++x){
+        if(k[x] != col[y] * row[x]) return false;
+      }
+    }
+    return true;
+  }
+
+  bool ConvolutionKernel::separate(std::vector<float> &col, std::vector<float> &row) const{
+    if(!fdata) return false;
+    const int w = getWidth(), h = getHeight();
+    const float *pivot = std::max_element(fdata, fdata+getDim(), [](float a, float b){ return std::fabs(a) < std::fabs(b); });
+    if(!*pivot) return false;
+    const int py = static_cast<int>(pivot - fdata) / w, px = static_cast<int>(pivot - fdata) % w;
+    const float eps = std::fabs(*pivot) * 1e-6f;
+
+    row.assign(fdata + py*w, fdata + (py+1)*w);
+    col.resize(h);
+    for(int y=0;y<h;++y){
+      const float *k = fdata + y*w;
+      col[y] = k[px] / *pivot;
+      for(int x=0;x<w;++x){
+        if(std::fabs(k[x] - col[y] * row[x]) > eps) return false;
+      }
+    }
+    return true;
+  }
+
 
   } // namespace icl::filter
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include <icl/utils/CompatMacros.h>
 #include <icl/utils/Size.h>
 #include <icl/utils/Exception.h>
+#include <vector>
 
 
 namespace icl::filter {
@@ -175,6 +176,18 @@ copies of shallow copied instances are shallow! */
     /// ensures shallow copied data is copied deeply
     void detach();
 
+    /// decomposes integer kernels of rank 1 into a column and a row vector
+    /** On success, kernel(x,y) == col[y] * row[x] holds exactly for all
+        kernel elements; the factor is not part of the decomposition. Returns
+        false for float kernels and for kernels that are not separable (such
+        as the laplace kernels) */
+    bool separate(std::vector<int> &col, std::vector<int> &row) const;
+
+    /// decomposes float kernels of rank 1 into a column and a row vector
+    /** kernel(x,y) == col[y] * row[x] holds up to float rounding errors.
+        Returns false for integer kernels and for non-separable kernels. */
+    bool separate(std::vector<float> &col, std::vector<float> &row) const;
+
   private:
     utils::Size size;    //!< associated size
     float *fdata; //!< float data pointer
@@ -132,7 +132,10 @@ namespace icl::filter {
       }
     }
 
-    getSelector<ConvSig>(Op::apply).resolve(src)->apply(src, dst, *this);
+    applyBands(getSelector<ConvSig>(Op::apply).resolve(src), dst,
+               [&](auto &impl, Image &band, int y0){
+                 impl.apply(shiftRows(src, y0), band, *this);
+               });
   }
 
   REGISTER_CONFIGURABLE_DEFAULT(ConvolutionOp);
@@ -2,6 +2,11 @@
 #include <icl/core/Img.h>
 #include <icl/core/Image.h>
 
+#include <algorithm>
+#include <vector>
+
+ICL_NO_FP_CONTRACT
+
 using namespace icl;
 using namespace icl::utils;
 using namespace icl::core;
@@ -56,9 +61,10 @@ namespace {
     if(factor != 1){
       for(int y=0;y<yEnd;++y){
         for(int x=0;x<xEnd;++x){
-          d[x] = ( s[x-dy-1]*m[0] + s[x-dy]*m[1] + s[x-dy+1]*m[2] +
+          d[x] = clipped_cast<KernelType, DstType>(
+                 ( s[x-dy-1]*m[0] + s[x-dy]*m[1] + s[x-dy+1]*m[2] +
                    s[x-1]*m[3] + s[x]*m[4] + s[x+1]*m[5] +
-                   s[x+dy-1]*m[6] + s[x+dy]*m[7] + s[x+dy+1]*m[8] ) / factor;
+                   s[x+dy-1]*m[6] + s[x+dy]*m[7] + s[x+dy+1]*m[8] ) / factor);
         }
         s+=src.getWidth();
         d+=dst.getWidth();
@@ -66,7 +72,8 @@ namespace {
     }else{
       for(int y=0;y<yEnd;++y){
         for(int x=0;x<xEnd;++x){
-          d[x] = ( s[x-dy-1]*m[0] + s[x-dy]*m[1] + s[x-dy+1]*m[2] +
+          d[x] = clipped_cast<KernelType, DstType>(
+                   s[x-dy-1]*m[0] + s[x-dy]*m[1] + s[x-dy+1]*m[2] +
                    s[x-1]*m[3] + s[x]*m[4] + s[x+1]*m[5] +
                    s[x+dy-1]*m[6] + s[x+dy]*m[7] + s[x+dy+1]*m[8] );
         }
@@ -76,13 +83,79 @@ namespace {
     }
   }
 
+  // ================================================================
+  // Separable (rank-1) convolution
+  // ================================================================
+
+  /// number of row pass results buffered per block (128KB for int/float):
+  /// the column pass reads them while they are still in the L2 cache
+  constexpr int SEPARABLE_BLOCK_SIZE = 1 << 15;
+
+  /// Two-pass convolution with kernel(x,y) = ky[y] * kx[x]
+  /** Rows of the destination ROI are processed in blocks: the horizontal
+      pass filters the maskH-1 + blockRows source rows of a block into a
+      buffer, the vertical pass then accumulates maskH buffered rows per
+      destination row. Integer kernels yield exactly the 2D result.
+      The per-pixel operation order (kx[0] first, then ky[0] first, without
+      fused multiply-adds) is also used by the Simd backend, so both
+      produce bitwise identical float results. */
+  template<class KernelType, class SrcType, class DstType>
+  void separable_cpp_convolution(const Img<SrcType> &src, Img<DstType> &dst,
+                                 const KernelType *kx, const KernelType *ky, COp &op, int c){
+    const int srcW = src.getWidth(), dstW = dst.getWidth();
+    const int roiW = dst.getROIWidth(), roiH = dst.getROIHeight();
+    const int maskW = op.getMaskSize().width, maskH = op.getMaskSize().height;
+    const Point anchor = op.getAnchor();
+    const Point roiOff = op.getROIOffset();
+    const int factor = op.getKernel().getFactor();
+    const SrcType *srcData = src.getData(c) + (roiOff.y - anchor.y) * srcW + (roiOff.x - anchor.x);
+    DstType *dstROI = dst.getROIData(c);
+    if(roiW <= 0 || roiH <= 0) return;
+
+    const int blockRows = std::clamp(SEPARABLE_BLOCK_SIZE / roiW - maskH + 1, 1, roiH);
+    std::vector<KernelType> rows((blockRows + maskH - 1) * roiW), acc(roiW);
+
+    for(int y0 = 0; y0 < roiH; y0 += blockRows){
+      const int n = std::min(blockRows, roiH - y0);
+      for(int j = 0; j < n + maskH - 1; ++j){
+        const SrcType *s = srcData + (y0 + j) * srcW;
+        KernelType *t = rows.data() + j * roiW;
+        for(int x = 0; x < roiW; ++x){
+          KernelType sum = 0;
+          for(int mx = 0; mx < maskW; ++mx){
+            const KernelType p = kx[mx] * (KernelType)s[x + mx];
+            sum += p;
+          }
+          t[x] = sum;
+        }
+      }
+      for(int y = 0; y < n; ++y){
+        std::fill(acc.begin(), acc.end(), KernelType(0));
+        for(int my = 0; my < maskH; ++my){
+          const KernelType *t = rows.data() + (y + my) * roiW;
+          for(int x = 0; x < roiW; ++x){
+            const KernelType p = ky[my] * t[x];
+            acc[x] += p;
+          }
+        }
+        DstType *d = dstROI + (y0 + y) * dstW;
+        for(int x = 0; x < roiW; ++x){
+          d[x] = clipped_cast<KernelType, DstType>(acc[x] / factor);
+        }
+      }
+    }
+  }
+
   // ================================================================
   // Generic convolute template — C++ fallback for all combos
   // ================================================================
 
   template<class KernelType, class SrcType, class DstType, filter::ConvolutionKernel::fixedType t>
   inline void convolute(const Img<SrcType> &src, Img<DstType> &dst,const KernelType *k, COp &op, int c){
-    if(op.getAnchor() == Point(1,1) && op.getMaskSize() == Size(3,3)){
+    std::vector<KernelType> ky, kx;
+    if(op.getKernel().separate(ky, kx)){
+      separable_cpp_convolution(src,dst,kx.data(),ky.data(),op,c);
+    }else if(op.getAnchor() == Point(1,1) && op.getMaskSize() == Size(3,3)){
       generic_cpp_convolution_3x3(src,dst,k,op,c);
     }else{
       generic_cpp_convolution(src,dst,k,op,c);
@@ -0,0 +1,276 @@
+#include <icl/core/ImageBackendDispatching.h>
+#include <icl/core/Img.h>
+#include <icl/core/Image.h>
+#include <icl/utils/SSETypes.h>
+#include <icl/filter/ConvolutionOp.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <type_traits>
+#include <vector>
+
+ICL_NO_FP_CONTRACT
+
+#ifdef ICL_HAVE_SSE2
+
+using namespace icl;
+using namespace icl::utils;
+using namespace icl::core;
+
+namespace {
+
+  using COp = filter::ConvolutionOp;
+  using Op = COp::Op;
+
+  /// row pass results buffered per block (see ConvolutionOp_Cpp.cpp)
+  constexpr int BLOCK_SIZE = 1 << 15;
+
+  /// integer sums below this bound are represented exactly in float lanes
+  constexpr float EXACT_FLOAT_INT = 16777216.f; // 2^24
+
+  // ================================================================
+  // Vectorized row primitives (4 x float)
+  // ================================================================
+
+  /// d[x] += k * s[x]; multiply and add are kept separate (no FMA), which
+  /// matches the operation order of the C++ backend's separable path
+  inline void madd_row(float *d, const float *s, float k, int n){
+    const icl32fx4 vk(k);
+    int x = 0;
+    for(; x <= n - 4; x += 4){
+      icl32fx4 a(d + x);
+      a += icl32fx4(s + x) * vk;
+      a.storeu(d + x);
+    }
+    for(; x < n; ++x){
+      const float p = k * s[x];
+      d[x] += p;
+    }
+  }
+
+  template<class SrcType>
+  inline void load_row(const SrcType *s, float *d, int n){
+    for(int x = 0; x < n; ++x) d[x] = static_cast<float>(s[x]);
+  }
+
+  template<>
+  inline void load_row(const icl8u *s, float *d, int n){
+    const __m128i z = _mm_setzero_si128();
+    int x = 0;
+    for(; x <= n - 8; x += 8){
+      const __m128i v = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(s + x)), z);
+      _mm_storeu_ps(d + x, _mm_cvtepi32_ps(_mm_unpacklo_epi16(v, z)));
+      _mm_storeu_ps(d + x + 4, _mm_cvtepi32_ps(_mm_unpackhi_epi16(v, z)));
+    }
+    for(; x < n; ++x) d[x] = s[x];
+  }
+
+  template<>
+  inline void load_row(const icl16s *s, float *d, int n){
+    int x = 0;
+    for(; x <= n - 8; x += 8){
+      const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + x));
+      _mm_storeu_ps(d + x, _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16)));
+      _mm_storeu_ps(d + x + 4, _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16)));
+    }
+    for(; x < n; ++x) d[x] = s[x];
+  }
+
+  template<>
+  inline void load_row(const icl32f *s, float *d, int n){
+    std::copy(s, s + n, d);
+  }
+
+  // ================================================================
+  // Output conversion
+  // ================================================================
+
+  /// float kernels: d = clipped_cast(acc / factor), as in the C++ backend
+  template<class DstType>
+  inline void store_float_row(const float *acc, DstType *d, int factor, int n){
+    for(int x = 0; x < n; ++x) d[x] = clipped_cast<float, DstType>(acc[x] / factor);
+  }
+
+  /// integer kernels: acc holds exact integer sums; truncating the float
+  /// quotient equals the integer division for |acc| < 2^24
+  template<class DstType>
+  inline void store_int_row(const float *acc, DstType *d, float factor, int n){
+    for(int x = 0; x < n; ++x) d[x] = clipped_cast<int, DstType>(static_cast<int>(acc[x] / factor));
+  }
+
+  inline __m128i truncated_quotients(const float *acc, __m128 f){
+    return _mm_cvttps_epi32(_mm_div_ps(_mm_loadu_ps(acc), f));
+  }
+
+  template<>
+  inline void store_int_row(const float *acc, icl16s *d, float factor, int n){
+    const __m128 f = _mm_set1_ps(factor);
+    int x = 0;
+    for(; x <= n - 8; x += 8){
+      const __m128i v = _mm_packs_epi32(truncated_quotients(acc + x, f), truncated_quotients(acc + x + 4, f));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(d + x), v);
+    }
+    for(; x < n; ++x) d[x] = clipped_cast<int, icl16s>(static_cast<int>(acc[x] / factor));
+  }
+
+  template<>
+  inline void store_int_row(const float *acc, icl8u *d, float factor, int n){
+    const __m128 f = _mm_set1_ps(factor);
+    int x = 0;
+    for(; x <= n - 8; x += 8){
+      const __m128i v = _mm_packs_epi32(truncated_quotients(acc + x, f), truncated_quotients(acc + x + 4, f));
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(d + x), _mm_packus_epi16(v, v));
+    }
+    for(; x < n; ++x) d[x] = clipped_cast<int, icl8u>(static_cast<int>(acc[x] / factor));
+  }
+
+  // ================================================================
+  // Blocked convolution engine
+  // ================================================================
+
+  /// Convolves one channel; all arithmetic is done in float lanes
+  /** If kx/ky are given, the kernel is applied as two 1D passes, otherwise
+      k holds the full 2D kernel. Source rows of a block are converted to
+      float once, so the tap loops only operate on float vectors. */
+  template<class SrcType, class DstType, class Store>
+  void simd_convolute(const Img<SrcType> &src, Img<DstType> &dst, COp &op, int c,
+                      const float *k, const float *kx, const float *ky, Store store){
+    const int srcW = src.getWidth(), dstW = dst.getWidth();
+    const int roiW = dst.getROIWidth(), roiH = dst.getROIHeight();
+    const int maskW = op.getMaskSize().width, maskH = op.getMaskSize().height;
+    const Point anchor = op.getAnchor();
+    const Point roiOff = op.getROIOffset();
+    const SrcType *srcData = src.getData(c) + (roiOff.y - anchor.y) * srcW + (roiOff.x - anchor.x);
+    DstType *dstROI = dst.getROIData(c);
+    if(roiW <= 0 || roiH <= 0) return;
+
+    const int inW = roiW + maskW - 1;
+    const int blockRows = std::clamp(BLOCK_SIZE / roiW - maskH + 1, 1, roiH);
+    std::vector<float> in((blockRows + maskH - 1) * inW), acc(roiW);
+    std::vector<float> rows(kx ? (blockRows + maskH - 1) * roiW : 0);
+
+    for(int y0 = 0; y0 < roiH; y0 += blockRows){
+      const int n = std::min(blockRows, roiH - y0);
+      for(int j = 0; j < n + maskH - 1; ++j){
+        load_row(srcData + (y0 + j) * srcW, in.data() + j * inW, inW);
+      }
+      if(kx){
+        std::fill(rows.begin(), rows.end(), 0.f);
+        for(int j = 0; j < n + maskH - 1; ++j){
+          for(int mx = 0; mx < maskW; ++mx){
+            madd_row(rows.data() + j * roiW, in.data() + j * inW + mx, kx[mx], roiW);
+          }
+        }
+      }
+      for(int y = 0; y < n; ++y){
+        std::fill(acc.begin(), acc.end(), 0.f);
+        if(kx){
+          for(int my = 0; my < maskH; ++my){
+            madd_row(acc.data(), rows.data() + (y + my) * roiW, ky[my], roiW);
+          }
+        }else{
+          for(int my = 0; my < maskH; ++my){
+            for(int mx = 0; mx < maskW; ++mx){
+              madd_row(acc.data(), in.data() + (y + my) * inW + mx, k[my * maskW + mx], roiW);
+            }
+          }
+        }
+        store(acc.data(), dstROI + (y0 + y) * dstW, roiW);
+      }
+    }
+  }
+
+  /// Integer kernels on 8u/16s: sums are computed exactly in float lanes
+  /** Returns false if the largest possible intermediate sum could exceed
+      2^24, in which case the C++ backend has to be used. */
+  template<class SrcType, class DstType>
+  bool simd_convolution_int(const Img<SrcType> &src, Img<DstType> &dst, COp &op){
+    const filter::ConvolutionKernel &kernel = op.getKernel();
+    const int factor = kernel.getFactor();
+    if(factor <= 0) return false;
+
+    std::vector<int> icol, irow;
+    const bool separable = kernel.separate(icol, irow);
+    const int *ik = kernel.getIntData();
+    float bound = 0;
+    if(separable){
+      float sx = 0, sy = 0;
+      for(int v : irow) sx += std::abs(v);
+      for(int v : icol) sy += std::abs(v);
+      bound = sx * sy;
+    }else{
+      for(int i = 0; i < kernel.getDim(); ++i) bound += std::abs(ik[i]);
+    }
+    const float maxSrc = std::is_same_v<SrcType, icl8u> ? 255.f : 32768.f;
+    if(bound * maxSrc >= EXACT_FLOAT_INT) return false;
+
+    std::vector<float> k(ik, ik + kernel.getDim()), kx(irow.begin(), irow.end()), ky(icol.begin(), icol.end());
+    const float f = static_cast<float>(factor);
+    auto store = [f](const float *acc, DstType *d, int n){ store_int_row(acc, d, f, n); };
+    for(int c = src.getChannels() - 1; c >= 0; --c){
+      simd_convolute(src, dst, op, c, k.data(), separable ? kx.data() : nullptr, ky.data(), store);
+    }
+    return true;
+  }
+
+  /// Separable float kernels on 32f (bitwise equal to the C++ backend)
+  template<class DstType>
+  bool simd_convolution_float(const Img32f &src, Img<DstType> &dst, COp &op){
+    std::vector<float> ky, kx;
+    if(!op.getKernel().separate(ky, kx)) return false;
+    const int factor = op.getKernel().getFactor();
+    auto store = [factor](const float *acc, DstType *d, int n){ store_float_row(acc, d, factor, n); };
+    for(int c = src.getChannels() - 1; c >= 0; --c){
+      simd_convolute(src, dst, op, c, nullptr, kx.data(), ky.data(), store);
+    }
+    return true;
+  }
+
+  template<class SrcType>
+  bool simd_convolution_s(const Img<SrcType> &src, ImgBase &dst, COp &op){
+    switch(dst.getDepth()){
+#define ICL_INSTANTIATE_DEPTH(D)                                        \
+      case depth##D:                                                    \
+        if constexpr(std::is_same_v<SrcType, icl32f>){                  \
+          return simd_convolution_float(src, *dst.asImg<icl##D>(), op); \
+        }else{                                                          \
+          return simd_convolution_int(src, *dst.asImg<icl##D>(), op);   \
+        }
+      ICL_INSTANTIATE_ALL_DEPTHS;
+#undef ICL_INSTANTIATE_DEPTH
+      default: return false;
+    }
+  }
+
+  // ================================================================
+  // SIMD backend entry point
+  // ================================================================
+
+  void simd_convolution(const Image &src, Image &dst, COp &op) {
+    const bool isFloat = op.getKernel().isFloat();
+    bool done = false;
+    switch(src.getDepth()){
+      case depth8u: done = !isFloat && simd_convolution_s(src.as8u(), *dst.ptr(), op); break;
+      case depth16s: done = !isFloat && simd_convolution_s(src.as16s(), *dst.ptr(), op); break;
+      case depth32f: done = isFloat && simd_convolution_s(src.as32f(), *dst.ptr(), op); break;
+      default: break;
+    }
+    if(done) return;
+
+    // non-separable float kernels and sums exceeding the exact float range
+    auto* cpp = COp::prototype()
+        .template getSelector<COp::ConvSig>(Op::apply)
+        .get(Backend::Cpp);
+    cpp->apply(src, dst, op);
+  }
+
+  static int _reg = [] {
+    auto simd = COp::prototype().backends(Backend::Simd);
+    simd.add<COp::ConvSig>(Op::apply, simd_convolution,
+      applicableTo<icl8u, icl16s, icl32f>, "SSE2/NEON separable convolution");
+    return 0;
+  }();
+
+} // anonymous namespace
+
+#endif // ICL_HAVE_SSE2
@@ -6,6 +6,7 @@
 #include <icl/utils/Point.h>
 #include <icl/utils/ConfigFile.h>
 #include <icl/utils/XML.h>
+#include <icl/utils/ThreadPool.h>
 #include <fstream>
 
 using namespace icl::utils;
@@ -251,15 +252,20 @@ namespace icl::filter {
     if(impl->params != impl->warpMapParams){
       impl->warpMapParams = impl->params;
 
-      Channel32f cs[2] = { impl->warpMap[0], impl->warpMap[1] };
+      // row-major, rows are independent (undistort() is const)
       const Size size = getImageSize();
-      for(int xi=0;xi<size.width;++xi){
-        for(int yi=0;yi<size.height; ++yi){
-          Point32f p = impl->undistort(Point32f(xi,yi));
-          cs[0](xi,yi) = p.x;
-          cs[1](xi,yi) = p.y;
+      const Impl &model = *impl;
+      icl32f *xs = impl->warpMap.getData(0), *ys = impl->warpMap.getData(1);
+      ThreadPool::global().parallelFor(0, size.height, 8, [&](int y0, int y1){
+        for(int yi=y0;yi<y1;++yi){
+          icl32f *xr = xs + yi*size.width, *yr = ys + yi*size.width;
+          for(int xi=0;xi<size.width;++xi){
+            const Point32f p = model.undistort(Point32f(xi,yi));
+            xr[xi] = p.x;
+            yr[xi] = p.y;
+          }
         }
-      }
+      });
     }
     return impl->warpMap;
   }
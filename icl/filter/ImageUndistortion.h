@@ -44,6 +44,7 @@ namespace icl::filter {
     const std::string &getModel() const;
     const utils::Point32f operator()(const utils::Point32f &distortedPos) const;
     void setParams(const std::vector<double> &params);
+    /// returns the warp map for WarpOp (recomputed, rows in parallel, if the parameters have changed)
     const core::Img32f &createWarpMap() const;
 
     inline bool isNull() const { return !impl; }
@@ -50,7 +50,7 @@ using namespace icl::core;
 namespace icl::filter {
   LocalThresholdOp::LocalThresholdOp(unsigned int maskSize, float globalThreshold, float gammaSlope):
     m_roiBufSrc(0), m_roiBufDst(0),
-    m_iiOp(new IntegralImgOp),
+    m_iiOp(new IntegralImgOp), m_iiBuf(0),
     m_cmp(new BinaryCompareOp(BinaryCompareOp::gt)),
     m_tiledBuf1(0),m_tiledBuf2(0){
 
@@ -71,7 +71,7 @@ namespace icl::filter {
 
   LocalThresholdOp::LocalThresholdOp(LocalThresholdOp::algorithm a, int maskSize, float globalThreshold, float gammaSlope):
     m_roiBufSrc(0), m_roiBufDst(0),
-    m_iiOp(new IntegralImgOp),
+    m_iiOp(new IntegralImgOp), m_iiBuf(0),
     m_cmp(new BinaryCompareOp(BinaryCompareOp::gt)),
     m_tiledBuf1(0),m_tiledBuf2(0){
 
@@ -88,6 +88,7 @@ namespace icl::filter {
 
     ICL_DELETE(m_roiBufDst);
     ICL_DELETE(m_iiOp);
+    ICL_DELETE(m_iiBuf);
     ICL_DELETE(m_cmp);
     ICL_DELETE(m_tiledBuf1);
     ICL_DELETE(m_tiledBuf2);
@@ -524,9 +525,8 @@ namespace icl::filter {
   template<> void LocalThresholdOp::apply_a<LocalThresholdOp::regionMean>(const ImgBase *src, ImgBase **dst){
 
     m_iiOp->setIntegralImageDepth((src->getDepth() == depth8u || src->getDepth() == depth16s) ? depth32s : src->getDepth());
-    static ImgBase *iiBuf = nullptr;
-    m_iiOp->apply(src, &iiBuf);
-    const ImgBase *ii = iiBuf;
+    m_iiOp->apply(src, &m_iiBuf);
+    const ImgBase *ii = m_iiBuf;
 
     float t = getGlobalThreshold();
     int s = getMaskSize();
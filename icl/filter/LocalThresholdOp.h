@@ -225,6 +225,9 @@ namespace icl::filter {
     /// IntegralImgOp for RegionMean algorithm
     IntegralImgOp *m_iiOp;
 
+    /// integral image buffer for RegionMean algorithm
+    core::ImgBase *m_iiBuf;
+
     /// currently used algorithm
     /// property algorithm m_algorithm;
 
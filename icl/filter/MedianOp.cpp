@@ -46,11 +46,15 @@ namespace icl::filter {
     if (!prepare(dst, src)) return;
     const Size &ms = getMaskSize();
     if (ms == Size(3,3) || ms == Size(5,5)) {
-      getSelector<MedianFixedSig>(Op::fixed).resolve(src)->apply(
-        src, dst, ms.width, getROIOffset());
+      applyBands(getSelector<MedianFixedSig>(Op::fixed).resolve(src), dst,
+                 [&](auto &impl, Image &band, int y0){
+                   impl.apply(shiftRows(src, y0), band, ms.width, getROIOffset());
+                 });
     } else {
-      getSelector<MedianGenericSig>(Op::generic).resolve(src)->apply(
-        src, dst, ms, getROIOffset(), getAnchor());
+      applyBands(getSelector<MedianGenericSig>(Op::generic).resolve(src), dst,
+                 [&](auto &impl, Image &band, int y0){
+                   impl.apply(shiftRows(src, y0), band, ms, getROIOffset(), getAnchor());
+                 });
     }
   }
 
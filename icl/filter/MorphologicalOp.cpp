@@ -111,13 +111,18 @@ namespace icl::filter {
       NeighborhoodOp::setMask(maskSize);
     }
 
-    ICL_DELETE_ARRAY(m_pcMask);
-    m_pcMask = new icl8u[maskSize.getDim()];
+    // pcMask may be the current mask (e.g. when called from setOptype), so
+    // it is copied before the old mask is released; if the current mask is
+    // passed with a new size, its data does not fit and is reset
+    if(pcMask == m_pcMask && maskSize != m_oMaskSizeMorphOp) pcMask = 0;
+    icl8u *mask = new icl8u[maskSize.getDim()];
     if(pcMask){
-      std::copy(pcMask,pcMask+maskSize.getDim(),m_pcMask);
+      std::copy(pcMask,pcMask+maskSize.getDim(),mask);
     }else{
-      std::fill(m_pcMask,m_pcMask+maskSize.getDim(),255);
+      std::fill(mask,mask+maskSize.getDim(),255);
     }
+    ICL_DELETE_ARRAY(m_pcMask);
+    m_pcMask = mask;
 
     m_oMaskSizeMorphOp = maskSize;
     ++m_maskVersion;
@@ -139,7 +144,16 @@ namespace icl::filter {
 
   void MorphologicalOp::apply(const core::Image &src, core::Image &dst) {
     if(!prepare(dst, src)) return;
-    getSelector<MorphSig>(Op::apply).resolve(src)->apply(src, dst, *this);
+    auto *impl = getSelector<MorphSig>(Op::apply).resolve(src);
+    // composite and 3x3 optypes use intermediate buffers or temporarily
+    // change the mask, so only plain dilation/erosion is split into bands
+    if(m_eType != dilate && m_eType != erode){
+      impl->apply(src, dst, *this);
+      return;
+    }
+    applyBands(impl, dst, [&](auto &bandImpl, Image &band, int y0){
+      bandImpl.apply(shiftRows(src, y0), band, *this);
+    });
   }
 
   REGISTER_CONFIGURABLE(MorphologicalOp,
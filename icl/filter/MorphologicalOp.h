@@ -40,8 +40,7 @@ namespace icl::filter {
       -# <b>erosion</b>: destination image pixel becomes the the minimum
          pixel of all pixels within mask
       -# <b>erosion3x3 and dilatation3x3</b>: this is just a shortcut
-         for using a 3x3 mask where all entries are set to 1. IPP obviously
-         does a lot of optimizations here, fallback doesn't
+         for using a 3x3 mask where all entries are set to 1
       -# <b>dilate/erode border replicate</b>: as standard operation, except
          copying border pixels from closes valid computed pixels (not tested
          well in fallback case)
@@ -51,6 +50,27 @@ namespace icl::filter {
       -# <b>blackhat</b> closing result - source image
       -# <b>gradient</b> closing result - opened result
 
+      \section IMPL C++ Implementation
+      The C++ backend selects the algorithm by the mask, so the composite
+      operations, which use dilation and erosion internally, benefit as
+      well:
+      - <b>rectangular masks</b> (all entries set) are separated into a
+        row and a column pass. The rows use a running minimum/maximum
+        that is computed by doubling the window length (log2(w)+1 SIMD
+        passes), the columns use the van Herk/Gil-Werman algorithm
+        (3 comparisons per pixel independent of the mask height)
+      - <b>other masks</b> (e.g. disks or diamonds) are decomposed into
+        horizontal line segments; the running extrema of all segment
+        lengths are computed once per row, so each pixel needs one
+        comparison per segment. Masks with many short segments are
+        evaluated directly
+      - <b>binary images</b> (depth8u images that contain only two
+        values) with non-rectangular masks are processed bit-packed,
+        64 pixels per operation
+
+      On a single core, a 15x15 dilation of a 1920x1080 gray image takes
+      about 1ms (direct evaluation: 360ms).
+
       \section EX Examples
       As a useful help, some example images are shown here:
 
@@ -1,10 +1,15 @@
 #include <icl/filter/MorphologicalOp.h>
 #include <icl/core/Img.h>
-#include <icl/utils/Range.h>
 #include <icl/core/ImgBorder.h>
 #include <icl/filter/BinaryArithmeticalOp.h>
 #include <icl/core/Image.h>
-#include <functional>
+#include <icl/utils/SSETypes.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
 
 using namespace icl;
 using namespace icl::utils;
@@ -15,38 +20,413 @@ namespace {
   using MOp = filter::MorphologicalOp;
 
   // ================================================================
-  // C++ morphological kernel
+  // Extremum functors for gray values, SSE2 vectors and bit sets
+  // ================================================================
+
+  struct MaxOp{
+    template<class T> static T apply(T a, T b){ return b > a ? b : a; }
+    static std::uint64_t bits(std::uint64_t a, std::uint64_t b){ return a | b; }
+    static constexpr std::uint64_t BITS_INIT = 0;
+#ifdef ICL_HAVE_SSE2
+    static __m128i apply(__m128i a, __m128i b){ return _mm_max_epu8(a, b); }
+    static __m128 apply(__m128 a, __m128 b){ return _mm_max_ps(b, a); }
+#endif
+  };
+
+  struct MinOp{
+    template<class T> static T apply(T a, T b){ return b < a ? b : a; }
+    static std::uint64_t bits(std::uint64_t a, std::uint64_t b){ return a & b; }
+    static constexpr std::uint64_t BITS_INIT = ~std::uint64_t(0);
+#ifdef ICL_HAVE_SSE2
+    static __m128i apply(__m128i a, __m128i b){ return _mm_min_epu8(a, b); }
+    static __m128 apply(__m128 a, __m128 b){ return _mm_min_ps(b, a); }
+#endif
+  };
+
+  // ================================================================
+  // Row primitives (d may be equal to a or b)
+  // ================================================================
+
+  /// d[x] = ext(a[x], b[x]) for x in [0,n)
+  template<class E, class T>
+  inline void ext_rows(T *d, const T *a, const T *b, int n){
+    for(int x = 0; x < n; ++x) d[x] = E::apply(a[x], b[x]);
+  }
+
+#ifdef ICL_HAVE_SSE2
+  template<class E>
+  inline void ext_rows(icl8u *d, const icl8u *a, const icl8u *b, int n){
+    int x = 0;
+    for(; x <= n - 16; x += 16){
+      const __m128i r = E::apply(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + x)),
+                                 _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + x)));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(d + x), r);
+    }
+    for(; x < n; ++x) d[x] = E::apply(a[x], b[x]);
+  }
+
+  template<class E>
+  inline void ext_rows(icl32f *d, const icl32f *a, const icl32f *b, int n){
+    int x = 0;
+    for(; x <= n - 4; x += 4){
+      _mm_storeu_ps(d + x, E::apply(_mm_loadu_ps(a + x), _mm_loadu_ps(b + x)));
+    }
+    for(; x < n; ++x) d[x] = E::apply(a[x], b[x]);
+  }
+#endif
+
+  /// running extrema of several lengths along one row of w values
+  /** outs[i][x] = ext(s[x], ..., s[x+lens[i]-1]) for x in [0, w-lens[i]+1),
+      lens must be ascending. The extrema are computed by doubling
+      (t_2k[x] = ext(t_k[x], t_k[x+k])), which needs log2(len)+1
+      vectorizable passes over the row rather than len comparisons per
+      value. The levels are shared between all lengths; tmp must
+      provide w values. */
+  template<class E, class T>
+  void running_ext(const T *s, int w, const int *lens, int nLens, T *const *outs, T *tmp){
+    const T *t = s;
+    int k = 1;
+    for(int i = 0; i < nLens; ++i){
+      const int len = lens[i];
+      for(; 2 * k <= len; k *= 2){
+        ext_rows<E>(tmp, t, t + k, w - 2 * k + 1);
+        t = tmp;
+      }
+      ext_rows<E>(outs[i], t, t + (len - k), w - len + 1);
+    }
+  }
+
+  // ================================================================
+  // Mask analysis
+  // ================================================================
+
+  /// decomposition of the mask into horizontal line segments
+  struct MaskSegments{
+    struct Segment{
+      int dx, dy, len;
+      int lenIndex;              //!< index into lengths
+    };
+    std::vector<Segment> segments;
+    std::vector<int> lengths;    //!< distinct segment lengths (ascending)
+    int count = 0;               //!< number of mask entries != 0
+    bool rect = true;            //!< all mask entries are != 0
+
+    MaskSegments(const icl8u *mask, const Size &size){
+      for(int y = 0; y < size.height; ++y){
+        const icl8u *m = mask + y * size.width;
+        for(int x = 0; x < size.width;){
+          if(!m[x]){ rect = false; ++x; continue; }
+          const int x0 = x;
+          while(x < size.width && m[x]) ++x;
+          segments.push_back({x0, y, x - x0, 0});
+          lengths.push_back(x - x0);
+          count += x - x0;
+        }
+      }
+      std::sort(lengths.begin(), lengths.end());
+      lengths.erase(std::unique(lengths.begin(), lengths.end()), lengths.end());
+      for(auto &s : segments){
+        s.lenIndex = std::lower_bound(lengths.begin(), lengths.end(), s.len) - lengths.begin();
+      }
+    }
+  };
+
+  /// geometry of one channel: the source region s (w+mw-1 x h+mh-1) is mapped to the dst ROI d (w x h)
+  template<class T>
+  struct MorphGeom{
+    const T *s;
+    int srcStep;
+    T *d;
+    int dstStep;
+    int w, h, mw, mh;
+  };
+
+  // ================================================================
+  // Gray value kernels
   // ================================================================
 
-  template<class T, typename cmp_func>
-  void morph_cpp(const Img<T> &src, Img<T> &dst, MOp &op,
-                 T init, cmp_func cmp, const icl8u *mask){
-    const int srcW = src.getWidth(), dstW = dst.getWidth();
-    const int roiW = dst.getROIWidth(), roiH = dst.getROIHeight();
-    const int maskW = op.getMaskSize().width, maskH = op.getMaskSize().height;
+  /// evaluates every mask entry at every pixel (for masks that do not decompose well)
+  template<class E, class T>
+  void morph_direct(const MorphGeom<T> &g, const icl8u *mask){
+    // lowest() rather than min(), which is the smallest positive value for floats
+    const T init = std::is_same_v<E, MaxOp> ? std::numeric_limits<T>::lowest() : std::numeric_limits<T>::max();
+    for(int y = 0; y < g.h; ++y){
+      T *dstRow = g.d + y * g.dstStep;
+      for(int x = 0; x < g.w; ++x){
+        const icl8u *m = mask;
+        T best = init;
+        for(int my = 0; my < g.mh; ++my){
+          const T *row = g.s + (y + my) * g.srcStep + x;
+          for(int mx = 0; mx < g.mw; ++mx, ++m){
+            if(*m) best = E::apply(best, row[mx]);
+          }
+        }
+        dstRow[x] = best;
+      }
+    }
+  }
+
+  /// rectangular masks: row pass by doubling, column pass by van Herk/Gil-Werman
+  /** The column pass splits the rows into blocks of mh rows. The
+      window of output row b+j (block start b) is the suffix extremum of
+      rows b+j..b+mh-1 combined with the prefix extremum of rows
+      b+mh..b+mh+j-1, so each pixel needs 3 comparisons, independent of
+      the mask height. */
+  template<class E, class T>
+  void morph_rect(const MorphGeom<T> &g){
+    const int wr = g.w + g.mw - 1, nr = g.h + g.mh - 1;
+    std::vector<T> tmp(wr);
+    if(g.mh == 1){
+      for(int y = 0; y < g.h; ++y){
+        T *out = g.d + y * g.dstStep;
+        running_ext<E>(g.s + y * g.srcStep, wr, &g.mw, 1, &out, tmp.data());
+      }
+      return;
+    }
+
+    std::vector<const T*> rows(nr);
+    std::vector<T> rowBuf;
+    if(g.mw == 1){
+      for(int r = 0; r < nr; ++r) rows[r] = g.s + r * g.srcStep;
+    }else{
+      rowBuf.resize(static_cast<std::size_t>(nr) * g.w);
+      for(int r = 0; r < nr; ++r){
+        T *out = rowBuf.data() + static_cast<std::size_t>(r) * g.w;
+        running_ext<E>(g.s + r * g.srcStep, wr, &g.mw, 1, &out, tmp.data());
+        rows[r] = out;
+      }
+    }
+
+    const int n = g.w, k = g.mh;
+    std::vector<T> prefix(n);
+    for(int b = 0; b < g.h; b += k){
+      // suffix extrema, written to the output rows (tmp for rows beyond the ROI)
+      const T *suffix = rows[b + k - 1];
+      for(int i = k - 1; i >= 0; --i){
+        T *out = b + i < g.h ? g.d + (b + i) * g.dstStep : tmp.data();
+        if(i == k - 1) std::copy(suffix, suffix + n, out);
+        else ext_rows<E>(out, rows[b + i], suffix, n);
+        suffix = out;
+      }
+      // combination with the prefix extrema of the next block
+      for(int j = 1; j < k && b + j < g.h; ++j){
+        const T *r = rows[b + k + j - 1];
+        if(j == 1) std::copy(r, r + n, prefix.data());
+        else ext_rows<E>(prefix.data(), prefix.data(), r, n);
+        T *out = g.d + (b + j) * g.dstStep;
+        ext_rows<E>(out, out, prefix.data(), n);
+      }
+    }
+  }
+
+  /// other masks: extremum of the running row extrema of all mask segments
+  /** The running extrema are computed once per source row and segment
+      length for blocks of output rows, so each pixel needs one
+      comparison per segment (e.g. 15 for a disk of diameter 15, instead
+      of 177 for the direct evaluation). */
+  template<class E, class T>
+  void morph_segments(const MorphGeom<T> &g, const MaskSegments &ms){
+    const int wr = g.w + g.mw - 1;
+    const int block = std::max(32, 2 * g.mh);
+    const int blockRows = block + g.mh - 1;
+    const int nLens = static_cast<int>(ms.lengths.size());
+    std::vector<T> tmp(wr), buf(static_cast<std::size_t>(nLens) * blockRows * wr);
+    std::vector<T*> outs(nLens);
+    auto hrow = [&](int lenIndex, int r){
+      return buf.data() + (static_cast<std::size_t>(lenIndex) * blockRows + r) * wr;
+    };
+
+    for(int y0 = 0; y0 < g.h; y0 += block){
+      const int b = std::min(block, g.h - y0);
+      for(int r = 0; r < b + g.mh - 1; ++r){
+        for(int i = 0; i < nLens; ++i) outs[i] = hrow(i, r);
+        running_ext<E>(g.s + (y0 + r) * g.srcStep, wr, ms.lengths.data(), nLens,
+                       outs.data(), tmp.data());
+      }
+      for(int y = 0; y < b; ++y){
+        T *out = g.d + (y0 + y) * g.dstStep;
+        bool first = true;
+        for(const auto &seg : ms.segments){
+          const T *h = hrow(seg.lenIndex, y + seg.dy) + seg.dx;
+          if(first) std::copy(h, h + g.w, out);
+          else ext_rows<E>(out, out, h, g.w);
+          first = false;
+        }
+      }
+    }
+  }
+
+  // ================================================================
+  // Bit-packed kernel for binary 8u images
+  // ================================================================
+
+  /// checks whether the region only contains the values lo and hi (lo <= hi)
+  bool is_binary(const icl8u *s, int step, int w, int h, icl8u &lo, icl8u &hi){
+    lo = hi = s[0];
+    bool haveHi = false;
+    auto accept = [&](icl8u v){
+      if(v == lo || v == hi) return true;
+      if(haveHi) return false;
+      hi = v;
+      haveHi = true;
+      return true;
+    };
+    for(int y = 0; y < h; ++y){
+      const icl8u *row = s + y * step;
+      int x = 0;
+#ifdef ICL_HAVE_SSE2
+      for(; x <= w - 16; x += 16){
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x));
+        const __m128i eq = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(static_cast<char>(lo))),
+                                        _mm_cmpeq_epi8(v, _mm_set1_epi8(static_cast<char>(hi))));
+        if(_mm_movemask_epi8(eq) == 0xffff) continue;
+        for(int i = 0; i < 16; ++i){
+          if(!accept(row[x + i])) return false;
+        }
+      }
+#endif
+      for(; x < w; ++x){
+        if(!accept(row[x])) return false;
+      }
+    }
+    if(hi < lo) std::swap(lo, hi);
+    return true;
+  }
+
+  /// bit x%64 of d[x/64] becomes s[x] == hi
+  void pack_row(const icl8u *s, int w, icl8u hi, std::uint64_t *d){
+    int x = 0;
+#ifdef ICL_HAVE_SSE2
+    const __m128i vhi = _mm_set1_epi8(static_cast<char>(hi));
+    for(; x <= w - 64; x += 64){
+      std::uint64_t m = 0;
+      for(int i = 0; i < 4; ++i){
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + x + 16 * i));
+        m |= static_cast<std::uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, vhi))) << (16 * i);
+      }
+      d[x / 64] = m;
+    }
+#endif
+    for(; x < w; ++x){
+      if(x % 64 == 0) d[x / 64] = 0;
+      d[x / 64] |= static_cast<std::uint64_t>(s[x] == hi) << (x % 64);
+    }
+  }
+
+  /// d[x] = bit x of b ? hi : lo
+  void unpack_row(const std::uint64_t *b, int w, icl8u lo, icl8u hi, icl8u *d){
+    int x = 0;
+#ifdef ICL_HAVE_SSE2
+    const __m128i bit = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+    const __m128i vlo = _mm_set1_epi8(static_cast<char>(lo));
+    const __m128i vdiff = _mm_set1_epi8(static_cast<char>(lo ^ hi));
+    for(; x <= w - 16; x += 16){
+      // spread the 16 bits to the bytes: bits 0-7 to bytes 0-7, bits 8-15 to bytes 8-15
+      __m128i v = _mm_cvtsi32_si128(static_cast<int>((b[x / 64] >> (x % 64)) & 0xffff));
+      v = _mm_unpacklo_epi8(v, v);
+      v = _mm_unpacklo_epi16(v, v);
+      v = _mm_unpacklo_epi32(v, v);
+      const __m128i set = _mm_cmpeq_epi8(_mm_and_si128(v, bit), bit);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(d + x),
+                       _mm_xor_si128(vlo, _mm_and_si128(set, vdiff)));
+    }
+#endif
+    for(; x < w; ++x) d[x] = ((b[x / 64] >> (x % 64)) & 1) ? hi : lo;
+  }
+
+  /// d[i] = ext(a[i], bits [64i+shift, 64i+shift+64) of b) for n words
+  template<class E>
+  inline void ext_bits(std::uint64_t *d, const std::uint64_t *a, const std::uint64_t *b,
+                       int shift, int n){
+    b += shift / 64;
+    const int o = shift % 64;
+    if(!o){
+      for(int i = 0; i < n; ++i) d[i] = E::bits(a[i], b[i]);
+    }else{
+      for(int i = 0; i < n; ++i) d[i] = E::bits(a[i], (b[i] >> o) | (b[i + 1] << (64 - o)));
+    }
+  }
+
+  /// images that contain only two values: max and min become bitwise or and and
+  /** The source rows are packed into 64 bit words, the mask segments are
+      processed as in morph_segments, but on 64 pixels per operation. */
+  template<class E>
+  void morph_binary(const MorphGeom<icl8u> &g, const MaskSegments &ms, icl8u lo, icl8u hi){
+    const int wr = g.w + g.mw - 1, nr = g.h + g.mh - 1;
+    const int nw = (wr + 63) / 64;
+    // padding for reading shifted words behind the last used word
+    const int step = nw + (g.mw + 63) / 64 + 2;
+    const int nLens = static_cast<int>(ms.lengths.size());
+    std::vector<std::uint64_t> packed(static_cast<std::size_t>(nr) * step, 0);
+    std::vector<std::uint64_t> runs(static_cast<std::size_t>(nLens) * nr * step, 0);
+    std::vector<std::uint64_t> tmp(step, 0), acc(step, 0);
+    auto hrow = [&](int lenIndex, int r){
+      return runs.data() + (static_cast<std::size_t>(lenIndex) * nr + r) * step;
+    };
+
+    for(int r = 0; r < nr; ++r){
+      std::uint64_t *src = packed.data() + static_cast<std::size_t>(r) * step;
+      pack_row(g.s + r * g.srcStep, wr, hi, src);
+      // running extrema by doubling (see running_ext)
+      const std::uint64_t *t = src;
+      int k = 1;
+      for(int i = 0; i < nLens; ++i){
+        const int len = ms.lengths[i];
+        for(; 2 * k <= len; k *= 2){
+          ext_bits<E>(tmp.data(), t, t, k, nw);
+          t = tmp.data();
+        }
+        ext_bits<E>(hrow(i, r), t, t, len - k, nw);
+      }
+    }
+
+    const int nOut = (g.w + 63) / 64;
+    for(int y = 0; y < g.h; ++y){
+      std::fill(acc.begin(), acc.begin() + nOut, E::BITS_INIT);
+      for(const auto &seg : ms.segments){
+        ext_bits<E>(acc.data(), acc.data(), hrow(seg.lenIndex, y + seg.dy), seg.dx, nOut);
+      }
+      unpack_row(acc.data(), g.w, lo, hi, g.d + y * g.dstStep);
+    }
+  }
+
+  // ================================================================
+  // C++ morphological kernel: selects the algorithm per channel
+  // ================================================================
+
+  template<class E, class T>
+  void morph_cpp(const Img<T> &src, Img<T> &dst, MOp &op){
+    const Size maskSize = op.getMaskSize();
+    const MaskSegments ms(op.getMask(), maskSize);
     const Point anchor = op.getAnchor();
     const Point roiOff = op.getROIOffset();
-    const T *srcData;
-    T *dstROI;
 
     for(int c = 0; c < src.getChannels(); ++c){
-      srcData = src.getData(c);
-      dstROI = dst.getROIData(c);
-      for(int y = 0; y < roiH; ++y){
-        T *dstRow = dstROI + y * dstW;
-        for(int x = 0; x < roiW; ++x){
-          const icl8u *m = mask;
-          T best = init;
-          for(int my = 0; my < maskH; ++my){
-            const T *row = srcData + (roiOff.y - anchor.y + y + my) * srcW
-                           + (roiOff.x - anchor.x + x);
-            for(int mx = 0; mx < maskW; ++mx, ++m){
-              if(*m && cmp(row[mx], best)) best = row[mx];
-            }
-          }
-          dstRow[x] = best;
+      const MorphGeom<T> g = {
+        src.getData(c) + (roiOff.y - anchor.y) * src.getWidth() + (roiOff.x - anchor.x),
+        src.getWidth(), dst.getROIData(c), dst.getWidth(),
+        dst.getROIWidth(), dst.getROIHeight(), maskSize.width, maskSize.height
+      };
+      if(!ms.count){
+        morph_direct<E>(g, op.getMask());
+        continue;
+      }
+      // for rectangular masks, the gray value kernel is as fast as packing
+      // and unpacking the bits
+      if constexpr(std::is_same_v<T, icl8u>){
+        icl8u lo, hi;
+        if(!ms.rect && is_binary(g.s, g.srcStep, g.w + g.mw - 1, g.h + g.mh - 1, lo, hi)){
+          morph_binary<E>(g, ms, lo, hi);
+          continue;
         }
       }
+      if(ms.rect){
+        morph_rect<E>(g);
+      }else if(2 * static_cast<int>(ms.segments.size()) <= ms.count){
+        morph_segments<E>(g, ms);
+      }else{
+        morph_direct<E>(g, op.getMask());
+      }
     }
   }
 
@@ -75,7 +455,6 @@ namespace {
   void apply_t(const Image &srcImg, Image &dstImg, MOp &op){
     const Img<T> &src = srcImg.as<T>();
     Img<T> &dst = dstImg.as<T>();
-    Range<T> limits = Range<T>::limits();
     Size sizeSave;
     std::vector<icl8u> maskSave;
     auto ot = op.getOptype();
@@ -88,12 +467,12 @@ namespace {
       case MOp::dilate:
       case MOp::dilate3x3:
       case MOp::dilateBorderReplicate:
-        morph_cpp(src,dst,op,limits.minVal,std::greater<T>(),op.getMask());
+        morph_cpp<MaxOp>(src,dst,op);
         break;
       case MOp::erode:
       case MOp::erode3x3:
       case MOp::erodeBorderReplicate:
-        morph_cpp(src,dst,op,limits.maxVal,std::less<T>(),op.getMask());
+        morph_cpp<MinOp>(src,dst,op);
         break;
       case MOp::tophatBorder:
       case MOp::blackhatBorder:{
@@ -5,9 +5,6 @@
 #include <icl/filter/NeighborhoodOp.h>
 #include <icl/core/Image.h>
 #include <icl/utils/Macros.h>
-#include <icl/filter/ImageSplitter.h>
-#include <future>
-#include <vector>
 
 using namespace icl::utils;
 using namespace icl::core;
@@ -53,45 +50,7 @@ namespace icl::filter {
   void NeighborhoodOp::applyMT(const ImgBase *poSrc, ImgBase **ppoDst, unsigned int nThreads){
     ICLASSERT_RETURN( nThreads > 0 );
     ICLASSERT_RETURN( poSrc );
-    if(nThreads == 1){
-      apply(poSrc,ppoDst);
-      return;
-    }
-    if(!prepare (ppoDst, poSrc)) return;
-
-    bool ctr = getClipToROI();
-    bool co = getCheckOnly();
-
-    setClipToROI(false);
-    setCheckOnly(true);
-
-    const ImgBase *srcROIAdapted = poSrc->shallowCopy(Rect(getROIOffset(),(*ppoDst)->getROISize()));
-    const std::vector<ImgBase*> srcs = ImageSplitter::split(srcROIAdapted,nThreads);
-    std::vector<ImgBase*> dsts = ImageSplitter::split(*ppoDst,nThreads);
-    delete srcROIAdapted;
-
-    /*
-        DEBUG_LOG("src image:" << *poSrc);
-        for(int i=0;i<srcs.size();++i){
-        DEBUG_LOG("part " << i << " roi:" << srcs[i]->getROI());
-        }
-    */
-
-
-
-    std::vector<std::future<void>> futures;
-    for(unsigned int i=0;i<nThreads;i++){
-      ImgBase *s = srcs[i];
-      ImgBase *d = const_cast<ImgBase*>(dsts[i]);
-      futures.push_back(std::async(std::launch::async, [this,s,&d]{ apply(s, &d); }));
-    }
-    for(auto &f : futures) f.get();
-
-    setClipToROI(ctr);
-    setCheckOnly(co);
-
-    ImageSplitter::release(srcs);
-    ImageSplitter::release(dsts);
-
+    ScopedThreadCount threads(static_cast<int>(nThreads));
+    apply(poSrc,ppoDst);
   }
   } // namespace icl::filter
\ No newline at end of file
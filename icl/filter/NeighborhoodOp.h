@@ -48,7 +48,11 @@ namespace icl::filter {
         */
     bool computeROI(const core::ImgBase *poSrc, utils::Point& oROIoffset, utils::Size& oROIsize);
 
-    /// *NEW* apply function for multithreaded filtering (reimplemented here for special roi handling!)
+    /// applies the operator using nThreads threads
+    /** Unlike setThreadCount(), the thread count only affects this call,
+        so the same op can be used concurrently with different counts.
+        Only subclasses that support band-parallel processing (see
+        \ref UNARY_MT) actually use more than one thread. */
     virtual void applyMT(const core::ImgBase *operand1, core::ImgBase **dst, unsigned int nThreads);
 
     /// Returns destination params accounting for mask margin shrinkage
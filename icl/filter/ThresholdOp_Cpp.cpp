@@ -15,7 +15,7 @@ namespace {
       using T = typename std::remove_reference_t<decltype(s)>::type;
       T t = clipped_cast<double,T>(threshold);
       T v = clipped_cast<double,T>(value);
-      visitROILinesPerChannelWith(s, d, [t, v](const T *sp, T *dp, int, int w) {
+      visitROILinesPerChannelWithMT(s, d, [t, v](const T *sp, T *dp, int, int w) {
         for(int i = 0; i < w; ++i) dp[i] = sp[i] < t ? v : sp[i];
       });
     });
@@ -26,7 +26,7 @@ namespace {
       using T = typename std::remove_reference_t<decltype(s)>::type;
       T t = clipped_cast<double,T>(threshold);
       T v = clipped_cast<double,T>(value);
-      visitROILinesPerChannelWith(s, d, [t, v](const T *sp, T *dp, int, int w) {
+      visitROILinesPerChannelWithMT(s, d, [t, v](const T *sp, T *dp, int, int w) {
         for(int i = 0; i < w; ++i) dp[i] = sp[i] > t ? v : sp[i];
       });
     });
@@ -40,7 +40,7 @@ namespace {
       T vl = clipped_cast<double,T>(vLo);
       T hi = clipped_cast<double,T>(tHi);
       T vh = clipped_cast<double,T>(vHi);
-      visitROILinesPerChannelWith(s, d, [lo, vl, hi, vh](const T *sp, T *dp, int, int w) {
+      visitROILinesPerChannelWithMT(s, d, [lo, vl, hi, vh](const T *sp, T *dp, int, int w) {
         for(int i = 0; i < w; ++i) {
           T val = sp[i];
           dp[i] = val < lo ? vl : (val > hi ? vh : val);
@@ -39,7 +39,7 @@ namespace {
         icl32f t = static_cast<icl32f>(threshold), v = static_cast<icl32f>(value);
         __m128 vt = _mm_set1_ps(t);
         __m128 vv = _mm_set1_ps(v);
-        visitROILinesPerChannelWith(s, d, [vt, vv, t, v](const icl32f *sp, icl32f *dp, int, int w) {
+        visitROILinesPerChannelWithMT(s, d, [vt, vv, t, v](const icl32f *sp, icl32f *dp, int, int w) {
           int i = 0;
           for(; i <= w-4; i += 4){
             __m128 val = _mm_loadu_ps(sp+i);
@@ -52,7 +52,7 @@ namespace {
         icl8u t = static_cast<icl8u>(threshold), v = static_cast<icl8u>(value);
         __m128i vt = _mm_set1_epi8(static_cast<char>(t));
         __m128i vv = _mm_set1_epi8(static_cast<char>(v));
-        visitROILinesPerChannelWith(s, d, [vt, vv, t, v](const icl8u *sp, icl8u *dp, int, int w) {
+        visitROILinesPerChannelWithMT(s, d, [vt, vv, t, v](const icl8u *sp, icl8u *dp, int, int w) {
           int i = 0;
           for(; i <= w-16; i += 16){
             __m128i val = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sp+i));
@@ -73,7 +73,7 @@ namespace {
         icl32f t = static_cast<icl32f>(threshold), v = static_cast<icl32f>(value);
         __m128 vt = _mm_set1_ps(t);
         __m128 vv = _mm_set1_ps(v);
-        visitROILinesPerChannelWith(s, d, [vt, vv, t, v](const icl32f *sp, icl32f *dp, int, int w) {
+        visitROILinesPerChannelWithMT(s, d, [vt, vv, t, v](const icl32f *sp, icl32f *dp, int, int w) {
           int i = 0;
           for(; i <= w-4; i += 4){
             __m128 val = _mm_loadu_ps(sp+i);
@@ -86,7 +86,7 @@ namespace {
         icl8u t = static_cast<icl8u>(threshold), v = static_cast<icl8u>(value);
         __m128i vt = _mm_set1_epi8(static_cast<char>(t));
         __m128i vv = _mm_set1_epi8(static_cast<char>(v));
-        visitROILinesPerChannelWith(s, d, [vt, vv, t, v](const icl8u *sp, icl8u *dp, int, int w) {
+        visitROILinesPerChannelWithMT(s, d, [vt, vv, t, v](const icl8u *sp, icl8u *dp, int, int w) {
           int i = 0;
           for(; i <= w-16; i += 16){
             __m128i val = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sp+i));
@@ -109,7 +109,7 @@ namespace {
         icl32f hi = static_cast<icl32f>(tHi), vh = static_cast<icl32f>(vHi);
         __m128 vtLow = _mm_set1_ps(lo), vvLow = _mm_set1_ps(vl);
         __m128 vtUp  = _mm_set1_ps(hi), vvUp  = _mm_set1_ps(vh);
-        visitROILinesPerChannelWith(s, d, [=](const icl32f *sp, icl32f *dp, int, int w) {
+        visitROILinesPerChannelWithMT(s, d, [=](const icl32f *sp, icl32f *dp, int, int w) {
           int i = 0;
           for(; i <= w-4; i += 4){
             __m128 v = _mm_loadu_ps(sp+i);
@@ -132,7 +132,7 @@ namespace {
         __m128i vvLow = _mm_set1_epi8(static_cast<char>(vl));
         __m128i vtUp  = _mm_set1_epi8(static_cast<char>(hi));
         __m128i vvUp  = _mm_set1_epi8(static_cast<char>(vh));
-        visitROILinesPerChannelWith(s, d, [=](const icl8u *sp, icl8u *dp, int, int w) {
+        visitROILinesPerChannelWithMT(s, d, [=](const icl8u *sp, icl8u *dp, int, int w) {
           int i = 0;
           for(; i <= w-16; i += 16){
             __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sp+i));
@@ -22,7 +22,7 @@ namespace {
     float neg  = -fval;
     float inv  = fval != 0.f ? 1.f / fval : 0.f;
 
-    visitROILinesPerChannelWith(src.as32f(), dst.as32f(),
+    visitROILinesPerChannelWithMT(src.as32f(), dst.as32f(),
       [&](const icl32f *s, icl32f *d, int, int w) {
         vImagePixelCount n = static_cast<vImagePixelCount>(w);
         switch(optype) {
@@ -39,7 +39,7 @@ namespace {
   // ================================================================
 
   void acc_arith_no_val(const Image &src, Image &dst, int optype) {
-    visitROILinesPerChannelWith(src.as32f(), dst.as32f(),
+    visitROILinesPerChannelWithMT(src.as32f(), dst.as32f(),
       [optype](const icl32f *s, icl32f *d, int, int w) {
         vImagePixelCount n = static_cast<vImagePixelCount>(w);
         int iw = w;
@@ -20,7 +20,7 @@ namespace {
 
   template<UAOp::optype OT, class T>
   void arithWithVal(const Img<T> &src, Img<T> &dst, T val) {
-    visitROILinesPerChannelWith(src, dst, [val](const T *s, T *d, int, int w) {
+    visitROILinesPerChannelWithMT(src, dst, [val](const T *s, T *d, int, int w) {
       for(int i = 0; i < w; ++i) {
         if constexpr (OT == UAOp::addOp) d[i] = clipped_cast<icl64f,T>(static_cast<icl64f>(s[i]) + static_cast<icl64f>(val));
         else if constexpr (OT == UAOp::subOp) d[i] = clipped_cast<icl64f,T>(static_cast<icl64f>(s[i]) - static_cast<icl64f>(val));
@@ -32,7 +32,7 @@ namespace {
 
   template<UAOp::optype OT, class T>
   void arithNoVal(const Img<T> &src, Img<T> &dst) {
-    visitROILinesPerChannelWith(src, dst, [](const T *s, T *d, int, int w) {
+    visitROILinesPerChannelWithMT(src, dst, [](const T *s, T *d, int, int w) {
       for(int i = 0; i < w; ++i) {
         if constexpr (OT == UAOp::sqrOp)  d[i] = s[i] * s[i];
         else if constexpr (OT == UAOp::sqrtOp) d[i] = clipped_cast<double,T>(std::sqrt(static_cast<double>(s[i])));
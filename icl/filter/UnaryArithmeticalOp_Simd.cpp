@@ -27,7 +27,7 @@ namespace {
     icl32f val = static_cast<icl32f>(value);
     __m128 vv = _mm_set1_ps(val);
 
-    visitROILinesPerChannelWith(s, d, [&](const icl32f *sp, icl32f *dp, int, int w) {
+    visitROILinesPerChannelWithMT(s, d, [&](const icl32f *sp, icl32f *dp, int, int w) {
       int i = 0;
       for(; i <= w-4; i += 4) {
         __m128 v = _mm_loadu_ps(sp+i);
@@ -60,7 +60,7 @@ namespace {
     __m128 signMask = _mm_set1_ps(-0.0f);
     bool hasSimd = (optype == UAOp::sqrOp || optype == UAOp::absOp || optype == UAOp::sqrtOp);
 
-    visitROILinesPerChannelWith(s, d, [&](const icl32f *sp, icl32f *dp, int, int w) {
+    visitROILinesPerChannelWithMT(s, d, [&](const icl32f *sp, icl32f *dp, int, int w) {
       int i = 0;
       if(hasSimd) {
         for(; i <= w-4; i += 4) {
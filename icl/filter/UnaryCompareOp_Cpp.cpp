@@ -13,7 +13,7 @@ namespace {
 
   template<UCO::optype OT, class T>
   void cmpTyped(const Img<T> &src, Img8u &dst, T value) {
-    visitROILinesPerChannelWith(src, dst, [value](const T *s, icl8u *d, int, int w) {
+    visitROILinesPerChannelWithMT(src, dst, [value](const T *s, icl8u *d, int, int w) {
       for(int i = 0; i < w; ++i) {
         if constexpr (OT == UCO::lt)   d[i] = s[i] < value ? 255 : 0;
         else if constexpr (OT == UCO::lteq) d[i] = s[i] <= value ? 255 : 0;
@@ -45,7 +45,7 @@ namespace {
       using T = typename std::remove_reference_t<decltype(s)>::type;
       T v = clipped_cast<double,T>(value);
       T t = clipped_cast<double,T>(tolerance);
-      visitROILinesPerChannelWith(s, d, [v, t](const T *sp, icl8u *dp, int, int w) {
+      visitROILinesPerChannelWithMT(s, d, [v, t](const T *sp, icl8u *dp, int, int w) {
         for(int i = 0; i < w; ++i)
           dp[i] = std::abs(sp[i] - v) <= t ? 255 : 0;
       });
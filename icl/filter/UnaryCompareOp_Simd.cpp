@@ -44,7 +44,7 @@ namespace {
       }
     };
 
-    visitROILinesPerChannelWith(src, dst, [&](const icl8u *s, icl8u *d, int, int w) {
+    visitROILinesPerChannelWithMT(src, dst, [&](const icl8u *s, icl8u *d, int, int w) {
       int i = 0;
       for(; i <= w-16; i += 16) {
         __m128i val = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s+i));
@@ -18,15 +18,15 @@ namespace {
         T v = clipped_cast<icl32s,T>(val);
         switch(optype) {
           case ULOp::andOp:
-            visitROILinesPerChannelWith(s, d, [v](const T *sp, T *dp, int, int w) {
+            visitROILinesPerChannelWithMT(s, d, [v](const T *sp, T *dp, int, int w) {
               for(int i = 0; i < w; ++i) dp[i] = sp[i] & v;
             }); break;
           case ULOp::orOp:
-            visitROILinesPerChannelWith(s, d, [v](const T *sp, T *dp, int, int w) {
+            visitROILinesPerChannelWithMT(s, d, [v](const T *sp, T *dp, int, int w) {
               for(int i = 0; i < w; ++i) dp[i] = sp[i] | v;
             }); break;
           case ULOp::xorOp:
-            visitROILinesPerChannelWith(s, d, [v](const T *sp, T *dp, int, int w) {
+            visitROILinesPerChannelWithMT(s, d, [v](const T *sp, T *dp, int, int w) {
               for(int i = 0; i < w; ++i) dp[i] = sp[i] ^ v;
             }); break;
           default: break;
@@ -39,7 +39,7 @@ namespace {
     src.visitWith(dst, [](const auto &s, auto &d) {
       using T = typename std::remove_reference_t<decltype(s)>::type;
       if constexpr (std::is_integral_v<T>) {
-        visitROILinesPerChannelWith(s, d, [](const T *sp, T *dp, int, int w) {
+        visitROILinesPerChannelWithMT(s, d, [](const T *sp, T *dp, int, int w) {
           for(int i = 0; i < w; ++i) dp[i] = ~sp[i];
         });
       }
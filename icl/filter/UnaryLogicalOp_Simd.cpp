@@ -22,7 +22,7 @@ namespace {
       if constexpr (std::is_same_v<T, icl8u>) {
         icl8u v = clipped_cast<icl32s, icl8u>(val);
         __m128i vv = _mm_set1_epi8(static_cast<char>(v));
-        visitROILinesPerChannelWith(s, d, [vv, v, optype](const icl8u *sp, icl8u *dp, int, int w) {
+        visitROILinesPerChannelWithMT(s, d, [vv, v, optype](const icl8u *sp, icl8u *dp, int, int w) {
           int i = 0;
           for(; i <= w-16; i += 16) {
             __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sp+i));
@@ -54,7 +54,7 @@ namespace {
           vv = _mm_set1_epi32(v);
 
         constexpr int step = 16 / sizeof(T);
-        visitROILinesPerChannelWith(s, d, [vv, v, optype](const T *sp, T *dp, int, int w) {
+        visitROILinesPerChannelWithMT(s, d, [vv, v, optype](const T *sp, T *dp, int, int w) {
           int i = 0;
           for(; i <= w-step; i += step) {
             __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sp+i));
@@ -86,7 +86,7 @@ namespace {
       if constexpr (std::is_integral_v<T>) {
         constexpr int step = 16 / sizeof(T);
         __m128i ones = _mm_set1_epi32(-1);  // all-ones mask for NOT
-        visitROILinesPerChannelWith(s, d, [ones](const T *sp, T *dp, int, int w) {
+        visitROILinesPerChannelWithMT(s, d, [ones](const T *sp, T *dp, int, int w) {
           int i = 0;
           for(; i <= w-step; i += step) {
             __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sp+i));
@@ -7,6 +7,8 @@
 #include <icl/filter/UnaryOp.h>
 #include <icl/core/Image.h>
 #include <icl/core/ImgBase.h>
+#include <icl/core/Img.h>
+#include <icl/utils/ThreadPool.h>
 #include <icl/filter/ImageSplitter.h>
 #include <future>
 #include <vector>
@@ -27,6 +29,14 @@ using namespace icl::utils;
 using namespace icl::core;
 
 namespace icl::filter {
+  namespace {
+    /// thread count override installed by UnaryOp::ScopedThreadCount (-1: none)
+    thread_local int t_threadCount = -1;
+
+    /// bands are not made smaller than this (in pixels)
+    constexpr int MIN_BAND_PIXELS = 4096;
+  }
+
   void UnaryOp::initConfigurable(){
     addProperty("UnaryOp.clip to ROI","menu","on,off",m_oROIHandler.getClipToROI() ? "on" : "off",0,
                 "If this option is set to true, the result images are always adapted\n"
@@ -39,6 +49,10 @@ namespace icl::filter {
                 "method are not adapted. Instead the given result images are checked\n"
                 "for their compatibility. In case of uncompatible result images,\n"
                 "an exception is thrown.");
+    addProperty("UnaryOp.threads","range:spinbox","[0,256]",str(m_threadCount),0,
+                "Number of threads used by operators that support band-parallel\n"
+                "processing: 1 processes the image serially, 0 uses all threads\n"
+                "of the global thread pool.");
   }
 
   UnaryOp::UnaryOp(){
@@ -46,15 +60,17 @@ namespace icl::filter {
   }
 
   UnaryOp::UnaryOp(const UnaryOp &other):
-    m_oROIHandler(other.m_oROIHandler){
+    m_oROIHandler(other.m_oROIHandler), m_threadCount(other.m_threadCount){
     initConfigurable();
   }
 
   UnaryOp &UnaryOp::operator=(const UnaryOp &other){
     m_oROIHandler = other.m_oROIHandler;
+    m_threadCount = other.m_threadCount;
 
     prop("UnaryOp.clip to ROI").value = other.prop("UnaryOp.clip to ROI").value;
     prop("UnaryOp.check only").value = other.prop("UnaryOp.check only").value;
+    prop("UnaryOp.threads").value = other.prop("UnaryOp.threads").value;
 
     return *this;
   }
@@ -138,14 +154,64 @@ namespace icl::filter {
   }
 
 
-  // applyMT removed — only NeighborhoodOp provides it now
+  void UnaryOp::setThreadCount(int n){
+    ICLASSERT_RETURN(n >= 0);
+    m_threadCount = n;
+    prop("UnaryOp.threads").value = str(n);
+    call_callbacks("UnaryOp.threads",this);
+  }
+
+  UnaryOp::ScopedThreadCount::ScopedThreadCount(int n) : m_prev(t_threadCount){
+    t_threadCount = n;
+  }
 
+  UnaryOp::ScopedThreadCount::~ScopedThreadCount(){
+    t_threadCount = m_prev;
+  }
 
+  int UnaryOp::getNumBands(const core::Image &dst) const {
+    int n = t_threadCount >= 0 ? t_threadCount : m_threadCount;
+    if(n == 1 || dst.isNull()) return 1;
+    if(n == 0) n = ThreadPool::global().getConcurrency();
+    const Size s = dst.getROISize();
+    return std::max(1, std::min({n, s.height, s.getDim() / MIN_BAND_PIXELS}));
+  }
 
+  void UnaryOp::applyBands(core::Image &dst,
+                           const std::function<void(core::Image&, int)> &f) const {
+    const int n = getNumBands(dst);
+    if(n < 2){
+      f(dst, 0);
+      return;
+    }
+    const Rect roi = dst.getROI();
+    ThreadPool::global().parallelForEach(n, [&](int i){
+      const int y0 = (roi.height * i) / n, y1 = (roi.height * (i + 1)) / n;
+      core::Image band = dst.shallowCopy();
+      band.setROI(Rect(roi.x, roi.y + y0, roi.width, y1 - y0));
+      f(band, y0);
+    });
+  }
+
+  core::Image UnaryOp::shiftRows(const core::Image &src, int dy){
+    if(!dy) return src;
+    return src.visit([dy](const auto &s) -> core::Image {
+      using T = typename std::remove_reference_t<decltype(s)>::type;
+      std::vector<T*> data(s.getChannels());
+      for(int c = 0; c < s.getChannels(); ++c){
+        data[c] = const_cast<T*>(s.getData(c)) + dy * s.getWidth();
+      }
+      Img<T> view(Size(s.getWidth(), s.getHeight() - dy), s.getChannels(), s.getFormat(), data);
+      view.setROI((s.getROI() - Point(0, dy)) & view.getImageRect());
+      view.setTime(s.getTime());
+      return core::Image(view);
+    });
+  }
 
   void UnaryOp::setPropertyValue(const std::string &propertyName, const Any &value){
     if(propertyName == "UnaryOp.clip to ROI") setClipToROI(value == "on");
     else if(propertyName == "UnaryOp.check only") setCheckOnly(value == "on");
+    else if(propertyName == "UnaryOp.threads") setThreadCount(parse<int>(value));
     Configurable::setPropertyValue(propertyName,value);
   }
 
@@ -9,12 +9,27 @@
 #include <icl/core/Image.h>
 #include <icl/core/ImgParams.h>
 #include <icl/filter/OpROIHandler.h>
+#include <icl/utils/BackendDispatching.h>
+#include <functional>
+#include <memory>
 #include <mutex>
 
 namespace icl::filter {
   /// Abstract Base class for Unary Operators \ingroup UNARY
   /** A list of unary operators can be found here:\n
       \ref UNARY
+
+      \section UNARY_MT Multi-threading
+      Each UnaryOp carries an execution policy, set via setThreadCount()
+      or setParallel(). Operators that support it (e.g. MedianOp,
+      ConvolutionOp, MorphologicalOp, WienerOp, BilateralFilterOp, AffineOp
+      and WarpOp) split the destination ROI into horizontal bands and
+      process them concurrently on utils::ThreadPool::global(). Bands are
+      formed after the destination image has been prepared, so the
+      neighborhood border of a NeighborhoodOp is already accounted for and
+      the result is identical to a serial run. Stateful backends (e.g. IPP
+      specifications) are cloned per band; OpenCL and Accelerate backends
+      parallelize internally and are never split.
   **/
   class ICLFilter_API UnaryOp : public utils::Configurable{
     void initConfigurable();
@@ -86,6 +101,22 @@ namespace icl::filter {
     */
     bool getCheckOnly() const { return m_oROIHandler.getCheckOnly(); }
 
+    /// sets the number of threads used by apply()
+    /** @param n 1 (default): serial processing, 0: automatic (all threads
+               of utils::ThreadPool::global()), n > 1: at most n bands
+        Only operators that implement band-parallel processing honor this
+        setting (see \ref UNARY_MT). */
+    void setThreadCount(int n);
+
+    /// returns the number of threads used by apply() (0 means automatic)
+    int getThreadCount() const { return m_threadCount; }
+
+    /// shortcut for setThreadCount(on ? 0 : 1)
+    void setParallel(bool on) { setThreadCount(on ? 0 : 1); }
+
+    /// returns whether apply() may use more than one thread
+    bool getParallel() const { return m_threadCount != 1; }
+
 
     /// sets value of a property (always call call_callbacks(propertyName) or Configurable::setPropertyValue)
     virtual void setPropertyValue(const std::string &propertyName, const utils::Any &value);
@@ -128,6 +159,64 @@ namespace icl::filter {
     /// Image-based prepare: as above, but with explicit depth override
     bool prepare(core::Image &dst, const core::Image &src, core::depth d);
 
+    /// Overrides the thread count of the calling thread's apply() calls while alive
+    /** Used to implement explicit per-call thread counts (e.g.
+        NeighborhoodOp::applyMT) without touching the op's own policy. */
+    class ICLFilter_API ScopedThreadCount {
+      int m_prev;
+      public:
+      explicit ScopedThreadCount(int n);
+      ~ScopedThreadCount();
+      ScopedThreadCount(const ScopedThreadCount&) = delete;
+      ScopedThreadCount &operator=(const ScopedThreadCount&) = delete;
+    };
+
+    /// Returns the number of horizontal bands dst's ROI is split into
+    /** Depends on the thread count, the pool size and the ROI size;
+        small ROIs are never split. */
+    int getNumBands(const core::Image &dst) const;
+
+    /// Calls f(band, y0) for disjoint horizontal bands covering dst's ROI
+    /** band is a shallow copy of dst whose ROI is restricted to the rows
+        [roi.y+y0, roi.y+y0+band.getROIHeight()). Bands are processed
+        concurrently according to getNumBands(); with a single band, f is
+        called with dst itself and y0 = 0. */
+    void applyBands(core::Image &dst,
+                    const std::function<void(core::Image &band, int y0)> &f) const;
+
+    /// Backend-aware version of applyBands
+    /** Calls f(impl, band, y0). Backends with a cloneFn (stateful
+        backends) get a private clone for every band but the first. OpenCL
+        and Accelerate backends, which parallelize internally, are always
+        called once with the complete dst image. While a measured backend
+        selection (utils::BackendTuning) is pending, the candidates are
+        timed on the complete image; afterwards, the bands use the winner. */
+    template<class Impl, class F>
+    void applyBands(Impl *resolved, core::Image &dst, F &&f) const {
+      auto *impl = resolved->concurrentImpl();
+      if(!impl){
+        f(*resolved, dst, 0);
+        return;
+      }
+      if(impl->backend == utils::Backend::OpenCL || impl->backend == utils::Backend::Accelerate
+         || getNumBands(dst) < 2){
+        f(*impl, dst, 0);
+        return;
+      }
+      applyBands(dst, [&](core::Image &band, int y0){
+        std::shared_ptr<std::remove_pointer_t<decltype(impl)>> state;
+        if(impl->cloneFn && y0) state = impl->cloneFn();
+        f(state ? *state : *impl, band, y0);
+      });
+    }
+
+    /// Returns a view on src whose first row is src's row dy (data is shared)
+    /** The view's height is reduced by dy and its ROI is moved up by dy
+        rows (clipped to the view). Backends that address the source via
+        an explicit ROI offset process the band starting at dst row y0 when
+        given shiftRows(src, y0) and the unchanged offset. */
+    static core::Image shiftRows(const core::Image &src, int dy);
+
     /// Legacy prepare (for subclasses not yet migrated)
     bool prepare (core::ImgBase **ppoDst, core::depth eDepth, const utils::Size &imgSize,
                   core::format eFormat, int nChannels, const utils::Rect& roi,
@@ -149,6 +238,8 @@ namespace icl::filter {
 
     OpROIHandler m_oROIHandler;
 
+    int m_threadCount = 1;
+
     core::Image m_buf;
   };
 
@@ -4,6 +4,7 @@
 
 #include <icl/filter/WarpOp.h>
 #include <icl/core/Image.h>
+#include <icl/utils/ThreadPool.h>
 
 using namespace icl::utils;
 using namespace icl::core;
@@ -12,6 +13,7 @@ namespace icl::filter {
   const char* toString(WarpOp::Op op) {
     switch(op) {
       case WarpOp::Op::warp: return "warp";
+      case WarpOp::Op::warpCompact: return "warpCompact";
     }
     return "?";
   }
@@ -20,6 +22,7 @@ namespace icl::filter {
     static core::ImageBackendDispatching proto;
     [[maybe_unused]] static bool init = [&] {
       proto.addSelector<WarpSig>(Op::warp);
+      proto.addSelector<WarpCompactSig>(Op::warpCompact);
       return true;
     }();
     return proto;
@@ -32,15 +35,100 @@ namespace icl::filter {
     warpMap.extractChannels(cs);
     const Size size = warpMap.getSize();
 
-    for(int x=0;x<size.width;++x){
-      for(int y=0;y<size.height;++y){
-        if(!r.contains(round(cs[0](x,y)),round(cs[1](x,y)))){
-          cs[0](x,y) = cs[1](x,y) = -1;
+    ThreadPool::global().parallelFor(0, size.height, 16, [&](int y0, int y1){
+      for(int y=y0;y<y1;++y){
+        icl32f *xs = &cs[0](0,y), *ys = &cs[1](0,y);
+        for(int x=0;x<size.width;++x){
+          if(!r.contains(round(xs[x]),round(ys[x]))){
+            xs[x] = ys[x] = -1;
+          }
         }
       }
+    });
+  }
+
+  namespace {
+    struct CompactWeights {
+      static constexpr int N = CompactWarpMap::FRAC_SIZE * CompactWarpMap::FRAC_SIZE;
+      std::int16_t i[4*N];
+      float f[4*N];
+
+      CompactWeights(){
+        const int F = CompactWarpMap::FRAC_SIZE;
+        const int one = 1 << CompactWarpMap::WEIGHT_BITS;
+        for(int fy=0;fy<F;++fy){
+          for(int fx=0;fx<F;++fx){
+            const int idx = 4 * ((fy << CompactWarpMap::FRAC_BITS) | fx);
+            // exact products of multiples of 1/F
+            const int w[4] = { (F-fx)*(F-fy), fx*(F-fy), (F-fx)*fy, fx*fy };
+            int sum = 0, maxIdx = 0;
+            for(int k=0;k<4;++k){
+              f[idx+k] = float(w[k]) / (F*F);
+              i[idx+k] = static_cast<std::int16_t>((w[k] * one + F*F/2) / (F*F));
+              sum += i[idx+k];
+              if(w[k] > w[maxIdx]) maxIdx = k;
+            }
+            i[idx+maxIdx] += one - sum; // weights of constant images sum up exactly
+          }
+        }
+      }
+    };
+
+    const CompactWeights &compact_weights(){
+      static const CompactWeights w;
+      return w;
     }
   }
 
+  const std::int16_t *CompactWarpMap::getIntWeights(){
+    return compact_weights().i;
+  }
+
+  const float *CompactWarpMap::getFloatWeights(){
+    return compact_weights().f;
+  }
+
+  CompactWarpMap::CompactWarpMap(const Img32f &warpMap):
+    m_size(warpMap.getSize()){
+    ICLASSERT_THROW(warpMap.getChannels() == 2,
+                    ICLException("CompactWarpMap: warp map must have 2 channels"));
+    ICLASSERT_THROW(m_size.width < 32768 && m_size.height < 32768,
+                    ICLException("CompactWarpMap: warp map is too large"));
+    const int w = m_size.width, h = m_size.height;
+    m_coords.resize(2 * m_size.getDim());
+    m_fracs.resize(m_size.getDim());
+    const float xMax = w - 0.5f, yMax = h - 0.5f;
+
+    ThreadPool::global().parallelFor(0, h, 16, [&](int y0, int y1){
+      for(int y=y0;y<y1;++y){
+        const icl32f *xs = warpMap.getData(0) + y*w, *ys = warpMap.getData(1) + y*w;
+        std::int16_t *c = m_coords.data() + 2*y*w;
+        std::uint16_t *f = m_fracs.data() + y*w;
+        for(int x=0;x<w;++x){
+          // x < 0 or rounded position outside the image (also catches NaN)
+          if(!(xs[x] >= 0 && xs[x] < xMax && ys[x] > -0.5f && ys[x] < yMax)){
+            c[2*x] = c[2*x+1] = -1;
+            f[x] = 0;
+            continue;
+          }
+          // truncation equals floor here, except for y in [-0.5,0), which
+          // is clamped to row 0 anyway
+          const int qx = static_cast<int>(xs[x] * FRAC_SIZE + 0.5f);
+          const int qy = static_cast<int>(ys[x] * FRAC_SIZE + 0.5f);
+          int ix = qx >> FRAC_BITS, fx = qx & (FRAC_SIZE-1);
+          int iy = qy >> FRAC_BITS, fy = qy & (FRAC_SIZE-1);
+          if(ix < 0){ ix = 0; fx = 0; }
+          if(ix >= w-1){ ix = w-1; fx = 0; }
+          if(iy < 0){ iy = 0; fy = 0; }
+          if(iy >= h-1){ iy = h-1; fy = 0; }
+          c[2*x] = static_cast<std::int16_t>(ix);
+          c[2*x+1] = static_cast<std::int16_t>(iy);
+          f[x] = static_cast<std::uint16_t>((fy << FRAC_BITS) | fx);
+        }
+      }
+    });
+  }
+
   static const char *WARP_INTERP_MENU = "NN,LIN";
   static const char *warpInterpName(scalemode m){
     return m == interpolateNN ? "NN" : "LIN";
@@ -56,9 +144,13 @@ namespace icl::filter {
     prepare_warp_table_inplace(m_warpMap);
     addProperty("interpolation","menu",WARP_INTERP_MENU,warpInterpName(mode));
     addProperty("allow warp map scaling","flag","",allowWarpMapScaling);
+    addProperty("compact map","flag","",false,0,
+                "remap 8u, 16s and 32f images using a fixed point warp map "
+                "(6 instead of 8 bytes per pixel, 1/32 pixel resolution)");
     registerCallback([this](const Property &p){
       if(p.name == "interpolation")               m_scaleMode = parseWarpInterp(p.value);
       else if(p.name == "allow warp map scaling") m_allowWarpMapScaling = parse<bool>(p.value);
+      else if(p.name == "compact map")            m_useCompactMap = parse<bool>(p.value);
     });
     // No file-path prop: filter lib can't depend on ICLIO for image loading,
     // so the warp table is supplied only through setWarpMap() (e.g. from the
@@ -76,12 +168,17 @@ namespace icl::filter {
     warpMap.deepCopy(&m_warpMap);
     prepare_warp_table_inplace(m_warpMap);
     m_scaledWarpMap = Img32f();
+    m_compactMap = CompactWarpMap();
   }
 
   void WarpOp::setAllowWarpMapScaling(bool allow){
     setPropertyValue("allow warp map scaling", allow);
   }
 
+  void WarpOp::setUseCompactMap(bool use){
+    setPropertyValue("compact map", use);
+  }
+
   REGISTER_CONFIGURABLE_DEFAULT(WarpOp);
 
   void WarpOp::apply(const Image &src, Image &dst) {
@@ -97,7 +194,7 @@ namespace icl::filter {
     }
 
     // Select and prepare warp map (scale if sizes differ)
-    Channel32f cwm[2];
+    Img32f *warpMap = &m_warpMap;
     if(src.getSize() != m_warpMap.getSize()) {
       if(m_allowWarpMapScaling) {
         if(m_scaledWarpMap.getSize() != src.getSize()) {
@@ -105,14 +202,12 @@ namespace icl::filter {
           m_warpMap.scaledCopy(&m_scaledWarpMap);
           prepare_warp_table_inplace(m_scaledWarpMap);
         }
-        m_scaledWarpMap.extractChannels(cwm);
+        warpMap = &m_scaledWarpMap;
       } else {
         ERROR_LOG("warp map size and image size are not equal\n"
                   "warp map can be scaled using setAllowWarpMapScaling(true)");
         return;
       }
-    } else {
-      m_warpMap.extractChannels(cwm);
     }
 
     // Warp map offset: maps dst coordinates to warp map coordinates.
@@ -121,12 +216,33 @@ namespace icl::filter {
     const Rect dstROI = dst.getROI();
     const Point warpOffset(srcROI.x - dstROI.x, srcROI.y - dstROI.y);
 
+    const depth d = src.getDepth();
+    if(m_useCompactMap && (d == depth8u || d == depth16s || d == depth32f)) {
+      // the scaled and the original map never have the same size
+      if(m_compactMap.getSize() != warpMap->getSize()) {
+        m_compactMap = CompactWarpMap(*warpMap);
+      }
+      auto* impl = getSelector<WarpCompactSig>(Op::warpCompact).resolve(src);
+      if(!impl) {
+        ERROR_LOG("no applicable backend for WarpOp");
+        return;
+      }
+      applyBands(impl, dst, [&](auto &bandImpl, Image &band, int){
+        bandImpl.apply(src, band, m_compactMap, warpOffset, m_scaleMode);
+      });
+      return;
+    }
+
+    Channel32f cwm[2];
+    warpMap->extractChannels(cwm);
     auto* impl = getSelector<WarpSig>(Op::warp).resolve(src);
     if(!impl) {
       ERROR_LOG("no applicable backend for WarpOp");
       return;
     }
-    impl->apply(src, dst, cwm, warpOffset, m_scaleMode);
+    applyBands(impl, dst, [&](auto &bandImpl, Image &band, int){
+      bandImpl.apply(src, band, cwm, warpOffset, m_scaleMode);
+    });
   }
 
   } // namespace icl::filter
\ No newline at end of file
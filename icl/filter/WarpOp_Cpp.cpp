@@ -1,4 +1,5 @@
 #include <icl/filter/WarpOp.h>
+#include <icl/filter/detail/CompactWarpRows.h>
 #include <icl/core/Img.h>
 #include <icl/core/Image.h>
 
@@ -19,17 +20,21 @@ namespace {
   template<class T>
   inline T interpolate_pixel_lin(float x, float y, const Channel<T> &src){
     if(x < 0) return T(0);
+    if(y < 0) y = 0; // rounds to row 0, but would be truncated towards row 1
     float fX0 = x - floor(x), fX1 = 1.0f - fX0;
     float fY0 = y - floor(y), fY1 = 1.0f - fY0;
     int xll = static_cast<int>(x);
     int yll = static_cast<int>(y);
 
+    // the right/bottom neighbours are clamped to the image (their weight
+    // is (almost) 0 there, but they must not be read from outside)
+    const int dx = xll+1 < src.getWidth() ? 1 : 0;
+    const int dy = yll+1 < src.getHeight() ? src.getWidth() : 0;
     const T* pLL = &src(xll,yll);
-    float a = *pLL;        //  a b
-    float b = *(++pLL);    //  c d
-    pLL += src.getWidth();
-    float d = *pLL;
-    float c = *(--pLL);
+    float a = pLL[0];      //  a b
+    float b = pLL[dx];     //  c d
+    float c = pLL[dy];
+    float d = pLL[dy+dx];
 
     return fX1 * (fY1*a + fY0*c) + fX0 * (fY1*b + fY0*d);
   }
@@ -73,11 +78,77 @@ namespace {
     });
   }
 
+  // ================================================================
+  // Compact (fixed point) warp map
+  // ================================================================
+
+  using CMap = filter::CompactWarpMap;
+  using filter::detail::compact_row_nn;
+
+  template<class T>
+  inline void compact_row_lin(const T *s, int sw, const std::int16_t *xy,
+                              const std::uint16_t *fr, T *d, int n){
+    const std::int16_t *weights = CMap::getIntWeights();
+    const int round = 1 << (CMap::WEIGHT_BITS-1);
+    for(int i = 0; i < n; ++i){
+      if(xy[2*i] < 0){ d[i] = T(0); continue; }
+      const T *p = s + xy[2*i] + xy[2*i+1]*sw;
+      const int dx = (fr[i] & (CMap::FRAC_SIZE-1)) ? 1 : 0;
+      const int dy = (fr[i] >> CMap::FRAC_BITS) ? sw : 0;
+      const std::int16_t *w = weights + 4*fr[i];
+      d[i] = T((w[0]*p[0] + w[1]*p[dx] + w[2]*p[dy] + w[3]*p[dy+dx] + round) >> CMap::WEIGHT_BITS);
+    }
+  }
+
+  template<>
+  inline void compact_row_lin(const icl32f *s, int sw, const std::int16_t *xy,
+                              const std::uint16_t *fr, icl32f *d, int n){
+    const float *weights = CMap::getFloatWeights();
+    for(int i = 0; i < n; ++i){
+      if(xy[2*i] < 0){ d[i] = 0; continue; }
+      const icl32f *p = s + xy[2*i] + xy[2*i+1]*sw;
+      const int dx = (fr[i] & (CMap::FRAC_SIZE-1)) ? 1 : 0;
+      const int dy = (fr[i] >> CMap::FRAC_BITS) ? sw : 0;
+      const float *w = weights + 4*fr[i];
+      d[i] = w[0]*p[0] + w[1]*p[dx] + w[2]*p[dy] + w[3]*p[dy+dx];
+    }
+  }
+
+  template<class T>
+  void compact_warp(const Img<T> &src, Img<T> &dst, const CMap &map,
+                    const Point &warpOffset, scalemode mode){
+    const int mw = map.getSize().width, sw = src.getWidth();
+    const Rect dstROI = dst.getROI();
+    for(int c = 0; c < src.getChannels(); ++c){
+      const T *s = src.begin(c);
+      for(int y = dstROI.y; y < dstROI.bottom(); ++y){
+        const int idx = (y + warpOffset.y) * mw + dstROI.x + warpOffset.x;
+        T *d = dst.begin(c) + y*dst.getWidth() + dstROI.x;
+        if(mode == interpolateNN){
+          compact_row_nn(s, sw, map.getCoords() + 2*idx, map.getFractions() + idx, d, dstROI.width);
+        }else{
+          compact_row_lin(s, sw, map.getCoords() + 2*idx, map.getFractions() + idx, d, dstROI.width);
+        }
+      }
+    }
+  }
+
+  void cpp_warp_compact(const Image& src, Image& dst, const CMap &map,
+                        Point warpOffset, scalemode mode) {
+    switch(src.getDepth()){
+      case depth8u:  compact_warp(src.as8u(), dst.as8u(), map, warpOffset, mode); break;
+      case depth16s: compact_warp(src.as16s(), dst.as16s(), map, warpOffset, mode); break;
+      case depth32f: compact_warp(src.as32f(), dst.as32f(), map, warpOffset, mode); break;
+      default: break; // WarpOp uses the float warp map for all other depths
+    }
+  }
+
   // Direct registration into the class prototype
   static int _reg = [] {
     using Op = WOp::Op;
     auto cpp = WOp::prototype().backends(Backend::Cpp);
     cpp.add<WOp::WarpSig>(Op::warp, cpp_warp, "C++ warp");
+    cpp.add<WOp::WarpCompactSig>(Op::warpCompact, cpp_warp_compact, "C++ fixed point warp");
     return 0;
   }();
 
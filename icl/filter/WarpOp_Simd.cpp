@@ -0,0 +1,184 @@
+#include <icl/core/ImageBackendDispatching.h>
+#include <icl/core/Img.h>
+#include <icl/core/Image.h>
+#include <icl/utils/SSETypes.h>
+#include <icl/filter/WarpOp.h>
+#include <icl/filter/detail/CompactWarpRows.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#ifdef ICL_HAVE_SSE2
+
+using namespace icl;
+using namespace icl::utils;
+using namespace icl::core;
+
+namespace {
+
+  using WOp = filter::WarpOp;
+  using CMap = filter::CompactWarpMap;
+  using filter::detail::compact_row_nn;
+
+  // The destination is processed in tiles, so the source pixels a tile
+  // depends on stay in cache (for rotations and strong distortions, a
+  // destination row touches many source rows)
+  constexpr int TILE_W = 128;
+  constexpr int TILE_H = 16;
+
+  // ================================================================
+  // Bilinear interpolation of 4 pixels. Source offsets and neighbour
+  // steps are computed vectorized; invalid lanes read pixel (0,0) with
+  // fractional index 0 and their result is masked to 0 afterwards.
+  // Results are bit-identical to the C++ backend.
+  // ================================================================
+
+  struct Lanes {
+    alignas(16) int off[4];  //!< offset of the top-left pixel
+    alignas(16) int dx[4];   //!< 1 if the right neighbour has a weight, else 0
+    alignas(16) int dy[4];   //!< source width if the bottom neighbour has a weight, else 0
+    alignas(16) int f[4];    //!< fractional index
+    __m128i invalid;
+
+    Lanes(const std::int16_t *xy, const std::uint16_t *fr, int sw){
+      const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(xy));
+      invalid = _mm_cmplt_epi32(_mm_srai_epi32(_mm_slli_epi32(c, 16), 16), _mm_setzero_si128());
+      // x + y*sw, using int16 pairs (x,y) * (1,sw)
+      const __m128i o = _mm_madd_epi16(c, _mm_set1_epi32((sw << 16) | 1));
+      const __m128i fv = _mm_andnot_si128(invalid, _mm_unpacklo_epi16(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(fr)), _mm_setzero_si128()));
+      const __m128i zero = _mm_setzero_si128();
+      const __m128i hasX = _mm_cmpgt_epi32(_mm_and_si128(fv, _mm_set1_epi32(CMap::FRAC_SIZE-1)), zero);
+      const __m128i hasY = _mm_cmpgt_epi32(_mm_srli_epi32(fv, CMap::FRAC_BITS), zero);
+      _mm_store_si128(reinterpret_cast<__m128i*>(off), _mm_andnot_si128(invalid, o));
+      _mm_store_si128(reinterpret_cast<__m128i*>(dx), _mm_and_si128(hasX, _mm_set1_epi32(1)));
+      _mm_store_si128(reinterpret_cast<__m128i*>(dy), _mm_and_si128(hasY, _mm_set1_epi32(sw)));
+      _mm_store_si128(reinterpret_cast<__m128i*>(f), fv);
+    }
+  };
+
+  /// 8u/16s: the 2x2 neighbourhoods are packed into int16 pairs and
+  /// weighted using _mm_madd_epi16 with the fixed point weights
+  template<class T>
+  inline __m128i lin4_int(const T *s, const Lanes &l){
+    const std::int16_t *weights = CMap::getIntWeights();
+    alignas(16) std::uint32_t top[4], bottom[4];
+    std::uint64_t w[4];
+    for(int k = 0; k < 4; ++k){
+      const T *p = s + l.off[k];
+      top[k] = std::uint16_t(p[0]) | (std::uint32_t(std::uint16_t(p[l.dx[k]])) << 16);
+      bottom[k] = std::uint16_t(p[l.dy[k]]) | (std::uint32_t(std::uint16_t(p[l.dy[k]+l.dx[k]])) << 16);
+      std::memcpy(&w[k], weights + 4*l.f[k], 8);
+    }
+    const __m128 w01 = _mm_castsi128_ps(_mm_set_epi64x(w[1], w[0]));
+    const __m128 w23 = _mm_castsi128_ps(_mm_set_epi64x(w[3], w[2]));
+    const __m128i wTop = _mm_castps_si128(_mm_shuffle_ps(w01, w23, _MM_SHUFFLE(2,0,2,0)));
+    const __m128i wBottom = _mm_castps_si128(_mm_shuffle_ps(w01, w23, _MM_SHUFFLE(3,1,3,1)));
+    __m128i r = _mm_add_epi32(_mm_madd_epi16(_mm_load_si128(reinterpret_cast<const __m128i*>(top)), wTop),
+                              _mm_madd_epi16(_mm_load_si128(reinterpret_cast<const __m128i*>(bottom)), wBottom));
+    r = _mm_add_epi32(r, _mm_set1_epi32(1 << (CMap::WEIGHT_BITS-1)));
+    return _mm_andnot_si128(l.invalid, _mm_srai_epi32(r, CMap::WEIGHT_BITS));
+  }
+
+  inline void store_lin4(const icl8u *s, const Lanes &l, icl8u *d, int m){
+    const __m128i r = lin4_int(s, l);
+    const __m128i p = _mm_packus_epi16(_mm_packs_epi32(r, r), r);
+    const int packed = _mm_cvtsi128_si32(p);
+    std::memcpy(d, &packed, m);
+  }
+
+  inline void store_lin4(const icl16s *s, const Lanes &l, icl16s *d, int m){
+    const __m128i r = lin4_int(s, l);
+    alignas(16) icl16s packed[8];
+    _mm_store_si128(reinterpret_cast<__m128i*>(packed), _mm_packs_epi32(r, r));
+    std::memcpy(d, packed, m * sizeof(icl16s));
+  }
+
+  /// 32f: the weights of 4 pixels are transposed, so each product is a
+  /// single vector multiplication (same summation order as in C++)
+  inline void store_lin4(const icl32f *s, const Lanes &l, icl32f *d, int m){
+    const float *weights = CMap::getFloatWeights();
+    alignas(16) float a[4], b[4], c[4], e[4];
+    for(int k = 0; k < 4; ++k){
+      const icl32f *p = s + l.off[k];
+      a[k] = p[0]; b[k] = p[l.dx[k]]; c[k] = p[l.dy[k]]; e[k] = p[l.dy[k]+l.dx[k]];
+    }
+    __m128 w0 = _mm_loadu_ps(weights + 4*l.f[0]), w1 = _mm_loadu_ps(weights + 4*l.f[1]);
+    __m128 w2 = _mm_loadu_ps(weights + 4*l.f[2]), w3 = _mm_loadu_ps(weights + 4*l.f[3]);
+    _MM_TRANSPOSE4_PS(w0, w1, w2, w3);
+    __m128 r = _mm_add_ps(_mm_mul_ps(w0, _mm_load_ps(a)), _mm_mul_ps(w1, _mm_load_ps(b)));
+    r = _mm_add_ps(r, _mm_mul_ps(w2, _mm_load_ps(c)));
+    r = _mm_add_ps(r, _mm_mul_ps(w3, _mm_load_ps(e)));
+    r = _mm_andnot_ps(_mm_castsi128_ps(l.invalid), r);
+    if(m == 4){
+      _mm_storeu_ps(d, r);
+    }else{
+      alignas(16) float tmp[4];
+      _mm_store_ps(tmp, r);
+      std::memcpy(d, tmp, m * sizeof(float));
+    }
+  }
+
+  template<class T>
+  inline void simd_row_lin(const T *s, int sw, const std::int16_t *xy,
+                           const std::uint16_t *fr, T *d, int n){
+    int i = 0;
+    for(; i + 4 <= n; i += 4){
+      store_lin4(s, Lanes(xy + 2*i, fr + i, sw), d + i, 4);
+    }
+    if(i < n){
+      // pad the remaining entries with invalid ones
+      std::int16_t xyTail[8] = {-1,-1,-1,-1,-1,-1,-1,-1};
+      std::uint16_t frTail[4] = {0,0,0,0};
+      std::memcpy(xyTail, xy + 2*i, 2*(n-i)*sizeof(std::int16_t));
+      std::memcpy(frTail, fr + i, (n-i)*sizeof(std::uint16_t));
+      store_lin4(s, Lanes(xyTail, frTail, sw), d + i, n - i);
+    }
+  }
+
+  template<class T>
+  void simd_compact_warp(const Img<T> &src, Img<T> &dst, const CMap &map,
+                         const Point &warpOffset, scalemode mode){
+    const int mw = map.getSize().width, sw = src.getWidth(), dw = dst.getWidth();
+    const Rect r = dst.getROI();
+    for(int c = 0; c < src.getChannels(); ++c){
+      const T *s = src.begin(c);
+      for(int ty = r.y; ty < r.bottom(); ty += TILE_H){
+        const int ey = std::min(ty + TILE_H, r.bottom());
+        for(int tx = r.x; tx < r.right(); tx += TILE_W){
+          const int n = std::min(TILE_W, r.right() - tx);
+          for(int y = ty; y < ey; ++y){
+            const int idx = (y + warpOffset.y) * mw + tx + warpOffset.x;
+            T *d = dst.begin(c) + y*dw + tx;
+            if(mode == interpolateNN){
+              compact_row_nn(s, sw, map.getCoords() + 2*idx, map.getFractions() + idx, d, n);
+            }else{
+              simd_row_lin(s, sw, map.getCoords() + 2*idx, map.getFractions() + idx, d, n);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  void simd_warp_compact(const Image& src, Image& dst, const CMap &map,
+                         Point warpOffset, scalemode mode) {
+    switch(src.getDepth()){
+      case depth8u:  simd_compact_warp(src.as8u(), dst.as8u(), map, warpOffset, mode); break;
+      case depth16s: simd_compact_warp(src.as16s(), dst.as16s(), map, warpOffset, mode); break;
+      case depth32f: simd_compact_warp(src.as32f(), dst.as32f(), map, warpOffset, mode); break;
+      default: break;
+    }
+  }
+
+  static int _reg = [] {
+    auto simd = WOp::prototype().backends(Backend::Simd);
+    simd.add<WOp::WarpCompactSig>(WOp::Op::warpCompact, simd_warp_compact,
+      applicableTo<icl8u, icl16s, icl32f>, "SSE2 tiled fixed point warp");
+    return 0;
+  }();
+
+} // anonymous namespace
+
+#endif // ICL_HAVE_SSE2
@@ -59,7 +59,7 @@ namespace icl::filter {
     if(!prepare(dst, src)) return;
     src.visitWith(dst, [this](const auto &s, auto &d) {
       using T = typename std::remove_reference_t<decltype(s)>::type;
-      visitROILinesPerChannelWith(s, d, [this](const T *sp, T *dp, int ch, int w) {
+      visitROILinesPerChannelWithMT(s, d, [this](const T *sp, T *dp, int ch, int w) {
         icl64f wt = m_vecWeights[ch];
         for(int i = 0; i < w; ++i) {
           dp[i] = clipped_cast<icl64f, T>(static_cast<icl64f>(sp[i]) * wt);
@@ -53,8 +53,11 @@ namespace icl::filter {
     // property callbacks.
     std::scoped_lock lock(m_applyMutex);
     if(!prepare(dst, src)) return;
-    getSelector<WienerSig>(Op::apply).resolve(src)->apply(
-      src, dst, getMaskSize(), getAnchor(), getROIOffset(), m_fNoise);
+    applyBands(getSelector<WienerSig>(Op::apply).resolve(src), dst,
+               [&](auto &impl, Image &band, int y0){
+                 impl.apply(shiftRows(src, y0), band, getMaskSize(), getAnchor(),
+                            getROIOffset(), m_fNoise);
+               });
   }
 
   REGISTER_CONFIGURABLE(WienerOp, return new WienerOp(utils::Size(3,3)));
@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// ICL - Image Component Library (https://github.com/iclcv/icl)
+// Copyright (C) 2006-2026 Christof Elbrechter
+
+#pragma once
+
+#include <icl/utils/CompatMacros.h>
+#include <icl/utils/Rect.h>
+#include <icl/core/Img.h>
+
+#include <algorithm>
+#include <cmath>
+
+// both AffineOp backends must sample exactly the same source coordinates
+ICL_NO_FP_CONTRACT
+
+namespace icl::filter::detail {
+  // ================================================================
+  // Row-wise inverse mapping of the AffineOp backends. Shared by the
+  // C++ and Simd backends, which therefore agree bitwise.
+  // ================================================================
+
+  /// Inverse mapping of one destination row
+  /** Destination pixel (x,y) maps to xs = m[0][0]*x + m[1][0]*y + m[2][0],
+      ys = m[0][1]*x + m[1][1]*y + m[2][1]. Rows are walked left to right,
+      the y-dependent part is computed once per row, so each pixel only
+      costs one multiply-add per coordinate. */
+  struct RowMapping {
+    double bx, by; ///< source coordinates of x = 0 in this row
+    double dx, dy; ///< source step per destination pixel
+    inline float x(int x) const { return static_cast<float>(bx + dx*x); }
+    inline float y(int x) const { return static_cast<float>(by + dy*x); }
+  };
+
+  /// mapping of destination row y for the inverse matrix inv
+  inline RowMapping row_mapping(const double inv[3][3], int y){
+    return { inv[1][0]*y + inv[2][0], inv[1][1]*y + inv[2][1], inv[0][0], inv[0][1] };
+  }
+
+  /// Largest [x0,x1) within [sx,ex) with 0 <= xs < maxX and 0 <= ys < maxY
+  /** The mapped coordinates are monotonic in x, so the valid pixels form an
+      interval: it is estimated analytically (widened by one pixel to absorb
+      rounding) and then shrunk with the exact float predicate, so it holds
+      exactly the pixels the per-pixel test would accept. */
+  inline void safe_span(const RowMapping &m, float maxX, float maxY, int sx, int ex, int &x0, int &x1){
+    double lo = sx, hi = ex;
+    auto clip = [&](double b, double d, double max){
+      if(d > 0){
+        lo = std::max(lo, -b/d - 1);
+        hi = std::min(hi, (max-b)/d + 1);
+      }else if(d < 0){
+        lo = std::max(lo, (max-b)/d - 1);
+        hi = std::min(hi, -b/d + 1);
+      }
+    };
+    clip(m.bx, m.dx, maxX);
+    clip(m.by, m.dy, maxY);
+    if(!(lo < hi)){
+      x0 = x1 = sx;
+      return;
+    }
+    auto valid = [&](int x){
+      const float xs = m.x(x), ys = m.y(x);
+      return xs >= 0 && xs < maxX && ys >= 0 && ys < maxY;
+    };
+    x0 = static_cast<int>(std::floor(lo));
+    x1 = static_cast<int>(std::ceil(hi));
+    while(x0 < x1 && !valid(x0)) ++x0;
+    while(x0 < x1 && !valid(x1-1)) --x1;
+  }
+
+  /// nearest neighbour sample of destination pixel x (0 outside the ROI r)
+  template<class T>
+  inline T affine_nn(const RowMapping &m, int x, const core::Channel<T> &src, const utils::Rect &r){
+    const int x3 = static_cast<int>(std::round(m.x(x)));
+    const int y3 = static_cast<int>(std::round(m.y(x)));
+    return r.contains(x3,y3) ? src(x3,y3) : T(0);
+  }
+}
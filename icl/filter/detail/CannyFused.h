@@ -0,0 +1,140 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// ICL - Image Component Library (https://github.com/iclcv/icl)
+// Copyright (C) 2006-2026 Christof Elbrechter
+
+#pragma once
+
+#include <icl/core/Img.h>
+#include <icl/core/Image.h>
+
+#include <cstdlib>
+#include <vector>
+
+namespace icl::filter::detail {
+  // ================================================================
+  // Fused 8u Canny: 3x3 Sobel gradient, quantized direction and
+  // non-maximum suppression, row by row. Shared by the CannyOp fused8u
+  // backends, which provide vectorized versions of the two row kernels.
+  //
+  // The results equal those of the separate path (16s Sobel derivatives,
+  // CannyOp::applyCanny16s): the float test on dx/dy against tan(67.5)
+  // and tan(22.5) is replaced by the integer tests below, which give the
+  // same decisions for all |dx|,|dy| <= 1020 (checked exhaustively).
+  // ================================================================
+
+  /// quantized gradient directions (neighbours compared in the NMS)
+  enum CannyDirection : icl8u {
+    cannyVertical = 0,    //!< up and down (also for a zero gradient)
+    cannyHorizontal = 1,  //!< left and right
+    cannyDiagonal = 2,    //!< up-left and down-right (dx, dy with equal signs)
+    cannyAntiDiagonal = 3 //!< down-left and up-right
+  };
+
+  /// |dx|/|dy| >= tan(67.5) as used by the float path
+  constexpr int CANNY_STEEP_DX = 408, CANNY_STEEP_DY = 985;
+
+  inline icl8u canny_direction(int dx, int dy){
+    const int ax = std::abs(dx), ay = std::abs(dy);
+    if(!(dx | dy)) return cannyVertical;
+    if(ax * CANNY_STEEP_DX >= ay * CANNY_STEEP_DY) return cannyHorizontal;
+    if(ax * CANNY_STEEP_DY > ay * CANNY_STEEP_DX) return (dx ^ dy) >= 0 ? cannyDiagonal : cannyAntiDiagonal;
+    return cannyVertical;
+  }
+
+  /// gradient magnitudes and directions of result columns [x0,x1)
+  /** r0, r1, r2 are three consecutive source rows; result column x is
+      centered at source column x+1 */
+  inline void canny_gradient_row(const icl8u *r0, const icl8u *r1, const icl8u *r2,
+                                 int x0, int x1, icl16s *mag, icl8u *dir){
+    for(int x = x0; x < x1; ++x){
+      const int dx = (r0[x] + 2*r1[x] + r2[x]) - (r0[x+2] + 2*r1[x+2] + r2[x+2]);
+      const int dy = (r0[x] + 2*r0[x+1] + r0[x+2]) - (r2[x] + 2*r2[x+1] + r2[x+2]);
+      mag[x] = std::abs(dx) + std::abs(dy);
+      dir[x] = canny_direction(dx, dy);
+    }
+  }
+
+  /// non-maximum suppression of result columns [x0,x1) of the row with magnitudes m1
+  /** m0 and m2 are the rows above and below; columns x0-1 and x1 must be
+      readable. Writes 0 (suppressed or below low), 1 (weak) or 2 (mag > high) */
+  inline void canny_nms_row(const icl16s *m0, const icl16s *m1, const icl16s *m2,
+                            const icl8u *dir, int x0, int x1, int low, int high, icl8u *dst){
+    for(int x = x0; x < x1; ++x){
+      const int m = m1[x];
+      int a, b;
+      switch(dir[x]){
+        case cannyHorizontal: a = m1[x-1]; b = m1[x+1]; break;
+        case cannyDiagonal:   a = m0[x-1]; b = m2[x+1]; break;
+        case cannyAntiDiagonal: a = m2[x-1]; b = m0[x+1]; break;
+        default:              a = m0[x];   b = m2[x];   break;
+      }
+      dst[x] = (m < low || m < a || m < b) ? 0 : (m > high ? 2 : 1);
+    }
+  }
+
+  /// source pixels the result is computed for
+  /** As for the derivative operators (see NeighborhoodOp::computeROI), the
+      source ROI is clipped to the pixels with a complete 3x3 neighbourhood;
+      the result has the size of this rect */
+  template<class I>
+  inline utils::Rect canny_result_rect(const I &src){
+    return src.getROI() & utils::Rect(1, 1, src.getWidth() - 2, src.getHeight() - 2);
+  }
+
+  /// computes the fused result rows [y0, y0 + dst ROI height) for all channels
+  /** GradientRow and NMSRow have the signatures of canny_gradient_row and
+      canny_nms_row. Rows and columns on the border of the full result are
+      set to 0, as in the separate path */
+  template<class GradientRow, class NMSRow>
+  void canny_fused_band(const core::Img8u &src, core::Img8u &dst, int y0, int low, int high,
+                        GradientRow gradientRow, NMSRow nmsRow){
+    const utils::Rect sr = canny_result_rect(src), dr = dst.getROI();
+    const int w = sr.width, h = sr.height, sw = src.getWidth(), dw = dst.getWidth();
+    if(w <= 0 || h <= 0) return;
+
+    // ring buffer of three magnitude and direction rows; the magnitude
+    // rows are padded, as the NMS reads one element beyond each end
+    const int pad = 16;
+    std::vector<icl16s> magBuf(3 * (w + 2*pad));
+    std::vector<icl8u> dirBuf(3 * (w + pad));
+    icl16s *mags[3];
+    icl8u *dirs[3];
+    for(int i = 0; i < 3; ++i){
+      mags[i] = magBuf.data() + i * (w + 2*pad) + pad;
+      dirs[i] = dirBuf.data() + i * (w + pad);
+    }
+
+    for(int c = 0; c < src.getChannels(); ++c){
+      // upper left pixel of the first 3x3 neighbourhood
+      const icl8u *s = src.getData(c) + (sr.y - 1) * sw + (sr.x - 1);
+      icl8u *d = dst.getROIData(c);
+
+      // magnitudes of result row r (-1 on the result border)
+      auto computeRow = [&](int r, int slot){
+        icl16s *m = mags[slot];
+        if(r <= 0 || r >= h - 1){
+          std::fill(m - 1, m + w + 1, icl16s(-1));
+          return;
+        }
+        const icl8u *r0 = s + r * sw;
+        gradientRow(r0, r0 + sw, r0 + 2*sw, 0, w, m, dirs[slot]);
+        m[-1] = m[0] = m[w-1] = m[w] = -1;
+      };
+
+      computeRow(y0 - 1, 0);
+      computeRow(y0, 1);
+      for(int j = 0; j < dr.height; ++j){
+        const int y = y0 + j;
+        const int above = j % 3, center = (j + 1) % 3, below = (j + 2) % 3;
+        computeRow(y + 1, below);
+        icl8u *out = d + j * dw;
+        if(y <= 0 || y >= h - 1 || w < 3){
+          std::fill(out, out + w, icl8u(0));
+          continue;
+        }
+        out[0] = out[w-1] = 0;
+        nmsRow(mags[above], mags[center], mags[below], dirs[center], 1, w - 1, low, high, out);
+      }
+    }
+  }
+} // namespace icl::filter::detail
@@ -0,0 +1,33 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// ICL - Image Component Library (https://github.com/iclcv/icl)
+// Copyright (C) 2006-2026 Christof Elbrechter
+
+#pragma once
+
+#include <icl/filter/WarpOp.h>
+
+#include <cstdint>
+
+namespace icl::filter::detail {
+  // ================================================================
+  // Row kernels for remapping with a CompactWarpMap, shared by the
+  // WarpOp backends.
+  // ================================================================
+
+  /// Nearest neighbour remapping of n pixels of one destination row
+  /** s is the source channel with width sw, xy and fr are the map's
+      integer coordinates and fractional indices for the row. Pixels that
+      map outside the source (negative x) become 0. */
+  template<class T>
+  inline void compact_row_nn(const T *s, int sw, const std::int16_t *xy,
+                             const std::uint16_t *fr, T *d, int n){
+    using CMap = CompactWarpMap;
+    const int half = CMap::FRAC_SIZE/2, mask = CMap::FRAC_SIZE-1;
+    for(int i = 0; i < n; ++i){
+      if(xy[2*i] < 0){ d[i] = T(0); continue; }
+      const int x = xy[2*i] + ((fr[i] & mask) >= half);
+      const int y = xy[2*i+1] + ((fr[i] >> CMap::FRAC_BITS) >= half);
+      d[i] = s[x + y*sw];
+    }
+  }
+}
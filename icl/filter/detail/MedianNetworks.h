@@ -0,0 +1,107 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// ICL - Image Component Library (https://github.com/iclcv/icl)
+// Copyright (C) 2006-2026 Christof Elbrechter
+
+#pragma once
+
+#include <algorithm>
+
+namespace icl::filter::detail {
+  // ================================================================
+  // Median sorting network core functions
+  // Templated on value type V: works for both scalar types (T)
+  // and SIMD types (icl128, icl128i8u, icl128i16s).
+  // ADL finds icl::utils::min/max for SIMD, std::min/max for scalars.
+  // Shared by the MedianOp backends and other 3x3/5x5 median filters.
+  // ================================================================
+
+  template<class V>
+  inline void minmax(V &a, V &b) {
+    using std::min; using std::max;
+    V t = a; a = min(t, b); b = max(t, b);
+  }
+
+  template<class V>
+  inline V median3x3_core(V a0, V a1, V a2, V b0, V b1, V b2, V c0, V c1, V c2) {
+    using std::min; using std::max;
+
+    V A1 = min(a1, a2); a2 = max(a1, a2);
+    a1 = max(a0, A1); a0 = min(a0, A1);
+    A1 = min(a1, a2); a2 = max(a1, a2);
+
+    V B1 = min(b1, b2); b2 = max(b1, b2);
+    b1 = max(b0, B1); b0 = min(b0, B1);
+    B1 = min(b1, b2); b2 = max(b1, b2);
+
+    V C1 = min(c1, c2); c2 = max(c1, c2);
+    c1 = max(c0, C1); c0 = min(c0, C1);
+    C1 = min(c1, c2); c2 = max(c1, c2);
+
+    a0 = max(a0, max(b0, c0));
+    a2 = min(a2, min(b2, c2));
+    b1 = min(B1, C1); b2 = max(B1, C1);
+    b1 = max(A1, b1);
+    a1 = min(b1, b2);
+
+    b1 = min(a1, a2); b2 = max(a1, a2);
+    b1 = max(a0, b1);
+    return min(b1, b2);
+  }
+
+  template<class V>
+  inline V median5x5_core(V r00, V r01, V r02, V r03, V r04,
+                          V r05, V r06, V r07, V r08, V r09,
+                          V r10, V r11, V r12, V r13, V r14,
+                          V r15, V r16, V r17, V r18, V r19,
+                          V r20, V r21, V r22, V r23, V r24) {
+    using std::min; using std::max;
+
+    minmax(r00, r01);
+    minmax(r03, r04); minmax(r02, r04); minmax(r02, r03);
+    minmax(r06, r07); minmax(r05, r07); minmax(r05, r06);
+    minmax(r02, r05);
+    minmax(r03, r06); minmax(r00, r06); minmax(r00, r03);
+    minmax(r04, r07); minmax(r01, r07); minmax(r01, r04);
+
+    minmax(r09, r10); minmax(r08, r10); minmax(r08, r09);
+    minmax(r12, r13); minmax(r11, r13); minmax(r11, r12);
+    minmax(r15, r16); minmax(r14, r16); minmax(r14, r15);
+    minmax(r11, r14); minmax(r08, r14); minmax(r08, r11);
+    minmax(r12, r15); minmax(r09, r15); minmax(r09, r12);
+    minmax(r13, r16); minmax(r10, r16); minmax(r10, r13);
+
+    minmax(r18, r19); minmax(r17, r19); minmax(r17, r18);
+    minmax(r21, r22); minmax(r20, r22); minmax(r20, r21);
+    minmax(r23, r24);
+    minmax(r20, r23); minmax(r17, r23); minmax(r17, r20);
+    minmax(r21, r24); minmax(r18, r24); minmax(r18, r21);
+    minmax(r19, r22);
+
+    r17 = max(r08, r17);
+    minmax(r09, r18); minmax(r00, r18); minmax(r00, r09);
+    r09 = max(r00, r09);
+    minmax(r10, r19); minmax(r01, r19); minmax(r01, r10);
+    minmax(r11, r20); minmax(r02, r20); r11 = max(r02, r11);
+    minmax(r12, r21); minmax(r03, r21); minmax(r03, r12);
+    minmax(r13, r22); minmax(r04, r22); r04 = min(r04, r22);
+    minmax(r04, r13);
+    minmax(r14, r23); minmax(r05, r23); minmax(r05, r14);
+    minmax(r15, r24); r06 = min(r06, r24); minmax(r06, r15);
+    r07 = min(r07, r16); r07 = min(r07, r19);
+    r13 = min(r13, r21); r15 = min(r15, r23);
+    r07 = min(r07, r13); r07 = min(r07, r15);
+    r09 = max(r01, r09); r11 = max(r03, r11);
+    r17 = max(r05, r17); r17 = max(r11, r17); r17 = max(r09, r17);
+    minmax(r04, r10); minmax(r06, r12); minmax(r07, r14);
+    minmax(r04, r06); r07 = max(r04, r07);
+    minmax(r12, r14); r10 = min(r10, r14);
+    minmax(r06, r07); minmax(r10, r12); minmax(r06, r10);
+    r17 = max(r06, r17);
+    minmax(r12, r17); r07 = min(r07, r17);
+    minmax(r07, r10); minmax(r12, r18);
+    r12 = max(r07, r12); r10 = min(r10, r18);
+    minmax(r12, r20); r10 = min(r10, r20);
+
+    return max(r10, r12);
+  }
+} // namespace icl::filter::detail
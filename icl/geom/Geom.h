@@ -48,6 +48,7 @@
     -# SoftPosit (icl::SoftPosit)
     -# Pose estimation for coplanar points (icl::CoplanarPointPoseEstimator)
     -# ICP (Iterative Closest utils::Point) (icl:ICP)
+    -# Point-to-plane ICP for dense point clouds (icl::PointToPlaneICP)
 
 
     \section _3D_VIS_ 3D Visualization
@@ -36,6 +36,13 @@
 #endif
 
 #include <icl/geom/PointCloudNormalEstimator.h>
+#include <icl/filter/detail/MedianNetworks.h>
+#include <icl/utils/SSETypes.h>
+#include <icl/utils/ThreadPool.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
 
 namespace icl {
 
@@ -304,6 +311,317 @@ struct Vec4 {
 };
 #endif
 
+// CPU implementation: row kernels that are shared by the single processing
+// steps and by the fused pipeline of calculate(). Normals are stored as 4
+// floats (x,y,z,w) per pixel. All kernels process the rows [y0,y1) only, so
+// the images are processed in parallel row bands.
+namespace {
+	using filter::detail::median3x3_core;
+	using filter::detail::median5x5_core;
+
+	/// rows per parallel band
+	constexpr int BAND_ROWS = 16;
+
+	/// rows of a float image, where row(first) is the first available row
+	struct RowView {
+		const float *data;
+		int first;
+		int w;
+		const float *row(int y) const {
+			return data + (y - first) * w;
+		}
+	};
+
+	/// median filtering of the rows [y0,y1) of src into dst (dst points to row y0)
+	/** Pixels closer than (size-1)/2 to the image border are copied. */
+	void median_rows(const float *src, float *dst, int w, int h, int size,
+			int y0, int y1) {
+		const int k = (size - 1) / 2;
+		std::vector<float> list(size * size);
+		for (int y = y0; y < y1; ++y) {
+			const float *s = src + y * w;
+			float *d = dst + (y - y0) * w;
+			if (y < k || y >= h - k || w <= 2 * k) {
+				std::copy(s, s + w, d);
+				continue;
+			}
+			std::copy(s, s + k, d);
+			std::copy(s + w - k, s + w, d + w - k);
+			const int xe = w - k;
+			int x = k;
+			if (size == 3) {
+				const float *l0 = s - w - 1, *l1 = s - 1, *l2 = s + w - 1;
+#ifdef ICL_HAVE_SSE2
+				for (; x + 4 <= xe; x += 4) {
+					median3x3_core<icl128>(l0 + x, l0 + x + 1, l0 + x + 2,
+							l1 + x, l1 + x + 1, l1 + x + 2,
+							l2 + x, l2 + x + 1, l2 + x + 2).storeu(d + x);
+				}
+#endif
+				for (; x < xe; ++x) {
+					d[x] = median3x3_core<float>(l0[x], l0[x + 1], l0[x + 2],
+							l1[x], l1[x + 1], l1[x + 2],
+							l2[x], l2[x + 1], l2[x + 2]);
+				}
+			} else if (size == 5) {
+				const float *l0 = s - 2 * w - 2, *l1 = s - w - 2, *l2 = s - 2,
+						*l3 = s + w - 2, *l4 = s + 2 * w - 2;
+#ifdef ICL_HAVE_SSE2
+				for (; x + 4 <= xe; x += 4) {
+					median5x5_core<icl128>(l0 + x, l0 + x + 1, l0 + x + 2, l0 + x + 3, l0 + x + 4,
+							l1 + x, l1 + x + 1, l1 + x + 2, l1 + x + 3, l1 + x + 4,
+							l2 + x, l2 + x + 1, l2 + x + 2, l2 + x + 3, l2 + x + 4,
+							l3 + x, l3 + x + 1, l3 + x + 2, l3 + x + 3, l3 + x + 4,
+							l4 + x, l4 + x + 1, l4 + x + 2, l4 + x + 3, l4 + x + 4).storeu(d + x);
+				}
+#endif
+				for (; x < xe; ++x) {
+					d[x] = median5x5_core<float>(l0[x], l0[x + 1], l0[x + 2], l0[x + 3], l0[x + 4],
+							l1[x], l1[x + 1], l1[x + 2], l1[x + 3], l1[x + 4],
+							l2[x], l2[x + 1], l2[x + 2], l2[x + 3], l2[x + 4],
+							l3[x], l3[x + 1], l3[x + 2], l3[x + 3], l3[x + 4],
+							l4[x], l4[x + 1], l4[x + 2], l4[x + 3], l4[x + 4]);
+				}
+			} else {
+				const int mid = size * size / 2;
+				for (; x < xe; ++x) {
+					float *l = list.data();
+					for (int sy = -k; sy <= k; ++sy) {
+						for (int sx = -k; sx <= k; ++sx) {
+							*l++ = s[sy * w + x + sx];
+						}
+					}
+					std::nth_element(list.begin(), list.begin() + mid, list.end());
+					d[x] = list[mid];
+				}
+			}
+		}
+	}
+
+	/// normals of the rows [y0,y1) (cross product of two vectors spanned by depth(x-r,y-r),
+	/// depth(x+r,y-r) and depth(x,y+r)); depth must provide the rows y-r and y+r
+	/** Normals closer than r to the image border are set to (0,0,0,w), interior normals
+		get w=1. The computation is exactly the same as the original scalar version. */
+	void normal_rows(const RowView &depth, float *normals, int w, int h, int r,
+			int y0, int y1) {
+		// fa = (2r, 0, a), fb = (r, 2r, b), n = fa x fb
+		const float fa0 = 2 * r, fa1 = 0, fb0 = r, fb1 = 2 * r;
+		const float nz = fa0 * fb1 - fa1 * fb0;
+		for (int y = y0; y < y1; ++y) {
+			float *n = normals + 4 * y * w;
+			if (y < r || y >= h - r || w <= 2 * r) {
+				for (int x = 0; x < w; ++x) {
+					n[4 * x] = n[4 * x + 1] = n[4 * x + 2] = 0;
+				}
+				continue;
+			}
+			for (int x = 0; x < r; ++x) {
+				n[4 * x] = n[4 * x + 1] = n[4 * x + 2] = 0;
+				n[4 * (w - 1 - x)] = n[4 * (w - 1 - x) + 1] = n[4 * (w - 1 - x) + 2] = 0;
+			}
+			const float *top = depth.row(y - r), *bottom = depth.row(y + r);
+			int x = r;
+			const int xe = w - r;
+#ifdef ICL_HAVE_SSE2
+			const __m128 vfa0 = _mm_set1_ps(fa0), vfa1 = _mm_set1_ps(fa1);
+			const __m128 vfb0 = _mm_set1_ps(fb0), vfb1 = _mm_set1_ps(fb1);
+			const __m128 vnz = _mm_set1_ps(nz);
+			for (; x + 4 <= xe; x += 4) {
+				const __m128 tl = _mm_loadu_ps(top + x - r);
+				const __m128 a = _mm_sub_ps(_mm_loadu_ps(top + x + r), tl);
+				const __m128 b = _mm_sub_ps(_mm_loadu_ps(bottom + x), tl);
+				__m128 vx = _mm_sub_ps(_mm_mul_ps(vfa1, b), _mm_mul_ps(a, vfb1));
+				__m128 vy = _mm_sub_ps(_mm_mul_ps(a, vfb0), _mm_mul_ps(vfa0, b));
+				const __m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx),
+						_mm_mul_ps(vy, vy)), _mm_mul_ps(vnz, vnz)));
+				vx = _mm_div_ps(vx, len);
+				vy = _mm_div_ps(vy, len);
+				__m128 vz = _mm_div_ps(vnz, len);
+				__m128 vw = _mm_set1_ps(1);
+				_MM_TRANSPOSE4_PS(vx, vy, vz, vw);
+				_mm_storeu_ps(n + 4 * x, vx);
+				_mm_storeu_ps(n + 4 * x + 4, vy);
+				_mm_storeu_ps(n + 4 * x + 8, vz);
+				_mm_storeu_ps(n + 4 * x + 12, vw);
+			}
+#endif
+			for (; x < xe; ++x) {
+				const float a = top[x + r] - top[x - r], b = bottom[x] - top[x - r];
+				const float vx = fa1 * b - a * fb1, vy = a * fb0 - fa0 * b;
+				const float len = std::sqrt(vx * vx + vy * vy + nz * nz);
+				n[4 * x] = vx / len;
+				n[4 * x + 1] = vy / len;
+				n[4 * x + 2] = nz / len;
+				n[4 * x + 3] = 1;
+			}
+		}
+	}
+
+	/// weighted average of the normals in a (2l+1)x(2l+1) neighborhood for the rows [y0,y1)
+	/** The weights are given by the outer product of k (2l+1 values) with itself, divided
+		by norm; the average is computed separably. Normals closer than l to the image
+		border (all normals if l is 0) are copied. */
+	void smooth_rows(const float *normals, float *out, int w, int h, const float *k,
+			int l, float norm, int y0, int y1) {
+		std::vector<float> col(4 * w);
+		for (int y = y0; y < y1; ++y) {
+			const float *src = normals + 4 * y * w;
+			float *dst = out + 4 * y * w;
+			if (l == 0 || y < l || y >= h - l || w <= 2 * l) {
+				std::copy(src, src + 4 * w, dst);
+				continue;
+			}
+			std::fill(col.begin(), col.end(), 0.f);
+			for (int j = -l; j <= l; ++j) {
+				const float *s = normals + 4 * (y + j) * w;
+				const float kj = k[j + l];
+				for (int i = 0; i < 4 * w; ++i) {
+					col[i] += kj * s[i];
+				}
+			}
+			std::copy(src, src + 4 * l, dst);
+			std::copy(src + 4 * (w - l), src + 4 * w, dst + 4 * (w - l));
+			for (int x = l; x < w - l; ++x) {
+				float sum[4] = { 0, 0, 0, 0 };
+				for (int i = -l; i <= l; ++i) {
+					const float *c = col.data() + 4 * (x + i);
+					for (int e = 0; e < 3; ++e) {
+						sum[e] += k[i + l] * c[e];
+					}
+				}
+				for (int e = 0; e < 3; ++e) {
+					dst[4 * x + e] = sum[e] / norm;
+				}
+				dst[4 * x + 3] = 1;
+			}
+		}
+	}
+
+	/// angle image (mean cosine of the normal to its neighbors in 8 directions, mode
+	/// 0 takes the minimum, mode 1 the mean of the directions) for the rows [y0,y1)
+	/** If bin is given, the binarized angle image is computed as well. Pixels closer
+		than range to the image border are set to 0. */
+	void angle_rows(const float *normals, float *angle, icl8u *bin, float threshold,
+			int w, int h, int range, int mode, int y0, int y1) {
+		const float fr = range;
+		for (int y = y0; y < y1; ++y) {
+			float *a = angle + y * w;
+			if (y < range || y >= h - range || w <= 2 * range) {
+				std::fill(a, a + w, 0.f);
+			} else {
+				std::fill(a, a + range, 0.f);
+				std::fill(a + w - range, a + w, 0.f);
+				int x = range;
+				const int xe = w - range;
+#ifdef ICL_HAVE_SSE2
+				const __m128 signMask = _mm_set1_ps(-0.f);
+				for (; x + 4 <= xe; x += 4) {
+					const float *c = normals + 4 * (y * w + x);
+					__m128 cx = _mm_loadu_ps(c), cy = _mm_loadu_ps(c + 4);
+					__m128 cz = _mm_loadu_ps(c + 8), cw = _mm_loadu_ps(c + 12);
+					_MM_TRANSPOSE4_PS(cx, cy, cz, cw);
+					// r, l, t, b, tr, tl, br, bl
+					__m128 sum[8];
+					for (int d = 0; d < 8; ++d) {
+						sum[d] = _mm_setzero_ps();
+					}
+					for (int z = 1; z <= range; ++z) {
+						const int offs[8] = { z, -z, w * z, -w * z, w * z + z, w * z - z,
+								-w * z + z, -w * z - z };
+						for (int d = 0; d < 8; ++d) {
+							const float *o = c + 4 * offs[d];
+							__m128 ox = _mm_loadu_ps(o), oy = _mm_loadu_ps(o + 4);
+							__m128 oz = _mm_loadu_ps(o + 8), ow = _mm_loadu_ps(o + 12);
+							_MM_TRANSPOSE4_PS(ox, oy, oz, ow);
+							const __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, ox),
+									_mm_mul_ps(cy, oy)), _mm_mul_ps(cz, oz));
+							// angles larger than 90 degree are flipped
+							sum[d] = _mm_add_ps(sum[d], _mm_andnot_ps(signMask, dot));
+						}
+					}
+					const __m128 vr = _mm_set1_ps(fr);
+					for (int d = 0; d < 8; ++d) {
+						sum[d] = _mm_div_ps(sum[d], vr);
+					}
+					if (mode == 0) {
+						__m128 m = sum[0];
+						const int order[7] = { 1, 2, 3, 7, 6, 5, 4 };
+						for (int d : order) {
+							m = _mm_min_ps(sum[d], m);
+						}
+						_mm_storeu_ps(a + x, m);
+					} else if (mode == 1) {
+						__m128 m = sum[0];
+						for (int d = 1; d < 8; ++d) {
+							m = _mm_add_ps(m, sum[d]);
+						}
+						_mm_storeu_ps(a + x, _mm_div_ps(m, _mm_set1_ps(8)));
+					}
+				}
+#endif
+				for (; x < xe; ++x) {
+					const float *c = normals + 4 * (y * w + x);
+					float sum[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+					for (int z = 1; z <= range; ++z) {
+						const int offs[8] = { z, -z, w * z, -w * z, w * z + z, w * z - z,
+								-w * z + z, -w * z - z };
+						for (int d = 0; d < 8; ++d) {
+							const float *o = c + 4 * offs[d];
+							sum[d] += std::fabs(c[0] * o[0] + c[1] * o[1] + c[2] * o[2]);
+						}
+					}
+					for (int d = 0; d < 8; ++d) {
+						sum[d] /= fr;
+					}
+					if (mode == 0) {
+						float m = sum[0];
+						const int order[7] = { 1, 2, 3, 7, 6, 5, 4 };
+						for (int d : order) {
+							m = sum[d] < m ? sum[d] : m;
+						}
+						a[x] = m;
+					} else if (mode == 1) {
+						float m = sum[0];
+						for (int d = 1; d < 8; ++d) {
+							m += sum[d];
+						}
+						a[x] = m / 8;
+					}
+				}
+			}
+			if (bin) {
+				icl8u *b = bin + y * w;
+				for (int x = 0; x < w; ++x) {
+					b[x] = a[x] > threshold ? 255 : 0;
+				}
+			}
+		}
+	}
+
+	/// Gaussian (binomial) smoothing kernel for the given averaging range
+	/** returns the kernel radius l; the 2D-kernel is k*k^T/norm */
+	int gauss_kernel(int range, float k[7], float &norm) {
+		static const float k3[3] = { 1, 2, 1 }, k5[5] = { 1, 4, 6, 4, 1 },
+				k7[7] = { 1, 6, 15, 20, 15, 6, 1 };
+		if (range <= 1) {
+			k[0] = 1;
+			norm = 1;
+			return 0;
+		} else if (range <= 3) {
+			std::copy(k3, k3 + 3, k);
+			norm = 16;
+			return 1;
+		} else if (range <= 5) {
+			std::copy(k5, k5 + 5, k);
+			norm = 256;
+			return 2;
+		}
+		std::copy(k7, k7 + 7, k);
+		norm = 4096;
+		return 3;
+	}
+}
+
 struct PointCloudNormalEstimator::Data {
 	Data(const Size &size) {
 		//set default values
@@ -541,32 +859,13 @@ void PointCloudNormalEstimator::applyMedianFilter() {
 		}
 #endif
 	} else {
-		// TODO: heavily optimize this (MedianOp ??)
-		std::vector < icl32f > list;
-		for (int y = 0; y < m_data->h; y++) {
-			for (int x = 0; x < m_data->w; x++) {
-				if (y < (m_data->medianFilterSize - 1) / 2
-						|| y >= m_data->h - (m_data->medianFilterSize - 1) / 2
-						|| x < (m_data->medianFilterSize - 1) / 2
-						|| x >= m_data->w - (m_data->medianFilterSize - 1) / 2) {
-					m_data->filteredImage(x, y, 0) = m_data->rawImage(x, y, 0); //pixel out of range
-				} else {
-					for (int sx = -(m_data->medianFilterSize - 1) / 2;
-							sx <= (m_data->medianFilterSize - 1) / 2; sx++) {
-						for (int sy = -(m_data->medianFilterSize - 1) / 2;
-								sy <= (m_data->medianFilterSize - 1) / 2;
-								sy++) {
-							list.push_back(m_data->rawImage(x + sx, y + sy, 0));
-						}
-					}
-					std::sort(list.begin(), list.end());
-					m_data->filteredImage(x, y, 0) =
-							list[m_data->medianFilterSize
-									* m_data->medianFilterSize / 2];
-					list.clear();
-				}
-			}
-		}
+		Data &d = *m_data;
+		d.filteredImage.detach();
+		const float *src = d.rawImage.begin(0);
+		float *dst = d.filteredImage.begin(0);
+		ThreadPool::global().parallelFor(0, d.h, BAND_ROWS, [&](int y0, int y1) {
+			median_rows(src, dst + y0 * d.w, d.w, d.h, d.medianFilterSize, y0, y1);
+		});
 	}
 }
 
@@ -618,41 +917,12 @@ void PointCloudNormalEstimator::applyNormalCalculation() {
 		}
 #endif
 	} else {
-		const int r = m_data->normalRange;
-		Vec fa1, fb1, n1, n01;
-		for (int y = 0; y < m_data->h; y++) {
-			for (int x = 0; x < m_data->w; x++) {
-				int i = x + m_data->w * y;
-				if (y < r || y >= m_data->h - r || x < r
-						|| x >= m_data->w - r) {
-					m_data->normals[i].x = 0; //points out of range
-					m_data->normals[i].y = 0;
-					m_data->normals[i].z = 0;
-				} else {
-					//cross product normal determination
-					fa1[0] = (x + r) - (x - r);
-					fa1[1] = (y - r) - (y - r);
-					fa1[2] = m_data->filteredImage(x + r, y - r, 0)
-							- m_data->filteredImage(x - r, y - r, 0);
-					fb1[0] = (x) - (x - r);
-					fb1[1] = (y + r) - (y - r);
-					fb1[2] = m_data->filteredImage(x, y + r, 0)
-							- m_data->filteredImage(x - r, y - r, 0);
-
-					n1[0] = fa1[1] * fb1[2] - fa1[2] * fb1[1];
-					n1[1] = fa1[2] * fb1[0] - fa1[0] * fb1[2];
-					n1[2] = fa1[0] * fb1[1] - fa1[1] * fb1[0];
-					n01[0] = n1[0] / norm3(n1);
-					n01[1] = n1[1] / norm3(n1);
-					n01[2] = n1[2] / norm3(n1);
-
-					m_data->normals[i].x = n01[0];
-					m_data->normals[i].y = n01[1];
-					m_data->normals[i].z = n01[2];
-					m_data->normals[i].w = 1;
-				}
-			}
-		}
+		Data &d = *m_data;
+		const RowView depth = { d.filteredImage.begin(0), 0, d.w };
+		float *normals = reinterpret_cast<float*>(d.normals);
+		ThreadPool::global().parallelFor(0, d.h, BAND_ROWS, [&](int y0, int y1) {
+			normal_rows(depth, normals, d.w, d.h, d.normalRange, y0, y1);
+		});
 	}
 
 	if (m_data->useNormalAveraging && !m_data->useGaussSmoothing) {
@@ -677,88 +947,32 @@ void PointCloudNormalEstimator::applyTemporalNormalAveraging() {
 		}
 #endif
 	} else {
-		const int r = m_data->normalAveragingRange;
-		for (int y = 0; y < m_data->h; y++) {
-			for (int x = 0; x < m_data->w; x++) {
-				int i = x + m_data->w * y;
-				if (y < r || y >= m_data->h - r || x < r
-						|| x >= m_data->w - r) {
-					m_data->avgNormals[i] = m_data->normals[i];
-				} else {
-					Vec4 avg;
-					avg.x = 0, avg.y = 0, avg.z = 0, avg.w = 0;
-					for (int sx = -r; sx <= r; sx++) {
-						for (int sy = -r; sy <= r; sy++) {
-							avg.x += m_data->normals[(x + sx)
-									+ m_data->w * (y + sy)].x;
-							avg.y += m_data->normals[(x + sx)
-									+ m_data->w * (y + sy)].y;
-							avg.z += m_data->normals[(x + sx)
-									+ m_data->w * (y + sy)].z;
-						}
-					}
-					avg.x /= ((1 + 2 * r) * (1 + 2 * r));
-					avg.y /= ((1 + 2 * r) * (1 + 2 * r));
-					avg.z /= ((1 + 2 * r) * (1 + 2 * r));
-					avg.w = 1;
-					m_data->avgNormals[i] = avg;
-				}
-			}
-		}
+		Data &d = *m_data;
+		const int r = d.normalAveragingRange;
+		const std::vector<float> k(2 * r + 1, 1.f);
+		const float norm = (1 + 2 * r) * (1 + 2 * r);
+		const float *normals = reinterpret_cast<const float*>(d.normals);
+		float *avg = reinterpret_cast<float*>(d.avgNormals);
+		ThreadPool::global().parallelFor(0, d.h, BAND_ROWS, [&](int y0, int y1) {
+			smooth_rows(normals, avg, d.w, d.h, k.data(), r, norm, y0, y1);
+		});
 	}
 }
 
 void PointCloudNormalEstimator::applyGaussianNormalSmoothing() {
-	float norm = 1;
-	DynMatrix<float> kernel = DynMatrix<float>(1, 1, 0.0);
-	int l = 0;
-	[[maybe_unused]] int kSize = 1;
-	[[maybe_unused]] int rowSize = 1;
-
-	if (m_data->normalAveragingRange <= 1) {
-		// nothing!
-	} else if (m_data->normalAveragingRange <= 3) {
-		norm = 16.;
-		l = 1;
-		kSize = 3 * 3;
-		rowSize = 3;
-		DynMatrix<float> k1 = DynMatrix<float>(1, 3, 0.0);
-		k1(0, 0) = 1.;
-		k1(1, 0) = 2.;
-		k1(2, 0) = 1.;
-		kernel = k1 * k1.transp();
-	} else if (m_data->normalAveragingRange <= 5) {
-		norm = 256.;
-		l = 2;
-		kSize = 5 * 5;
-		rowSize = 5;
-		DynMatrix<float> k1 = DynMatrix<float>(1, 5, 0.0);
-		k1(0, 0) = 1.;
-		k1(1, 0) = 4.;
-		k1(2, 0) = 6.;
-		k1(3, 0) = 4.;
-		k1(4, 0) = 1.;
-		kernel = k1 * k1.transp();
-	} else {
-		norm = 4096.;
-		l = 3;
-		kSize = 7 * 7;
-		rowSize = 7;
-		DynMatrix<float> k1 = DynMatrix<float>(1, 7, 0.0);
-		k1(0, 0) = 1.;
-		k1(1, 0) = 6.;
-		k1(2, 0) = 15.;
-		k1(3, 0) = 20.;
-		k1(4, 0) = 15.;
-		k1(5, 0) = 6.;
-		k1(6, 0) = 1.;
-		kernel = k1 * k1.transp();
-	}
+	float k[7], norm;
+	const int l = gauss_kernel(m_data->normalAveragingRange, k, norm);
 	if (m_data->useCL == true && m_data->clReady == true) {
 #ifdef ICL_HAVE_OPENCL
 		try {
-
-			m_data->gaussKernelBuffer = m_data->program.createBuffer("rw", kSize * sizeof(float), static_cast<void *>(&kernel[0]));
+			const int rowSize = 2 * l + 1;
+			std::vector<float> kernel(rowSize * rowSize);
+			for (int i = 0; i < rowSize; ++i) {
+				for (int j = 0; j < rowSize; ++j) {
+					kernel[i * rowSize + j] = k[i] * k[j];
+				}
+			}
+			m_data->gaussKernelBuffer = m_data->program.createBuffer("rw", kernel.size() * sizeof(float), kernel.data());
 
 			m_data->kernelNormalGaussSmoothing.setArgs(m_data->normalsBuffer,
 					m_data->avgNormalsBuffer,
@@ -775,36 +989,12 @@ void PointCloudNormalEstimator::applyGaussianNormalSmoothing() {
 		}
 #endif
 	} else {
-		for (int y = 0; y < m_data->h; y++) {
-			for (int x = 0; x < m_data->w; x++) {
-				int i = x + m_data->w * y;
-				if (y < l || y >= m_data->h - l || x < l || x >= m_data->w - l
-						|| l == 0) {
-					m_data->avgNormals[i] = m_data->normals[i];
-				} else {
-					Vec4 avg;
-					avg.x = 0, avg.y = 0, avg.z = 0, avg.w = 0;
-					for (int sx = -l; sx <= l; sx++) {
-						for (int sy = -l; sy <= l; sy++) {
-							avg.x += m_data->normals[(x + sx)
-									+ m_data->w * (y + sy)].x
-									* kernel(sy + l, sx + l);
-							avg.y += m_data->normals[(x + sx)
-									+ m_data->w * (y + sy)].y
-									* kernel(sy + l, sx + l);
-							avg.z += m_data->normals[(x + sx)
-									+ m_data->w * (y + sy)].z
-									* kernel(sy + l, sx + l);
-						}
-					}
-					avg.x /= norm;
-					avg.y /= norm;
-					avg.z /= norm;
-					avg.w = 1;
-					m_data->avgNormals[i] = avg;
-				}
-			}
-		}
+		Data &d = *m_data;
+		const float *normals = reinterpret_cast<const float*>(d.normals);
+		float *avg = reinterpret_cast<float*>(d.avgNormals);
+		ThreadPool::global().parallelFor(0, d.h, BAND_ROWS, [&](int y0, int y1) {
+			smooth_rows(normals, avg, d.w, d.h, k, l, norm, y0, y1);
+		});
 	}
 }
 
@@ -983,124 +1173,17 @@ void PointCloudNormalEstimator::applyAngleImageCalculation() {
 		}
 #endif
 	} else {
-		Vec4 * norm;
-		if (m_data->useNormalAveraging == true) {
-			norm = m_data->avgNormals;
-		} else {
-			norm = m_data->normals;
-		}
-		const int w = m_data->w, h = m_data->h;
-		for (int y = 0; y < h; y++) {
-			for (int x = 0; x < w; x++) {
-				int i = x + w * y;
-				if (y < m_data->neighborhoodRange
-						|| y >= h - (m_data->neighborhoodRange)
-						|| x < m_data->neighborhoodRange
-						|| x >= w - (m_data->neighborhoodRange)) {
-					m_data->angleImage(x, y, 0) = 0;
-				} else {
-					float snr = 0; //sum right
-					float snl = 0; //sum left
-					float snt = 0; //sum top
-					float snb = 0; //sum bottom
-					float sntr = 0; //sum top-right
-					float sntl = 0; //sum top-left
-					float snbr = 0; //sum bottom-right
-					float snbl = 0; //sum bottom-left
-					for (int z = 1; z <= m_data->neighborhoodRange; z++) {
-						//angle between normals
-						float nr = (norm[i].x * norm[i + z].x
-								+ norm[i].y * norm[i + z].y
-								+ norm[i].z * norm[i + z].z);
-						float nl = (norm[i].x * norm[i - z].x
-								+ norm[i].y * norm[i - z].y
-								+ norm[i].z * norm[i - z].z);
-						float nt = (norm[i].x * norm[i + w * z].x
-								+ norm[i].y * norm[i + w * z].y
-								+ norm[i].z * norm[i + w * z].z);
-						float nb = (norm[i].x * norm[i - w * z].x
-								+ norm[i].y * norm[i - w * z].y
-								+ norm[i].z * norm[i - w * z].z);
-						float ntr = (norm[i].x * norm[i + w * z + z].x
-								+ norm[i].y * norm[i + w * z + z].y
-								+ norm[i].z * norm[i + w * z + z].z);
-						float ntl = (norm[i].x * norm[i + w * z - z].x
-								+ norm[i].y * norm[i + w * z - z].y
-								+ norm[i].z * norm[i + w * z - z].z);
-						float nbr = (norm[i].x * norm[i - w * z + z].x
-								+ norm[i].y * norm[i - w * z + z].y
-								+ norm[i].z * norm[i - w * z + z].z);
-						float nbl = (norm[i].x * norm[i - w * z - z].x
-								+ norm[i].y * norm[i - w * z - z].y
-								+ norm[i].z * norm[i - w * z - z].z);
-						//flip if angle is bigger than 90°
-						if (nr < cos(M_PI / 2))
-							nr = cos(M_PI - acos(nr));
-						if (nl < cos(M_PI / 2))
-							nl = cos(M_PI - acos(nl));
-						if (nt < cos(M_PI / 2))
-							nt = cos(M_PI - acos(nt));
-						if (nb < cos(M_PI / 2))
-							nb = cos(M_PI - acos(nb));
-						if (ntr < cos(M_PI / 2))
-							ntr = cos(M_PI - acos(ntr));
-						if (ntl < cos(M_PI / 2))
-							ntl = cos(M_PI - acos(ntl));
-						if (nbr < cos(M_PI / 2))
-							nbr = cos(M_PI - acos(nbr));
-						if (nbl < cos(M_PI / 2))
-							nbl = cos(M_PI - acos(nbl));
-
-						snr += nr;
-						snl += nl;
-						snt += nt;
-						snb += nb;
-						sntr += ntr;
-						sntl += ntl;
-						snbr += nbr;
-						snbl += nbl;
-					}
-					snr /= m_data->neighborhoodRange;
-					snl /= m_data->neighborhoodRange;
-					snt /= m_data->neighborhoodRange;
-					snb /= m_data->neighborhoodRange;
-					sntr /= m_data->neighborhoodRange;
-					sntl /= m_data->neighborhoodRange;
-					snbr /= m_data->neighborhoodRange;
-					snbl /= m_data->neighborhoodRange;
-
-					if (m_data->neighborhoodMode == 0) {
-						m_data->angleImage(x, y, 0) = snr;
-						if (m_data->angleImage(x, y, 0) > snl) {
-							m_data->angleImage(x, y, 0) = snl;
-						}
-						if (m_data->angleImage(x, y, 0) > snt) {
-							m_data->angleImage(x, y, 0) = snt;
-						}
-						if (m_data->angleImage(x, y, 0) > snb) {
-							m_data->angleImage(x, y, 0) = snb;
-						}
-						if (m_data->angleImage(x, y, 0) > snbl) {
-							m_data->angleImage(x, y, 0) = snbl;
-						}
-						if (m_data->angleImage(x, y, 0) > snbr) {
-							m_data->angleImage(x, y, 0) = snbr;
-						}
-						if (m_data->angleImage(x, y, 0) > sntl) {
-							m_data->angleImage(x, y, 0) = sntl;
-						}
-						if (m_data->angleImage(x, y, 0) > sntr) {
-							m_data->angleImage(x, y, 0) = sntr;
-						}
-					} else if (m_data->neighborhoodMode == 1) {
-						m_data->angleImage(x, y, 0) = (snr + snl + snt + snb
-								+ sntr + sntl + snbr + snbl) / 8;
-					} else {
-						std::cout << "Unknown neighborhood mode" << std::endl;
-					}
-				}
-			}
+		Data &d = *m_data;
+		const Vec4 *norm = d.useNormalAveraging ? d.avgNormals : d.normals;
+		if (d.neighborhoodMode != 0 && d.neighborhoodMode != 1) {
+			std::cout << "Unknown neighborhood mode" << std::endl;
 		}
+		d.angleImage.detach();
+		float *angle = d.angleImage.begin(0);
+		ThreadPool::global().parallelFor(0, d.h, BAND_ROWS, [&](int y0, int y1) {
+			angle_rows(reinterpret_cast<const float*>(norm), angle, nullptr, 0, d.w, d.h,
+					d.neighborhoodRange, d.neighborhoodMode, y0, y1);
+		});
 	}
 }
 
@@ -1149,16 +1232,16 @@ void PointCloudNormalEstimator::applyImageBinarization() {
 		}
 #endif
 	} else {
-		for (int y = 0; y < m_data->h; y++) {
-			for (int x = 0; x < m_data->w; x++) {
-				if (m_data->angleImage(x, y, 0)
-						> m_data->binarizationThreshold) {
-					m_data->binarizedImage(x, y, 0) = 255;
-				} else {
-					m_data->binarizedImage(x, y, 0) = 0;
-				}
+		Data &d = *m_data;
+		d.binarizedImage.detach();
+		const float *angle = d.angleImage.begin(0);
+		icl8u *bin = d.binarizedImage.begin(0);
+		const float t = d.binarizationThreshold;
+		ThreadPool::global().parallelFor(0, d.w * d.h, BAND_ROWS * d.w, [&](int i0, int i1) {
+			for (int i = i0; i < i1; ++i) {
+				bin[i] = angle[i] > t ? 255 : 0;
 			}
-		}
+		});
 	}
 }
 
@@ -1221,8 +1304,67 @@ bool PointCloudNormalEstimator::isCLActive() {
 	return m_data->useCL;
 }
 
+void PointCloudNormalEstimator::calculateCPU(const Img32f &depthImage,
+		bool filter, bool average, bool gauss) {
+	Data &d = *m_data;
+	d.useNormalAveraging = average;
+	d.useGaussSmoothing = gauss;
+	const int w = d.w, h = d.h;
+	float *normals = reinterpret_cast<float*>(d.normals);
+
+	// median filter and normals: each band filters its rows plus the rows
+	// that are needed for its normals, only its own rows are written back
+	if (filter) {
+		d.rawImage = depthImage;
+		d.filteredImage.detach();
+	} else {
+		d.filteredImage = depthImage;
+	}
+	const float *raw = d.rawImage.begin(0);
+	float *filtered = d.filteredImage.begin(0);
+	const int r = d.normalRange;
+	ThreadPool::global().parallelFor(0, h, 2 * BAND_ROWS, [&](int y0, int y1) {
+		if (!filter) {
+			normal_rows(RowView{ filtered, 0, w }, normals, w, h, r, y0, y1);
+			return;
+		}
+		const int b0 = std::max(0, y0 - r), b1 = std::min(h, y1 + r);
+		std::vector<float> band((b1 - b0) * w);
+		median_rows(raw, band.data(), w, h, d.medianFilterSize, b0, b1);
+		std::copy(band.begin() + (y0 - b0) * w, band.begin() + (y1 - b0) * w, filtered + y0 * w);
+		normal_rows(RowView{ band.data(), b0, w }, normals, w, h, r, y0, y1);
+	});
+
+	// smoothing needs the neighboring normals of all bands
+	if (average) {
+		if (gauss) {
+			applyGaussianNormalSmoothing();
+		} else {
+			applyTemporalNormalAveraging();
+		}
+	}
+
+	// angle image and binarization
+	const float *norm = reinterpret_cast<const float*>(average ? d.avgNormals : d.normals);
+	if (d.neighborhoodMode != 0 && d.neighborhoodMode != 1) {
+		std::cout << "Unknown neighborhood mode" << std::endl;
+	}
+	d.angleImage.detach();
+	d.binarizedImage.detach();
+	float *angle = d.angleImage.begin(0);
+	icl8u *bin = d.binarizedImage.begin(0);
+	ThreadPool::global().parallelFor(0, h, BAND_ROWS, [&](int y0, int y1) {
+		angle_rows(norm, angle, bin, d.binarizationThreshold, w, h,
+				d.neighborhoodRange, d.neighborhoodMode, y0, y1);
+	});
+}
+
 const Img8u &PointCloudNormalEstimator::calculate(const Img32f &depthImage,
 		bool filter, bool average, bool gauss) {
+	if (!(m_data->useCL == true && m_data->clReady == true)) {
+		calculateCPU(depthImage, filter, average, gauss);
+		return m_data->binarizedImage;
+	}
 	if (filter == false) {
 		setFilteredDepthImage(depthImage);
 	} else {
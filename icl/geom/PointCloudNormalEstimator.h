@@ -40,11 +40,29 @@ namespace icl::geom {
       -# gaussian normal smoothing
       -# ... ???
 
+      \section CPU CPU Implementation
+
+      Without OpenCL (or if setUseCL(false) is set), all steps are computed
+      in parallel row bands using the global utils::ThreadPool. Median
+      filtering (3x3 and 5x5), normal calculation (cross products) and the
+      angle image are vectorized with SSE2. calculate() uses a fused
+      pipeline: each band filters the depth rows it needs and computes its
+      normals directly from them, and the angle image is binarized right
+      away. Only the normal smoothing, which needs the normals of the
+      neighboring bands, is a separate pass. Intermediate results are
+      still available afterwards. The single steps (applyMedianFilter()
+      etc.) use the same parallel implementation.
+
+      Please note: angles larger than 90 degree are flipped by taking the
+      absolute value of the normals' dot product.
    */
   class ICLGeom_API PointCloudNormalEstimator {
     struct Data;  //!< internal data type
     Data *m_data; //!< internal data pointer
 
+    /// fused CPU implementation of calculate()
+    void calculateCPU(const core::Img32f &depthImage, bool filter, bool average, bool gauss);
+
    public:
     PointCloudNormalEstimator(const PointCloudNormalEstimator&) = delete;
     PointCloudNormalEstimator& operator=(const PointCloudNormalEstimator&) = delete;
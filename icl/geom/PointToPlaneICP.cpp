@@ -0,0 +1,357 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// ICL - Image Component Library (https://github.com/iclcv/icl)
+// Copyright (C) 2006-2026 Christof Elbrechter
+
+#include <icl/geom/PointToPlaneICP.h>
+#include <icl/geom/PointCloudObjectBase.h>
+#include <icl/math/FlatKDTree.h>
+#include <icl/utils/Exception.h>
+#include <icl/utils/ThreadPool.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace icl::utils;
+using namespace icl::math;
+using namespace icl::core;
+
+namespace icl::geom {
+  namespace {
+    /// source points per parallel chunk; partial sums are added per chunk
+    constexpr int CHUNK_SIZE = 2048;
+
+    /// normal equations of the linearized point-to-plane problem
+    struct NormalEquations {
+      double A[21] = {0};  //!< upper triangle of J^T J (row-major)
+      double b[6] = {0};   //!< J^T r
+      double error = 0;    //!< sum of squared residuals
+      int n = 0;           //!< number of correspondences
+
+      inline void add(const float j[6], float r){
+        for(int i = 0, k = 0; i < 6; ++i){
+          for(int l = i; l < 6; ++l, ++k) A[k] += double(j[i]) * j[l];
+          b[i] += double(j[i]) * r;
+        }
+        error += double(r) * r;
+        ++n;
+      }
+
+      inline void add(const NormalEquations &o){
+        for(int i = 0; i < 21; ++i) A[i] += o.A[i];
+        for(int i = 0; i < 6; ++i) b[i] += o.b[i];
+        error += o.error;
+        n += o.n;
+      }
+
+      /// solves A x = -b using a Cholesky decomposition
+      bool solve(double x[6]) const {
+        double L[6][6] = {{0}};
+        for(int i = 0, k = 0; i < 6; ++i){
+          for(int l = i; l < 6; ++l, ++k) L[l][i] = A[k];
+        }
+        for(int j = 0; j < 6; ++j){
+          double d = L[j][j];
+          for(int k = 0; k < j; ++k) d -= L[j][k] * L[j][k];
+          if(!(d > 1e-12 * std::max(1.0, std::fabs(L[j][j])))) return false;
+          L[j][j] = std::sqrt(d);
+          for(int i = j + 1; i < 6; ++i){
+            double s = L[i][j];
+            for(int k = 0; k < j; ++k) s -= L[i][k] * L[j][k];
+            L[i][j] = s / L[j][j];
+          }
+        }
+        double y[6];
+        for(int i = 0; i < 6; ++i){
+          double s = -b[i];
+          for(int k = 0; k < i; ++k) s -= L[i][k] * y[k];
+          y[i] = s / L[i][i];
+        }
+        for(int i = 5; i >= 0; --i){
+          double s = y[i];
+          for(int k = i + 1; k < 6; ++k) s -= L[k][i] * x[k];
+          x[i] = s / L[i][i];
+        }
+        return true;
+      }
+    };
+
+    inline bool is_finite(const Vec &v){
+      return std::isfinite(v[0]) && std::isfinite(v[1]) && std::isfinite(v[2]);
+    }
+
+    inline bool is_valid_normal(const Vec &n){
+      const float l = n[0]*n[0] + n[1]*n[1] + n[2]*n[2];
+      return std::isfinite(l) && l > 0.25f;
+    }
+
+    /// rigid transform for the rotation vector w (axis-angle) and translation t
+    Mat4D64f rigid_transform(const double w[3], const double t[3]){
+      const double angle = std::sqrt(w[0]*w[0] + w[1]*w[1] + w[2]*w[2]);
+      Mat4D64f T = Mat4D64f::id();
+      if(angle > 0){
+        const double x = w[0]/angle, y = w[1]/angle, z = w[2]/angle;
+        const double c = std::cos(angle), s = std::sin(angle), C = 1 - c;
+        T(0,0) = x*x*C + c;   T(0,1) = x*y*C - z*s; T(0,2) = x*z*C + y*s;
+        T(1,0) = y*x*C + z*s; T(1,1) = y*y*C + c;   T(1,2) = y*z*C - x*s;
+        T(2,0) = z*x*C - y*s; T(2,1) = z*y*C + x*s; T(2,2) = z*z*C + c;
+      }
+      T(0,3) = t[0];
+      T(1,3) = t[1];
+      T(2,3) = t[2];
+      return T;
+    }
+  } // anonymous namespace
+
+  struct PointToPlaneICP::Data {
+    int maxIterations;
+    float maxDistance;
+    int levels;
+    float rotationThreshold = 1e-5f;
+    float translationThreshold = 1e-2f;
+
+    std::vector<Vec> targetXYZ;
+    std::vector<Vec> targetNormals;
+    std::vector<unsigned char> targetValid;   //!< finite point with valid normal
+    Size targetSize = Size::null;             //!< null for unorganized targets
+
+    bool hasCamera = false;
+    Mat projection;                           //!< camera's P*C
+
+    FlatKDTree<float> tree;                   //!< valid target points
+    std::vector<int> treeIndex;               //!< tree index -> target index
+    bool treeValid = false;
+
+    bool projective() const {
+      return hasCamera && targetSize != Size::null;
+    }
+
+    void buildTree(){
+      std::vector<float> pts;
+      treeIndex.clear();
+      for(size_t i = 0; i < targetXYZ.size(); ++i){
+        if(!targetValid[i]) continue;
+        treeIndex.push_back(int(i));
+        pts.insert(pts.end(), {targetXYZ[i][0], targetXYZ[i][1], targetXYZ[i][2]});
+      }
+      tree.build(pts.data(), int(treeIndex.size()), 3, true);
+      treeValid = true;
+    }
+
+    /// returns the target index corresponding to p, or -1
+    /** For nearest neighbour association, match is the tree index of the
+        point's previous match (or -1): its distance bounds the search,
+        which is then mostly confined to a few leaves */
+    inline int associate(const float p[3], int &match) const {
+      if(projective()){
+        const Mat &Q = projection;
+        const float w = Q(3,0)*p[0] + Q(3,1)*p[1] + Q(3,2)*p[2] + Q(3,3);
+        if(!(w > 0)) return -1;
+        const float u = (Q(0,0)*p[0] + Q(0,1)*p[1] + Q(0,2)*p[2] + Q(0,3)) / w;
+        const float v = (Q(1,0)*p[0] + Q(1,1)*p[1] + Q(1,2)*p[2] + Q(1,3)) / w;
+        if(!(u >= -0.5f && u < targetSize.width - 0.5f &&
+             v >= -0.5f && v < targetSize.height - 0.5f)) return -1;
+        const int idx = int(v + 0.5f) * targetSize.width + int(u + 0.5f);
+        return targetValid[idx] ? idx : -1;
+      }
+      float bound = maxDistance * maxDistance;
+      if(match >= 0){
+        const Vec &q = targetXYZ[treeIndex[match]];
+        const float d[3] = { p[0] - q[0], p[1] - q[1], p[2] - q[2] };
+        bound = std::min(bound, d[0]*d[0] + d[1]*d[1] + d[2]*d[2]);
+      }
+      const int i = tree.nearestWithin(p, bound);
+      if(i >= 0) match = i;
+      return match < 0 ? -1 : treeIndex[match];
+    }
+
+    /// accumulates the normal equations for the given source points
+    NormalEquations accumulate(const std::vector<Vec> &src, std::vector<int> &matches,
+                               const Mat &T) const {
+      const int n = int(src.size()), chunks = (n + CHUNK_SIZE - 1) / CHUNK_SIZE;
+      const float maxDist2 = maxDistance * maxDistance;
+      std::vector<NormalEquations> partial(chunks);
+      parallelFor(0, chunks, 1, [&](int c0, int c1){
+        for(int c = c0; c < c1; ++c){
+          NormalEquations &eq = partial[c];
+          const int end = std::min(n, (c + 1) * CHUNK_SIZE);
+          for(int i = c * CHUNK_SIZE; i < end; ++i){
+            const Vec &s = src[i];
+            const float p[3] = {
+              T(0,0)*s[0] + T(0,1)*s[1] + T(0,2)*s[2] + T(0,3),
+              T(1,0)*s[0] + T(1,1)*s[1] + T(1,2)*s[2] + T(1,3),
+              T(2,0)*s[0] + T(2,1)*s[1] + T(2,2)*s[2] + T(2,3)
+            };
+            const int idx = associate(p, matches[i]);
+            if(idx < 0) continue;
+            const Vec &q = targetXYZ[idx], &nq = targetNormals[idx];
+            const float d[3] = { p[0] - q[0], p[1] - q[1], p[2] - q[2] };
+            if(d[0]*d[0] + d[1]*d[1] + d[2]*d[2] > maxDist2) continue;
+            const float j[6] = {
+              p[1]*nq[2] - p[2]*nq[1],
+              p[2]*nq[0] - p[0]*nq[2],
+              p[0]*nq[1] - p[1]*nq[0],
+              nq[0], nq[1], nq[2]
+            };
+            eq.add(j, d[0]*nq[0] + d[1]*nq[1] + d[2]*nq[2]);
+          }
+        }
+      });
+      NormalEquations sum;
+      for(const NormalEquations &eq : partial) sum.add(eq);
+      return sum;
+    }
+  };
+
+  PointToPlaneICP::Result::Result():
+    transform(Mat::id()), error(0), iterations(0), correspondences(0), converged(false){}
+
+  PointToPlaneICP::PointToPlaneICP(int maxIterations, float maxDistance, int levels):
+    m_data(new Data){
+    setMaxIterations(maxIterations);
+    setMaxDistance(maxDistance);
+    setLevels(levels);
+  }
+
+  PointToPlaneICP::~PointToPlaneICP(){
+    delete m_data;
+  }
+
+  void PointToPlaneICP::setTarget(const DataSegment<float,4> &xyzh,
+                                  const DataSegment<float,4> &normals){
+    if(xyzh.getDim() != normals.getDim()){
+      throw ICLException("PointToPlaneICP::setTarget: xyzh and normals differ in size");
+    }
+    const int n = xyzh.getDim();
+    Data &d = *m_data;
+    d.targetXYZ.resize(n);
+    d.targetNormals.resize(n);
+    d.targetValid.resize(n);
+    parallelFor(0, n, 4096, [&](int a, int b){
+      for(int i = a; i < b; ++i){
+        d.targetXYZ[i] = xyzh[i];
+        d.targetNormals[i] = normals[i];
+        d.targetValid[i] = is_finite(xyzh[i]) && is_valid_normal(normals[i]);
+      }
+    });
+    d.targetSize = xyzh.isOrganized() ? xyzh.getSize() : Size::null;
+    d.treeValid = false;
+  }
+
+  void PointToPlaneICP::setTarget(const PointCloudObjectBase &target){
+    setTarget(target.selectXYZH(), target.selectNormal());
+  }
+
+  void PointToPlaneICP::setTargetCamera(const Camera &camera){
+    m_data->projection = camera.getProjectionMatrix() * camera.getCSTransformationMatrix();
+    m_data->hasCamera = true;
+  }
+
+  void PointToPlaneICP::removeTargetCamera(){
+    m_data->hasCamera = false;
+  }
+
+  bool PointToPlaneICP::usesProjectiveAssociation() const {
+    return m_data->projective();
+  }
+
+  PointToPlaneICP::Result PointToPlaneICP::apply(const DataSegment<float,4> &xyzh,
+                                                 const Mat &initialTransform){
+    Data &d = *m_data;
+    if(d.targetXYZ.empty()){
+      throw ICLException("PointToPlaneICP::apply: no target given");
+    }
+    if(!d.projective() && !d.treeValid){
+      d.buildTree();
+    }
+
+    const bool organized = xyzh.isOrganized();
+    const int n = xyzh.getDim(), w = organized ? xyzh.getSize().width : n;
+    const int h = organized ? xyzh.getSize().height : 1;
+
+    Mat4D64f T;
+    std::copy(initialTransform.begin(), initialTransform.end(), T.begin());
+
+    Result r;
+    std::vector<Vec> src;
+    for(int level = d.levels - 1; level >= 0; --level){
+      // subsampled source: every step-th point per direction for organized
+      // clouds and every step^2-th point otherwise
+      const int step = 1 << level;
+      src.clear();
+      for(int y = 0; y < h; y += step){
+        const int xStep = organized ? step : step * step;
+        for(int x = 0; x < w; x += xStep){
+          const Vec &p = xyzh[x + y * w];
+          if(is_finite(p)) src.push_back(p);
+        }
+      }
+
+      std::vector<int> matches(src.size(), -1);
+      r.converged = false;
+      for(int it = 0; it < d.maxIterations; ++it){
+        Mat Tf;
+        std::copy(T.begin(), T.end(), Tf.begin());
+        const NormalEquations eq = d.accumulate(src, matches, Tf);
+        ++r.iterations;
+        r.correspondences = eq.n;
+        r.error = eq.n ? float(std::sqrt(eq.error / eq.n)) : 0;
+
+        double x[6];
+        if(eq.n < 6 || !eq.solve(x)) break;
+        T = rigid_transform(x, x + 3) * T;
+
+        const double angle = std::sqrt(x[0]*x[0] + x[1]*x[1] + x[2]*x[2]);
+        const double trans = std::sqrt(x[3]*x[3] + x[4]*x[4] + x[5]*x[5]);
+        if(angle < d.rotationThreshold && trans < d.translationThreshold){
+          r.converged = true;
+          break;
+        }
+      }
+    }
+    std::copy(T.begin(), T.end(), r.transform.begin());
+    return r;
+  }
+
+  PointToPlaneICP::Result PointToPlaneICP::apply(const PointCloudObjectBase &source,
+                                                 const Mat &initialTransform){
+    return apply(source.selectXYZH(), initialTransform);
+  }
+
+  void PointToPlaneICP::setMaxIterations(int maxIterations){
+    m_data->maxIterations = std::max(1, maxIterations);
+  }
+
+  int PointToPlaneICP::getMaxIterations() const {
+    return m_data->maxIterations;
+  }
+
+  void PointToPlaneICP::setMaxDistance(float maxDistance){
+    m_data->maxDistance = maxDistance;
+  }
+
+  float PointToPlaneICP::getMaxDistance() const {
+    return m_data->maxDistance;
+  }
+
+  void PointToPlaneICP::setLevels(int levels){
+    m_data->levels = std::max(1, levels);
+  }
+
+  int PointToPlaneICP::getLevels() const {
+    return m_data->levels;
+  }
+
+  void PointToPlaneICP::setConvergenceThresholds(float rotation, float translation){
+    m_data->rotationThreshold = rotation;
+    m_data->translationThreshold = translation;
+  }
+
+  float PointToPlaneICP::getRotationThreshold() const {
+    return m_data->rotationThreshold;
+  }
+
+  float PointToPlaneICP::getTranslationThreshold() const {
+    return m_data->translationThreshold;
+  }
+} // namespace icl::geom
@@ -0,0 +1,162 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// ICL - Image Component Library (https://github.com/iclcv/icl)
+// Copyright (C) 2006-2026 Christof Elbrechter
+
+#pragma once
+
+#include <icl/utils/CompatMacros.h>
+#include <icl/core/DataSegment.h>
+#include <icl/geom/GeomDefs.h>
+#include <icl/geom/Camera.h>
+
+namespace icl::geom {
+  /** \cond */
+  class PointCloudObjectBase;
+  /** \endcond */
+
+  /// Point-to-plane ICP for dense point clouds
+  /** In contrast to ICP and ICP3D, which work on lists of single points
+      and minimize point-to-point distances, this class registers whole
+      point clouds as they are provided by PointCloudObjectBase: the
+      source and the target are passed as XYZH DataSegments, and the
+      target needs normals as well (e.g. from PointCloudNormalEstimator
+      or PointCloudObjectBase::selectNormal()).
+
+      Each iteration minimizes the sum of squared point-to-plane
+      distances ((T p - q) . n)^2 over all correspondences (p,q), where n
+      is the normal of the target point q. The problem is linearized for
+      small rotations, and the resulting 6x6 normal equations are solved
+      by a Cholesky decomposition. The incremental rotation is applied
+      exactly (axis-angle), so the accumulated transform stays rigid.
+
+      \section ASSOC Data Association
+
+      Correspondences are found in one of two ways:
+      - <b>projective association</b>: if the target is organized and the
+        camera it was captured with is given (setTargetCamera()), each
+        transformed source point is projected into the target image, and
+        the target point at that pixel is used. This costs one projection
+        per point and is the method of choice for consecutive depth
+        camera frames.
+      - <b>nearest neighbour association</b>: otherwise, the closest
+        target point is searched in a math::FlatKDTree. The tree is built
+        lazily (in parallel) by the first apply() call that uses nearest
+        neighbour association after the target was set.
+
+      In both cases, pairs that are farther apart than the maximum
+      distance, and target points without a valid (non-zero, finite)
+      normal, are rejected.
+
+      \section C2F Coarse-to-Fine
+
+      With L levels, the alignment starts on every 2^(L-1)th source point
+      in each direction (every 4^(L-1)th point for unorganized clouds) and
+      refines the result on denser subsets, down to the full cloud. Each
+      level iterates until the update becomes smaller than the
+      convergence thresholds, or until the maximum number of iterations
+      is reached.
+
+      \section PAR Parallelization
+
+      Correspondence search and the accumulation of the normal equations
+      run on utils::ThreadPool::global(). The source points are split
+      into fixed chunks whose partial sums are added in a fixed order, so
+      the result does not depend on the number of threads.
+
+      \code
+      PointToPlaneICP icp;
+      icp.setTarget(lastFrame);            // XYZH and normals
+      icp.setTargetCamera(depthCam);       // enables projective association
+      PointToPlaneICP::Result r = icp.apply(currentFrame.selectXYZH());
+      // r.transform maps points of the current frame into the last one
+      \endcode
+  */
+  class ICLGeom_API PointToPlaneICP {
+    struct Data;  //!< internal data type
+    Data *m_data; //!< internal data pointer
+
+    public:
+    PointToPlaneICP(const PointToPlaneICP&) = delete;
+    PointToPlaneICP& operator=(const PointToPlaneICP&) = delete;
+
+    /// Result of an apply() call
+    struct ICLGeom_API Result {
+      Result();
+      Mat transform;        //!< transforms source points onto the target
+      float error;          //!< RMS point-to-plane distance of the last iteration
+      int iterations;       //!< number of iterations over all levels
+      int correspondences;  //!< number of correspondences of the last iteration
+      bool converged;       //!< whether the finest level converged
+    };
+
+    /// creates an ICP instance
+    /** @param maxIterations maximum number of iterations per level
+        @param maxDistance maximum distance of corresponding points
+        @param levels number of coarse-to-fine levels (>= 1) */
+    PointToPlaneICP(int maxIterations=20, float maxDistance=50, int levels=3);
+
+    /// Destructor
+    ~PointToPlaneICP();
+
+    /// sets the target points and normals (deep copy)
+    /** If xyzh is organized, projective association can be used after
+        setting the target camera. The nearest neighbour search structure
+        is not built here, but by the first apply() call that uses nearest
+        neighbour association. */
+    void setTarget(const core::DataSegment<float,4> &xyzh,
+                   const core::DataSegment<float,4> &normals);
+
+    /// sets the target from the XYZH and normal features of the given object
+    void setTarget(const PointCloudObjectBase &target);
+
+    /// sets the camera the (organized) target was captured with
+    /** This enables projective data association. The camera's image
+        size should match the size of the target cloud */
+    void setTargetCamera(const Camera &camera);
+
+    /// switches back to nearest neighbour association
+    void removeTargetCamera();
+
+    /// returns whether projective association is used for the current target
+    bool usesProjectiveAssociation() const;
+
+    /// aligns the source points to the target
+    /** @param xyzh source points
+        @param initialTransform initial estimate of the source to target transform */
+    Result apply(const core::DataSegment<float,4> &xyzh,
+                 const Mat &initialTransform=Mat::id());
+
+    /// aligns the XYZH feature of the given object to the target
+    Result apply(const PointCloudObjectBase &source,
+                 const Mat &initialTransform=Mat::id());
+
+    /// sets the maximum number of iterations per level
+    void setMaxIterations(int maxIterations);
+
+    /// returns the maximum number of iterations per level
+    int getMaxIterations() const;
+
+    /// sets the maximum distance between corresponding points
+    void setMaxDistance(float maxDistance);
+
+    /// returns the maximum distance between corresponding points
+    float getMaxDistance() const;
+
+    /// sets the number of coarse-to-fine levels
+    void setLevels(int levels);
+
+    /// returns the number of coarse-to-fine levels
+    int getLevels() const;
+
+    /// sets the convergence thresholds
+    /** A level is finished, once the update's rotation angle (in radians)
+        and translation are both below the given values */
+    void setConvergenceThresholds(float rotation, float translation);
+
+    /// returns the rotation convergence threshold (radians)
+    float getRotationThreshold() const;
+
+    /// returns the translation convergence threshold
+    float getTranslationThreshold() const;
+  };
+} // namespace icl::geom
@@ -34,6 +34,13 @@
 
 #include <icl/qt/Quick2.h>
 #include <icl/geom/GeomDefs.h>
+#include <icl/utils/ThreadPool.h>
+
+#include <algorithm>
+#include <mutex>
+#include <random>
+#include <utility>
+#include <vector>
 
 using namespace icl::core;
 using namespace icl::utils;
@@ -186,6 +193,121 @@ static char segmentationKernel[] =
 ;
 #endif
 
+namespace {
+	/// number of image rows that are labeled by one task of the connected component labeling
+	const int CC_BAND_ROWS = 32;
+
+	inline int find_root(int *parent, int i) {
+		while (parent[i] != i) {
+			parent[i] = parent[parent[i]];
+			i = parent[i];
+		}
+		return i;
+	}
+
+	/// joins the sets of a and b, the root is always the smallest index
+	inline void unite(int *parent, int a, int b) {
+		a = find_root(parent, a);
+		b = find_root(parent, b);
+		if (a < b) {
+			parent[b] = a;
+		} else if (b < a) {
+			parent[a] = b;
+		}
+	}
+
+	/// 8-connected components of the eligible pixels of a w x h image
+	/** Two neighboring pixels i and j are connected if both are eligible and
+		connected(i,j) is true (which must be symmetric). The image is split into
+		bands of rows that are labeled in parallel using union-find; the bands are
+		merged along their borders afterwards. On return, label[i] is the smallest
+		pixel index of i's component (i.e. the pixel a raster scan region growing
+		would start with), or -1 if i is not eligible. */
+	template<class Eligible, class Connected>
+	void connected_components(int w, int h, Eligible eligible, Connected connected,
+			std::vector<int> &label) {
+		std::vector<int> parent(w * h);
+		int *p = parent.data();
+		auto link = [&](int i, int j) {
+			if (eligible(j) && connected(i, j)) {
+				unite(p, i, j);
+			}
+		};
+		auto link_above = [&](int i, int x) {
+			if (x > 0) link(i, i - w - 1);
+			link(i, i - w);
+			if (x + 1 < w) link(i, i - w + 1);
+		};
+		parallelFor(0, h, CC_BAND_ROWS, [&](int y0, int y1) {
+			for (int i = y0 * w; i < y1 * w; ++i) {
+				p[i] = i;
+			}
+			for (int y = y0; y < y1; ++y) {
+				for (int x = 0; x < w; ++x) {
+					int i = x + w * y;
+					if (!eligible(i)) continue;
+					if (x > 0) link(i, i - 1);
+					if (y > y0) link_above(i, x);
+				}
+			}
+		});
+		// merge the bands (only the first row of each band has unvisited upper neighbors)
+		for (int y = CC_BAND_ROWS; y < h; y += CC_BAND_ROWS) {
+			for (int x = 0; x < w; ++x) {
+				int i = x + w * y;
+				if (eligible(i)) link_above(i, x);
+			}
+		}
+		label.resize(w * h);
+		parallelFor(0, h, CC_BAND_ROWS, [&](int y0, int y1) {
+			for (int i = y0 * w; i < y1 * w; ++i) {
+				int r = i;
+				while (parent[r] != r) r = parent[r];
+				label[i] = eligible(i) ? r : -1;
+			}
+		});
+	}
+
+	/// numbers the components (given by connected_components) of at least minSize pixels
+	/** The components are numbered consecutively in raster order of their first pixel,
+		starting with firstID. On return, id[i] is the number of the component whose
+		first pixel is i, or 0 for smaller components. Returns the number of components. */
+	int number_components(const std::vector<int> &label, unsigned int minSize, int firstID,
+			std::vector<int> &id) {
+		const int dim = label.size();
+		id.assign(dim, 0);
+		for (int i = 0; i < dim; ++i) {
+			if (label[i] >= 0) ++id[label[i]];
+		}
+		int num = 0;
+		for (int i = 0; i < dim; ++i) {
+			if (label[i] == i) {
+				id[i] = static_cast<unsigned int>(id[i]) < minSize ? 0 : firstID + num++;
+			}
+		}
+		return num;
+	}
+
+	/// plane through three random points of the given cluster (as in the original RANSAC)
+	inline void random_plane(const DataSegment<float, 4> &xyz, const std::vector<int> &c,
+			std::mt19937 &rng, Vec &n0, float &dist) {
+		int p0i = c[rng() % c.size()];
+		int p1i = c[rng() % c.size()];
+		int p2i = c[rng() % c.size()];
+		Vec fa1 = xyz[p1i] - xyz[p0i];
+		Vec fb1 = xyz[p2i] - xyz[p0i];
+		Vec n1;
+		n1[0] = fa1[1] * fb1[2] - fa1[2] * fb1[1];
+		n1[1] = fa1[2] * fb1[0] - fa1[0] * fb1[2];
+		n1[2] = fa1[0] * fb1[1] - fa1[1] * fb1[0];
+		n0[0] = n1[0] / norm3(n1);
+		n0[1] = n1[1] / norm3(n1);
+		n0[2] = n1[2] / norm3(n1);
+		const Vec &r = xyz[p0i];
+		dist = r[0] * n0[0] + r[1] * n0[1] + r[2] * n0[2];
+	}
+}
+
 Segmentation3D::Segmentation3D(Size size) {
 	//set default values
 	clReady = false;
@@ -204,6 +326,7 @@ Segmentation3D::Segmentation3D(Size size) {
 	RANSACpasses = 20;
 	RANSACtolerance = 30;
 	RANSACsubset = 2;
+	RANSACseed = 0;
 	BLOBSeuclDistance = 15;
 
 	useROI = false;
@@ -341,6 +464,10 @@ void Segmentation3D::setRANSACsubset(int subset) {
 	RANSACsubset = subset;
 }
 
+void Segmentation3D::setRANSACseed(unsigned int seed) {
+	RANSACseed = seed;
+}
+
 void Segmentation3D::setBLOBSeuclDistance(int distance) {
 	BLOBSeuclDistance = distance;
 }
@@ -459,32 +586,18 @@ void Segmentation3D::regionGrow() {
 			}
 		}
 	} else {
-		int numCluster = 0;
-		std::vector < std::vector<int> > remove;
-		for (int y = 0; y < h; ++y) {
-			for (int x = 0; x < w; ++x) {
-				int i = x + w * y;
-				if (elements[i] == true && normalEdgeImage(x, y, 0) == 255) {
-					elements[i] = false;
-					numCluster++;
-					assignment[i] = numCluster;
-					std::vector<int> data;
-					data.push_back(i);
-					checkNeighbourGrayThreshold(x, y, assignment[i], 255,
-							&data);
-					if (data.size() < minClusterSize) {
-						remove.push_back(data);
-						numCluster--;
-					} else {
-						cluster.push_back(data);
-					}
-				}
-			}
-		}
-		for (unsigned int i = 0; i < remove.size(); i++) {
-			for (unsigned int j = 0; j < remove.at(i).size(); j++) {
-				elements[remove.at(i).at(j)] = true;
-				assignment[remove.at(i).at(j)] = 0;
+		const icl8u *edge = normalEdgeImage.begin(0);
+		std::vector<int> label, id;
+		connected_components(w, h, [this, edge](int i) {
+			return elements[i] && edge[i] == 255;
+		}, [](int, int) {return true;}, label);
+		int numCluster = number_components(label, minClusterSize, 1, id);
+		cluster.resize(numCluster);
+		for (int i = 0; i < dim; ++i) {
+			if (label[i] >= 0 && id[label[i]]) {
+				assignment[i] = id[label[i]];
+				elements[i] = false;
+				cluster[assignment[i] - 1].push_back(i);
 			}
 		}
 	}
@@ -541,63 +654,70 @@ void Segmentation3D::calculatePointAssignmentAndAdjacency() {
 		int numFaces = cluster.size();
 		DynMatrixBase<bool> newMatrix(numFaces, numFaces, false);
 		neighbours = newMatrix;
-		int *assignmentOut = new int[w * h];
-    for (int x=0; x<w; x++) {
-			for(int y=0; y<h; y++) {
-				int i=x+w*y;
-				float dist=100000;
-				int ass=0;
-				bool assigned=false;
-				if(elements[i]==true && assignment[i]==0) {
-					bool *adj = new bool[numFaces];
-					for(int a=0; a<numFaces; a++) {
-						adj[a]=false;
-					}
-					for(int xx=-assignmentRadius; xx<=assignmentRadius; xx++) {
-						for(int yy=-assignmentRadius; yy<=assignmentRadius; yy++) {
-							if(x+xx>=0 && x+xx<w && y+yy>=0 && y+yy<h && assignment[(x+xx)+w*(y+yy)]!=0) {
-								Vec p1=xyzData[i];
-								Vec p2=xyzData[(x+xx)+w*(y+yy)];
-								float distance=dist3(p1, p2);
-								if(distance<assignmentMaxDistance) {
-									adj[assignment[(x+xx)+w*(y+yy)]-1]=true;
-								}
-								if(distance<dist && distance<assignmentMaxDistance) {
-									dist=distance;
-									ass=assignment[(x+xx)+w*(y+yy)];
-									assigned=true;
+		std::vector<int> assignmentOut(dim);
+		std::mutex neighboursMutex;
+		// every unassigned point is processed independently (it only depends on the
+		// assignment of the region growing); the columns are split among the threads
+		parallelFor(0, w, 8, [&](int x0, int x1) {
+			std::vector<int> adj;
+			std::vector<std::pair<int, int> > pairs;
+			for (int x = x0; x < x1; x++) {
+				for (int y = 0; y < h; y++) {
+					int i = x + w * y;
+					assignmentOut[i] = assignment[i];
+					if (elements[i] == false || assignment[i] != 0) continue;
+					float dist = 100000;
+					int ass = 0;
+					adj.clear();
+					const Vec &p1 = xyzData[i];
+					for (int xx = -assignmentRadius; xx <= assignmentRadius; xx++) {
+						for (int yy = -assignmentRadius; yy <= assignmentRadius; yy++) {
+							if (x + xx >= 0 && x + xx < w && y + yy >= 0 && y + yy < h
+									&& assignment[(x + xx) + w * (y + yy)] != 0) {
+								int j = (x + xx) + w * (y + yy);
+								float distance = dist3(p1, xyzData[j]);
+								if (distance < assignmentMaxDistance) {
+									if (std::find(adj.begin(), adj.end(), assignment[j] - 1) == adj.end()) {
+										adj.push_back(assignment[j] - 1);
+									}
+									if (distance < dist) {
+										dist = distance;
+										ass = assignment[j];
+									}
 								}
 							}
 						}
 					}
-					for(int a=0; a<numFaces-1; a++) {
-						for (int b=a+1; b<numFaces; b++) {
-							if(adj[a]==true && adj[b]==true) {
-								neighbours(b, a)=true;
-								neighbours(a, b)=true;
-							}
+					for (unsigned int a = 0; a < adj.size(); a++) {
+						for (unsigned int b = a + 1; b < adj.size(); b++) {
+							pairs.push_back(std::make_pair(adj[a], adj[b]));
 						}
 					}
-					if(assigned==true) {
-						cluster.at(ass-1).push_back(i);
-						elements[i]=false;
-						assignmentOut[i]=ass;
+					if (ass != 0) {
+						elements[i] = false;
+						assignmentOut[i] = ass;
 					}
-					else {
-						assignmentOut[i]=assignment[i];
-					}
-                                    ICL_DELETE_ARRAY(adj);
 				}
-				else {
-					assignmentOut[i]=assignment[i];
+			}
+			std::lock_guard<std::mutex> lock(neighboursMutex);
+			for (unsigned int k = 0; k < pairs.size(); k++) {
+				neighbours(pairs[k].first, pairs[k].second) = true;
+				neighbours(pairs[k].second, pairs[k].first) = true;
+			}
+		});
+		// the newly assigned points are appended in the original (column major) order
+		for (int x = 0; x < w; x++) {
+			for (int y = 0; y < h; y++) {
+				int i = x + w * y;
+				if (assignmentOut[i] != assignment[i]) {
+					cluster.at(assignmentOut[i] - 1).push_back(i);
 				}
 			}
 		}
 		for (int i = 0; i < numFaces; i++) {
 			neighbours(i, i) = true;
 		}
-		memcpy(assignment, assignmentOut, w*h*sizeof(int));
-    ICL_DELETE_ARRAY(assignmentOut);
+		std::copy(assignmentOut.begin(), assignmentOut.end(), assignment);
 	}
 }
 
@@ -605,6 +725,58 @@ void Segmentation3D::calculateCutfreeMatrix() {
 	DynMatrixBase<bool> newMatrix(neighbours.rows(), neighbours.cols(), false);
 	cutfree = newMatrix;
 
+	if (useCL == false || clReady == false) {
+		std::vector<std::pair<int, int> > pairs;
+		for (unsigned int a = 0; a < neighbours.rows(); a++) {
+			for (unsigned int b = 0; b < neighbours.cols(); b++) {
+				if (a == b) {
+					cutfree(b, a) = true;
+				} else if (neighbours(b, a) == true) {
+					pairs.push_back(std::make_pair(a, b));
+				}
+			}
+		}
+		// the neighboring cluster pairs are checked in parallel; the planes of each
+		// pair are sampled by a random generator that is seeded with the RANSAC seed
+		// and the pair, so the result does not depend on the number of threads
+		parallelFor(0, pairs.size(), 1, [&](int k0, int k1) {
+			for (int k = k0; k < k1; k++) {
+				const int a = pairs[k].first, b = pairs[k].second;
+				const std::vector<int> &ca = cluster.at(a), &cb = cluster.at(b);
+				std::seed_seq seq{RANSACseed, static_cast<unsigned int>(a),
+					static_cast<unsigned int>(b)};
+				std::mt19937 rng(seq);
+				int countAcc = 0;
+				int countNAcc = 0;
+				for (int p = 0; p < RANSACpasses; p++) {
+					Vec n01;
+					float distance1;
+					random_plane(xyzData, ca, rng, n01, distance1);
+					int countAbove = 0;
+					int countBelow = 0;
+					for (unsigned int q = 0; q < cb.size(); q++) {
+						const Vec &v = xyzData[cb[q]];
+						float s1 = (v[0] * n01[0] + v[1] * n01[1] + v[2] * n01[2])
+								- distance1;
+						if (s1 > RANSACeuclDistance) {
+							countAbove++;
+						} else if (s1 < -RANSACeuclDistance) {
+							countBelow++;
+						}
+					}
+					if (countAbove < RANSACtolerance
+							|| countBelow < RANSACtolerance) {
+						countAcc++;
+					} else {
+						countNAcc++;
+					}
+				}
+				cutfree(b, a) = countAcc > countNAcc;
+			}
+		});
+		return;
+	}
+
 	for (unsigned int a = 0; a < neighbours.rows(); a++) {
 #ifdef ICL_HAVE_OPENCL
       int numPoints=cluster.at(a).size();
@@ -619,11 +791,10 @@ void Segmentation3D::calculateCutfreeMatrix() {
 			} else if (neighbours(b, a) == false) {
 				cutfree(b, a) = false;
 			} else {
-				int countAcc = 0;
-				int countNAcc = 0;
-
-				if (useCL == true && clReady == true) {
 #ifdef ICL_HAVE_OPENCL
+				{
+					int countAcc = 0;
+					int countNAcc = 0;
 
 					Vec *n0 = new Vec[RANSACpasses];
 					float *dist = new float[RANSACpasses];
@@ -715,64 +886,8 @@ void Segmentation3D::calculateCutfreeMatrix() {
           delete[] cAboveRead;
           delete[] cBelowRead;
           delete[] cOnRead;
-#endif
-				} else {
-					for (int p = 0; p < RANSACpasses; p++) {
-						Vec rPoint1;
-						Vec n01;
-						int p0i = cluster.at(a).at(
-								rand() % cluster.at(a).size());
-						int p1i = cluster.at(a).at(
-								rand() % cluster.at(a).size());
-						int p2i = cluster.at(a).at(
-								rand() % cluster.at(a).size());
-						Vec fa1;
-						Vec fb1;
-						Vec n1;
-						//PlaneFitting
-						fa1 = xyzData[p1i] - xyzData[p0i];
-						fb1 = xyzData[p2i] - xyzData[p0i];
-						n1[0] = fa1[1] * fb1[2] - fa1[2] * fb1[1];
-						n1[1] = fa1[2] * fb1[0] - fa1[0] * fb1[2];
-						n1[2] = fa1[0] * fb1[1] - fa1[1] * fb1[0];
-						n01[0] = n1[0] / norm3(n1);
-						n01[1] = n1[1] / norm3(n1);
-						n01[2] = n1[2] / norm3(n1);
-						rPoint1 = xyzData[p0i];
-						float distance1 = rPoint1[0] * n01[0]
-								+ rPoint1[1] * n01[1] + rPoint1[2] * n01[2];
-
-						int countAbove = 0;
-						int countBelow = 0;
-						[[maybe_unused]] int countOn = 0;
-						for (unsigned int p = 0; p < cluster.at(b).size();
-								p++) {
-							float s1 = (xyzData[cluster.at(b).at(p)][0] * n01[0]
-									+ xyzData[cluster.at(b).at(p)][1] * n01[1]
-									+ xyzData[cluster.at(b).at(p)][2] * n01[2])
-									- distance1;
-							if ((s1 >= -RANSACeuclDistance
-									&& s1 <= RANSACeuclDistance)) {
-								countOn++;
-							} else if (s1 > RANSACeuclDistance) {
-								countAbove++;
-							} else if (s1 < -RANSACeuclDistance) {
-								countBelow++;
-							}
-						}
-						if (countAbove < RANSACtolerance
-								|| countBelow < RANSACtolerance) {
-							countAcc++;
-						} else {
-							countNAcc++;
-						}
-					}
-					if (countAcc > countNAcc) {
-						cutfree(b, a) = true;
-					} else {
-						cutfree(b, a) = false;
-					}
 				}
+#endif
 			}
 		}
 	}
@@ -1242,6 +1357,8 @@ void Segmentation3D::blobSegmentation() {
 	float *dist = new float[RANSACpasses];
 	int *cOnRead = new int[RANSACpasses];
 
+	std::seed_seq seq{RANSACseed};
+	std::mt19937 rng(seq);
 	for (int i = 0; i < RANSACpasses; i++) {
 #ifdef ICL_HAVE_OPENCL
 		cAbove[i]=0;
@@ -1251,28 +1368,7 @@ void Segmentation3D::blobSegmentation() {
 		cBelowRead[i]=0;
 #endif
 		cOnRead[i] = 0;
-
-		Vec rPoint1;
-		Vec n01;
-		int p0i = cluster.at(maxID).at(rand() % cluster.at(maxID).size());
-		int p1i = cluster.at(maxID).at(rand() % cluster.at(maxID).size());
-		int p2i = cluster.at(maxID).at(rand() % cluster.at(maxID).size());
-		Vec fa1;
-		Vec fb1;
-		Vec n1;
-		fa1 = xyzData[p1i] - xyzData[p0i];
-		fb1 = xyzData[p2i] - xyzData[p0i];
-		n1[0] = fa1[1] * fb1[2] - fa1[2] * fb1[1];
-		n1[1] = fa1[2] * fb1[0] - fa1[0] * fb1[2];
-		n1[2] = fa1[0] * fb1[1] - fa1[1] * fb1[0];
-		n01[0] = n1[0] / norm3(n1);
-		n01[1] = n1[1] / norm3(n1);
-		n01[2] = n1[2] / norm3(n1);
-		rPoint1 = xyzData[p0i];
-		float distance1 = rPoint1[0] * n01[0] + rPoint1[1] * n01[1]
-				+ rPoint1[2] * n01[2];
-		dist[i] = distance1;
-		n0[i] = n01;
+		random_plane(xyzData, cluster.at(maxID), rng, n0[i], dist[i]);
 	}
 
 	if (useCL == true && clReady == true) {
@@ -1310,19 +1406,22 @@ void Segmentation3D::blobSegmentation() {
 		}
 #endif
 	} else {
-		for (int p = 0; p < RANSACpasses; p++) {
-			for (unsigned int q = 0; q < cluster.at(maxID).size(); q++) {
-				Vec n01 = n0[p];
-				float s1 = (xyzData[cluster.at(maxID).at(q)][0] * n01[0]
-						+ xyzData[cluster.at(maxID).at(q)][1] * n01[1]
-						+ xyzData[cluster.at(maxID).at(q)][2] * n01[2])
-						- dist[p];
-				if ((s1 >= -RANSACeuclDistance / 2
-						&& s1 <= RANSACeuclDistance / 2)) {
-					cOnRead[p]++;
+		const std::vector<int> &c = cluster.at(maxID);
+		parallelFor(0, RANSACpasses, 1, [&](int p0, int p1) {
+			for (int p = p0; p < p1; p++) {
+				const Vec &n01 = n0[p];
+				int count = 0;
+				for (unsigned int q = 0; q < c.size(); q++) {
+					const Vec &v = xyzData[c[q]];
+					float s1 = (v[0] * n01[0] + v[1] * n01[1] + v[2] * n01[2]) - dist[p];
+					if ((s1 >= -RANSACeuclDistance / 2
+							&& s1 <= RANSACeuclDistance / 2)) {
+						count++;
+					}
 				}
+				cOnRead[p] = count;
 			}
-		}
+		});
 	}
 	int maxMatch = 0;
 	int maxMatchID = 0;
@@ -1356,25 +1455,28 @@ void Segmentation3D::blobSegmentation() {
 		}
 #endif
 	} else {
-		for (int i = 0; i < w * h; i++) {
-			if (assignment[i] == maxID + 1) {
-				assignmentBlobs[i] = 1;
-				elementsBlobs[i] = false;
-			} else {
-				Vec n01 = n0[maxMatchID];
-				float s1 = (xyzData[i][0] * n01[0] + xyzData[i][1] * n01[1]
-						+ xyzData[i][2] * n01[2]) - dist[maxMatchID];
-				if ((s1 >= -RANSACeuclDistance && s1 <= RANSACeuclDistance)
-						&& elementsBlobs[i] == true) {
+		const Vec n01 = n0[maxMatchID];
+		const float d = dist[maxMatchID];
+		parallelFor(0, w * h, 4096, [&](int i0, int i1) {
+			for (int i = i0; i < i1; i++) {
+				if (assignment[i] == maxID + 1) {
 					assignmentBlobs[i] = 1;
 					elementsBlobs[i] = false;
+				} else {
+					float s1 = (xyzData[i][0] * n01[0] + xyzData[i][1] * n01[1]
+							+ xyzData[i][2] * n01[2]) - d;
+					if ((s1 >= -RANSACeuclDistance && s1 <= RANSACeuclDistance)
+							&& elementsBlobs[i] == true) {
+						assignmentBlobs[i] = 1;
+						elementsBlobs[i] = false;
+					}
 				}
 			}
-		}
+		});
 	}
 
 	regionGrowBlobs();
-  assignment = assignmentBlobs;
+	std::copy(assignmentBlobs, assignmentBlobs + w * h, assignment);
 
   delete[] n0;
   delete[] dist;
@@ -1466,92 +1568,6 @@ void Segmentation3D::colorPointcloud() {
 	}
 }
 
-void Segmentation3D::checkNeighbourGrayThreshold(int x, int y, int zuw,
-		int threshold, std::vector<int> *data) {
-	std::vector<int> toProcessX;
-	std::vector<int> toProcessY;
-	bool process = true;
-	unsigned int index = 0;
-	toProcessX.push_back(x);
-	toProcessY.push_back(y);
-
-	while (process == true) {
-		int i = toProcessX.at(index) + w * toProcessY.at(index);
-		x = toProcessX.at(index);
-		y = toProcessY.at(index);
-
-		if (elements[i + 1] == true && x + 1 < w
-				&& normalEdgeImage(x + 1, y, 0) == threshold) {
-			elements[i + 1] = false;
-			assignment[i + 1] = zuw;
-			toProcessX.push_back(toProcessX.at(index) + 1);
-			toProcessY.push_back(toProcessY.at(index));
-			data->push_back(i + 1);
-		}
-		if (elements[i - 1] == true && x - 1 >= 0
-				&& normalEdgeImage(x - 1, y, 0) == threshold) {
-			elements[i - 1] = false;
-			assignment[i - 1] = zuw;
-			toProcessX.push_back(toProcessX.at(index) - 1);
-			toProcessY.push_back(toProcessY.at(index));
-			data->push_back(i - 1);
-		}
-		if (elements[i + w] == true && y + 1 < h
-				&& normalEdgeImage(x, y + 1, 0) == threshold) {
-			elements[i + w] = false;
-			assignment[i + w] = zuw;
-			toProcessX.push_back(toProcessX.at(index));
-			toProcessY.push_back(toProcessY.at(index) + 1);
-			data->push_back(i + w);
-		}
-		if (elements[i + w - 1] == true && x - 1 >= 0 && y + 1 < h
-				&& normalEdgeImage(x - 1, y + 1, 0) == threshold) {
-			elements[i + w - 1] = false;
-			assignment[i + w - 1] = zuw;
-			toProcessX.push_back(toProcessX.at(index) - 1);
-			toProcessY.push_back(toProcessY.at(index) + 1);
-			data->push_back(i + w - 1);
-		}
-		if (elements[i + w + 1] == true && x + 1 < w && y + 1 < h
-				&& normalEdgeImage(x + 1, y + 1, 0) == threshold) {
-			elements[i + w + 1] = false;
-			assignment[i + w + 1] = zuw;
-			toProcessX.push_back(toProcessX.at(index) + 1);
-			toProcessY.push_back(toProcessY.at(index) + 1);
-			data->push_back(i + w + 1);
-		}
-		if (elements[i - w] == true && y - 1 >= 0
-				&& normalEdgeImage(x, y - 1, 0) == threshold) {
-			elements[i - w] = false;
-			assignment[i - w] = zuw;
-			toProcessX.push_back(toProcessX.at(index));
-			toProcessY.push_back(toProcessY.at(index) - 1);
-			data->push_back(i - w);
-		}
-		if (elements[i - w - 1] == true && x - 1 >= 0 && y - 1 >= 0
-				&& normalEdgeImage(x - 1, y - 1, 0) == threshold) {
-			elements[i - w - 1] = false;
-			assignment[i - w - 1] = zuw;
-			toProcessX.push_back(toProcessX.at(index) - 1);
-			toProcessY.push_back(toProcessY.at(index) - 1);
-			data->push_back(i - w - 1);
-		}
-		if (elements[i - w + 1] == true && x + 1 < w && y - 1 >= 0
-				&& normalEdgeImage(x + 1, y - 1, 0) == threshold) {
-			elements[i - w + 1] = false;
-			assignment[i - w + 1] = zuw;
-			toProcessX.push_back(toProcessX.at(index) + 1);
-			toProcessY.push_back(toProcessY.at(index) - 1);
-			data->push_back(i - w + 1);
-		}
-
-		index++;
-		if (index >= toProcessX.size()) {
-			process = false;
-		}
-	}
-}
-
 void Segmentation3D::checkNeighbourDistanceRemaining(int x, int y, int zuw,
 		std::vector<int> *data) {
 	std::vector<int> toProcessX;
@@ -1639,125 +1655,21 @@ void Segmentation3D::checkNeighbourDistanceRemaining(int x, int y, int zuw,
 }
 
 void Segmentation3D::regionGrowBlobs() {
-	int numCluster = 1;
-	std::vector < std::vector<int> > remove;
-	for (int y = 0; y < h; ++y) {
-		for (int x = 0; x < w; ++x) {
-			int i = x + w * y;
-			if (elementsBlobs[i] == true) {
+	const float *depth = depthImage.begin(0);
+	std::vector<int> label, id;
+	connected_components(w, h, [this](int i) {return elementsBlobs[i];},
+			[this, depth](int i, int j) {
+				return fabs(depth[i] - depth[j]) < BLOBSeuclDistance;
+			}, label);
+	number_components(label, minClusterSize, 2, id);
+	parallelFor(0, h, CC_BAND_ROWS, [&](int y0, int y1) {
+		for (int i = y0 * w; i < y1 * w; ++i) {
+			if (label[i] >= 0 && id[label[i]]) {
+				assignmentBlobs[i] = id[label[i]];
 				elementsBlobs[i] = false;
-				numCluster++;
-				assignmentBlobs[i] = numCluster;
-				std::vector<int> data;
-				data.push_back(i);
-				checkNeighbourDistance(x, y, assignmentBlobs[i], &data);
-				if (data.size() < minClusterSize) {
-					remove.push_back(data);
-					numCluster--;
-				}
 			}
 		}
-	}
-	for (unsigned int i = 0; i < remove.size(); i++) {
-		for (unsigned int j = 0; j < remove.at(i).size(); j++) {
-			elementsBlobs[remove.at(i).at(j)] = true;
-			assignmentBlobs[remove.at(i).at(j)] = 0;
-		}
-	}
-}
-
-void Segmentation3D::checkNeighbourDistance(int x, int y, int zuw,
-		std::vector<int> *data) {
-	std::vector<int> toProcessX;
-	std::vector<int> toProcessY;
-	bool process = true;
-	unsigned int index = 0;
-	toProcessX.push_back(x);
-	toProcessY.push_back(y);
-
-	while (process == true) {
-		int i = toProcessX.at(index) + w * toProcessY.at(index);
-		x = toProcessX.at(index);
-		y = toProcessY.at(index);
-
-		if (elementsBlobs[i + 1] == true && x + 1 < w
-				&& fabs(depthImage(x, y, 0) - depthImage(x + 1, y, 0))
-						< BLOBSeuclDistance) {
-			elementsBlobs[i + 1] = false;
-			assignmentBlobs[i + 1] = zuw;
-			toProcessX.push_back(toProcessX.at(index) + 1);
-			toProcessY.push_back(toProcessY.at(index));
-			data->push_back(i + 1);
-		}
-		if (elementsBlobs[i - 1] == true && x - 1 >= 0
-				&& fabs(depthImage(x, y, 0) - depthImage(x - 1, y, 0))
-						< BLOBSeuclDistance) {
-			elementsBlobs[i - 1] = false;
-			assignmentBlobs[i - 1] = zuw;
-			toProcessX.push_back(toProcessX.at(index) - 1);
-			toProcessY.push_back(toProcessY.at(index));
-			data->push_back(i - 1);
-		}
-		if (elementsBlobs[i + w] == true && y + 1 < h
-				&& fabs(depthImage(x, y, 0) - depthImage(x, y + 1, 0))
-						< BLOBSeuclDistance) {
-			elementsBlobs[i + w] = false;
-			assignmentBlobs[i + w] = zuw;
-			toProcessX.push_back(toProcessX.at(index));
-			toProcessY.push_back(toProcessY.at(index) + 1);
-			data->push_back(i + w);
-		}
-		if (elementsBlobs[i + w - 1] == true && x - 1 >= 0 && y + 1 < h
-				&& fabs(depthImage(x, y, 0) - depthImage(x - 1, y + 1, 0))
-						< BLOBSeuclDistance) {
-			elementsBlobs[i + w - 1] = false;
-			assignmentBlobs[i + w - 1] = zuw;
-			toProcessX.push_back(toProcessX.at(index) - 1);
-			toProcessY.push_back(toProcessY.at(index) + 1);
-			data->push_back(i + w - 1);
-		}
-		if (elementsBlobs[i + w + 1] == true && x + 1 < w && y + 1 < h
-				&& fabs(depthImage(x, y, 0) - depthImage(x + 1, y + 1, 0))
-						< BLOBSeuclDistance) {
-			elementsBlobs[i + w + 1] = false;
-			assignmentBlobs[i + w + 1] = zuw;
-			toProcessX.push_back(toProcessX.at(index) + 1);
-			toProcessY.push_back(toProcessY.at(index) + 1);
-			data->push_back(i + w + 1);
-		}
-		if (elementsBlobs[i - w] == true && y - 1 >= 0
-				&& fabs(depthImage(x, y, 0) - depthImage(x, y - 1, 0))
-						< BLOBSeuclDistance) {
-			elementsBlobs[i - w] = false;
-			assignmentBlobs[i - w] = zuw;
-			toProcessX.push_back(toProcessX.at(index));
-			toProcessY.push_back(toProcessY.at(index) - 1);
-			data->push_back(i - w);
-		}
-		if (elementsBlobs[i - w - 1] == true && x - 1 >= 0 && y - 1 >= 0
-				&& fabs(depthImage(x, y, 0) - depthImage(x - 1, y - 1, 0))
-						< BLOBSeuclDistance) {
-			elementsBlobs[i - w - 1] = false;
-			assignmentBlobs[i - w - 1] = zuw;
-			toProcessX.push_back(toProcessX.at(index) - 1);
-			toProcessY.push_back(toProcessY.at(index) - 1);
-			data->push_back(i - w - 1);
-		}
-		if (elementsBlobs[i - w + 1] == true && x + 1 < w && y - 1 >= 0
-				&& fabs(depthImage(x, y, 0) - depthImage(x + 1, y - 1, 0))
-						< BLOBSeuclDistance) {
-			elementsBlobs[i - w + 1] = false;
-			assignmentBlobs[i - w + 1] = zuw;
-			toProcessX.push_back(toProcessX.at(index) + 1);
-			toProcessY.push_back(toProcessY.at(index) - 1);
-			data->push_back(i - w + 1);
-		}
-
-		index++;
-		if (index >= toProcessX.size()) {
-			process = false;
-		}
-	}
+	});
 }
 
 bool Segmentation3D::checkNotExist(int zw, std::vector<int> &nb) {
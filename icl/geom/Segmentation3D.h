@@ -18,7 +18,16 @@
 
 namespace icl::geom {
   /**
-     This class includes segmentation algorithms for depth images. It uses OpenCL for hardware parallelization if a compatible GPU is found. The input is a depth image, a binarized edge image from the PointNormalEstimation class and the xyz DataSegment from the PointCloudObject class. The output is a color image (e.g. as input for setColorsFromDisplay() method of the PointCloudObject class).*/
+     This class includes segmentation algorithms for depth images. It uses OpenCL for hardware parallelization if a compatible GPU is found. The input is a depth image, a binarized edge image from the PointNormalEstimation class and the xyz DataSegment from the PointCloudObject class. The output is a color image (e.g. as input for setColorsFromDisplay() method of the PointCloudObject class).
+
+     Without OpenCL, the expensive steps run on the global utils::ThreadPool: the region growing
+     (regionGrow() and the blob region growing of blobSegmentation()) is a union-find based
+     connected component labeling that processes bands of image rows in parallel and merges
+     them afterwards, the point assignment processes the image columns in parallel, and the
+     RANSAC checks of calculateCutfreeMatrix() run in parallel for all neighboring cluster pairs.
+     Each pair samples its planes with its own random generator, seeded with the RANSAC seed
+     (see setRANSACseed()) and the pair's cluster indices, so the segmentation does not depend
+     on the number of threads.*/
   class ICLGeom_API Segmentation3D{
 
    public:
@@ -91,6 +100,10 @@ namespace icl::geom {
     /**       @param subset the point subset for RANSAC */
     void setRANSACsubset(int subset);
 
+    /// Sets the seed for the random plane sampling of RANSAC (default 0)
+    /**       @param seed the seed. The results are reproducible for a fixed seed */
+    void setRANSACseed(unsigned int seed);
+
     /// Sets the minimum euclidean BLOB distance for remaining points or the blob segmentation
     /**       @param distance the minimum euclidean distance for blob segmentation */
     void setBLOBSeuclDistance(int distance);
@@ -193,6 +206,7 @@ namespace icl::geom {
     int RANSACpasses;
     int RANSACtolerance;
     int RANSACsubset;
+    unsigned int RANSACseed;
     int BLOBSeuclDistance;
 
     math::DynMatrixBase<bool> neighbours;
@@ -204,14 +218,10 @@ namespace icl::geom {
     bool clReady;
     bool useCL;
 
-    void checkNeighbourGrayThreshold(int x, int y, int zuw, int threshold, std::vector<int> *data);
-
     void checkNeighbourDistanceRemaining(int x, int y, int zuw, std::vector<int> *data);
 
     void regionGrowBlobs();
 
-    void checkNeighbourDistance(int x, int y, int zuw, std::vector<int> *data);
-
     bool checkNotExist(int zw, std::vector<int> &nb);
 
     float dist3(const Vec &a, const Vec &b);
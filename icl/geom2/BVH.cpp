@@ -6,10 +6,16 @@
 #include <icl/geom2/PointCloud.h>
 #include <icl/geom/Camera.h>
 #include <icl/geom/ViewRay.h>
+#include <icl/utils/ThreadPool.h>
+#include <icl/utils/SSETypes.h>
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <limits>
 #include <numeric>
 
+ICL_NO_FP_CONTRACT
+
 namespace icl::geom2 {
 
   // --- AABB ---
@@ -18,7 +24,7 @@ namespace icl::geom2 {
     float min[3] = { 1e30f,  1e30f,  1e30f};
     float max[3] = {-1e30f, -1e30f, -1e30f};
 
-    void expand(const Vec &v) {
+    void expand(const float *v) {
       for (int i = 0; i < 3; i++) {
         if (v[i] < min[i]) min[i] = v[i];
         if (v[i] > max[i]) max[i] = v[i];
@@ -32,18 +38,151 @@ namespace icl::geom2 {
       }
     }
 
-    Vec centroid() const {
-      return Vec((min[0]+max[0])*0.5f, (min[1]+max[1])*0.5f,
-                 (min[2]+max[2])*0.5f, 1);
+    float centroid(int axis) const {
+      return (min[axis] + max[axis]) * 0.5f;
     }
 
-    int longestAxis() const {
+    // half surface area (the SAH only compares ratios); 0 for empty boxes
+    float area() const {
       float dx = max[0]-min[0], dy = max[1]-min[1], dz = max[2]-min[2];
-      return (dx >= dy && dx >= dz) ? 0 : (dy >= dz ? 1 : 2);
+      if (dx < 0 || dy < 0 || dz < 0) return 0;
+      return dx*dy + dy*dz + dz*dx;
+    }
+  };
+
+  // --- Triangles and rays ---
+
+  namespace {
+    // Triangle vertices in leaf order (hot during traversal)
+    struct TriVerts {
+      float a[3], b[3], c[3];
+
+      void set(const BVH::Triangle &t) {
+        for (int i = 0; i < 3; i++) { a[i] = t.a[i]; b[i] = t.b[i]; c[i] = t.c[i]; }
+      }
+      AABB bounds() const {
+        AABB box;
+        box.expand(a);
+        box.expand(b);
+        box.expand(c);
+        return box;
+      }
+    };
+
+    // Hit metadata in leaf order (only read for reported hits)
+    struct TriInfo {
+      Node *node;
+      GeomColor color;
+    };
+
+    constexpr float MISS = std::numeric_limits<float>::infinity();
+    constexpr float DET_EPSILON = 1e-12f;
+
+    // Moeller-Trumbore ray-triangle test (both sides); returns the ray
+    // parameter of the hit or MISS. The 4-ray version below performs the
+    // same operations in the same order, so single rays and packets
+    // report identical hits.
+    inline float intersectTriangle(const float *o, const float *d, const TriVerts &t) {
+      const float e1[3] = {t.b[0]-t.a[0], t.b[1]-t.a[1], t.b[2]-t.a[2]};
+      const float e2[3] = {t.c[0]-t.a[0], t.c[1]-t.a[1], t.c[2]-t.a[2]};
+      const float p[3] = {d[1]*e2[2] - d[2]*e2[1], d[2]*e2[0] - d[0]*e2[2], d[0]*e2[1] - d[1]*e2[0]};
+      const float det = e1[0]*p[0] + e1[1]*p[1] + e1[2]*p[2];
+      if (!(std::fabs(det) >= DET_EPSILON)) return MISS;
+      const float inv = 1.0f / det;
+      const float s[3] = {o[0]-t.a[0], o[1]-t.a[1], o[2]-t.a[2]};
+      const float u = (s[0]*p[0] + s[1]*p[1] + s[2]*p[2]) * inv;
+      if (!(u >= 0 && u <= 1)) return MISS;
+      const float q[3] = {s[1]*e1[2] - s[2]*e1[1], s[2]*e1[0] - s[0]*e1[2], s[0]*e1[1] - s[1]*e1[0]};
+      const float v = (d[0]*q[0] + d[1]*q[1] + d[2]*q[2]) * inv;
+      if (!(v >= 0 && u + v <= 1)) return MISS;
+      const float tt = (e2[0]*q[0] + e2[1]*q[1] + e2[2]*q[2]) * inv;
+      return tt >= 0 ? tt : MISS;
+    }
+
+    // A single ray in the layout used by the traversal
+    struct Ray {
+      float o[3], d[3], inv[3];
+
+      explicit Ray(const geom::ViewRay &r) {
+        for (int i = 0; i < 3; i++) {
+          o[i] = r.offset[i];
+          d[i] = r.direction[i];
+          inv[i] = 1.0f / (d[i] != 0 ? d[i] : 1e-20f);
+        }
+      }
+    };
+
+#ifdef ICL_HAVE_SSE2
+    // 4 rays, one per SIMD lane
+    struct RayPacket {
+      __m128 o[3], d[3], inv[3];
+      float meanDir[3];
+
+      explicit RayPacket(const Ray *r) {
+        for (int i = 0; i < 3; i++) {
+          o[i] = _mm_setr_ps(r[0].o[i], r[1].o[i], r[2].o[i], r[3].o[i]);
+          d[i] = _mm_setr_ps(r[0].d[i], r[1].d[i], r[2].d[i], r[3].d[i]);
+          inv[i] = _mm_setr_ps(r[0].inv[i], r[1].inv[i], r[2].inv[i], r[3].inv[i]);
+          meanDir[i] = r[0].d[i] + r[1].d[i] + r[2].d[i] + r[3].d[i];
+        }
+      }
+    };
+
+    inline __m128 dot4(__m128 ax, __m128 ay, __m128 az, __m128 bx, __m128 by, __m128 bz) {
+      return _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_mul_ps(az, bz));
+    }
+
+    inline __m128 cross4(__m128 ay, __m128 az, __m128 by, __m128 bz) {
+      return _mm_sub_ps(_mm_mul_ps(ay, bz), _mm_mul_ps(az, by));
+    }
+
+    // intersectTriangle() for 4 rays
+    inline __m128 intersectTriangle4(const RayPacket &r, const TriVerts &t) {
+      const __m128 e1x = _mm_set1_ps(t.b[0]-t.a[0]), e1y = _mm_set1_ps(t.b[1]-t.a[1]), e1z = _mm_set1_ps(t.b[2]-t.a[2]);
+      const __m128 e2x = _mm_set1_ps(t.c[0]-t.a[0]), e2y = _mm_set1_ps(t.c[1]-t.a[1]), e2z = _mm_set1_ps(t.c[2]-t.a[2]);
+      const __m128 px = cross4(r.d[1], r.d[2], e2y, e2z);
+      const __m128 py = cross4(r.d[2], r.d[0], e2z, e2x);
+      const __m128 pz = cross4(r.d[0], r.d[1], e2x, e2y);
+      const __m128 det = dot4(e1x, e1y, e1z, px, py, pz);
+      const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+      const __m128 absDet = _mm_andnot_ps(_mm_set1_ps(-0.0f), det);
+      __m128 valid = _mm_cmpge_ps(absDet, _mm_set1_ps(DET_EPSILON));
+      const __m128 inv = _mm_div_ps(one, det);
+      const __m128 sx = _mm_sub_ps(r.o[0], _mm_set1_ps(t.a[0]));
+      const __m128 sy = _mm_sub_ps(r.o[1], _mm_set1_ps(t.a[1]));
+      const __m128 sz = _mm_sub_ps(r.o[2], _mm_set1_ps(t.a[2]));
+      const __m128 u = _mm_mul_ps(dot4(sx, sy, sz, px, py, pz), inv);
+      valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpge_ps(u, zero), _mm_cmple_ps(u, one)));
+      const __m128 qx = cross4(sy, sz, e1y, e1z);
+      const __m128 qy = cross4(sz, sx, e1z, e1x);
+      const __m128 qz = cross4(sx, sy, e1x, e1y);
+      const __m128 v = _mm_mul_ps(dot4(r.d[0], r.d[1], r.d[2], qx, qy, qz), inv);
+      valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpge_ps(v, zero), _mm_cmple_ps(_mm_add_ps(u, v), one)));
+      const __m128 tt = _mm_mul_ps(dot4(e2x, e2y, e2z, qx, qy, qz), inv);
+      valid = _mm_and_ps(valid, _mm_cmpge_ps(tt, zero));
+      return _mm_or_ps(_mm_and_ps(valid, tt), _mm_andnot_ps(valid, _mm_set1_ps(MISS)));
+    }
+#endif
+  }
+
+  // --- BVH Node (32 bytes) ---
+
+  struct BVH::BVHNode {
+    float min[3];
+    int leftOrFirst;     // internal: index of the left child (right = left+1)
+    float max[3];        // leaf: index of the first triangle
+    int count;           // leaf: number of triangles (0 = internal)
+
+    bool isLeaf() const { return count > 0; }
+
+    void setBounds(const AABB &b) {
+      std::copy(b.min, b.min + 3, min);
+      std::copy(b.max, b.max + 3, max);
     }
 
-    // Slab-method ray-AABB intersection, returns true if ray hits box
-    bool intersectsRay(const Vec &origin, const Vec &invDir, float maxDist) const {
+    // Slab-method ray-AABB intersection, returns the entry distance or
+    // +inf if the ray misses the box or enters it behind maxDist
+    float intersectRay(const float *origin, const float *invDir, float maxDist) const {
       float t1 = (min[0] - origin[0]) * invDir[0];
       float t2 = (max[0] - origin[0]) * invDir[0];
       float tmin = std::min(t1, t2);
@@ -56,82 +195,290 @@ namespace icl::geom2 {
       t2 = (max[2] - origin[2]) * invDir[2];
       tmin = std::max(tmin, std::min(t1, t2));
       tmax = std::min(tmax, std::max(t1, t2));
-      return tmax >= std::max(tmin, 0.0f) && tmin < maxDist;
+      return (tmax >= std::max(tmin, 0.0f) && tmin < maxDist) ? tmin : MISS;
     }
-  };
-
-  // --- BVH Node ---
-
-  struct BVH::BVHNode {
-    AABB bounds;
-    int left = -1;       // child index or -1
-    int right = -1;
-    int triStart = -1;   // leaf: index into triangle array
-    int triCount = 0;    // leaf: number of triangles (0 = internal)
 
-    bool isLeaf() const { return triCount > 0; }
+#ifdef ICL_HAVE_SSE2
+    // slab test for 4 rays, returns the lane mask of rays hitting the box
+    // before their current closest hit
+    int intersectRays(const RayPacket &r, __m128 maxDist) const {
+      __m128 tmin = _mm_set1_ps(-MISS), tmax = _mm_set1_ps(MISS);
+      for (int i = 0; i < 3; i++) {
+        const __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(min[i]), r.o[i]), r.inv[i]);
+        const __m128 t2 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(max[i]), r.o[i]), r.inv[i]);
+        tmin = _mm_max_ps(tmin, _mm_min_ps(t1, t2));
+        tmax = _mm_min_ps(tmax, _mm_max_ps(t1, t2));
+      }
+      const __m128 hit = _mm_and_ps(_mm_cmpge_ps(tmax, _mm_max_ps(tmin, _mm_setzero_ps())),
+                                    _mm_cmplt_ps(tmin, maxDist));
+      return _mm_movemask_ps(hit);
+    }
+#endif
   };
 
   // --- Data ---
 
   struct BVH::Data {
-    std::vector<Triangle> triangles;
-    std::vector<AABB> triAABBs;       // per-triangle AABB
-    std::vector<Vec> triCentroids;    // per-triangle centroid
+    static_assert(sizeof(BVHNode) == 32, "BVH nodes must stay 32 bytes");
+
     std::vector<BVHNode> nodes;
-    std::vector<int> triIndices;      // reordered triangle indices
+    std::vector<TriVerts> verts;      // leaf order
+    std::vector<TriInfo> info;        // leaf order
+    std::vector<int> order;           // leaf position -> build() input index
+    TraversalMode mode = RayPackets;
+
+    // build-time only
+    std::vector<AABB> triAABBs;       // per input triangle
+    std::atomic<int> usedNodes{0};
+
+    static constexpr int MAX_LEAF_SIZE = 4;      // SAH may stop splitting at or below this
+    static constexpr int MAX_FORCED_LEAF = 16;   // largest leaf of coincident centroids
+    static constexpr int SAH_BINS = 16;
+    static constexpr float TRAVERSAL_COST = 1.0f; // relative to one triangle test
+    static constexpr int PARALLEL_BUILD_SIZE = 4096;
+    static constexpr int MAX_SAH_DEPTH = 64;     // median splits below this depth
+    static constexpr int STACK_SIZE = 128;       // > MAX_SAH_DEPTH + log2(#triangles)
+
+    struct Bin {
+      AABB bounds;
+      int count = 0;
+    };
+
+    void buildNode(int ni, std::vector<int> &idx, int start, int end, int depth) {
+      AABB bounds, cbounds;
+      for (int i = start; i < end; i++) {
+        const AABB &b = triAABBs[idx[i]];
+        bounds.expand(b);
+        const float c[3] = {b.centroid(0), b.centroid(1), b.centroid(2)};
+        cbounds.expand(c);
+      }
+      nodes[ni].setBounds(bounds);
+
+      const int count = end - start;
+      auto makeLeaf = [&] {
+        nodes[ni].leftOrFirst = start;
+        nodes[ni].count = count;
+      };
+      if (count <= 1) { makeLeaf(); return; }
+
+      // Binned SAH over all axes with non-zero centroid extent
+      int bestAxis = -1, bestBin = 0;
+      float bestCost = std::numeric_limits<float>::max();
+      if (depth < MAX_SAH_DEPTH) {
+        for (int axis = 0; axis < 3; axis++) {
+          const float lo = cbounds.min[axis], ext = cbounds.max[axis] - lo;
+          if (!(ext > 0)) continue;
+          const float scale = SAH_BINS / ext;
+          Bin bins[SAH_BINS];
+          for (int i = start; i < end; i++) {
+            const AABB &b = triAABBs[idx[i]];
+            const int k = std::min(SAH_BINS - 1, static_cast<int>((b.centroid(axis) - lo) * scale));
+            bins[k].count++;
+            bins[k].bounds.expand(b);
+          }
+          // right-to-left sweep stores the right side costs, the
+          // left-to-right sweep then evaluates every split plane
+          float rightCost[SAH_BINS];
+          AABB acc;
+          int n = 0;
+          for (int k = SAH_BINS - 1; k > 0; k--) {
+            acc.expand(bins[k].bounds);
+            n += bins[k].count;
+            rightCost[k] = n ? n * acc.area() : 0;
+          }
+          acc = AABB();
+          n = 0;
+          for (int k = 0; k < SAH_BINS - 1; k++) {
+            acc.expand(bins[k].bounds);
+            n += bins[k].count;
+            if (!n || n == count) continue;
+            const float cost = n * acc.area() + rightCost[k + 1];
+            if (cost < bestCost) {
+              bestCost = cost;
+              bestAxis = axis;
+              bestBin = k;
+            }
+          }
+        }
+      }
 
-    static constexpr int MAX_LEAF_SIZE = 4;
+      int mid;
+      if (bestAxis >= 0) {
+        const float parentArea = bounds.area();
+        const float splitCost = parentArea > 0 ? TRAVERSAL_COST + bestCost / parentArea : count;
+        if (count <= MAX_LEAF_SIZE && splitCost >= count) { makeLeaf(); return; }
+        const float lo = cbounds.min[bestAxis];
+        const float scale = SAH_BINS / (cbounds.max[bestAxis] - lo);
+        auto it = std::partition(idx.begin() + start, idx.begin() + end, [&](int t) {
+          const int k = std::min(SAH_BINS - 1, static_cast<int>((triAABBs[t].centroid(bestAxis) - lo) * scale));
+          return k <= bestBin;
+        });
+        mid = static_cast<int>(it - idx.begin());
+      } else if (depth < MAX_SAH_DEPTH && count <= MAX_FORCED_LEAF) {
+        // all centroids coincide: no plane separates them
+        makeLeaf();
+        return;
+      } else {
+        // very deep subtrees (or coincident centroids in large numbers):
+        // median split keeps the depth logarithmic
+        int axis = 0;
+        for (int a = 1; a < 3; a++) {
+          if (cbounds.max[a] - cbounds.min[a] > cbounds.max[axis] - cbounds.min[axis]) axis = a;
+        }
+        mid = (start + end) / 2;
+        std::nth_element(idx.begin() + start, idx.begin() + mid, idx.begin() + end,
+                         [&](int a, int b) {
+                           return triAABBs[a].centroid(axis) < triAABBs[b].centroid(axis);
+                         });
+      }
 
-    AABB computeTriAABB(int ti) const {
-      AABB box;
-      const auto &t = triangles[triIndices[ti]];
-      box.expand(t.a);
-      box.expand(t.b);
-      box.expand(t.c);
-      return box;
+      // children are allocated as adjacent pair after their parent, so
+      // parents always precede their children (used by refit)
+      const int left = usedNodes.fetch_add(2);
+      nodes[ni].leftOrFirst = left;
+      nodes[ni].count = 0;
+
+      if (count > PARALLEL_BUILD_SIZE) {
+        utils::ThreadPool::global().parallelForEach(2, [&](int i) {
+          if (i) buildNode(left + 1, idx, mid, end, depth + 1);
+          else buildNode(left, idx, start, mid, depth + 1);
+        });
+      } else {
+        buildNode(left, idx, start, mid, depth + 1);
+        buildNode(left + 1, idx, mid, end, depth + 1);
+      }
     }
 
-    int buildNode(int start, int end) {
-      int idx = (int)nodes.size();
-      nodes.push_back({});
-      auto &node = nodes[idx];
-
-      // Compute bounds over all triangles in range
-      for (int i = start; i < end; i++) {
-        node.bounds.expand(triAABBs[triIndices[i]]);
+    // recomputes all node bounds bottom-up from the current vertices
+    void refitBounds() {
+      const int n = static_cast<int>(nodes.size());
+      utils::parallelFor(0, n, 1024, [&](int a, int b) {
+        for (int i = a; i < b; i++) {
+          BVHNode &node = nodes[i];
+          if (!node.isLeaf()) continue;
+          AABB box;
+          for (int t = node.leftOrFirst; t < node.leftOrFirst + node.count; t++) {
+            box.expand(verts[t].bounds());
+          }
+          node.setBounds(box);
+        }
+      });
+      for (int i = n - 1; i >= 0; i--) {
+        BVHNode &node = nodes[i];
+        if (node.isLeaf()) continue;
+        const BVHNode &l = nodes[node.leftOrFirst], &r = nodes[node.leftOrFirst + 1];
+        for (int k = 0; k < 3; k++) {
+          node.min[k] = std::min(l.min[k], r.min[k]);
+          node.max[k] = std::max(l.max[k], r.max[k]);
+        }
       }
+    }
 
-      int count = end - start;
-      if (count <= MAX_LEAF_SIZE) {
-        // Leaf
-        node.triStart = start;
-        node.triCount = count;
-        return idx;
+    // single ray traversal of the subtree at root; updates bestT/bestTri
+    // if a closer hit is found
+    void traverse(const Ray &r, int root, float &bestT, int &bestTri) const {
+      // (entry distances are kept to skip nodes behind a closer hit found
+      // after they were pushed)
+      int stack[STACK_SIZE];
+      float stackT[STACK_SIZE];
+      int top = 0;
+      stackT[top] = nodes[root].intersectRay(r.o, r.inv, bestT);
+      if (stackT[top] == MISS) return;
+      stack[top++] = root;
+
+      while (top > 0) {
+        --top;
+        if (stackT[top] >= bestT) continue;
+        const BVHNode &node = nodes[stack[top]];
+
+        if (node.isLeaf()) {
+          for (int i = node.leftOrFirst; i < node.leftOrFirst + node.count; i++) {
+            const float t = intersectTriangle(r.o, r.d, verts[i]);
+            if (t < bestT) {
+              bestT = t;
+              bestTri = i;
+            }
+          }
+          continue;
+        }
+
+        // Visit the nearer child first: push it last
+        int near = node.leftOrFirst, far = near + 1;
+        float tNear = nodes[near].intersectRay(r.o, r.inv, bestT);
+        float tFar = nodes[far].intersectRay(r.o, r.inv, bestT);
+        if (tFar < tNear) {
+          std::swap(near, far);
+          std::swap(tNear, tFar);
+        }
+        if (tFar != MISS) { stackT[top] = tFar; stack[top++] = far; }
+        if (tNear != MISS) { stackT[top] = tNear; stack[top++] = near; }
       }
+    }
 
-      // Find split axis and position (median split on centroids)
-      AABB centroidBounds;
-      for (int i = start; i < end; i++) {
-        centroidBounds.expand(triCentroids[triIndices[i]]);
+#ifdef ICL_HAVE_SSE2
+    // packet traversal: a node is entered if any ray hits it; once only
+    // one ray is left, its subtree is finished with single ray traversal
+    void traverse4(const Ray *rays, float bestT[4], int bestTri[4]) const {
+      const RayPacket r(rays);
+      int stack[STACK_SIZE];
+      int top = 0;
+      stack[top++] = 0;
+
+      while (top > 0) {
+        const int ni = stack[--top];
+        const BVHNode &node = nodes[ni];
+        const int mask = node.intersectRays(r, _mm_loadu_ps(bestT));
+        if (!mask) continue;
+
+        if (!(mask & (mask - 1))) {
+          int i = 0;
+          while (!(mask & (1 << i))) i++;
+          traverse(rays[i], ni, bestT[i], bestTri[i]);
+          continue;
+        }
+
+        if (node.isLeaf()) {
+          // rays that missed the leaf box cannot hit its triangles closer
+          // than their current hit, so all lanes are updated
+          for (int k = node.leftOrFirst; k < node.leftOrFirst + node.count; k++) {
+            const __m128 t = intersectTriangle4(r, verts[k]);
+            const int closer = _mm_movemask_ps(_mm_cmplt_ps(t, _mm_loadu_ps(bestT)));
+            if (!closer) continue;
+            alignas(16) float tt[4];
+            _mm_store_ps(tt, t);
+            for (int i = 0; i < 4; i++) {
+              if (closer & (1 << i)) {
+                bestT[i] = tt[i];
+                bestTri[i] = k;
+              }
+            }
+          }
+          continue;
+        }
+
+        // order the children along the packet's mean direction
+        const BVHNode &a = nodes[node.leftOrFirst], &b = nodes[node.leftOrFirst + 1];
+        float ab = 0;
+        for (int i = 0; i < 3; i++) {
+          ab += ((b.min[i] + b.max[i]) - (a.min[i] + a.max[i])) * r.meanDir[i];
+        }
+        int near = node.leftOrFirst, far = near + 1;
+        if (ab < 0) std::swap(near, far);
+        stack[top++] = far;
+        stack[top++] = near;
       }
-      int axis = centroidBounds.longestAxis();
-
-      int mid = (start + end) / 2;
-      std::nth_element(triIndices.begin() + start,
-                       triIndices.begin() + mid,
-                       triIndices.begin() + end,
-                       [&](int a, int b) {
-                         return triCentroids[a][axis] < triCentroids[b][axis];
-                       });
-
-      // Need to update nodes[idx] after recursive calls since vector may realloc
-      int leftIdx = buildNode(start, mid);
-      int rightIdx = buildNode(mid, end);
-      nodes[idx].left = leftIdx;
-      nodes[idx].right = rightIdx;
-      nodes[idx].triCount = 0;  // internal node
-      return idx;
+    }
+#endif
+
+    BVHHit makeHit(const Ray &r, float t, int tri) const {
+      BVHHit hit;
+      if (tri < 0) return hit;
+      const float dx = r.d[0]*t, dy = r.d[1]*t, dz = r.d[2]*t;
+      hit.node = info[tri].node;
+      hit.color = info[tri].color;
+      hit.pos = Vec(r.o[0] + dx, r.o[1] + dy, r.o[2] + dz, 1);
+      hit.dist = std::sqrt(dx*dx + dy*dy + dz*dz);
+      return hit;
     }
   };
 
@@ -143,86 +490,137 @@ namespace icl::geom2 {
   BVH &BVH::operator=(BVH &&) noexcept = default;
 
   void BVH::build(std::vector<Triangle> &&triangles) {
-    m_data->triangles = std::move(triangles);
-    int n = (int)m_data->triangles.size();
-    if (n == 0) {
-      m_data->nodes.clear();
-      return;
-    }
-
-    // Pre-compute per-triangle AABBs and centroids
-    m_data->triAABBs.resize(n);
-    m_data->triCentroids.resize(n);
+    Data &d = *m_data;
+    const int n = (int)triangles.size();
+    d.nodes.clear();
+    d.verts.clear();
+    d.info.clear();
+    d.order.clear();
+    if (n == 0) return;
+
+    // Pre-compute per-triangle AABBs
+    d.triAABBs.resize(n);
+    utils::parallelFor(0, n, 4096, [&](int a, int b) {
+      for (int i = a; i < b; i++) {
+        TriVerts v;
+        v.set(triangles[i]);
+        d.triAABBs[i] = v.bounds();
+      }
+    });
+
+    // Build tree (a binary tree with n leaves at most has 2n-1 nodes)
+    std::vector<int> idx(n);
+    std::iota(idx.begin(), idx.end(), 0);
+    d.nodes.resize(2 * n - 1);
+    d.usedNodes = 1;
+    d.buildNode(0, idx, 0, n, 0);
+    d.nodes.resize(d.usedNodes);
+    d.nodes.shrink_to_fit();
+    d.triAABBs.clear();
+    d.triAABBs.shrink_to_fit();
+
+    // Store vertices and metadata in leaf order
+    d.verts.resize(n);
+    d.info.resize(n);
     for (int i = 0; i < n; i++) {
-      auto &t = m_data->triangles[i];
-      auto &box = m_data->triAABBs[i];
-      box = {};
-      box.expand(t.a);
-      box.expand(t.b);
-      box.expand(t.c);
-      m_data->triCentroids[i] = box.centroid();
+      const Triangle &t = triangles[idx[i]];
+      d.verts[i].set(t);
+      d.info[i] = {t.node, t.color};
     }
+    d.order = std::move(idx);
+    triangles.clear();
+  }
 
-    // Initialize index array
-    m_data->triIndices.resize(n);
-    std::iota(m_data->triIndices.begin(), m_data->triIndices.end(), 0);
-
-    // Build tree
-    m_data->nodes.clear();
-    m_data->nodes.reserve(2 * n);  // upper bound
-    m_data->buildNode(0, n);
+  void BVH::refit(std::vector<Triangle> &&triangles) {
+    Data &d = *m_data;
+    if (triangles.size() != d.order.size()) {
+      build(std::move(triangles));
+      return;
+    }
+    const int n = (int)triangles.size();
+    utils::parallelFor(0, n, 4096, [&](int a, int b) {
+      for (int i = a; i < b; i++) {
+        const Triangle &t = triangles[d.order[i]];
+        d.verts[i].set(t);
+        d.info[i] = {t.node, t.color};
+      }
+    });
+    d.refitBounds();
+    triangles.clear();
   }
 
   BVHHit BVH::intersect(const geom::ViewRay &ray) const {
-    if (m_data->nodes.empty()) return {};
-
-    Vec invDir(1.0f / (ray.direction[0] != 0 ? ray.direction[0] : 1e-20f),
-               1.0f / (ray.direction[1] != 0 ? ray.direction[1] : 1e-20f),
-               1.0f / (ray.direction[2] != 0 ? ray.direction[2] : 1e-20f),
-               0);
-
-    float bestDistSq = 1e30f;
-    BVHHit result;
-
-    // Stack-based traversal (no recursion)
-    int stack[64];
-    int top = 0;
-    stack[top++] = 0;  // root
-
-    while (top > 0) {
-      int ni = stack[--top];
-      const auto &node = m_data->nodes[ni];
+    const Data &d = *m_data;
+    if (d.nodes.empty()) return {};
+    const Ray r(ray);
+    float bestT = MISS;
+    int bestTri = -1;
+    d.traverse(r, 0, bestT, bestTri);
+    return d.makeHit(r, bestT, bestTri);
+  }
 
-      if (!node.bounds.intersectsRay(ray.offset, invDir, std::sqrt(bestDistSq))) {
-        continue;
+  void BVH::intersect4(const geom::ViewRay *rays, BVHHit *hits) const {
+    const Data &d = *m_data;
+    if (d.nodes.empty()) {
+      std::fill(hits, hits + 4, BVHHit());
+      return;
+    }
+    const Ray r[4] = {Ray(rays[0]), Ray(rays[1]), Ray(rays[2]), Ray(rays[3])};
+    float bestT[4] = {MISS, MISS, MISS, MISS};
+    int bestTri[4] = {-1, -1, -1, -1};
+
+#ifdef ICL_HAVE_SSE2
+    // packets only pay off if all rays traverse the tree in similar order
+    bool coherent = true;
+    for (int i = 1; i < 4; i++) {
+      for (int k = 0; k < 3; k++) {
+        coherent = coherent && std::signbit(r[i].d[k]) == std::signbit(r[0].d[k]);
       }
+    }
+    if (coherent) {
+      d.traverse4(r, bestT, bestTri);
+    } else
+#endif
+    {
+      for (int i = 0; i < 4; i++) d.traverse(r[i], 0, bestT[i], bestTri[i]);
+    }
+    for (int i = 0; i < 4; i++) hits[i] = d.makeHit(r[i], bestT[i], bestTri[i]);
+  }
 
-      if (node.isLeaf()) {
-        // Test triangles in leaf
-        for (int i = node.triStart; i < node.triStart + node.triCount; i++) {
-          const auto &tri = m_data->triangles[m_data->triIndices[i]];
-          Vec ip;
-          auto r = ray.getIntersectionWithTriangle(tri.a, tri.b, tri.c, &ip);
-          if (r == geom::ViewRay::foundIntersection) {
-            Vec d = ip - ray.offset;
-            float distSq = d[0]*d[0] + d[1]*d[1] + d[2]*d[2];
-            if (distSq < bestDistSq) {
-              bestDistSq = distSq;
-              result.node = tri.node;
-              result.pos = ip;
-              result.color = tri.color;
-              result.dist = std::sqrt(distSq);
-            }
+  void BVH::setTraversalMode(TraversalMode mode) { m_data->mode = mode; }
+  BVH::TraversalMode BVH::getTraversalMode() const { return m_data->mode; }
+
+  // Casts one ray per output pixel and passes the hits to store(idx, hit);
+  // rows are processed in pairs on the shared ThreadPool so that packets
+  // can cover 2x2 pixel blocks
+  template<class Store>
+  static void castCameraRays(const BVH &bvh, const geom::Camera &cam, int outW, int outH,
+                             int stepX, int stepY, Store store) {
+    const bool packets = bvh.getTraversalMode() == BVH::RayPackets;
+    auto ray = [&](int x, int y) {
+      return cam.getViewRay(utils::Point32f(x * stepX + stepX * 0.5f, y * stepY + stepY * 0.5f));
+    };
+    utils::ThreadPool::global().parallelFor(0, (outH + 1) / 2, 1, [&](int r0, int r1) {
+      for (int y = 2 * r0; y < std::min(2 * r1, outH); y += 2) {
+        int x = 0;
+        if (packets && y + 1 < outH) {
+          for (; x + 1 < outW; x += 2) {
+            const geom::ViewRay rays[4] = {ray(x, y), ray(x + 1, y), ray(x, y + 1), ray(x + 1, y + 1)};
+            BVHHit hits[4];
+            bvh.intersect4(rays, hits);
+            store(y * outW + x, hits[0]);
+            store(y * outW + x + 1, hits[1]);
+            store((y + 1) * outW + x, hits[2]);
+            store((y + 1) * outW + x + 1, hits[3]);
+          }
+        }
+        for (int yy = y; yy < std::min(y + 2, outH); yy++) {
+          for (int xx = x; xx < outW; xx++) {
+            store(yy * outW + xx, bvh.intersect(ray(xx, yy)));
           }
         }
-      } else {
-        // Push children (push far child first so near child is processed first)
-        stack[top++] = node.left;
-        stack[top++] = node.right;
       }
-    }
-
-    return result;
+    });
   }
 
   void BVH::raycastImage(const geom::Camera &cam, PointCloud &cloud,
@@ -241,26 +639,16 @@ namespace icl::geom2 {
     core::DataSegment<float,4> rgbaSeg;
     if (hasColor) rgbaSeg = cloud.selectRGBA32f();
 
-    #pragma omp parallel for schedule(dynamic, 8) collapse(2)
-    for (int y = 0; y < outH; y++) {
-      for (int x = 0; x < outW; x++) {
-        int idx = y * outW + x;
-        float px = x * stepX + stepX * 0.5f;
-        float py = y * stepY + stepY * 0.5f;
-
-        geom::ViewRay ray = cam.getViewRay(utils::Point32f(px, py));
-        BVHHit hit = intersect(ray);
-
-        auto &xyz = xyzSeg[idx];
-        if (hit) {
-          xyz[0] = hit.pos[0]; xyz[1] = hit.pos[1]; xyz[2] = hit.pos[2];
-          if (hasColor) rgbaSeg[idx] = hit.color;
-        } else {
-          xyz[0] = xyz[1] = xyz[2] = 0;
-          if (hasColor) rgbaSeg[idx] = GeomColor(0,0,0,0);
-        }
+    castCameraRays(*this, cam, outW, outH, stepX, stepY, [&](int idx, const BVHHit &hit) {
+      auto &xyz = xyzSeg[idx];
+      if (hit) {
+        xyz[0] = hit.pos[0]; xyz[1] = hit.pos[1]; xyz[2] = hit.pos[2];
+        if (hasColor) rgbaSeg[idx] = hit.color;
+      } else {
+        xyz[0] = xyz[1] = xyz[2] = 0;
+        if (hasColor) rgbaSeg[idx] = GeomColor(0,0,0,0);
       }
-    }
+    });
   }
 
   BVH::ImageResult BVH::raycastToImage(const geom::Camera &cam,
@@ -291,38 +679,27 @@ namespace icl::geom2 {
     icl8u *bData = result.image.getData(2);
     float *dData = wantDepth ? result.depth.getData(0) : nullptr;
 
-    #pragma omp parallel for schedule(dynamic, 8) collapse(2)
-    for (int y = 0; y < outH; y++) {
-      for (int x = 0; x < outW; x++) {
-        int idx = y * outW + x;
-        float px = x * stepX + stepX * 0.5f;
-        float py = y * stepY + stepY * 0.5f;
-
-        geom::ViewRay ray = cam.getViewRay(utils::Point32f(px, py));
-        BVHHit hit = intersect(ray);
-
-        if (hit) {
-          rData[idx] = static_cast<icl8u>(std::clamp(hit.color[0], 0.f, 255.f));
-          gData[idx] = static_cast<icl8u>(std::clamp(hit.color[1], 0.f, 255.f));
-          bData[idx] = static_cast<icl8u>(std::clamp(hit.color[2], 0.f, 255.f));
-
-          if (dData) {
-            if (mode == DistToCamCenter) {
-              dData[idx] = hit.dist;
-            } else {
-              // DistToCamPlane: project hit-to-camera vector onto forward direction
-              Vec diff = hit.pos - camPos;
-              dData[idx] = diff[0]*camFwd[0] + diff[1]*camFwd[1] + diff[2]*camFwd[2];
-            }
-          }
+    castCameraRays(*this, cam, outW, outH, stepX, stepY, [&](int idx, const BVHHit &hit) {
+      if (!hit) return;
+      rData[idx] = static_cast<icl8u>(std::clamp(hit.color[0], 0.f, 255.f));
+      gData[idx] = static_cast<icl8u>(std::clamp(hit.color[1], 0.f, 255.f));
+      bData[idx] = static_cast<icl8u>(std::clamp(hit.color[2], 0.f, 255.f));
+
+      if (dData) {
+        if (mode == DistToCamCenter) {
+          dData[idx] = hit.dist;
+        } else {
+          // DistToCamPlane: project hit-to-camera vector onto forward direction
+          Vec diff = hit.pos - camPos;
+          dData[idx] = diff[0]*camFwd[0] + diff[1]*camFwd[1] + diff[2]*camFwd[2];
         }
       }
-    }
+    });
 
     return result;
   }
 
-  int BVH::getTriangleCount() const { return (int)m_data->triangles.size(); }
+  int BVH::getTriangleCount() const { return (int)m_data->verts.size(); }
   int BVH::getNodeCount() const { return (int)m_data->nodes.size(); }
 
 } // namespace icl::geom2
@@ -37,8 +37,21 @@ namespace icl::geom2 {
 
   /// Bounding Volume Hierarchy for fast ray-triangle intersection
   /** Build from a list of world-space triangles, then query with rays.
-      Uses median-split construction and stack-based traversal.
-      Thread-safe for concurrent queries after build(). */
+      Construction uses a binned surface area heuristic (SAH); large
+      subtrees are built concurrently on the shared ThreadPool. Nodes are
+      32 bytes (bounds plus child/leaf range indices), triangles are
+      stored as plain vertex arrays in leaf order, and the hit metadata
+      (node, color) is kept in a separate array that is only touched for
+      the final hit. Traversal visits the nearer child first.
+
+      Coherent rays (the primary rays of neighbouring pixels) can be traced
+      as 4-ray packets with SIMD box and triangle tests, see intersect4().
+      raycastImage() and raycastToImage() use 2x2 pixel packets by default
+      (setTraversalMode()).
+
+      For animated scenes, refit() updates the bounds for moved geometry
+      without rebuilding the tree topology.
+      Thread-safe for concurrent queries after build() or refit(). */
   class ICLGeom2_API BVH {
   public:
     /// A single triangle with metadata for hit reporting
@@ -57,10 +70,39 @@ namespace icl::geom2 {
     /// Build from a list of triangles (moves the data in)
     void build(std::vector<Triangle> &&triangles);
 
+    /// Updates the triangles and node bounds without rebuilding the tree
+    /** triangles must be given in the same order as passed to build(),
+        typically re-collected after Node transforms changed. The tree
+        topology is kept, so traversal gets slower if geometry moved far
+        relative to each other; rebuild in that case. If the triangle count
+        differs from the built one, the tree is rebuilt instead. */
+    void refit(std::vector<Triangle> &&triangles);
+
     /// Find the closest intersection along a ray
     BVHHit intersect(const geom::ViewRay &ray) const;
 
-    /// Raycast an entire camera image into a point cloud (OpenMP-parallel)
+    /// Find the closest intersections along 4 rays using packet traversal
+    /** A node is visited if any of the rays hits its bounds; subtrees that
+        only a single ray reaches are continued with single ray traversal.
+        Rays whose directions differ in sign are traced one by one. The
+        hits are the same as those of intersect() for each ray.
+        @param rays  4 rays, ideally with a common origin and similar directions
+        @param hits  receives the 4 results */
+    void intersect4(const geom::ViewRay *rays, BVHHit *hits) const;
+
+    /// Ray traversal used by raycastImage() and raycastToImage()
+    enum TraversalMode {
+      SingleRays,   ///< one intersect() call per pixel
+      RayPackets    ///< intersect4() for 2x2 pixel blocks (default)
+    };
+
+    /// Sets the traversal mode of the raycast functions
+    void setTraversalMode(TraversalMode mode);
+
+    /// Returns the traversal mode of the raycast functions
+    TraversalMode getTraversalMode() const;
+
+    /// Raycast an entire camera image into a point cloud (rows run on the shared ThreadPool)
     /** @param cam    camera to cast from
         @param cloud  target (must support XYZ; RGBA32f written if available)
         @param stepX  pixel step in X (>1 for subsampling)
@@ -93,7 +135,7 @@ namespace icl::geom2 {
     /// Number of triangles in the BVH
     int getTriangleCount() const;
 
-    /// Number of internal nodes
+    /// Number of tree nodes (internal nodes and leaves)
     int getNodeCount() const;
 
   private:
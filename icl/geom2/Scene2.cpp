@@ -402,8 +402,9 @@ namespace icl::geom2 {
     }
   }
 
-  // Build a BVH from the scene's prepared geometry
-  static BVH buildSceneBVH(const std::vector<PreparedGeom> &geoms) {
+  // Flatten the scene's prepared geometry into BVH triangles (the order
+  // only depends on the scene structure, so it is stable for refitting)
+  static std::vector<BVH::Triangle> collectSceneTriangles(const std::vector<PreparedGeom> &geoms) {
     std::vector<BVH::Triangle> tris;
     for (const auto &pg : geoms) {
       int nTri = (int)pg.triIndices.size() / 3;
@@ -417,17 +418,25 @@ namespace icl::geom2 {
         });
       }
     }
+    return tris;
+  }
+
+  BVH Scene2::buildBVH() const {
+    std::vector<PreparedGeom> geoms;
+    for (auto &node : m_data->objects) {
+      collectPreparedGeom(node.get(), geoms);
+    }
     BVH bvh;
-    bvh.build(std::move(tris));
+    bvh.build(collectSceneTriangles(geoms));
     return bvh;
   }
 
-  BVH Scene2::buildBVH() const {
+  void Scene2::refitBVH(BVH &bvh) const {
     std::vector<PreparedGeom> geoms;
     for (auto &node : m_data->objects) {
       collectPreparedGeom(node.get(), geoms);
     }
-    return buildSceneBVH(geoms);
+    bvh.refit(collectSceneTriangles(geoms));
   }
 
 } // namespace icl::geom2
@@ -117,6 +117,12 @@ namespace icl::geom2 {
         Thread-safe for concurrent queries after construction. */
     BVH buildBVH() const;
 
+    /// Update a BVH from buildBVH() after node transforms changed
+    /** Re-collects the world-space triangles and refits the BVH's bounds
+        instead of rebuilding it (see BVH::refit). If adding, removing or
+        hiding geometry changed the triangle count, the BVH is rebuilt. */
+    void refitBVH(BVH &bvh) const;
+
     // --- Cursor (rotation center for mouse navigation) ---
     void setCursor(const Vec &pos);
     Vec getCursor() const;
@@ -9,7 +9,9 @@
 #include <algorithm>
 #include <icl/utils/Exception.h>
 #include <icl/utils/StringUtils.h>
+#include <icl/utils/ThreadPool.h>
 #include <icl/core/CoreFunctions.h>
+#include <icl/core/Img.h>
 
 #include <cstring>
 #include <cstdint>
@@ -59,8 +61,8 @@ namespace icl::io {
   //   offset  size  field
   //   ------  ----  ----------------------------------------------------
   //        0    4   magic = 'I''C''L''C'
-  //        4    2   version = 1                          (uint16)
-  //        6    2   flags (reserved, 0)                  (uint16)
+  //        4    2   version = 1, 2 if flags != 0         (uint16)
+  //        6    2   flags: 1 = tiled payload             (uint16)
   //        8    4   width                                (int32)
   //       12    4   height                               (int32)
   //       16    4   channels                             (int32)
@@ -83,12 +85,33 @@ namespace icl::io {
   // intentionally break the pre-Session-47 wire format (Header::Params
   // POD) so codec names can be longer than 4 chars and per-codec params
   // can be richer than `int32 quality`.
+  //
+  // Tiled payload (flag 1): the image is split into T tiles — bands of
+  // rows (all channels) or single channels — that were compressed
+  // independently, each by its own plugin instance:
+  //
+  //        0    1   tile mode (0 = rows, 1 = channels)   (uint8)
+  //        1    1   reserved (0)                         (uint8)
+  //        2    2   tile count T                         (uint16)
+  //        4   4T   tile payload lengths                 (uint32 each)
+  //                 tile payloads follow, in tile order
+  //
+  // Row tile i covers rows [i*H/T, (i+1)*H/T). Tiled envelopes carry
+  // version 2, so version-1 readers reject them instead of misreading
+  // the payload; untiled envelopes are unchanged.
   // ----------------------------------------------------------------------
 
   namespace {
     constexpr int kFixedPrefix = 46;
     constexpr char kMagic[4] = {'I','C','L','C'};
     constexpr uint16_t kVersion = 1;
+    constexpr uint16_t kVersionTiled = 2;
+    constexpr uint16_t kFlagTiled = 1;
+    constexpr int kTileHeader = 4;
+    /// images of at least this many bytes are tiled in automatic mode ("tiles" = 0)
+    constexpr std::size_t kAutoTileBytes = std::size_t(1) << 20;
+    /// minimum tile height in automatic mode
+    constexpr int kAutoTileRows = 32;
 
     template <typename T> void writeLE(icl8u *&p, T v) {
       std::memcpy(p, &v, sizeof(T));
@@ -109,6 +132,7 @@ namespace icl::io {
       std::string codecName;
       std::string codecParams;
       std::string meta;
+      uint16_t    flags = 0;
     };
 
     int envelopeSize(const EnvelopeFields &f) {
@@ -121,8 +145,8 @@ namespace icl::io {
     void writeEnvelope(icl8u *dst, const EnvelopeFields &f) {
       icl8u *p = dst;
       std::memcpy(p, kMagic, 4); p += 4;
-      writeLE<uint16_t>(p, kVersion);
-      writeLE<uint16_t>(p, 0);  // flags
+      writeLE<uint16_t>(p, f.flags ? kVersionTiled : kVersion);
+      writeLE<uint16_t>(p, f.flags);
       writeLE<int32_t>(p, f.params.getSize().width);
       writeLE<int32_t>(p, f.params.getSize().height);
       writeLE<int32_t>(p, f.params.getChannels());
@@ -152,10 +176,11 @@ namespace icl::io {
       }
       const icl8u *p = bytes + 4;
       const uint16_t version = readLE<uint16_t>(p);
-      if (version != kVersion) {
+      if (version != kVersion && version != kVersionTiled) {
         throw ICLException("ImageCompressor::parseEnvelope: unsupported version " + str(version));
       }
-      readLE<uint16_t>(p);  // flags (ignored for now)
+      out.flags = readLE<uint16_t>(p);
+      if (version == kVersion) out.flags = 0;
 
       const int32_t w  = readLE<int32_t>(p);
       const int32_t h  = readLE<int32_t>(p);
@@ -190,6 +215,25 @@ namespace icl::io {
 
       return static_cast<int>(p - bytes);  // payload offset
     }
+
+    /// Shallow view of rows [y0,y1) (channel c only if c >= 0) of img
+    /** Channel data is planar, so a band of rows is contiguous and can
+        be wrapped without copying. */
+    Image tileView(const ImgBase *img, int y0, int y1, int c) {
+      const int w = img->getWidth();
+      const int c0 = c < 0 ? 0 : c, nc = c < 0 ? img->getChannels() : 1;
+      Image tile;
+      Image(*img).visit([&](const auto &typed) {
+        using T = typename std::decay_t<decltype(typed)>::type;
+        std::vector<T*> ptrs(nc);
+        for (int i = 0; i < nc; ++i) {
+          ptrs[i] = const_cast<T*>(typed.getData(c0 + i)) + static_cast<std::size_t>(y0) * w;
+        }
+        tile = Image(new Img<T>(Size(w, y1 - y0), nc, ptrs));
+        if (c < 0) tile.ptr()->setFormat(img->getFormat());
+      });
+      return tile;
+    }
   } // anonymous namespace
 
   // ------------------------------------------------------- pimpl --
@@ -203,6 +247,33 @@ namespace icl::io {
     std::unique_ptr<CompressionPlugin> decodePlugin;  // dispatched per-message; cached if
                                                      // the codec didn't change between calls
     std::string                        decodePluginName;
+
+    int                                tiles = 1;        // 1 = off, 0 = automatic
+    bool                               channelTiles = false;
+    std::vector<std::unique_ptr<CompressionPlugin>> tilePlugins;        // one per tile
+    std::vector<std::unique_ptr<CompressionPlugin>> tileDecodePlugins;  // one per tile
+    std::string                        tileDecodePluginName;
+    std::vector<CompressionPlugin::Bytes> tilePayloads;
+    std::vector<Image>                 tileImages;
+
+    /// number of tiles img is split into (1: untiled envelope)
+    int tileCount(const ImgBase *img) const {
+      if (tiles == 1) return 1;
+      if (channelTiles) return std::min(img->getChannels(), 0xffff);
+      if (tiles > 1) return std::min(tiles, img->getHeight());
+      const std::size_t bytes = static_cast<std::size_t>(img->getChannels())
+                              * img->getDim() * getSizeOf(img->getDepth());
+      if (bytes < kAutoTileBytes) return 1;
+      return std::clamp(img->getHeight() / kAutoTileRows, 1,
+                        ThreadPool::global().getConcurrency());
+    }
+
+    /// (re-)creates n plugin instances of the given codec in v
+    static void ensurePlugins(std::vector<std::unique_ptr<CompressionPlugin>> &v,
+                              std::size_t n, const std::string &name) {
+      if (!v.empty() && v.front()->name() != name) v.clear();
+      while (v.size() < n) v.push_back(compressionRegistry().getOrThrow(name).payload());
+    }
   };
 
   // -------------------------------------------------------- public --
@@ -232,8 +303,19 @@ namespace icl::io {
                 "the envelope, so it does NOT need to match this setting. "
                 "Each codec exposes its own tunables as sibling properties; "
                 "the set of siblings changes when `mode` changes.");
+    addProperty("tiles", "range", "[0,64]:1", "1", 0,
+                "Number of horizontal tiles that are compressed (and "
+                "decompressed) independently and in parallel. 1 = off "
+                "(readable by every ICL version), 0 = automatic (one tile "
+                "per thread-pool thread for images of 1MB or more). Lossy "
+                "codecs may show seams at tile borders.");
+    addProperty("tile mode", "menu", "rows,channels", "rows", 0,
+                "rows: tiles are bands of image rows. channels: one tile "
+                "per channel (used if tiles != 1).");
     Configurable::registerCallback([this](const Property &p){
       if (p.name == "mode") installPlugin(p.value, "");
+      else if (p.name == "tiles") m_data->tiles = parse<int>(p.value);
+      else if (p.name == "tile mode") m_data->channelTiles = (p.value == "channels");
     });
     installPlugin(spec.mode, spec.quality);
   }
@@ -276,8 +358,31 @@ namespace icl::io {
       throw ICLException("ImageCompressor::compress: image is null");
     }
 
-    // Encode payload via the active plugin.
-    const CompressionPlugin::Bytes payload = m_data->plugin->compress(img);
+    // Encode payload via the active plugin, or tile-wise via one plugin
+    // instance per tile (each configured like the active one).
+    const int nTiles = m_data->tileCount(img.ptr());
+    CompressionPlugin::Bytes payload{nullptr, 0};
+    if (nTiles > 1) {
+      const std::string params = m_data->plugin->getCodecParamsString();
+      Data::ensurePlugins(m_data->tilePlugins, nTiles, m_data->plugin->name());
+      m_data->tilePayloads.assign(nTiles, CompressionPlugin::Bytes{nullptr, 0});
+      const ImgBase *src = img.ptr();
+      const int h = src->getHeight();
+      ThreadPool::global().parallelFor(0, nTiles, 1, [&](int t0, int t1){
+        for (int t = t0; t < t1; ++t) {
+          CompressionPlugin &pl = *m_data->tilePlugins[t];
+          pl.setCodecParamsString(params);
+          const Image tile = m_data->channelTiles
+                           ? tileView(src, 0, h, t)
+                           : tileView(src, t * h / nTiles, (t + 1) * h / nTiles, -1);
+          m_data->tilePayloads[t] = pl.compress(tile);
+        }
+      });
+      for (const auto &b : m_data->tilePayloads) payload.len += b.len;
+      payload.len += kTileHeader + 4 * static_cast<std::size_t>(nTiles);
+    } else {
+      payload = m_data->plugin->compress(img);
+    }
 
     // Assemble envelope.
     EnvelopeFields f;
@@ -287,13 +392,26 @@ namespace icl::io {
     f.codecName   = m_data->plugin->name();
     f.codecParams = m_data->plugin->getCodecParamsString();
     f.meta        = skipMetaData ? std::string{} : img.ptr()->getMetaData();
+    f.flags       = nTiles > 1 ? kFlagTiled : 0;
 
     const int envSz   = envelopeSize(f);
     const int totalSz = envSz + static_cast<int>(payload.len);
 
     m_data->envelopeBuf.resize(static_cast<std::size_t>(totalSz));
     writeEnvelope(m_data->envelopeBuf.data(), f);
-    std::memcpy(m_data->envelopeBuf.data() + envSz, payload.data, payload.len);
+    if (nTiles > 1) {
+      icl8u *p = m_data->envelopeBuf.data() + envSz;
+      writeLE<uint8_t>(p, m_data->channelTiles ? 1 : 0);
+      writeLE<uint8_t>(p, 0);
+      writeLE<uint16_t>(p, static_cast<uint16_t>(nTiles));
+      for (const auto &b : m_data->tilePayloads) writeLE<uint32_t>(p, static_cast<uint32_t>(b.len));
+      for (const auto &b : m_data->tilePayloads) {
+        std::memcpy(p, b.data, b.len);
+        p += b.len;
+      }
+    } else {
+      std::memcpy(m_data->envelopeBuf.data() + envSz, payload.data, payload.len);
+    }
 
     // Compute compression ratio over the codec payload only (envelope
     // overhead is fixed and small; reporting raw vs. payload is the
@@ -309,6 +427,15 @@ namespace icl::io {
     EnvelopeFields f;
     const int payloadOffset = parseEnvelope(bytes, len, f);
 
+    if (f.flags & kFlagTiled) {
+      Image out = uncompressTiles(bytes + payloadOffset, len - payloadOffset,
+                                  f.params, f.d, f.codecName, f.codecParams);
+      if (!f.meta.empty()) out.ptr()->getMetaData() = f.meta;
+      out.ptr()->setTime(f.timestamp);
+      m_data->decoded = out;
+      return out;
+    }
+
     // Cache the decode plugin if the codec name didn't change between calls.
     if (m_data->decodePluginName != f.codecName) {
       m_data->decodePlugin     = compressionRegistry().getOrThrow(f.codecName).payload();
@@ -331,6 +458,62 @@ namespace icl::io {
     return out;
   }
 
+  Image ImageCompressor::uncompressTiles(const icl8u *bytes, int len,
+                                         const ImgParams &params, depth d,
+                                         const std::string &codec,
+                                         const std::string &codecParams) {
+    const icl8u *p = bytes;
+    if (len < kTileHeader) {
+      throw ICLException("ImageCompressor::uncompress: truncated tile header");
+    }
+    const bool channelTiles = readLE<uint8_t>(p) == 1;
+    readLE<uint8_t>(p);  // reserved
+    const int nTiles = readLE<uint16_t>(p);
+    const int w = params.getWidth(), h = params.getHeight(), nc = params.getChannels();
+    if (nTiles < 1 || (channelTiles ? nTiles != nc : nTiles > h)
+        || len < kTileHeader + 4 * nTiles) {
+      throw ICLException("ImageCompressor::uncompress: tile layout does not match the image");
+    }
+    std::vector<CompressionPlugin::Bytes> tiles(nTiles);
+    std::size_t offs = kTileHeader + 4 * static_cast<std::size_t>(nTiles);
+    for (auto &t : tiles) {
+      t.len = readLE<uint32_t>(p);
+      t.data = bytes + offs;
+      offs += t.len;
+    }
+    if (offs > static_cast<std::size_t>(len)) {
+      throw ICLException("ImageCompressor::uncompress: truncated tile payload");
+    }
+
+    if (m_data->tileDecodePluginName != codec) {
+      m_data->tileDecodePlugins.clear();
+      m_data->tileDecodePluginName = codec;
+    }
+    Data::ensurePlugins(m_data->tileDecodePlugins, nTiles, codec);
+
+    Image out(params.getSize(), d, nc, params.getFormat());
+    out.ptr()->setROI(params.getROI());
+    const int bpp = getSizeOf(d);
+    ThreadPool::global().parallelFor(0, nTiles, 1, [&](int t0, int t1){
+      for (int t = t0; t < t1; ++t) {
+        CompressionPlugin &pl = *m_data->tileDecodePlugins[t];
+        pl.setCodecParamsString(codecParams);
+        const int y0 = channelTiles ? 0 : t * h / nTiles;
+        const int y1 = channelTiles ? h : (t + 1) * h / nTiles;
+        const int c0 = channelTiles ? t : 0, tc = channelTiles ? 1 : nc;
+        const ImgParams tp(Size(w, y1 - y0), tc, channelTiles ? formatMatrix : params.getFormat());
+        const Image tile = pl.decompress(tiles[t], tp, d);
+        const std::size_t n = static_cast<std::size_t>(w) * (y1 - y0) * bpp;
+        for (int c = 0; c < tc; ++c) {
+          std::memcpy(static_cast<icl8u*>(out.ptr()->getDataPtr(c0 + c))
+                      + static_cast<std::size_t>(y0) * w * bpp,
+                      tile.ptr()->getDataPtr(c), n);
+        }
+      }
+    });
+    return out;
+  }
+
   Time ImageCompressor::pickTimeStamp(const icl8u *bytes, int len) {
     EnvelopeFields f;
     parseEnvelope(bytes, len, f);
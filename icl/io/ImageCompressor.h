@@ -43,6 +43,19 @@ namespace icl::io {
       compatibility with the pre-Session 47 `Header::Params` POD
       (codec names are no longer 4-byte truncated; tunable codec
       parameters can be richer than `int32 quality`).
+
+      \section TILES Tiled compression
+      With the `tiles` property != 1, `compress()` splits the image
+      into bands of rows (`tile mode` = rows) or into its channels
+      (`tile mode` = channels) and compresses the tiles concurrently on
+      the global `utils::ThreadPool`, using one plugin instance per
+      tile. The receiver detects tiled envelopes and decodes the tiles
+      concurrently as well. Since every tile index always uses the same
+      plugin instance, stateful codec settings (e.g. the `keyframe
+      interval` of `zstd`) keep working. `tiles` = 0 picks one tile per
+      pool thread for images of 1MB or more. Tiled envelopes use
+      envelope version 2 — receivers built before tiling was added
+      cannot read them, so tiling is off by default.
    */
   class ICLIO_API ImageCompressor : public utils::Configurable {
     struct Data;
@@ -110,5 +123,11 @@ namespace icl::io {
     private:
     /// Replaces the active plugin and re-attaches it as a child Configurable.
     void installPlugin(const std::string &mode, const std::string &params);
+
+    /// Decodes a tiled payload (see \ref TILES) with one plugin per tile.
+    core::Image uncompressTiles(const icl8u *bytes, int len,
+                                const core::ImgParams &params, core::depth d,
+                                const std::string &codec,
+                                const std::string &codecParams);
   };
 } // namespace icl::io
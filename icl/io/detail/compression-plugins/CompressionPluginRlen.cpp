@@ -5,13 +5,18 @@
 // `rlen` codec: per-channel run-length encoding for icl8u images.
 // Quality 1/4/6/8 maps to bits-per-value (the rest is run-length); see
 // ImageCompressor.h for the historical description. Always built.
+// At the lossless quality 8, the channels can be pre-filtered by a
+// CompressionPreFilter (prediction, temporal delta) first, which turns
+// gradients and static background into runs.
 
 #include <icl/io/detail/compression-plugins/CompressionPlugin.h>
+#include <icl/io/detail/compression-plugins/CompressionPreFilter.h>
 #include <icl/io/detail/compression-plugins/CompressionRegistry.h>
 #include <icl/core/CoreFunctions.h>
 #include <icl/core/Img.h>
 #include <icl/utils/StringUtils.h>
 #include <icl/utils/Exception.h>
+#include <cstring>
 #include <vector>
 
 namespace icl::io {
@@ -136,7 +141,12 @@ namespace icl::io {
 
     class RlenPlugin : public CompressionPlugin {
       std::vector<icl8u> m_buf;
+      std::vector<icl8u> m_filtered;   // pre-filter header + channels
       int m_quality = 1;
+      CompressionPreFilter m_filter;
+
+      // the pre-filter requires lossless coding
+      bool filtered() const { return m_quality == 8 && m_filter.isActive(); }
 
     public:
       RlenPlugin() {
@@ -144,8 +154,16 @@ namespace icl::io {
                     "Bits-per-value for the RLE token. 1 = binary (best for "
                     "low-noise binary masks); 4/6 = lossy quantization; "
                     "8 = lossless byte-level RLE.");
+        addProperty("prediction", "menu", "none,left,up,paeth", "none", 0,
+                    "PNG-style per-channel prediction applied before the "
+                    "run-length coding (quality 8 only).");
+        addProperty("keyframe interval", "range", "[0,300]:1", "0", 0,
+                    "If > 0, only every n-th frame is sent completely; the "
+                    "others are sent as difference to that keyframe, which "
+                    "turns static background into runs (quality 8 only).");
         Configurable::registerCallback([this](const Property &p){
           if (p.name == "quality") m_quality = parse<int>(p.value);
+          else m_filter.setProperty(p.name, p.value);
         });
       }
 
@@ -159,10 +177,21 @@ namespace icl::io {
         const int dim   = p->getDim();
         const int nChan = p->getChannels();
         // Worst-case: q=8 emits 2 bytes per pixel; everyone else <= 1.
-        m_buf.resize(static_cast<std::size_t>(nChan) * dim * (m_quality == 8 ? 2 : 1));
+        m_buf.resize(static_cast<std::size_t>(nChan) * dim * (m_quality == 8 ? 2 : 1)
+                     + CompressionPreFilter::HEADER_SIZE);
         icl8u *out = m_buf.data();
-        for (int c = 0; c < nChan; ++c) {
-          out = encodeChannel(p->as8u()->getData(c), dim, out, m_quality);
+        if (filtered()) {
+          // header as is, then the run-length coded filtered channels
+          m_filter.encode(p, m_filtered);
+          out = std::copy(m_filtered.begin(), m_filtered.begin() + CompressionPreFilter::HEADER_SIZE, out);
+          for (int c = 0; c < nChan; ++c) {
+            out = encodeChannel(m_filtered.data() + CompressionPreFilter::HEADER_SIZE
+                                + static_cast<std::size_t>(c) * dim, dim, out, m_quality);
+          }
+        } else {
+          for (int c = 0; c < nChan; ++c) {
+            out = encodeChannel(p->as8u()->getData(c), dim, out, m_quality);
+          }
         }
         m_buf.resize(static_cast<std::size_t>(out - m_buf.data()));
         return {m_buf.data(), m_buf.size()};
@@ -177,15 +206,34 @@ namespace icl::io {
         out.ptr()->setROI(params.getROI());
         const int dim = out.getDim();
         const icl8u *src = bytes.data;
+        if (filtered()) {
+          const std::size_t hdr = CompressionPreFilter::HEADER_SIZE;
+          if (bytes.len < hdr) throw ICLException("rlen: pre-filter header missing");
+          m_filtered.resize(hdr + static_cast<std::size_t>(out.getChannels()) * dim);
+          std::memcpy(m_filtered.data(), src, hdr);
+          src += hdr;
+          for (int c = 0; c < out.getChannels(); ++c) {
+            src = decodeChannel(m_filtered.data() + hdr + static_cast<std::size_t>(c) * dim,
+                                dim, src, m_quality);
+          }
+          m_filter.decode(m_filtered.data(), m_filtered.size(), out.ptr());
+          return out;
+        }
         for (int c = 0; c < out.getChannels(); ++c) {
           src = decodeChannel(out.ptr()->as8u()->getData(c), dim, src, m_quality);
         }
         return out;
       }
 
-      std::string getCodecParamsString() const override { return str(m_quality); }
+      // "<quality>" or "8;<pre-filter>", e.g. "8;paeth,key30"
+      std::string getCodecParamsString() const override {
+        return filtered() ? str(m_quality) + ";" + m_filter.toString() : str(m_quality);
+      }
       void setCodecParamsString(const std::string &p) override {
-        if (!p.empty()) m_quality = parse<int>(p);
+        if (p.empty()) return;
+        const std::size_t sep = p.find(';');
+        m_quality = parse<int>(p.substr(0, sep));
+        m_filter.fromString(sep == std::string::npos ? "none" : p.substr(sep + 1));
       }
     };
   }
@@ -5,11 +5,14 @@
 // `zstd` codec: lossless general-purpose compression via libzstd.
 // Built only when ICL_HAVE_ZSTD. Treats image bytes as an opaque
 // planar concatenation (same layout as the `raw` plugin) — zstd does
-// the entropy coding on top.
+// the entropy coding on top. Optionally, the planar bytes are passed
+// through a CompressionPreFilter (prediction, byte planes, temporal
+// delta) first; the filter settings travel in the codec params.
 
 #ifdef ICL_HAVE_ZSTD
 
 #include <icl/io/detail/compression-plugins/CompressionPlugin.h>
+#include <icl/io/detail/compression-plugins/CompressionPreFilter.h>
 #include <icl/io/detail/compression-plugins/CompressionRegistry.h>
 #include <icl/core/CoreFunctions.h>
 #include <icl/core/Img.h>
@@ -18,7 +21,10 @@
 #include <icl/utils/Exception.h>
 
 #include <zstd.h>
+#include <algorithm>
 #include <cstring>
+#include <memory>
+#include <thread>
 #include <vector>
 
 namespace icl::io {
@@ -26,6 +32,9 @@ namespace icl::io {
   using namespace icl::utils;
 
   namespace {
+    /// frames of at least this size are compressed with zstd worker threads ("threads" = 0)
+    constexpr std::size_t kParallelBytes = std::size_t(4) << 20;
+
     // Pack channels planarly into `dst` (length must be ≥ nChan*dim*bpp).
     static void packPlanar(const ImgBase *p, icl8u *dst) {
       const int nChan = p->getChannels();
@@ -47,17 +56,45 @@ namespace icl::io {
     }
 
     class ZstdPlugin : public CompressionPlugin {
-      std::vector<icl8u> m_rawBuf;     // planar staging buffer
+      std::vector<icl8u> m_rawBuf;     // planar (or pre-filtered) staging buffer
       std::vector<icl8u> m_compressed; // zstd output
       int m_level = 3;                 // zstd default
+      int m_threads = 0;               // 0 = automatic
+      CompressionPreFilter m_filter;
+      // contexts are reused across frames (allocated on first use)
+      std::unique_ptr<ZSTD_CCtx, size_t(*)(ZSTD_CCtx*)> m_cctx{nullptr, ZSTD_freeCCtx};
+      std::unique_ptr<ZSTD_DCtx, size_t(*)(ZSTD_DCtx*)> m_dctx{nullptr, ZSTD_freeDCtx};
+
+      int workersFor(std::size_t len) const {
+        if (m_threads > 0) return m_threads;
+        if (len < kParallelBytes) return 0;
+        return std::clamp(static_cast<int>(std::thread::hardware_concurrency()), 1, 8);
+      }
 
     public:
       ZstdPlugin() {
         addProperty("level", "range", "[1,22]:1", "3", 0,
                     "zstd compression level (1=fastest, 22=smallest). "
                     "Default 3 matches libzstd's ZSTD_CLEVEL_DEFAULT.");
+        addProperty("threads", "range", "[0,16]:1", "0", 0,
+                    "zstd worker threads (0 = automatic: multi-threaded for "
+                    "frames of 4MB or more, if libzstd supports it).");
+        addProperty("prediction", "menu", "none,left,up,paeth", "none", 0,
+                    "PNG-style per-channel prediction applied before "
+                    "compression (reversible). paeth usually works best "
+                    "for camera and depth images.");
+        addProperty("split bytes", "flag", "", "false", 0,
+                    "Store the bytes of 16s/32s/32f/64f values as separate "
+                    "planes (low bytes first), which helps zstd a lot for "
+                    "depth images.");
+        addProperty("keyframe interval", "range", "[0,300]:1", "0", 0,
+                    "If > 0, only every n-th frame is sent completely; the "
+                    "others are sent as difference to that keyframe. "
+                    "Receivers that join a stream wait for the next keyframe.");
         Configurable::registerCallback([this](const Property &p){
           if (p.name == "level") m_level = parse<int>(p.value);
+          else if (p.name == "threads") m_threads = parse<int>(p.value);
+          else m_filter.setProperty(p.name, p.value);
         });
       }
 
@@ -65,16 +102,25 @@ namespace icl::io {
 
       Bytes compress(const Image &src) override {
         const ImgBase *p = src.ptr();
-        const std::size_t rawLen = static_cast<std::size_t>(p->getChannels())
-                                 * p->getDim() * getSizeOf(p->getDepth());
-        m_rawBuf.resize(rawLen);
-        packPlanar(p, m_rawBuf.data());
+        if (m_filter.isActive()) {
+          m_filter.encode(p, m_rawBuf);
+        } else {
+          m_rawBuf.resize(static_cast<std::size_t>(p->getChannels())
+                          * p->getDim() * getSizeOf(p->getDepth()));
+          packPlanar(p, m_rawBuf.data());
+        }
+        const std::size_t rawLen = m_rawBuf.size();
+
+        if (!m_cctx) m_cctx.reset(ZSTD_createCCtx());
+        ZSTD_CCtx_setParameter(m_cctx.get(), ZSTD_c_compressionLevel, m_level);
+        // fails without libzstd multi-threading support: stays single-threaded
+        ZSTD_CCtx_setParameter(m_cctx.get(), ZSTD_c_nbWorkers, workersFor(rawLen));
 
         const std::size_t maxCompressed = ZSTD_compressBound(rawLen);
         m_compressed.resize(maxCompressed);
-        const std::size_t actual = ZSTD_compress(
-          m_compressed.data(), maxCompressed,
-          m_rawBuf.data(), rawLen, m_level);
+        const std::size_t actual = ZSTD_compress2(
+          m_cctx.get(), m_compressed.data(), maxCompressed,
+          m_rawBuf.data(), rawLen);
         if (ZSTD_isError(actual)) {
           throw ICLException(std::string("zstd: compress failed: ")
                              + ZSTD_getErrorName(actual));
@@ -86,10 +132,12 @@ namespace icl::io {
       Image decompress(Bytes bytes, const ImgParams &params,
                        depth d) override {
         const std::size_t rawLen = static_cast<std::size_t>(params.getChannels())
-                                 * params.getSize().getDim() * getSizeOf(d);
+                                 * params.getSize().getDim() * getSizeOf(d)
+                                 + (m_filter.isActive() ? CompressionPreFilter::HEADER_SIZE : 0);
         m_rawBuf.resize(rawLen);
-        const std::size_t actual = ZSTD_decompress(
-          m_rawBuf.data(), rawLen, bytes.data, bytes.len);
+        if (!m_dctx) m_dctx.reset(ZSTD_createDCtx());
+        const std::size_t actual = ZSTD_decompressDCtx(
+          m_dctx.get(), m_rawBuf.data(), rawLen, bytes.data, bytes.len);
         if (ZSTD_isError(actual)) {
           throw ICLException(std::string("zstd: decompress failed: ")
                              + ZSTD_getErrorName(actual));
@@ -100,13 +148,20 @@ namespace icl::io {
         }
         Image out(params.getSize(), d, params.getChannels(), params.getFormat());
         out.ptr()->setROI(params.getROI());
-        unpackPlanar(m_rawBuf.data(), out.ptr());
+        if (m_filter.isActive()) m_filter.decode(m_rawBuf.data(), rawLen, out.ptr());
+        else unpackPlanar(m_rawBuf.data(), out.ptr());
         return out;
       }
 
-      std::string getCodecParamsString() const override { return str(m_level); }
+      // "<level>" or "<level>;<pre-filter>", e.g. "3;paeth,split,key30"
+      std::string getCodecParamsString() const override {
+        return m_filter.isActive() ? str(m_level) + ";" + m_filter.toString() : str(m_level);
+      }
       void setCodecParamsString(const std::string &p) override {
-        if (!p.empty()) m_level = parse<int>(p);
+        if (p.empty()) return;
+        const std::size_t sep = p.find(';');
+        m_level = parse<int>(p.substr(0, sep));
+        m_filter.fromString(sep == std::string::npos ? "none" : p.substr(sep + 1));
       }
     };
   }
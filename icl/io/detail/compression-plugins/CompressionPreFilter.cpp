@@ -0,0 +1,270 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// ICL - Image Component Library (https://github.com/iclcv/icl)
+// Copyright (C) 2006-2026 Christof Elbrechter
+
+#include <icl/io/detail/compression-plugins/CompressionPreFilter.h>
+#include <icl/core/CoreFunctions.h>
+#include <icl/utils/Exception.h>
+#include <icl/utils/StringUtils.h>
+
+#include <cstring>
+
+namespace icl::io {
+  using namespace icl::core;
+  using namespace icl::utils;
+
+  // ----------------------------------------------------------------------
+  // Header (little-endian):
+  //
+  //   offset  size  field
+  //   ------  ----  ----------------------------------------------------
+  //        0    1   prediction (Prediction enum)
+  //        1    1   flags: 1 = byte planes split, 2 = delta frame
+  //        2    1   bytes per value
+  //        3    1   reserved (0)
+  //        4    4   keyframe id (of this keyframe / the referenced one)
+  //                 filtered planar channel data follows
+  // ----------------------------------------------------------------------
+
+  namespace {
+    constexpr icl8u FLAG_SPLIT = 1;
+    constexpr icl8u FLAG_DELTA = 2;
+
+    /// writes v little-endian to p[0..3] (independent of the host byte order)
+    inline void write_u32_le(icl8u *p, std::uint32_t v){
+      for(int i = 0; i < 4; ++i) p[i] = static_cast<icl8u>(v >> (8*i));
+    }
+
+    /// reads a little-endian value from p[0..3]
+    inline std::uint32_t read_u32_le(const icl8u *p){
+      std::uint32_t v = 0;
+      for(int i = 0; i < 4; ++i) v |= static_cast<std::uint32_t>(p[i]) << (8*i);
+      return v;
+    }
+
+    /// PNG paeth predictor, written with unsigned distances only
+    /** pa = |b-c|, pb = |a-c| and pc = |(a-c)+(b-c)|. If a and b lie on
+        the same side of c, pc >= max(pa,pb) and c is never chosen */
+    template<class U>
+    inline U paeth(U a, U b, U c){
+      const bool aUp = a >= c, bUp = b >= c;
+      const U pa = bUp ? U(b - c) : U(c - b);
+      const U pb = aUp ? U(a - c) : U(c - a);
+      if(aUp == bUp) return pa <= pb ? a : b;
+      const U pc = pa > pb ? U(pa - pb) : U(pb - pa);
+      if(pa <= pb && pa <= pc) return a;
+      return pb <= pc ? b : c;
+    }
+
+    /// value predicted for position x of row (up: previous row or null)
+    template<class U>
+    inline U predict(CompressionPreFilter::Prediction p, const U *row, const U *up, int x){
+      switch(p){
+        case CompressionPreFilter::PredictLeft: return x ? row[x-1] : U(0);
+        case CompressionPreFilter::PredictUp: return up ? up[x] : U(0);
+        case CompressionPreFilter::PredictPaeth:
+          return paeth<U>(x ? row[x-1] : U(0), up ? up[x] : U(0), up && x ? up[x-1] : U(0));
+        default: return U(0);
+      }
+    }
+
+    /// res = v - prediction(v)
+    template<class U>
+    void apply_prediction(CompressionPreFilter::Prediction p, const U *v, U *res, int w, int h){
+      for(int y = 0; y < h; ++y){
+        const U *row = v + static_cast<std::size_t>(y) * w;
+        const U *up = y ? row - w : nullptr;
+        U *r = res + static_cast<std::size_t>(y) * w;
+        for(int x = 0; x < w; ++x) r[x] = U(row[x] - predict<U>(p, row, up, x));
+      }
+    }
+
+    /// v = res + prediction(v), in place
+    template<class U>
+    void revert_prediction(CompressionPreFilter::Prediction p, U *v, int w, int h){
+      for(int y = 0; y < h; ++y){
+        U *row = v + static_cast<std::size_t>(y) * w;
+        const U *up = y ? row - w : nullptr;
+        for(int x = 0; x < w; ++x) row[x] = U(row[x] + predict<U>(p, row, up, x));
+      }
+    }
+
+    template<class U>
+    void split_bytes(const U *v, std::size_t n, icl8u *dst){
+      for(std::size_t b = 0; b < sizeof(U); ++b){
+        icl8u *plane = dst + b * n;
+        for(std::size_t i = 0; i < n; ++i) plane[i] = static_cast<icl8u>(v[i] >> (8 * b));
+      }
+    }
+
+    template<class U>
+    void merge_bytes(const icl8u *src, std::size_t n, U *v){
+      std::fill(v, v + n, U(0));
+      for(std::size_t b = 0; b < sizeof(U); ++b){
+        const icl8u *plane = src + b * n;
+        for(std::size_t i = 0; i < n; ++i) v[i] = U(v[i] | (U(plane[i]) << (8 * b)));
+      }
+    }
+
+    /// filters channel data src into dst; key is the keyframe channel (delta frames only)
+    template<class U>
+    void encode_channel(const void *src, const icl8u *key, icl8u *dst, int w, int h,
+                        CompressionPreFilter::Prediction p, bool split){
+      const std::size_t n = static_cast<std::size_t>(w) * h;
+      std::vector<U> v(n), res(n);
+      std::memcpy(v.data(), src, n * sizeof(U));
+      if(key){
+        std::vector<U> k(n);
+        std::memcpy(k.data(), key, n * sizeof(U));
+        for(std::size_t i = 0; i < n; ++i) v[i] = U(v[i] - k[i]);
+      }
+      if(p != CompressionPreFilter::PredictNone) apply_prediction<U>(p, v.data(), res.data(), w, h);
+      else res.swap(v);
+      if(split && sizeof(U) > 1) split_bytes<U>(res.data(), n, dst);
+      else std::memcpy(dst, res.data(), n * sizeof(U));
+    }
+
+    template<class U>
+    void decode_channel(const icl8u *src, const icl8u *key, void *dst, int w, int h,
+                        CompressionPreFilter::Prediction p, bool split){
+      const std::size_t n = static_cast<std::size_t>(w) * h;
+      std::vector<U> v(n);
+      if(split && sizeof(U) > 1) merge_bytes<U>(src, n, v.data());
+      else std::memcpy(v.data(), src, n * sizeof(U));
+      if(p != CompressionPreFilter::PredictNone) revert_prediction<U>(p, v.data(), w, h);
+      if(key){
+        std::vector<U> k(n);
+        std::memcpy(k.data(), key, n * sizeof(U));
+        for(std::size_t i = 0; i < n; ++i) v[i] = U(v[i] + k[i]);
+      }
+      std::memcpy(dst, v.data(), n * sizeof(U));
+    }
+
+    /// calls f with a value of the unsigned integer type of bpp bytes
+    template<class F>
+    void with_value_type(int bpp, F &&f){
+      switch(bpp){
+        case 1: f(std::uint8_t()); break;
+        case 2: f(std::uint16_t()); break;
+        case 4: f(std::uint32_t()); break;
+        case 8: f(std::uint64_t()); break;
+        default: throw ICLException("CompressionPreFilter: unsupported value size " + str(bpp));
+      }
+    }
+  }
+
+  bool CompressionPreFilter::setProperty(const std::string &name, const std::string &value){
+    if(name == "prediction") prediction = parsePrediction(value);
+    else if(name == "split bytes") splitBytes = parse<bool>(value);
+    else if(name == "keyframe interval") keyframeInterval = parse<int>(value);
+    else return false;
+    return true;
+  }
+
+  std::string CompressionPreFilter::toString() const {
+    if(!isActive()) return "none";
+    std::string s = predictionName(prediction);
+    if(splitBytes) s += ",split";
+    if(keyframeInterval > 0) s += ",key" + str(keyframeInterval);
+    return s;
+  }
+
+  void CompressionPreFilter::fromString(const std::string &s){
+    prediction = PredictNone;
+    splitBytes = false;
+    keyframeInterval = 0;
+    for(const std::string &t : tok(s, ",")){
+      if(t == "split") splitBytes = true;
+      else if(t.rfind("key", 0) == 0) keyframeInterval = parse<int>(t.substr(3));
+      else prediction = parsePrediction(t);
+    }
+  }
+
+  CompressionPreFilter::Prediction CompressionPreFilter::parsePrediction(const std::string &s){
+    if(s == "none") return PredictNone;
+    if(s == "left") return PredictLeft;
+    if(s == "up") return PredictUp;
+    if(s == "paeth") return PredictPaeth;
+    throw ICLException("CompressionPreFilter: unknown prediction '" + s + "' (allowed: none, left, up, paeth)");
+  }
+
+  std::string CompressionPreFilter::predictionName(Prediction p){
+    static const char *names[] = { "none", "left", "up", "paeth" };
+    return names[p];
+  }
+
+  void CompressionPreFilter::encode(const ImgBase *src, std::vector<icl8u> &dst){
+    const int w = src->getWidth(), h = src->getHeight(), nChan = src->getChannels();
+    const int bpp = getSizeOf(src->getDepth());
+    const std::size_t chanLen = static_cast<std::size_t>(src->getDim()) * bpp;
+
+    bool delta = false;
+    if(keyframeInterval > 0){
+      delta = m_encKey.matches(src) && m_framesSinceKey < keyframeInterval;
+      if(!delta){
+        m_encKey.size = src->getSize();
+        m_encKey.channels = nChan;
+        m_encKey.d = src->getDepth();
+        m_encKey.data.resize(chanLen * nChan);
+        if(!++m_encKey.id) m_encKey.id = 1; // 0 marks frames without temporal delta
+        m_encKey.valid = true;
+        m_framesSinceKey = 0;
+      }
+      ++m_framesSinceKey;
+    }else{
+      m_encKey.valid = false;
+    }
+
+    dst.resize(HEADER_SIZE + chanLen * nChan);
+    icl8u *p = dst.data();
+    p[0] = static_cast<icl8u>(prediction);
+    p[1] = (splitBytes && bpp > 1 ? FLAG_SPLIT : 0) | (delta ? FLAG_DELTA : 0);
+    p[2] = static_cast<icl8u>(bpp);
+    p[3] = 0;
+    write_u32_le(p + 4, m_encKey.valid ? m_encKey.id : 0);
+
+    for(int c = 0; c < nChan; ++c){
+      icl8u *key = m_encKey.valid ? m_encKey.data.data() + c * chanLen : nullptr;
+      if(key && !delta) std::memcpy(key, src->getDataPtr(c), chanLen);
+      with_value_type(bpp, [&](auto t){
+        encode_channel<decltype(t)>(src->getDataPtr(c), delta ? key : nullptr,
+                                    p + HEADER_SIZE + c * chanLen, w, h, prediction, splitBytes);
+      });
+    }
+  }
+
+  void CompressionPreFilter::decode(const icl8u *data, std::size_t len, ImgBase *dst){
+    const int w = dst->getWidth(), h = dst->getHeight(), nChan = dst->getChannels();
+    const int bpp = getSizeOf(dst->getDepth());
+    const std::size_t chanLen = static_cast<std::size_t>(dst->getDim()) * bpp;
+    if(len != HEADER_SIZE + chanLen * nChan || data[2] != bpp || data[0] > PredictPaeth){
+      throw ICLException("CompressionPreFilter: filtered data does not match the image parameters");
+    }
+    const Prediction p = static_cast<Prediction>(data[0]);
+    const bool split = data[1] & FLAG_SPLIT, delta = data[1] & FLAG_DELTA;
+    const std::uint32_t id = read_u32_le(data + 4);
+
+    if(delta && !(m_decKey.matches(dst) && m_decKey.id == id)){
+      throw ICLException("CompressionPreFilter: delta frame refers to keyframe " + str(id)
+                         + ", which was not received (waiting for the next keyframe)");
+    }
+    const bool key = !delta && id;
+    if(key){
+      m_decKey.size = dst->getSize();
+      m_decKey.channels = nChan;
+      m_decKey.d = dst->getDepth();
+      m_decKey.data.resize(chanLen * nChan);
+      m_decKey.id = id;
+      m_decKey.valid = true;
+    }
+
+    for(int c = 0; c < nChan; ++c){
+      icl8u *k = key || delta ? m_decKey.data.data() + c * chanLen : nullptr;
+      with_value_type(bpp, [&](auto t){
+        decode_channel<decltype(t)>(data + HEADER_SIZE + c * chanLen, delta ? k : nullptr,
+                                    dst->getDataPtr(c), w, h, p, split);
+      });
+      if(key) std::memcpy(k, dst->getDataPtr(c), chanLen);
+    }
+  }
+} // namespace icl::io
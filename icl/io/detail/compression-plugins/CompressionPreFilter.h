@@ -0,0 +1,112 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// ICL - Image Component Library (https://github.com/iclcv/icl)
+// Copyright (C) 2006-2026 Christof Elbrechter
+
+#pragma once
+
+#include <icl/utils/CompatMacros.h>
+#include <icl/core/ImgBase.h>
+#include <icl/core/Types.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace icl::io {
+  /// Reversible pre-filters for the lossless compression plugins
+  /** Image data compresses poorly if it is passed to an entropy coder
+      as is: neighbouring pixels are similar, but rarely identical. The
+      pre-filter turns the planar image bytes into residuals that are
+      mostly close to zero, which zstd and rlen compress much better.
+      All steps work on the integer representation of the pixel values
+      with wrap-around arithmetic, so they are exactly reversible for
+      every depth (32f and 64f included).
+
+      Per channel, the following steps are applied in this order:
+        - <b>temporal delta</b> (keyframeInterval > 0): every
+          keyframeInterval-th frame is a keyframe, the others are
+          replaced by their difference to the last keyframe. Deltas refer
+          to the keyframe rather than to the previous frame, so a receiver
+          only depends on the last keyframe. A new keyframe is also sent
+          whenever the image parameters change.
+        - <b>spatial prediction</b>: PNG-style left, up or paeth
+          prediction of each value from its already coded neighbours
+          (values outside the image are predicted as 0).
+        - <b>byte plane splitting</b> (splitBytes, for depths with more
+          than one byte per value): all lowest bytes are stored first,
+          then all second bytes and so on. For depth images, the high
+          byte planes become almost constant.
+
+      The encoded data starts with a small header that contains the
+      applied filters and the frame's keyframe id, so the decoder does
+      not need to know the encoder's settings. A decoder that has not
+      received the keyframe a delta frame refers to (e.g. because it
+      connected to a running stream) throws an exception until the next
+      keyframe arrives.
+
+      The filter keeps the last keyframe as state, so one instance must
+      be used for one stream (in encode or decode direction). */
+  class CompressionPreFilter {
+    public:
+    enum Prediction {
+      PredictNone,
+      PredictLeft,
+      PredictUp,
+      PredictPaeth
+    };
+
+    /// size of the header that precedes the filtered data
+    static constexpr std::size_t HEADER_SIZE = 8;
+
+    Prediction prediction = PredictNone;
+    bool splitBytes = false;
+    int keyframeInterval = 0;   ///< 0: no temporal delta
+
+    /// returns whether any filter is enabled (otherwise encode just adds a header)
+    bool isActive() const {
+      return prediction != PredictNone || splitBytes || keyframeInterval > 0;
+    }
+
+    /// handles the common plugin properties "prediction", "split bytes" and "keyframe interval"
+    /** returns false if name is none of these */
+    bool setProperty(const std::string &name, const std::string &value);
+
+    /// serializes the settings (e.g. "paeth,split,key30", "none" if inactive)
+    std::string toString() const;
+
+    /// parses the result of toString()
+    void fromString(const std::string &s);
+
+    /// writes the header and the filtered planar data of src to dst (resized)
+    void encode(const core::ImgBase *src, std::vector<icl8u> &dst);
+
+    /// decodes the result of encode() into dst, which must have the encoded image's parameters
+    /** throws a utils::ICLException if the data is inconsistent or if
+        it refers to an unknown keyframe */
+    void decode(const icl8u *data, std::size_t len, core::ImgBase *dst);
+
+    /// parses a prediction name (none, left, up or paeth)
+    static Prediction parsePrediction(const std::string &s);
+
+    /// name of the given prediction mode
+    static std::string predictionName(Prediction p);
+
+    private:
+    struct KeyFrame {
+      std::vector<icl8u> data;   ///< planar values
+      utils::Size size;
+      int channels = 0;
+      core::depth d = core::depth8u;
+      std::uint32_t id = 0;
+      bool valid = false;
+      bool matches(const core::ImgBase *img) const {
+        return valid && img->getSize() == size && img->getChannels() == channels
+            && img->getDepth() == d;
+      }
+    };
+    KeyFrame m_encKey;           ///< last encoded keyframe
+    KeyFrame m_decKey;           ///< last decoded keyframe
+    int m_framesSinceKey = 0;
+  };
+} // namespace icl::io
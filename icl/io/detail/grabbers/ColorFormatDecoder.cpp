@@ -10,6 +10,11 @@
 
 #include <icl/io/detail/grabbers/MyrmexDecoder.h>
 #include <icl/core/BayerConverter.h>
+#include <icl/utils/SSETypes.h>
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
 
 using namespace icl::utils;
 using namespace icl::core;
@@ -153,6 +158,310 @@ namespace icl::io {
       interleavedToPlanar(data, (*dst)->as8u());
     }
 
+    // ++ fused decoders ++ //
+
+    // All fused decoders write the target format, depth and size in a
+    // single pass over the raw data. f is the integer downscaling factor
+    // (1 or 2); downscaled pixels are the rounded mean of their 2x2 block.
+
+    template<class D>
+    inline void copy_row(const icl8u *src, D *dst, int n){
+      if constexpr(std::is_same_v<D,icl8u>){
+        std::copy(src, src+n, dst);
+      }else{
+        for(int x=0;x<n;++x) dst[x] = src[x];
+      }
+    }
+
+    /// dst[x] = mean of r0[2x], r0[2x+1], r1[2x] and r1[2x+1]
+    template<class D>
+    inline void mean2x2_row(const icl8u *r0, const icl8u *r1, D *dst, int n){
+      int x = 0;
+#ifdef ICL_HAVE_SSE2
+      if constexpr(std::is_same_v<D,icl8u>){
+        const __m128i lo = _mm_set1_epi16(0xFF), two = _mm_set1_epi16(2);
+        for(; x <= n-8; x += 8){
+          const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r0 + 2*x));
+          const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r1 + 2*x));
+          __m128i sum = _mm_add_epi16(_mm_add_epi16(_mm_and_si128(a, lo), _mm_srli_epi16(a, 8)),
+                                      _mm_add_epi16(_mm_and_si128(b, lo), _mm_srli_epi16(b, 8)));
+          sum = _mm_srli_epi16(_mm_add_epi16(sum, two), 2);
+          _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + x), _mm_packus_epi16(sum, sum));
+        }
+      }
+#endif
+      for(; x < n; ++x){
+        dst[x] = static_cast<D>((r0[2*x] + r0[2*x+1] + r1[2*x] + r1[2*x+1] + 2) >> 2);
+      }
+    }
+
+    template<class D>
+    inline void yuv_to_rgb(int y, int u, int v, D *r, D *g, D *b){
+      int tr,tg,tb;
+      cc_util_yuv_to_rgb(y,u,v,tr,tg,tb);
+      *r = static_cast<D>(tr);
+      *g = static_cast<D>(tg);
+      *b = static_cast<D>(tb);
+    }
+
+    /// YUV to RGB with the float formula and the rounding (to nearest, ties
+    /// to even) of convertYUV420ToRGB8
+    template<class D>
+    inline void yuv420_to_rgb(int y, int u, int v, D *r, D *g, D *b){
+      icl32f tr,tg,tb;
+      cc_util_yuv_to_rgb(static_cast<icl32f>(y), static_cast<icl32f>(u), static_cast<icl32f>(v), tr, tg, tb);
+      *r = static_cast<D>(std::nearbyint(tr));
+      *g = static_cast<D>(std::nearbyint(tg));
+      *b = static_cast<D>(std::nearbyint(tb));
+    }
+
+#ifdef ICL_HAVE_SSE2
+    /// the 8 luma values of 16 bytes of packed 4:2:2 data as 16 bit values
+    template<int YOFF>
+    inline __m128i packed422_luma(const icl8u *src){
+      const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+      return YOFF ? _mm_srli_epi16(v, 8) : _mm_and_si128(v, _mm_set1_epi16(0xFF));
+    }
+#endif
+
+    /// luma of packed 4:2:2 data (luma at byte 2x+YOFF)
+    template<int YOFF, class D>
+    inline void packed422_luma_row(const icl8u *src, D *dst, int n){
+      int x = 0;
+#ifdef ICL_HAVE_SSE2
+      if constexpr(std::is_same_v<D,icl8u>){
+        for(; x <= n-16; x += 16){
+          const __m128i v = _mm_packus_epi16(packed422_luma<YOFF>(src + 2*x),
+                                             packed422_luma<YOFF>(src + 2*x + 16));
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), v);
+        }
+      }
+#endif
+      for(; x < n; ++x) dst[x] = src[2*x+YOFF];
+    }
+
+    /// 2x2 mean of the luma of packed 4:2:2 rows r0 and r1
+    template<int YOFF, class D>
+    inline void packed422_luma_mean_row(const icl8u *r0, const icl8u *r1, D *dst, int n){
+      int x = 0;
+#ifdef ICL_HAVE_SSE2
+      if constexpr(std::is_same_v<D,icl8u>){
+        const __m128i one = _mm_set1_epi16(1), two = _mm_set1_epi32(2);
+        auto pair_sums = [&](int offs){
+          return _mm_add_epi32(_mm_madd_epi16(packed422_luma<YOFF>(r0 + offs), one),
+                               _mm_madd_epi16(packed422_luma<YOFF>(r1 + offs), one));
+        };
+        for(; x <= n-8; x += 8){
+          const __m128i lo = _mm_srli_epi32(_mm_add_epi32(pair_sums(4*x), two), 2);
+          const __m128i hi = _mm_srli_epi32(_mm_add_epi32(pair_sums(4*x + 16), two), 2);
+          const __m128i v = _mm_packs_epi32(lo, hi);
+          _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + x), _mm_packus_epi16(v, v));
+        }
+      }
+#endif
+      for(; x < n; ++x){
+        dst[x] = static_cast<D>((r0[4*x+YOFF] + r0[4*x+YOFF+2] + r1[4*x+YOFF] + r1[4*x+YOFF+2] + 2) >> 2);
+      }
+    }
+
+    /// packed 4:2:2 (YUYV: YOFF=0, luma at even bytes, chroma order U,V)
+    template<int YOFF, class D>
+    void packed422_fused(const icl8u *data, const Size &size, Img<D> &dst, int f){
+      const int U = 1-YOFF, V = 3-YOFF;
+      const int w = dst.getWidth(), h = dst.getHeight(), stride = 2*size.width;
+      for(int y=0;y<h;++y){
+        const icl8u *r0 = data + y*f*stride, *r1 = r0 + (f-1)*stride;
+        const int o = y*w;
+        switch(dst.getFormat()){
+          case formatGray:
+            if(f == 1) packed422_luma_row<YOFF>(r0, dst.getData(0)+o, w);
+            else packed422_luma_mean_row<YOFF>(r0, r1, dst.getData(0)+o, w);
+            break;
+          case formatYUV:{
+            D *u = dst.getData(1)+o, *v = dst.getData(2)+o;
+            if(f == 1){
+              packed422_luma_row<YOFF>(r0, dst.getData(0)+o, w);
+              for(int x=0;x<w;++x){
+                u[x] = r0[(x>>1)*4+U];
+                v[x] = r0[(x>>1)*4+V];
+              }
+            }else{
+              packed422_luma_mean_row<YOFF>(r0, r1, dst.getData(0)+o, w);
+              for(int x=0;x<w;++x){
+                u[x] = static_cast<D>((r0[4*x+U] + r1[4*x+U] + 1) >> 1);
+                v[x] = static_cast<D>((r0[4*x+V] + r1[4*x+V] + 1) >> 1);
+              }
+            }
+            break;
+          }
+          case formatRGB:{
+            D *r = dst.getData(0)+o, *g = dst.getData(1)+o, *b = dst.getData(2)+o;
+            for(int x=0;x<w;++x){
+              const icl8u *m0 = r0 + (f == 1 ? (x>>1)*4 : 4*x), *m1 = r1 + (m0 - r0);
+              const int luma = f == 1 ? m0[YOFF + 2*(x&1)]
+                                      : (m0[YOFF] + m0[YOFF+2] + m1[YOFF] + m1[YOFF+2] + 2) >> 2;
+              const int u = (m0[U] + m1[U] + 1) >> 1, v = (m0[V] + m1[V] + 1) >> 1;
+              yuv_to_rgb(luma, u, v, r+x, g+x, b+x);
+            }
+            break;
+          }
+          default:
+            break;
+        }
+      }
+    }
+
+    /// planar 4:2:0, chroma either in separate U and V planes (YU12) or
+    /// interleaved in one UV plane (NV12)
+    template<bool NV12, class D>
+    void planar420_fused(const icl8u *data, const Size &size, Img<D> &dst, int f){
+      const int W = size.width, H = size.height;
+      const int w = dst.getWidth(), h = dst.getHeight();
+      const int step = NV12 ? 2 : 1;
+      const icl8u *U = data + W*H;
+      const icl8u *V = NV12 ? U + 1 : U + (W/2)*(H/2);
+      const int cstride = NV12 ? W : W/2;
+      for(int y=0;y<h;++y){
+        const icl8u *r0 = data + y*f*W, *r1 = r0 + (f-1)*W;
+        const int cy = f == 1 ? y>>1 : y;
+        const icl8u *u = U + cy*cstride, *v = V + cy*cstride;
+        const int o = y*w;
+        switch(dst.getFormat()){
+          case formatGray:
+            if(f == 1) copy_row(r0, dst.getData(0)+o, w);
+            else mean2x2_row(r0, r1, dst.getData(0)+o, w);
+            break;
+          case formatYUV:{
+            D *du = dst.getData(1)+o, *dv = dst.getData(2)+o;
+            if(f == 1){
+              copy_row(r0, dst.getData(0)+o, w);
+              for(int x=0;x<w;++x){
+                du[x] = u[(x>>1)*step];
+                dv[x] = v[(x>>1)*step];
+              }
+            }else{
+              mean2x2_row(r0, r1, dst.getData(0)+o, w);
+              for(int x=0;x<w;++x){
+                du[x] = u[x*step];
+                dv[x] = v[x*step];
+              }
+            }
+            break;
+          }
+          case formatRGB:{
+            D *r = dst.getData(0)+o, *g = dst.getData(1)+o, *b = dst.getData(2)+o;
+            for(int x=0;x<w;++x){
+              const int luma = f == 1 ? r0[x] : (r0[2*x] + r0[2*x+1] + r1[2*x] + r1[2*x+1] + 2) >> 2;
+              const int cx = (f == 1 ? x>>1 : x)*step;
+              yuv420_to_rgb(luma, u[cx], v[cx], r+x, g+x, b+x);
+            }
+            break;
+          }
+          default:
+            break;
+        }
+      }
+    }
+
+    /// gray sources (scaling and depth conversion only)
+    template<class D>
+    void gray_fused(const icl8u *data, const Size &size, Img<D> &dst, int f){
+      const int w = dst.getWidth(), W = size.width;
+      for(int y=0;y<dst.getHeight();++y){
+        const icl8u *r0 = data + y*f*W;
+        if(f == 1) copy_row(r0, dst.getData(0)+y*w, w);
+        else mean2x2_row(r0, r0 + W, dst.getData(0)+y*w, w);
+      }
+    }
+
+    /// Bayer sources at half resolution: each 2x2 cell becomes one pixel
+    /// (no demosaicing; green is the mean of both green samples)
+    template<BayerConverter::bayerPattern P, class D>
+    void bayer_fused(const icl8u *data, const Size &size, Img<D> &dst, int f){
+      const int i = P - BayerConverter::bayerPattern_RGGB;
+      const int rx = i >> 1, ry = i & 1;  // position of red in the cell (RGGB,GBRG,GRBG,BGGR)
+      const int rIdx = ry*size.width + rx, bIdx = (1-ry)*size.width + (1-rx);
+      const int g1Idx = ry*size.width + (1-rx), g2Idx = (1-ry)*size.width + rx;
+      const int w = dst.getWidth();
+      for(int y=0;y<dst.getHeight();++y){
+        const icl8u *c = data + 2*y*size.width;
+        const int o = y*w;
+        switch(dst.getFormat()){
+          case formatGray:{
+            D *d = dst.getData(0)+o;
+            for(int x=0;x<w;++x, c+=2){
+              d[x] = static_cast<D>((2*c[rIdx] + c[g1Idx] + c[g2Idx] + 2*c[bIdx] + 3) / 6);
+            }
+            break;
+          }
+          case formatRGB:{
+            D *r = dst.getData(0)+o, *g = dst.getData(1)+o, *b = dst.getData(2)+o;
+            for(int x=0;x<w;++x, c+=2){
+              r[x] = c[rIdx];
+              g[x] = static_cast<D>((c[g1Idx] + c[g2Idx] + 1) >> 1);
+              b[x] = c[bIdx];
+            }
+            break;
+          }
+          default:
+            break;
+        }
+      }
+    }
+
+    /// adapts a typed fused decoder to the fused_func signature (8u and 32f targets)
+    template<class Decoder>
+    bool fused(const icl8u *data, const Size &size, ImgBase **dst, format fmt, depth d, int f){
+      if((d != depth8u && d != depth32f) || !Decoder::supports(fmt, f)) return false;
+      if(f == 2 && (size.width % 2 || size.height % 2)) return false;
+      ensureCompatible(dst, d, Size(size.width/f, size.height/f), fmt);
+      if(d == depth8u) Decoder::apply(data, size, *(*dst)->as8u(), f);
+      else Decoder::apply(data, size, *(*dst)->as32f(), f);
+      return true;
+    }
+
+    template<int YOFF> struct Packed422 {
+      static bool supports(format fmt, int){
+        return fmt == formatGray || fmt == formatYUV || fmt == formatRGB;
+      }
+      template<class D> static void apply(const icl8u *data, const Size &size, Img<D> &dst, int f){
+        packed422_fused<YOFF>(data, size, dst, f);
+      }
+    };
+
+    template<bool NV12> struct Planar420 {
+      static bool supports(format fmt, int){
+        return fmt == formatGray || fmt == formatYUV || fmt == formatRGB;
+      }
+      template<class D> static void apply(const icl8u *data, const Size &size, Img<D> &dst, int f){
+        planar420_fused<NV12>(data, size, dst, f);
+      }
+    };
+
+    struct Gray {
+      static bool supports(format fmt, int){
+        return fmt == formatGray;
+      }
+      template<class D> static void apply(const icl8u *data, const Size &size, Img<D> &dst, int f){
+        gray_fused(data, size, dst, f);
+      }
+    };
+
+    template<BayerConverter::bayerPattern P> struct Bayer {
+      static bool supports(format fmt, int f){
+        return f == 2 && (fmt == formatGray || fmt == formatRGB);
+      }
+      template<class D> static void apply(const icl8u *data, const Size &size, Img<D> &dst, int f){
+        bayer_fused<P>(data, size, dst, f);
+      }
+    };
+
+    void nv12(const icl8u* data, const Size &size, ImgBase **dst, std::vector<icl8u>*){
+      fused<Planar420<true>>(data, size, dst, formatRGB, depth8u, 1);
+    }
+
+    // -- fused decoders -- //
+
   }
   ColorFormatDecoder::ColorFormatDecoder():m_dstBuf(0){
     m_functions[FourCC("GRAY").asInt()] = color_format_converter::gray;
@@ -169,6 +478,20 @@ namespace icl::io {
     m_functions[FourCC("GBRG").asInt()] = color_format_converter::bayer<BayerConverter::bayerPattern_GBRG>;
     m_functions[FourCC("GRBG").asInt()] = color_format_converter::bayer<BayerConverter::bayerPattern_GRBG>;
     m_functions[FourCC("BGGR").asInt()] = color_format_converter::bayer<BayerConverter::bayerPattern_BGGR>;
+    m_functions[FourCC("NV12").asInt()] = color_format_converter::nv12;
+
+    using namespace color_format_converter;
+    m_fused[FourCC("GRAY").asInt()] = fused<Gray>;
+    m_fused[FourCC("Y800").asInt()] = fused<Gray>;
+    m_fused[FourCC("GREY").asInt()] = fused<Gray>;
+    m_fused[FourCC("YUYV").asInt()] = fused<Packed422<0>>;
+    m_fused[FourCC("YUY2").asInt()] = fused<Packed422<1>>;
+    m_fused[FourCC("YU12").asInt()] = fused<Planar420<false>>;
+    m_fused[FourCC("NV12").asInt()] = fused<Planar420<true>>;
+    m_fused[FourCC("RGGB").asInt()] = fused<Bayer<BayerConverter::bayerPattern_RGGB>>;
+    m_fused[FourCC("GBRG").asInt()] = fused<Bayer<BayerConverter::bayerPattern_GBRG>>;
+    m_fused[FourCC("GRBG").asInt()] = fused<Bayer<BayerConverter::bayerPattern_GRBG>>;
+    m_fused[FourCC("BGGR").asInt()] = fused<Bayer<BayerConverter::bayerPattern_BGGR>>;
 
 #ifdef ICL_HAVE_LIBJPEG
     m_functions[FourCC("MJPG").asInt()] = color_format_converter::mjpg;
@@ -186,4 +509,22 @@ namespace icl::io {
       it->second(data,size,dst,&m_buffer);
     }
   }
+
+  bool ColorFormatDecoder::decode(FourCC fourcc, const icl8u *data, const Size &size, ImgBase **dst,
+                                  format dstFmt, depth dstDepth, const Size &dstSize){
+    auto it = m_fused.find(fourcc.asInt());
+    if(it != m_fused.end()){
+      const bool gray = fourcc.asString() == "GRAY" || fourcc.asString() == "Y800" || fourcc.asString() == "GREY";
+      const format fmt = static_cast<int>(dstFmt) == -1 ? (gray ? formatGray : formatRGB) : dstFmt;
+      const depth d = static_cast<int>(dstDepth) == -1 ? depth8u : dstDepth;
+      int f = 0;
+      if(dstSize == Size::null || dstSize == size) f = 1;
+      else if(dstSize.width*2 == size.width && dstSize.height*2 == size.height) f = 2;
+      // the plain decoders are used for their own default output
+      const bool isDefault = f == 1 && d == depth8u && fmt == (gray ? formatGray : formatRGB);
+      if(f && !isDefault && it->second(data,size,dst,fmt,d,f)) return true;
+    }
+    decode(fourcc,data,size,dst);
+    return false;
+  }
   } // namespace icl::io
\ No newline at end of file
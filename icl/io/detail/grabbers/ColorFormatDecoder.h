@@ -35,6 +35,32 @@ namespace icl::io {
         backend, the core::BayerConverter is used automatically)
       * <b>MJPG</b> Motion jpeg. Here, each image frame actually contains binary encoded
         jpeg data
+      * <b>NV12</b> planar 4:2:0 format like YU12, but with U and V interleaved in a
+        single plane
+
+      \section FUS Fused Decoding
+      Usually, the decoded image is converted to the format, depth and size that the
+      application wants afterwards (see Grabber::useDesired), which takes one or more
+      additional passes over the whole frame. The extended decode() method instead
+      writes the desired parameters directly where possible:
+      * GRAY/Y800/GREY, YUYV, YUY2, YU12 and NV12 to formatGray, formatYUV (YUV sources)
+        and formatRGB, with depth8u or depth32f, at full or half resolution. Gray output
+        of YUV sources is their luma channel.
+      * Bayer formats to formatGray or formatRGB at half resolution; each 2x2 cell becomes
+        one pixel without demosaicing.
+
+      Half resolution pixels are the rounded mean of their 2x2 block (chroma: of the
+      available samples). Other combinations are decoded the normal way.
+
+      RGB output of YU12 and NV12 uses the float formula of convertYUV420ToRGB8 (as the
+      YU12 decoder does), rounded to the nearest integer (full resolution 8u RGB output
+      of YU12 is the YU12 decoder's own result). Where a value is exactly halfway between
+      two integers, it may still differ by 1, as convertYUV420ToRGB8 rounds these up at
+      the end of its rows (non-SIMD remainder). Without SSE2, convertYUV420ToRGB8 uses a
+      different, table based formula. At half resolution, the YUV values are averaged
+      before the conversion, so the result differs from a downscaled RGB image at edges.
+      Packed 4:2:2 sources use the fixed point cc_util_yuv_to_rgb, like the YUYV and
+      YUY2 decoders.
 
       \section EX ICL Specific Extensions
       For supporting the Myrmex Tactile Device, we added an extra
@@ -47,9 +73,14 @@ namespace icl::io {
     // conversion function type
     using decoder_func = void(*)(const icl8u*,const utils::Size&,core::ImgBase**,std::vector<icl8u>*);
 
+    // fused conversion function type (target format, depth and downscaling
+    // factor); returns false if the target is not supported
+    using fused_func = bool(*)(const icl8u*,const utils::Size&,core::ImgBase**,core::format,core::depth,int);
+
     private:
     std::vector<icl8u> m_buffer; //!< internal buffer
     std::map<icl32u,decoder_func> m_functions; //!< internal lookup for conversion functions
+    std::map<icl32u,fused_func> m_fused; //!< internal lookup for fused conversion functions
     core::ImgBase *m_dstBuf;  //!< optionally used output buffer
 
     public:
@@ -67,6 +98,14 @@ namespace icl::io {
     /// decodes a given data range to RGB
     void decode(FourCC fourcc, const icl8u *data, const utils::Size &size, core::ImgBase **dst);
 
+    /// decodes directly into the given format, depth and size if possible
+    /** dstFmt, dstDepth and dstSize may be (format)-1, (depth)-1 and Size::null
+        to keep the decoder's default. If no fused decoder is available for the
+        given combination, the data is decoded as by decode(fourcc,data,size,dst)
+        and false is returned; the caller then has to adapt the result. */
+    bool decode(FourCC fourcc, const icl8u *data, const utils::Size &size, core::ImgBase **dst,
+                core::format dstFmt, core::depth dstDepth, const utils::Size &dstSize);
+
     /// decode, but use the internal buffer as output
     const core::ImgBase *decode(FourCC fourcc, const icl8u *data, const utils::Size &size){
       decode(fourcc,data,size,&m_dstBuf);
@@ -41,6 +41,9 @@ namespace icl::io {
       \section CFG Properties (Configurable)
         - `compression`         menu (none/raw/rlen/jpeg/png/1611)
         - `quality`             range, passed to ImageCompressor
+        - `compression.tiles`   parallel tiled compression (see
+                                ImageCompressor; WSGrabber decodes tiled
+                                frames automatically)
         - `max message size MB` range, default 256
         - `bind address`        info, e.g. `0.0.0.0`
         - `port`                info (the actually bound port)
@@ -78,10 +78,12 @@ namespace icl::io {
       std::vector<icl8u> convertBuffer;
       ColorFormatDecoder decoder;
       bool stoppedAlready;
+      const Grabber *grabber; //!< if given, its desired parameters are decoded directly
 
-      Impl(const std::string &deviceName, const std::string &initialFormat="", bool startGrabbing=true):
+      Impl(const std::string &deviceName, const std::string &initialFormat="", bool startGrabbing=true,
+           const Grabber *grabber=0):
         deviceName(deviceName),isGrabbing(startGrabbing),avoidDoubleFrames(true),lastTime(Time::now()),
-        image(0),imageOut(0),stoppedAlready(false){
+        image(0),imageOut(0),stoppedAlready(false),grabber(grabber){
 
         // note, \b is the word boundary special character (while $ is a line end which does not work so well here)
         if(deviceName.length() == 1 && match(deviceName,"^[0-9]\\b")){
@@ -452,7 +454,13 @@ namespace icl::io {
         if(deviceNameInfo == "Myrmex"){ // spezialization for the myrmex tactile device
           fourcc = FourCC("MYRM");
         }
-        decoder.decode(fourcc,p, currentSize, &image);
+        if(grabber){
+          // fused decoding saves the separate conversion in Grabber::adaptGrabResult
+          decoder.decode(fourcc,p, currentSize, &image, grabber->getDesired<format>(),
+                         grabber->getDesired<depth>(), grabber->getDesired<Size>());
+        }else{
+          decoder.decode(fourcc,p, currentSize, &image);
+        }
         if(image) image->setTime(t);
       }
 
@@ -670,7 +678,7 @@ namespace icl::io {
   V4L2Grabber::V4L2Grabber(const std::string &device)
     : implMutex()
   {
-    impl = new Impl(device);
+    impl = new Impl(device,"",true,this);
     addProperties();
   }
 
@@ -741,7 +749,7 @@ namespace icl::io {
       std::string oldDeviceName = impl->deviceName;
       impl->stop();
       delete impl;
-      impl = new Impl(oldDeviceName,addBraces(prop.value));
+      impl = new Impl(oldDeviceName,addBraces(prop.value),true,this);
       setPropertyValue("avoid doubled frames",impl->avoidDoubleFrames);
       for(Impl::PMap::const_iterator it=impl->supportedProperties.begin();
           it != impl->supportedProperties.end();++it){
@@ -4,6 +4,7 @@
 
 #include <vector>
 #include <algorithm>
+#include <bit>
 
 #include <memory>
 #include <icl/utils/Exception.h>
@@ -42,9 +43,14 @@ namespace icl::markers {
   static std::shared_ptr<icl8u> static_indices;
   static const char **static_bch_codes=0;
 
+  static void init_static_data_once();
+
   static void init_static_data(){
-    if(static_indices) return;
+    static std::once_flag once;
+    std::call_once(once, init_static_data_once);
+  }
 
+  static void init_static_data_once(){
     static const char *all_codes[4096]={
       "XhqhUc","XNlua5","XxMD3K","X39ozF","XplQIr","XVq5mQ","XF9W73","X-MJvm","XdMcMW","XJ9ril","Xtqy-w","XZllrT","Xl9VQJ","XRM8ey","XBl1Zf","X7qMD+","XfRfQB","XLWweG","XvDFZ9","X1gmDg","XnWOMi","XTR7iZ","XDgY-U","X9DHrv","XbDaIP","XHgtms","XrRA7p","XXWjv0","XjgTU6","XPD+ab","XzW33C","X5RKzN","XgwvI1","XMngmo","XwGp7t","X27CvO","Xon4UM","XUwRaD","XE7I3a","X+GXz7","XcGqQh","XI7de8","XswkZH","XYnzDA","Xk79Mu","XQGUiV","XAnN-Y","X6w0rj","XeTxMS","XK2eix","XuBn-k","X0aErX","Xm26Q-","XSTPee","XCaGZz","X8BZDI","XaBsUE","XGabaL","XqTi34","XW2Bzd","Xia-In","XOBSm2","Xy2L7R","X4T2vq",
       "rhtoiz","rNiDMI","rxLur-","r3+h-e","rpiJek","rVtWQX","rF+5DS","r-LQZx","rdLlaR","rJ+yUq","rttrzn","rZic32","rl+Mm4","rRL1Id","rBi8vE","r7tV7L","rfOmma","rLZFI7","rvEwvM","r1ff7D","rnZHat","rTOYUO","rDf7z1","r9EO3o","rbEjeY","rHfAQj","rrOtDu","rXZaZV","rjfKiH","rPE3MA","rzZ+rh","r5OT-8","rgvCeU","rMopQv","rwJgDi","r24vZZ","rooXi9","rUvIMg","rE4RrB","r+J4-G","rcJzmC","rI4kIN","rsvdv6","rYoq7b","rk40ap","rQJNU0","rAoUzP","r6v93s","reUEa3","rK1nUm","ruyezr","r0dx3Q","rm1ZmK","rSUGIF","rCdPvc","r8y675","rayBif","rGdiM+","rqUbrJ","rW1s-y","rid2ew","rOyLQT","ry1SDW","r4U-Zl",
@@ -590,6 +596,120 @@ namespace icl::markers {
   }
 
 
+  namespace{
+    inline uint64_t code_to_bits(const BCHCode &c){
+      return static_cast<uint64_t>(c.to_ullong());
+    }
+  }
+
+  BCHCodeTable::BCHCodeTable(int maxErrors, int maxID){
+    BCHCodeSubSet ids;
+    for(int i=0;i<=maxID && i<4096;++i) ids.set(i);
+    init(ids,maxErrors);
+  }
+
+  BCHCodeTable::BCHCodeTable(const BCHCodeSubSet &ids, int maxErrors){
+    init(ids,maxErrors);
+  }
+
+  void BCHCodeTable::init(const BCHCodeSubSet &ids, int maxErrors){
+    if(maxErrors < 0 || maxErrors > 4){
+      throw ICLException("BCHCodeTable::init: maxErrors must be in [0,4]");
+    }
+    m_maxErrors = maxErrors;
+    m_entries.clear();
+    m_entries.reserve(4*ids.count());
+    for(int id=0;id<4096;++id){
+      if(!ids[id]) continue;
+      // a code rotated rot times (clock wise) matches the table entry that
+      // contains the original code rotated (4-rot) times
+      BCHCode c[4] = { BCHCoder::encode(id) };
+      for(int r=1;r<4;++r) c[r] = BCHCoder::rotateCode(c[r-1]);
+      for(int rot=0;rot<4;++rot){
+        m_entries.push_back(Entry{ code_to_bits(c[(4-rot)%4]), id, rot });
+      }
+    }
+
+    const int n = maxErrors+1;
+    m_chunks.assign(n,ChunkIndex());
+    for(int j=0;j<n;++j){
+      ChunkIndex &ci = m_chunks[j];
+      ci.shift = (36*j)/n;
+      const int bits = (36*(j+1))/n - ci.shift;
+      ci.mask = (uint64_t(1) << bits) - 1;
+      ci.entries = m_entries;
+      std::stable_sort(ci.entries.begin(),ci.entries.end(),[&ci](const Entry &a, const Entry &b){
+        return ((a.code >> ci.shift) & ci.mask) < ((b.code >> ci.shift) & ci.mask);
+      });
+      if(bits <= 16){
+        ci.offsets.assign((size_t(1) << bits) + 1, 0);
+        for(const Entry &e : ci.entries) ++ci.offsets[((e.code >> ci.shift) & ci.mask) + 1];
+        for(size_t i=1;i<ci.offsets.size();++i) ci.offsets[i] += ci.offsets[i-1];
+      }else{
+        ci.values.resize(ci.entries.size());
+        for(size_t i=0;i<ci.entries.size();++i) ci.values[i] = (ci.entries[i].code >> ci.shift) & ci.mask;
+      }
+    }
+  }
+
+  DecodedBCHCode2D BCHCodeTable::decode(const BCHCode &code) const{
+    const uint64_t c = code_to_bits(code);
+    const Entry *best = 0;
+    int bestErrors = m_maxErrors+1;
+    for(unsigned int j=0;j<m_chunks.size() && bestErrors;++j){
+      const ChunkIndex &ci = m_chunks[j];
+      const uint64_t v = (c >> ci.shift) & ci.mask;
+      size_t begin, end;
+      if(ci.offsets.size()){
+        begin = ci.offsets[v];
+        end = ci.offsets[v+1];
+      }else{
+        std::pair<std::vector<uint64_t>::const_iterator,std::vector<uint64_t>::const_iterator> r =
+          std::equal_range(ci.values.begin(),ci.values.end(),v);
+        begin = r.first - ci.values.begin();
+        end = r.second - ci.values.begin();
+      }
+      for(size_t i=begin;i<end;++i){
+        const Entry &e = ci.entries[i];
+        const int errors = std::popcount(e.code ^ c);
+        if(errors <= m_maxErrors && (errors < bestErrors || (errors == bestErrors && e.rot < best->rot))){
+          best = &e;
+          bestErrors = errors;
+        }
+      }
+    }
+
+    DecodedBCHCode2D ret;
+    ret.origCode = code;
+    ret.rot = DecodedBCHCode2D::Rot0;
+    if(!best){
+      ret.id = -1;
+      ret.errors = 36;
+      return ret;
+    }
+    for(int r=0;r<best->rot;++r) ret.origCode = BCHCoder::rotateCode(ret.origCode);
+    ret.id = best->id;
+    ret.errors = bestErrors;
+    ret.rot = static_cast<DecodedBCHCode2D::Rotation>(best->rot);
+    ret.correctedCode = bestErrors ? BCHCoder::encode(best->id) : ret.origCode;
+    return ret;
+  }
+
+  DecodedBCHCode2D BCHCodeTable::decode(const icl8u data[36]) const{
+    BCHCode code(0);
+    for(unsigned int i=0;i<36;++i){
+      code[i] = data[i];
+    }
+    return decode(code);
+  }
+
+  void BCHCodeTable::decode(const std::vector<BCHCode> &codes, std::vector<DecodedBCHCode2D> &results) const{
+    results.resize(codes.size());
+    for(unsigned int i=0;i<codes.size();++i){
+      results[i] = decode(codes[i]);
+    }
+  }
+
   Img8u BCHCoder::createMarkerImage(int idx, int border, const Size &resultSize){
     if(border < 0) throw ICLException("create_bch_marker_image: border must be >= 0");
     BCHCode c = encode(idx);
@@ -29,12 +29,15 @@ namespace icl::markers {
 
   struct BinaryPP : public Preprocessor, public Configurable{
     LocalThresholdOp lt;
-    BinaryPP(){
+    ImgBase *buf;
+    BinaryPP():buf(0){
       lt.deactivateProperty("^UnaryOp.*");
       addChildConfigurable(&lt);
     }
+    ~BinaryPP(){
+      ICL_DELETE(buf);
+    }
     virtual const Img8u &pp(const ImgBase *src){
-      static ImgBase *buf = nullptr;
       lt.apply(src, &buf);
       return *buf->asImg<icl8u>();
     }
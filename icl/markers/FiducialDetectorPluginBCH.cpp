@@ -55,7 +55,8 @@ namespace icl::markers {
 
     std::shared_ptr<PatternBinarization> bin;
     int maxBCHErr;
-    BCHCoder bch;
+    std::shared_ptr<BCHCodeTable> table; //!< all codes up to maxLoaded (rebuilt on demand)
+    bool tableDirty;
   };
 
   FiducialDetectorPluginBCH::FiducialDetectorPluginBCH():
@@ -66,6 +67,8 @@ namespace icl::markers {
     data->loaded.reset();
     data->maxLoaded = -1;
     data->sizes.resize(4096);
+    data->maxBCHErr = -1;
+    data->tableDirty = true;
 
     addProperty("max bch errors","range","[0,4]:1",3,0,
                 "Maximum amount of binary BCH code error\n");
@@ -115,14 +118,21 @@ namespace icl::markers {
         break;
       }
     }
-
+    data->tableDirty = true;
   }
 
 
 
 
   void FiducialDetectorPluginBCH::prepareForPatchClassification(){
-    data->maxBCHErr = getPropertyValue("max bch errors");
+    const int maxBCHErr = getPropertyValue("max bch errors");
+    if(data->tableDirty || maxBCHErr != data->maxBCHErr){
+      // non-loaded IDs up to maxLoaded stay in the table, so that a patch
+      // that is closer to one of these is still rejected
+      data->table.reset(new BCHCodeTable(maxBCHErr, data->maxLoaded));
+      data->tableDirty = false;
+    }
+    data->maxBCHErr = maxBCHErr;
     std::string mode = getPropertyValue("binarize.mode");
     if(mode == "threshold"){
       data->bin.reset(new PatternBinarizationThresh(getPropertyValue("binarize.threshold").as<int>()));
@@ -138,7 +148,7 @@ namespace icl::markers {
 
     data->bin->apply(data->buffer.begin(0));
 
-    DecodedBCHCode2D p = data->bch.decode2D(data->buffer,data->maxLoaded,false);
+    DecodedBCHCode2D p = data->table->decode(data->buffer.begin(0));
 
     static Fiducial::FeatureSet supported = Fiducial::AllFeatures;
     static Fiducial::FeatureSet computed = ( Fiducial::Center2D |
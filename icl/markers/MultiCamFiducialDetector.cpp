@@ -4,6 +4,8 @@
 
 #include <icl/markers/MultiCamFiducialDetector.h>
 #include <icl/markers/MultiCamFiducialImpl.h>
+#include <icl/utils/ThreadPool.h>
+#include <icl/utils/Time.h>
 
 using namespace icl::utils;
 using namespace icl::math;
@@ -19,6 +21,7 @@ namespace icl::markers {
     std::vector<MultiCamFiducialImpl> impls;
     int numImplsUsed;
     std::vector<MultiCamFiducial> output;
+    std::vector<Time> times;   //!< per camera detection times of the last detect call
 
 
     ~Data(){
@@ -34,7 +37,17 @@ namespace icl::markers {
   };
 
 
+  namespace{
+    std::string msec_string(const Time &t){
+      return str(0.01*static_cast<int>(t.toMilliSecondsDouble()*100)) + " ms";
+    }
+    bool is_own_property(const std::string &name){
+      return name == "parallel detection" || !name.compare(0,6,"times.");
+    }
+  }
+
   void MultiCamFiducialDetector::property_callback(const Configurable::Property &p){
+    if(is_own_property(p.name)) return;
     Any value = getPropertyValue(p.name);
     for(unsigned int i=1;i<m_data->detectors.size();++i){
       m_data->detectors[i]->setPropertyValue(p.name, value);
@@ -83,6 +96,15 @@ namespace icl::markers {
     }
 
     m_data->results.resize(cams.size());
+    m_data->times.resize(cams.size());
+
+    addProperty("parallel detection","flag","",true,0,
+                "Run the per-camera detectors concurrently on the global ThreadPool");
+    for(unsigned int i=0;i<cams.size();++i){
+      addProperty("times.camera "+str(i),"info","","-",0,"2D detection time of the last frame");
+    }
+    addProperty("times.fusion","info","","-",0,"time for combining the 2D results by ID");
+    addProperty("times.total","info","","-",0,"time for the whole last detect call");
   }
 
 
@@ -94,17 +116,36 @@ namespace icl::markers {
                                  + str(images.size()) + " but expected "
                                  + str(m_data->detectors.size()) + ")" ));
 
+    // each detector owns its state (buffers, region detector, plugin), so
+    // the cameras are processed independently. Nested parallel filters
+    // inside a detector queue their chunks on the same pool: the worker
+    // that processes the camera runs chunks itself and executes pending
+    // tasks while waiting, so nesting cannot deadlock, and idle workers help
+    const Time tStart = Time::now();
+    auto detectCam = [&](int i){
+      const Time t = Time::now();
+      m_data->results[i] = m_data->detectors[i]->detect(images[i]);
+      m_data->times[i] = Time::now() - t;
+    };
+    const int n = static_cast<int>(m_data->detectors.size());
+    if(getPropertyValue("parallel detection").as<bool>() && n > 1){
+      ThreadPool::global().parallelForEach(n, detectCam);
+    }else{
+      for(int i=0;i<n;++i) detectCam(i);
+    }
+    const Time tFusion = Time::now();
+
     int maxID = -1;
-    for(unsigned int i=0;i<m_data->detectors.size();++i){
-      std::vector<Fiducial> &r = m_data->results[i];
-      r = m_data->detectors[i]->detect(images[i]);
-       for(unsigned int j=0;j<r.size();++j){
+    for(unsigned int i=0;i<m_data->results.size();++i){
+      const std::vector<Fiducial> &r = m_data->results[i];
+      for(unsigned int j=0;j<r.size();++j){
         int id = r[j].getID();
         if(id > maxID) maxID = id;
       }
     }
     if(maxID == -1){
       m_data->output.clear();
+      update_times(tStart, tFusion);
       return m_data->output;
     }
     m_data->numImplsUsed = maxID +1;
@@ -137,8 +178,18 @@ namespace icl::markers {
       }
     }
 
+    update_times(tStart, tFusion);
     return m_data->output;
-   }
+  }
+
+  void MultiCamFiducialDetector::update_times(const Time &start, const Time &fusionStart){
+    const Time now = Time::now();
+    for(unsigned int i=0;i<m_data->times.size();++i){
+      setPropertyValue("times.camera "+str(i), msec_string(m_data->times[i]));
+    }
+    setPropertyValue("times.fusion", msec_string(now - fusionStart));
+    setPropertyValue("times.total", msec_string(now - start));
+  }
 
   const FiducialDetector &MultiCamFiducialDetector::getFiducialDetector(int idx) const{
     ICLASSERT_THROW(m_data, ICLException(str(__FUNCTION__)+": this is null"));
@@ -7,6 +7,7 @@
 #include <icl/utils/CompatMacros.h>
 #include <icl/markers/MultiCamFiducial.h>
 #include <icl/utils/Configurable.h>
+#include <icl/utils/Time.h>
 
 
 namespace icl::markers {
@@ -24,6 +25,14 @@ namespace icl::markers {
       image. Then, the 2D fiducial detection results are sorted by marker ID and combined.
       A MultiCamFiducial with ID x combines all fiducials with ID x that were detection in all views
 
+      \section __MT__ Multi-threading
+      As each FiducialDetector owns its state, the cameras are processed concurrently on the
+      global utils::ThreadPool (property "parallel detection", enabled by default). The
+      results are combined once all views are processed; the 3D pose estimation itself is
+      performed lazily when a MultiCamFiducial's 3D features are queried. The info properties
+      "times.camera N", "times.fusion" and "times.total" show the timing of the last
+      detect call.
+
       \section __RES__ Restriction
       Due to the fact, that the markers are combined by ID, It is not allowed to have
       several markers with Identical IDs in a scene. If you have, they will be mixed up and the
@@ -39,6 +48,9 @@ namespace icl::markers {
     /// internally used property callback
     void property_callback(const Property &p);
 
+    /// updates the "times.*" info properties after detect
+    void update_times(const utils::Time &start, const utils::Time &fusionStart);
+
     public:
 
     /// creates an uninitialized instance
@@ -478,6 +478,7 @@ namespace icl::markers {
     Size lastPPSize;
 
     ImgBase *lastBinImage;
+    ImgBase *ltBuf;
   };
 
   static const int RD_VALS[6] = { 0, 255, 0, 0, 255, 255 };
@@ -535,6 +536,7 @@ namespace icl::markers {
     data->css.setSigma(4.2);
     data->css.setCurvatureCutoff(66);
     data->lastBinImage = 0;
+    data->ltBuf = 0;
 
     // set some default values ...
     //setPropertyValue("css.angle-threshold", 180);
@@ -546,6 +548,8 @@ namespace icl::markers {
   }
 
   QuadDetector::~QuadDetector() {
+    ICL_DELETE(data->lastBinImage);
+    ICL_DELETE(data->ltBuf);
     delete data;
   }
 
@@ -611,9 +615,8 @@ namespace icl::markers {
     }
 
     if (data->pp) {
-      static ImgBase *ltBuf = nullptr;
-      data->lt->apply(image, &ltBuf);
-      data->pp->apply(ltBuf, &data->lastBinImage);
+      data->lt->apply(image, &data->ltBuf);
+      data->pp->apply(data->ltBuf, &data->lastBinImage);
     } else {
       data->lt->apply(image, &data->lastBinImage);
     }
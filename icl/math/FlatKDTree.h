@@ -0,0 +1,314 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// ICL - Image Component Library (https://github.com/iclcv/icl)
+// Copyright (C) 2006-2026 Christof Elbrechter
+
+#pragma once
+
+#include <icl/utils/CompatMacros.h>
+#include <icl/utils/ThreadPool.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace icl::math {
+  /// KD-tree over a flat array of fixed-dimensional points
+  /** The tree is stored without any per-node allocation: building it
+      reorders a copy of the points so that every subtree occupies a
+      contiguous range [lo,hi) whose median point sits at (lo+hi)/2.
+      Nodes are therefore implicit; besides the reordered coordinates,
+      only the split dimension per point and the original point index are
+      stored.
+
+      The tree is built by recursive median partitioning with
+      std::nth_element, splitting the dimension of largest extent. With
+      parallel building enabled, independent subtrees are partitioned
+      concurrently on utils::ThreadPool::global().
+
+      All queries return indices into the point array that was passed to
+      build() together with <em>squared</em> Euclidean distances. An
+      approximation factor eps >= 0 may be given for k-NN queries: subtrees
+      are then skipped unless they may contain points closer than
+      d/(1+eps), where d is the current k-th best distance, so each
+      reported neighbour is at most (1+eps) times farther away than the
+      true one.
+
+      \section TMP Template Parameters
+      * <b>T</b> coordinate type, float or double
+
+      \code
+      std::vector<float> pts = ...;                  // x0,y0,z0,x1,y1,z1,...
+      FlatKDTree<float> tree(pts.data(), pts.size()/3, 3);
+      std::vector<FlatKDTree<float>::Neighbour> nn;
+      tree.knn(query, 8, nn);                        // 8 nearest, ascending
+      tree.radius(query, 0.05f, nn);                 // all within 5cm
+      \endcode
+  */
+  template<class T>
+  class FlatKDTree {
+    public:
+    /// Query result: original point index and squared distance
+    struct Neighbour {
+      int index;
+      T sqrDist;
+      bool operator<(const Neighbour &o) const { return sqrDist < o.sqrDist; }
+    };
+
+    /// creates an empty tree
+    FlatKDTree() = default;
+
+    /// creates a tree from numPoints points of dimension dim (copied)
+    FlatKDTree(const T *points, int numPoints, int dim, bool parallel=false){
+      build(points, numPoints, dim, parallel);
+    }
+
+    /// (re)builds the tree from numPoints points of dimension dim (copied)
+    /** points are expected point-major (x0,y0,..,x1,y1,..). If parallel is
+        true, large subtrees are partitioned on the shared ThreadPool */
+    void build(const T *points, int numPoints, int dim, bool parallel=false){
+      m_dim = dim;
+      m_num = std::max(0, numPoints);
+      m_index.resize(m_num);
+      std::iota(m_index.begin(), m_index.end(), 0);
+      m_split.assign(m_num, 0);
+      if(m_num && m_dim > 0){
+        partition(points, 0, m_num, parallel);
+      }
+      m_points.resize(static_cast<size_t>(m_num) * m_dim);
+      for(int i = 0; i < m_num; ++i){
+        std::copy(points + static_cast<size_t>(m_index[i]) * m_dim,
+                  points + static_cast<size_t>(m_index[i] + 1) * m_dim,
+                  m_points.begin() + static_cast<size_t>(i) * m_dim);
+      }
+    }
+
+    /// number of points in the tree
+    int size() const { return m_num; }
+
+    /// point dimension
+    int getDim() const { return m_dim; }
+
+    /// returns whether the tree contains no points
+    bool isEmpty() const { return !m_num; }
+
+    /// returns the index of the nearest point, or -1 if there is none
+    /** There is none for an empty tree, and if no distance is smaller than
+        numeric_limits<T>::max(), e.g. for a query with NaN coordinates */
+    int nearest(const T *query, T *sqrDist=nullptr, T eps=0) const {
+      Neighbour n = { -1, std::numeric_limits<T>::max() };
+      if(m_num){
+        Best1 best{ &n, pruneFactor(eps) };
+        search(query, 0, m_num, best);
+        if(n.index >= 0) n.index = m_index[n.index];
+      }
+      if(sqrDist) *sqrDist = n.sqrDist;
+      return n.index;
+    }
+
+    /// returns the index of the nearest point closer than sqrt(maxSqrDist), or -1
+    /** The bound prunes the search from the start, which makes queries
+        much cheaper when a good upper bound is known, e.g. the distance
+        to the previous match in iterative registration */
+    int nearestWithin(const T *query, T maxSqrDist, T *sqrDist=nullptr, T eps=0) const {
+      Neighbour n = { -1, maxSqrDist };
+      if(m_num){
+        Best1 best{ &n, pruneFactor(eps) };
+        search(query, 0, m_num, best);
+        if(n.index >= 0) n.index = m_index[n.index];
+      }
+      if(sqrDist) *sqrDist = n.sqrDist;
+      return n.index;
+    }
+
+    /// finds the k nearest points, sorted by ascending distance
+    /** result contains min(k,size()) entries */
+    void knn(const T *query, int k, std::vector<Neighbour> &result, T eps=0) const {
+      result.clear();
+      if(!m_num || k <= 0) return;
+      result.reserve(std::min(k, m_num));
+      BestK best{ &result, static_cast<size_t>(k), pruneFactor(eps) };
+      search(query, 0, m_num, best);
+      std::sort_heap(result.begin(), result.end());
+      for(auto &n : result) n.index = m_index[n.index];
+    }
+
+    /// finds all points within the given radius (unsorted unless sorted is true)
+    void radius(const T *query, T r, std::vector<Neighbour> &result, bool sorted=false) const {
+      result.clear();
+      if(!m_num) return;
+      InRadius in{ &result, r*r };
+      search(query, 0, m_num, in);
+      for(auto &n : result) n.index = m_index[n.index];
+      if(sorted) std::sort(result.begin(), result.end());
+    }
+
+    /// nearest neighbour for numQueries point-major queries on the shared ThreadPool
+    /** indices (and sqrDists, if given) must provide numQueries entries */
+    void nearestBatch(const T *queries, int numQueries, int *indices,
+                      T *sqrDists=nullptr, T eps=0) const {
+      utils::parallelFor(0, numQueries, BATCH_GRAIN, [&](int a, int b){
+        for(int i = a; i < b; ++i){
+          indices[i] = nearest(queries + static_cast<size_t>(i) * m_dim,
+                               sqrDists ? sqrDists + i : nullptr, eps);
+        }
+      });
+    }
+
+    /// k-NN for numQueries point-major queries on the shared ThreadPool
+    /** indices and sqrDists are resized to numQueries*k; row i holds the
+        neighbours of query i in ascending order, padded with index -1 if
+        the tree has fewer than k points */
+    void knnBatch(const T *queries, int numQueries, int k, std::vector<int> &indices,
+                  std::vector<T> &sqrDists, T eps=0) const {
+      indices.assign(static_cast<size_t>(numQueries) * k, -1);
+      sqrDists.assign(static_cast<size_t>(numQueries) * k, std::numeric_limits<T>::max());
+      utils::parallelFor(0, numQueries, BATCH_GRAIN, [&](int a, int b){
+        std::vector<Neighbour> nn;
+        for(int i = a; i < b; ++i){
+          knn(queries + static_cast<size_t>(i) * m_dim, k, nn, eps);
+          for(size_t j = 0; j < nn.size(); ++j){
+            indices[static_cast<size_t>(i) * k + j] = nn[j].index;
+            sqrDists[static_cast<size_t>(i) * k + j] = nn[j].sqrDist;
+          }
+        }
+      });
+    }
+
+    private:
+    /// ranges below this size are scanned linearly during queries
+    static constexpr int LEAF_SIZE = 8;
+    /// ranges above this size are built concurrently in parallel mode
+    static constexpr int PARALLEL_BUILD_SIZE = 1 << 14;
+    /// queries per ThreadPool chunk in batched queries
+    static constexpr int BATCH_GRAIN = 64;
+
+    int m_dim = 0;
+    int m_num = 0;
+    std::vector<T> m_points;      ///< reordered coordinates, point-major
+    std::vector<int> m_index;     ///< tree position -> original point index
+    std::vector<int> m_split;     ///< split dimension of the node at each position
+
+    static T pruneFactor(T eps){
+      return (1 + eps) * (1 + eps);
+    }
+
+    /// partitions m_index[lo,hi) (indices into the original points)
+    void partition(const T *points, int lo, int hi, bool parallel){
+      if(hi - lo <= 1) return;
+      auto coord = [&](int i, int d){ return points[static_cast<size_t>(i) * m_dim + d]; };
+
+      int best = 0;
+      T bestExtent = -1;
+      for(int d = 0; d < m_dim; ++d){
+        T mn = coord(m_index[lo], d), mx = mn;
+        for(int i = lo + 1; i < hi; ++i){
+          const T v = coord(m_index[i], d);
+          mn = std::min(mn, v);
+          mx = std::max(mx, v);
+        }
+        if(mx - mn > bestExtent){
+          bestExtent = mx - mn;
+          best = d;
+        }
+      }
+
+      // NaN coordinates (e.g. invalid depth pixels) are ordered last
+      const int mid = lo + (hi - lo) / 2;
+      std::nth_element(m_index.begin() + lo, m_index.begin() + mid, m_index.begin() + hi,
+                       [&](int a, int b){
+                         const T ca = coord(a, best), cb = coord(b, best);
+                         return std::isnan(cb) ? !std::isnan(ca) : ca < cb;
+                       });
+      m_split[mid] = best;
+
+      if(parallel && hi - lo > PARALLEL_BUILD_SIZE){
+        utils::ThreadPool::global().parallelForEach(2, [&](int i){
+          if(i) partition(points, mid + 1, hi, parallel);
+          else partition(points, lo, mid, parallel);
+        });
+      }else{
+        partition(points, lo, mid, parallel);
+        partition(points, mid + 1, hi, parallel);
+      }
+    }
+
+    inline T sqrDist(const T *query, int pos) const {
+      const T *p = m_points.data() + static_cast<size_t>(pos) * m_dim;
+      T s = 0;
+      for(int d = 0; d < m_dim; ++d){
+        const T diff = query[d] - p[d];
+        s += diff * diff;
+      }
+      return s;
+    }
+
+    /// result collectors: bound() is the squared distance a subtree must
+    /// beat to be visited, offer() receives every visited point
+    struct Best1 {
+      Neighbour *n;
+      T factor;
+      T bound() const { return n->sqrDist; }
+      T prune(T planeDist) const { return planeDist * factor; }
+      void offer(int pos, T d){
+        if(d < n->sqrDist){
+          n->index = pos;
+          n->sqrDist = d;
+        }
+      }
+    };
+
+    struct BestK {
+      std::vector<Neighbour> *heap;
+      size_t k;
+      T factor;
+      T bound() const {
+        return heap->size() < k ? std::numeric_limits<T>::max() : heap->front().sqrDist;
+      }
+      T prune(T planeDist) const { return planeDist * factor; }
+      void offer(int pos, T d){
+        if(heap->size() < k){
+          heap->push_back({pos, d});
+          std::push_heap(heap->begin(), heap->end());
+        }else if(d < heap->front().sqrDist){
+          std::pop_heap(heap->begin(), heap->end());
+          heap->back() = {pos, d};
+          std::push_heap(heap->begin(), heap->end());
+        }
+      }
+    };
+
+    struct InRadius {
+      std::vector<Neighbour> *result;
+      T r2;
+      T bound() const { return r2; }
+      T prune(T planeDist) const { return planeDist; }
+      void offer(int pos, T d){
+        if(d <= r2) result->push_back({pos, d});
+      }
+    };
+
+    template<class Collector>
+    void search(const T *query, int lo, int hi, Collector &c) const {
+      while(hi - lo > LEAF_SIZE){
+        const int mid = lo + (hi - lo) / 2;
+        c.offer(mid, sqrDist(query, mid));
+        const int d = m_split[mid];
+        const T diff = query[d] - m_points[static_cast<size_t>(mid) * m_dim + d];
+        // descend into the query's side first, the other side only if the
+        // splitting plane is closer than the current bound (or NaN)
+        if(diff < 0){
+          search(query, lo, mid, c);
+          if(c.prune(diff * diff) > c.bound()) return;
+          lo = mid + 1;
+        }else{
+          search(query, mid + 1, hi, c);
+          if(c.prune(diff * diff) > c.bound()) return;
+          hi = mid;
+        }
+      }
+      for(int i = lo; i < hi; ++i) c.offer(i, sqrDist(query, i));
+    }
+  };
+  } // namespace icl::math
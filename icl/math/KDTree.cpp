@@ -6,189 +6,47 @@
 
 namespace icl::math {
   KDTree::KDTree(std::vector<DynMatrix<icl64f> > &list){
-    if(list.size()>0){
-      buildTree(list, 0, &root);
-    }
+    buildTree(list);
   }
 
   KDTree::KDTree(std::vector<DynMatrix<icl64f> *> &list){
-    if(list.size()>0){
-      buildTree(list, 0, &root);
-    }
+    buildTree(list);
   }
 
   KDTree::~KDTree(){}
 
-  struct sort_by_axis{
-    unsigned int axis;
-    sort_by_axis(unsigned int axis):axis(axis){}
-    bool operator()(const DynMatrix<icl64f> &a, const DynMatrix<icl64f> &b) const{
-      return a[axis] < b[axis];
-    }
-    bool operator()(const DynMatrix<icl64f> *a, const DynMatrix<icl64f> *b) const{
-      return (*a)[axis] < (*b)[axis];
-    }
-  };
-
-  void KDTree::buildTree(std::vector<DynMatrix<icl64f> > &list, unsigned int depth, Node *node){
-    if(list.size() == 1){
-      node->point = &(list.at(0));
-      return;
-    }
-    unsigned int k = (list.at(0)).rows();
-    unsigned int axis = depth % k;
-    std::sort(list.begin(),list.end(),sort_by_axis(axis));
-    //sortList(list, axis);
-
-    unsigned int median = list.size()/2;
-
-    node->left = new Node();
-    node->median = double((list.at(median))(axis, 0));
-    std::vector<DynMatrix<icl64f> > sublist;
-    for(unsigned int i=0;i<median;++i){
-      sublist.push_back(list.at(i));
-    }
-    buildTree(sublist,depth+1,node->left);
-
-    node->right = new Node();
-    sublist.clear();
-    for(unsigned int i=median;i<list.size();++i){
-      sublist.push_back(list.at(i));
-    }
-    buildTree(sublist,depth+1,node->right);
-  }
-
-  void KDTree::buildTree(std::vector<DynMatrix<icl64f> *> &list,unsigned int depth, Node *node){
-    if(list.size() <= 1){
-      node->point = list.at(0);
-      return;
-    }
-    unsigned int k = list.at(0)->rows();
-    unsigned int axis = depth % k;
-    std::sort(list.begin(),list.end(),sort_by_axis(axis));
-    //sortList(list, axis);
-
-    unsigned int median = list.size()/2;
-
-    node->left = new Node();
-    node->median = double((list.at(median))->operator()(axis, 0));
-    std::vector<DynMatrix<icl64f>* > sublist;
-    for(unsigned int i=0;i<median;++i){
-      sublist.push_back(list.at(i));
-    }
-    buildTree(sublist,depth+1,node->left);
-
-    node->right = new Node();
-    sublist.clear();
-    for(unsigned int i=median;i<list.size();++i){
-      sublist.push_back(list.at(i));
-    }
-    buildTree(sublist,depth+1,node->right);
+  void KDTree::buildTree(std::vector<DynMatrix<icl64f> > &list){
+    m_points.clear();
+    for(auto &p : list) m_points.push_back(&p);
+    buildFlat();
   }
 
-  void KDTree::sortList(std::vector<DynMatrix<icl64f> > &list, unsigned int dim){
-    DynMatrix<icl64f> temp;
-    unsigned int minIndex = 0;
-    for(unsigned int i=0;i<list.size()-1;++i){
-      minIndex = i;
-      for(unsigned int j=(i+1);j<list.size();++j){
-        if((list.at(minIndex))(dim, 0) < (list.at(j))(dim, 0)){
-          minIndex = j;
-        }
-      }
-      if(minIndex > i){
-        temp = list.at(i);
-        list.at(i) = list.at(minIndex);
-        list.at(minIndex) = temp;
-      }
-    }
+  void KDTree::buildTree(std::vector<DynMatrix<icl64f> *> &list){
+    m_points = list;
+    buildFlat();
   }
 
-  void KDTree::sortList(std::vector<DynMatrix<icl64f>* > &list, unsigned int dim){
-    DynMatrix<icl64f> *temp=0;
-    unsigned int minIndex = 0;
-    for(unsigned int i=0;i<list.size()-1;++i){
-      minIndex = i;
-      for(unsigned int j=(i+1);j<list.size();++j){
-        if(list.at(minIndex)->operator()(dim, 0) < list.at(j)->operator()(dim, 0)){
-          minIndex = j;
-        }
-      }
-      if(minIndex > i){
-        temp = list.at(i);
-        list.at(i) = list.at(minIndex);
-        list.at(minIndex) = temp;
-      }
+  void KDTree::buildFlat(){
+    const int dim = m_points.empty() ? 0 : m_points.front()->rows();
+    std::vector<icl64f> coords(m_points.size() * dim);
+    for(size_t i=0;i<m_points.size();++i){
+      std::copy(m_points[i]->begin(), m_points[i]->begin()+dim, coords.begin()+i*dim);
     }
-  }
-
-  void KDTree::releaseTree(){
-    if(root.right)
-      delete root.right;
-    if(root.left)
-      delete root.left;
+    m_tree.build(coords.data(), static_cast<int>(m_points.size()), dim);
   }
 
   DynMatrix<icl64f>* KDTree::nearestNeighbour(const DynMatrix<icl64f> &point){
-    unsigned int k = point.rows();
-    unsigned int depth = 0;
-    unsigned int axis = depth % k;
-    Node *n = &root;
-    while(1){
-      if(point[axis]<n->median){
-        if(n->left)
-          n = n->left;
-        else
-          return n->point;
-      } else {
-        if(n->right)
-          n = n->right;
-        else
-          return n->point;
-      }
-      depth += 1;
-      axis = depth % k;
-    }
+    const int i = m_tree.nearest(point.begin());
+    return i < 0 ? nullptr : m_points[i];
   }
 
   DynMatrix<icl64f>* KDTree::nearestNeighbour(const DynMatrix<icl64f> *point){
-    unsigned int k = point->rows();
-    unsigned int depth = 0;
-    unsigned int axis = depth % k;
-    Node *n = &root;
-    while(1){
-      if(((*point)[axis]) < (n->median)){
-        if(n->left != 0){
-          n = n->left;
-        }else{
-          return n->point;
-        }
-      } else {
-        if(n->right != 0){
-          n = n->right;
-        }else{
-          return n->point;
-        }
-      }
-      depth += 1;
-      axis = depth % k;
-    }
+    return nearestNeighbour(*point);
   }
 
   void KDTree::print(){
-    print(&root);
-  }
-
-  void KDTree::print(Node *n){
-    if(n->left){
-      print(n->left);
-    }
-    if(n->right){
-      print(n->right);
-    }
-    if(n->point){
-      std::cout << (*(n->point))[0] << "  " << (*(n->point))[1] << "  " << (*(n->point))[2]  << std::endl;
-      //SHOW(*(n->point));
+    for(const DynMatrix<icl64f> *p : m_points){
+      std::cout << (*p)[0] << "  " << (*p)[1] << "  " << (*p)[2]  << std::endl;
     }
   }
-  } // namespace icl::math
\ No newline at end of file
+  } // namespace icl::math
@@ -6,6 +6,7 @@
 
 #include <icl/utils/CompatMacros.h>
 #include <icl/math/DynMatrix.h>
+#include <icl/math/FlatKDTree.h>
 #include <icl/utils/Macros.h>
 #include <icl/utils/BasicTypes.h>
 #include <vector>
@@ -19,6 +20,11 @@ namespace icl::math {
         <b>Note:</b> If point data was passed to the KD-Tree constructor, it only references
         by the KD-Tree instance. Therefore, that tree instance will only stay valid as long as
         the referenced data does
+
+        Internally, the point coordinates are copied into a FlatKDTree<icl64f>, so
+        nearestNeighbour() performs an exact search over contiguous memory and
+        only maps the result back to the referenced matrix. New code that
+        does not need DynMatrix pointers should use FlatKDTree directly.
     */
     class ICLMath_API KDTree {
       public:
@@ -26,49 +32,14 @@ namespace icl::math {
       KDTree& operator=(const KDTree&) = delete;
 
       private:
-      ///Keeps data of node
-      struct Node{
-        ///left node
-        Node *left;
-        ///right node
-        Node *right;
-        ///point in leafnode, else null
-        DynMatrix<icl64f> *point;
-        ///median of dimension
-        double median;
-
-        ///Constructor
-        inline Node():left(0),right(0),point(0),median(0.0){}
-
-        ///Destructor
-        inline ~Node(){
-          if(right != 0){
-            delete right;
-            right = 0;
-          }
-          if(left != 0){
-            delete left;
-            left = 0;
-          }
-
-        }
-      };
-
-      ///the root node of the tree
-      Node root;
-
-      ///internal print call
-      void print(Node *node);
-      ///internal call to fill the KDTree with data
-      void buildTree(std::vector<math::DynMatrix<icl64f> > &list,unsigned int depth, Node *node);
+      ///flat search structure over copies of the point coordinates
+      FlatKDTree<icl64f> m_tree;
+
+      ///referenced points, indexed like the points of m_tree
+      std::vector<DynMatrix<icl64f>*> m_points;
+
       ///internal call to fill the KDTree with data
-      void buildTree(std::vector<math::DynMatrix<icl64f> *> &list,unsigned int depth, Node *node);
-      ///internal call to sort list by dimension of the vector (unused, instead std::sort)
-      void sortList(std::vector<math::DynMatrix<icl64f> > &list, unsigned int dim);
-      ///internal call to sort list by dimension of the vector (unused, instead std::sort)
-      void sortList(std::vector<math::DynMatrix<icl64f>* > &list, unsigned int dim);
-      ///internal call to release data from KDTree
-      void releaseTree();
+      void buildFlat();
 
       public :
       ///Constructor
@@ -95,32 +66,29 @@ namespace icl::math {
       /** Fills empty kd-tree or the current one with new data.
        * @param list list of points for the kd-tree
        */
-      inline void buildTree(std::vector<math::DynMatrix<icl64f> *> &list){
-        releaseTree();
-        buildTree(list,0,&root);
-      }
+      void buildTree(std::vector<math::DynMatrix<icl64f> *> &list);
 
       ///builds a kd-tree
       /** Fills empty KDTree object or the current one with new data.
        * @param list list of points for the kd-tree
        */
-      inline void buildTree(std::vector<math::DynMatrix<icl64f> > &list){
-        releaseTree();
-        buildTree(list,0,&root);
-      }
+      void buildTree(std::vector<math::DynMatrix<icl64f> > &list);
 
       ///Prints the tree on standard output.
       void print();
 
       ///Returns pointer to nearest neighbour to passed point.
       /** @param point the point to search nearest neighbor for
-       *  @return the pointer to nearest neighbour */
+       *  @return the pointer to nearest neighbour (null for an empty tree or a NaN point) */
       math::DynMatrix<icl64f>* nearestNeighbour(const math::DynMatrix<icl64f> &point);
 
       ///Returns pointer to nearest neighbour to passed point.
       /** @param point the point to search nearest neighbor for
-       *  @return the pointer to nearest neighbour */
+       *  @return the pointer to nearest neighbour (null for an empty tree or a NaN point) */
       math::DynMatrix<icl64f>* nearestNeighbour(const math::DynMatrix<icl64f> *point);
 
+      ///Returns the underlying flat tree (point indices refer to the build list)
+      const FlatKDTree<icl64f> &getFlatTree() const { return m_tree; }
+
     };
   } // namespace utils
\ No newline at end of file
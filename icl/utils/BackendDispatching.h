@@ -6,15 +6,26 @@
 
 #include <icl/utils/CompatMacros.h>
 #include <icl/utils/PluginRegistry.h>
+#include <icl/utils/BackendTuning.h>
 
+#include <atomic>
+#include <chrono>
 #include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
+#include <typeinfo>
 #include <vector>
 
+#if defined(__GNUG__)
+  #include <cxxabi.h>
+  #include <cstdlib>
+#endif
+
 namespace icl::utils {
   // ================================================================
   // Backend enum — values encode priority (higher = preferred).
@@ -62,11 +73,26 @@ namespace icl::utils {
   template<class Context>
   using ApplicabilityFn = PluginApplicabilityFn<Context>;
 
+  /// Returns a readable name for the type (demangled where supported)
+  inline std::string backendTypeName(const std::type_info &t) {
+#if defined(__GNUG__)
+    int status = 0;
+    char *d = abi::__cxa_demangle(t.name(), nullptr, nullptr, &status);
+    if(status == 0 && d) {
+      std::string r(d);
+      std::free(d);
+      return r;
+    }
+#endif
+    return t.name();
+  }
+
   template<class Context>
   struct BackendSelectorBase {
     virtual ~BackendSelectorBase() = default;
 
     std::string name;
+    std::string qualifiedName;  // owner enum type + name, used as tuning key prefix
 
     virtual void force(Backend b) = 0;
     virtual void unforce() = 0;
@@ -95,6 +121,10 @@ namespace icl::utils {
       virtual ~ImplBase() = default;
 
       virtual R apply(Args... args) = 0;
+
+      /// Implementation for concurrent calls on parts of the data (e.g.
+      /// image bands); nullptr while a measured selection is pending
+      virtual ImplBase* concurrentImpl() { return this; }
     };
 
     template<class F>
@@ -151,8 +181,16 @@ namespace icl::utils {
     }
 
     // --- Resolution: highest-priority applicable wins; forcedBackend overrides ---
+    // In tuning mode (see BackendTuning), a measured winner takes precedence
+    // over the static priority; unknown contexts resolve to a TuningImpl
+    // that benchmarks all applicable backends on its first call.
 
     ImplBase* resolve(const Context& ctx) const {
+      if constexpr(BackendTuningTraits<Context>::enabled) {
+        if(BackendTuning::isEnabled() && !registry.forcedKey()) {
+          if(auto* t = resolveTuned(ctx)) return t;
+        }
+      }
       const auto* e = registry.resolve(ctx);
       return e ? e->payload.get() : nullptr;
     }
@@ -173,6 +211,129 @@ namespace icl::utils {
       return e ? e->payload.get() : nullptr;
     }
 
+    // --- Measured selection (tuning mode) ---
+
+    /// Times all candidates once on real arguments and records the fastest.
+    /// Calls after the decision are forwarded to the winner. Callers that
+    /// split the data into parts must not pass the TuningImpl itself to
+    /// concurrent workers: until the decision, concurrentImpl() is nullptr
+    /// and the data must be processed as a whole; afterwards it returns the
+    /// winner, whose backend and cloneFn apply.
+    struct TuningImpl : ImplBase {
+      std::string key;
+      std::vector<ImplBase*> candidates;  // owned by the selector's registry
+      std::mutex mutex;                   // serializes the measurement
+      std::atomic<ImplBase*> winner{nullptr};
+
+      TuningImpl(std::string key, std::vector<ImplBase*> candidates)
+        : ImplBase(candidates.front()->backend), key(std::move(key)),
+          candidates(std::move(candidates)) {}
+
+      R apply(Args... args) override {
+        ImplBase* w = winner.load(std::memory_order_acquire);
+        if(!w) {
+          std::scoped_lock lock(mutex);
+          w = winner.load(std::memory_order_relaxed);
+          if(!w) {
+            if(isInPlace(args...)) return candidates.front()->apply(args...);
+            w = measure(args...);
+            winner.store(w, std::memory_order_release);
+          }
+        }
+        return w->apply(args...);
+      }
+
+      ImplBase* concurrentImpl() override {
+        return winner.load(std::memory_order_acquire);
+      }
+
+      /// Adopts a recorded decision; returns the winner (null if b is no candidate)
+      ImplBase* adopt(Backend b) {
+        for(ImplBase* c : candidates) {
+          if(c->backend != b) continue;
+          ImplBase* expected = nullptr;
+          winner.compare_exchange_strong(expected, c, std::memory_order_acq_rel);
+          return winner.load(std::memory_order_acquire);
+        }
+        return nullptr;
+      }
+
+      static bool isInPlace(const Args&... args) {
+        std::vector<const void*> ids;
+        auto collect = [&](const auto& a) {
+          if constexpr(std::is_same_v<std::decay_t<decltype(a)>, Context>)
+            ids.push_back(BackendTuningTraits<Context>::identity(a));
+        };
+        (collect(args), ...);
+        for(size_t i = 0; i < ids.size(); ++i)
+          for(size_t j = i + 1; j < ids.size(); ++j)
+            if(ids[i] && ids[i] == ids[j]) return true;
+        return false;
+      }
+
+      ImplBase* measure(Args... args) {
+        const int reps = BackendTuning::getRepetitions();
+        BackendTuning::Decision d{key, candidates.front()->backend, {}};
+        ImplBase* best = candidates.front();
+        double bestTime = 0;
+        for(ImplBase* c : candidates) {
+          c->apply(args...);  // warm-up (lazy initialization, caches)
+          double t = 0;
+          for(int r = 0; r < reps; ++r) {
+            const auto start = std::chrono::steady_clock::now();
+            c->apply(args...);
+            const std::chrono::duration<double> dt = std::chrono::steady_clock::now() - start;
+            if(!r || dt.count() < t) t = dt.count();
+          }
+          d.timings.emplace_back(c->backend, t);
+          if(c == candidates.front() || t < bestTime) {
+            best = c;
+            bestTime = t;
+          }
+        }
+        d.winner = best->backend;
+        BackendTuning::record(std::move(d));
+        return best;
+      }
+    };
+
+    /// TuningImpl for the context's key and candidate set
+    /** The decision is cached in the TuningImpl, so BackendTuning's global
+        cache is only consulted until the winner is known. TuningImpls are
+        never released before the selector, as callers may still hold the
+        pointers returned earlier (e.g. after the candidate set changed). */
+    ImplBase* resolveTuned(const Context& ctx) const {
+      std::vector<ImplBase*> candidates;
+      for(const auto& e : registry.entries()) {  // sorted by descending priority
+        if(!e.applicability || e.applicability(ctx)) candidates.push_back(e.payload.get());
+      }
+      if(candidates.size() < 2) return nullptr;
+
+      const std::string key = (this->qualifiedName.empty() ? this->name : this->qualifiedName)
+                              + " [" + BackendTuningTraits<Context>::key(ctx) + "]";
+      TuningImpl* t = nullptr;
+      {
+        std::scoped_lock lock(m_tuningMutex);
+        auto& impls = m_tuning[key];
+        for(const auto& i : impls) {
+          if(i->candidates == candidates) t = i.get();
+        }
+        if(!t) {
+          impls.push_back(std::make_shared<TuningImpl>(key, std::move(candidates)));
+          t = impls.back().get();
+        }
+      }
+      if(ImplBase* w = t->winner.load(std::memory_order_acquire)) return w;
+      if(auto b = BackendTuning::lookup(t->key)) {
+        if(ImplBase* w = t->adopt(*b)) return w;
+      }
+      return t;
+    }
+
+    mutable std::mutex m_tuningMutex;
+    /// per key, one TuningImpl per candidate set (never erased, see resolveTuned)
+    mutable std::map<std::string, std::vector<std::shared_ptr<TuningImpl>>> m_tuning;
+
     // --- Forced override (delegates to registry) ---
 
     void force(Backend b) override { registry.setForced(b); }
@@ -186,6 +347,7 @@ namespace icl::utils {
     std::unique_ptr<BackendSelectorBase<Context>> clone() const override {
       auto c = std::make_unique<BackendSelector>();
       c->name = this->name;
+      c->qualifiedName = this->qualifiedName;
       for(const auto& e : registry.entries()) {
         auto payload = e.payload->cloneFn ? e.payload->cloneFn() : e.payload;
         c->registry.registerPlugin(e.key, std::move(payload),
@@ -255,6 +417,7 @@ namespace icl::utils {
           + " does not match insertion index " + std::to_string(m_selectors.size()));
       auto sel = std::make_unique<BackendSelector<Context, Sig>>();
       sel->name = toString(key);
+      sel->qualifiedName = backendTypeName(typeid(K)) + "::" + sel->name;
       auto* ptr = sel.get();
       m_selectors.push_back(std::move(sel));
       return *ptr;
@@ -0,0 +1,229 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// ICL - Image Component Library (https://github.com/iclcv/icl)
+// Copyright (C) 2006-2026 Christof Elbrechter
+
+#include <icl/utils/BackendTuning.h>
+#include <icl/utils/BackendDispatching.h>
+#include <icl/utils/Macros.h>
+#include <icl/utils/StringUtils.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <ostream>
+
+#ifdef ICL_SYSTEM_APPLE
+  #include <sys/sysctl.h>
+#endif
+
+namespace icl::utils {
+  namespace {
+    /// per-thread override installed by BackendTuning::ScopedMode (-1: none)
+    thread_local int t_mode = -1;
+
+    std::atomic<bool> &global_mode(){
+      static std::atomic<bool> on = [] {
+        const char *v = std::getenv("ICL_BACKEND_TUNING");
+        return v && *v && std::string(v) != "0";
+      }();
+      return on;
+    }
+
+    std::string default_cache_file(){
+      if(const char *f = std::getenv("ICL_BACKEND_TUNING_CACHE")) return f;
+      std::filesystem::path dir;
+      if(const char *x = std::getenv("XDG_CACHE_HOME"); x && *x) dir = x;
+      else if(const char *h = std::getenv("HOME"); h && *h) dir = std::filesystem::path(h) / ".cache";
+      else return "";
+      return (dir / "icl" / "backend-tuning.txt").string();
+    }
+
+    /// cache file format: one decision per line, tab separated:
+    /// cpu model, key, winner, then "backend=seconds" for every candidate
+    struct Cache {
+      std::mutex mutex;
+      std::string file = default_cache_file();
+      bool loaded = false;
+      int repetitions = 3;
+      std::map<std::string, BackendTuning::Decision> decisions;
+      std::vector<std::string> foreignLines; ///< entries of other CPUs, kept on save
+
+      void load(){
+        loaded = true;
+        foreignLines.clear();
+        if(file.empty()) return;
+        std::ifstream f(file);
+        std::string line;
+        while(std::getline(f, line)){
+          std::vector<std::string> t = tok(line, "\t");
+          if(t.size() < 3) continue;
+          if(t[0] != BackendTuning::cpuModel()){
+            foreignLines.push_back(line);
+            continue;
+          }
+          std::optional<Backend> w = BackendTuning::backendFromName(t[2]);
+          if(!w) continue;
+          BackendTuning::Decision d{t[1], *w, {}};
+          for(size_t i = 3; i < t.size(); ++i){
+            std::vector<std::string> bt = tok(t[i], "=");
+            std::optional<Backend> b = bt.size() == 2 ? BackendTuning::backendFromName(bt[0]) : std::nullopt;
+            if(b) d.timings.emplace_back(*b, parse<double>(bt[1]));
+          }
+          decisions.try_emplace(d.key, std::move(d));
+        }
+      }
+
+      void save(){
+        if(file.empty()) return;
+        std::error_code ec;
+        std::filesystem::path p(file);
+        if(p.has_parent_path()) std::filesystem::create_directories(p.parent_path(), ec);
+        std::ofstream f(file);
+        if(!f){
+          WARNING_LOG("unable to write backend tuning cache " << file);
+          return;
+        }
+        for(const auto &l : foreignLines) f << l << '\n';
+        for(const auto &[key, d] : decisions){
+          f << BackendTuning::cpuModel() << '\t' << key << '\t' << backendName(d.winner);
+          for(const auto &[b, t] : d.timings) f << '\t' << backendName(b) << '=' << t;
+          f << '\n';
+        }
+      }
+    };
+
+    Cache &cache(){
+      static Cache c;
+      return c;
+    }
+  }
+
+  void BackendTuning::setEnabled(bool on){
+    global_mode() = on;
+  }
+
+  bool BackendTuning::isEnabled(){
+    return t_mode >= 0 ? t_mode != 0 : global_mode().load();
+  }
+
+  BackendTuning::ScopedMode::ScopedMode(bool on) : m_prev(t_mode){
+    t_mode = on ? 1 : 0;
+  }
+
+  BackendTuning::ScopedMode::~ScopedMode(){
+    t_mode = m_prev;
+  }
+
+  void BackendTuning::setRepetitions(int n){
+    ICLASSERT_RETURN(n > 0);
+    Cache &c = cache();
+    std::scoped_lock lock(c.mutex);
+    c.repetitions = n;
+  }
+
+  int BackendTuning::getRepetitions(){
+    Cache &c = cache();
+    std::scoped_lock lock(c.mutex);
+    return c.repetitions;
+  }
+
+  void BackendTuning::setCacheFile(const std::string &filename){
+    Cache &c = cache();
+    std::scoped_lock lock(c.mutex);
+    c.file = filename;
+    c.loaded = false;
+  }
+
+  std::string BackendTuning::getCacheFile(){
+    Cache &c = cache();
+    std::scoped_lock lock(c.mutex);
+    return c.file;
+  }
+
+  const std::string &BackendTuning::cpuModel(){
+    static const std::string model = [] {
+      std::string m;
+#if defined(ICL_SYSTEM_LINUX)
+      std::ifstream f("/proc/cpuinfo");
+      std::string line;
+      while(m.empty() && std::getline(f, line)){
+        // x86: "model name", ARM: "Model" / "CPU part"
+        if(line.rfind("model name", 0) == 0 || line.rfind("Model", 0) == 0){
+          std::string::size_type p = line.find(':');
+          if(p != std::string::npos) m = line.substr(p + 1);
+        }
+      }
+#elif defined(ICL_SYSTEM_APPLE)
+      char buf[256] = {0};
+      size_t len = sizeof(buf);
+      if(!sysctlbyname("machdep.cpu.brand_string", buf, &len, nullptr, 0)) m = buf;
+#endif
+      std::replace(m.begin(), m.end(), '\t', ' ');
+      m.erase(0, m.find_first_not_of(' '));
+      m.erase(m.find_last_not_of(' ') + 1);
+      return m.empty() ? std::string("unknown") : m;
+    }();
+    return model;
+  }
+
+  std::optional<Backend> BackendTuning::lookup(const std::string &key){
+    Cache &c = cache();
+    std::scoped_lock lock(c.mutex);
+    if(!c.loaded) c.load();
+    auto it = c.decisions.find(key);
+    if(it == c.decisions.end()) return std::nullopt;
+    return it->second.winner;
+  }
+
+  void BackendTuning::record(Decision d){
+    Cache &c = cache();
+    std::scoped_lock lock(c.mutex);
+    if(!c.loaded) c.load();
+    std::string key = d.key;
+    c.decisions[key] = std::move(d);
+    c.save();
+  }
+
+  std::vector<BackendTuning::Decision> BackendTuning::decisions(){
+    Cache &c = cache();
+    std::scoped_lock lock(c.mutex);
+    if(!c.loaded) c.load();
+    std::vector<Decision> r;
+    for(const auto &[key, d] : c.decisions) r.push_back(d);
+    return r;
+  }
+
+  void BackendTuning::dump(std::ostream &s){
+    s << "backend tuning decisions for '" << cpuModel() << "'";
+    const std::string file = getCacheFile();
+    if(!file.empty()) s << " (" << file << ")";
+    s << '\n';
+    for(const auto &d : decisions()){
+      s << "  " << std::left << std::setw(48) << d.key << " -> " << std::setw(10) << backendName(d.winner);
+      for(const auto &[b, t] : d.timings){
+        s << "  " << backendName(b) << ": " << t * 1e6 << "us";
+      }
+      s << '\n';
+    }
+  }
+
+  void BackendTuning::clear(){
+    Cache &c = cache();
+    std::scoped_lock lock(c.mutex);
+    c.decisions.clear();
+    c.loaded = false;
+  }
+
+  std::optional<Backend> BackendTuning::backendFromName(const std::string &name){
+    for(int i = static_cast<int>(Backend::Cpp); i <= static_cast<int>(Backend::OpenCL); ++i){
+      if(name == backendName(static_cast<Backend>(i))) return static_cast<Backend>(i);
+    }
+    return std::nullopt;
+  }
+
+  } // namespace icl::utils
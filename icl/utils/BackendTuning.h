@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// ICL - Image Component Library (https://github.com/iclcv/icl)
+// Copyright (C) 2006-2026 Christof Elbrechter
+
+#pragma once
+
+#include <icl/utils/CompatMacros.h>
+
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace icl::utils {
+  enum class Backend : int;
+
+  /// Describes how a BackendSelector context is mapped to a tuning key
+  /** Tuning is only available for context types that specialize this
+      template with
+      - <tt>static constexpr bool enabled = true;</tt>
+      - <tt>static std::string key(const Context&)</tt>: a short string that
+        buckets contexts with (presumably) the same performance profile,
+        e.g. depth, channel count and a power-of-two size bucket
+      - <tt>static const void *identity(const Context&)</tt>: the memory the
+        context refers to; arguments with equal identity indicate in-place
+        calls, which are never benchmarked (the repeated calls would
+        accumulate their effect). */
+  template<class Context>
+  struct BackendTuningTraits {
+    static constexpr bool enabled = false;
+  };
+
+  /// Global state of the measured backend auto-tuning \ingroup UTILS
+  /** By default, BackendSelector::resolve() picks the applicable backend
+      with the highest static priority. In tuning mode, the first call for
+      a new (operation, context bucket) pair instead benchmarks all
+      applicable backends on the actual arguments, records the fastest one
+      and dispatches to it from then on. Decisions are kept in a text file
+      together with the CPU model they were measured on, so later
+      processes on the same machine skip the measurements.
+
+      Tuning mode is enabled via setEnabled(), or by setting the
+      environment variable ICL_BACKEND_TUNING=1. The cache file defaults to
+      $XDG_CACHE_HOME/icl/backend-tuning.txt (or ~/.cache/icl/...) and can
+      be overridden by ICL_BACKEND_TUNING_CACHE or setCacheFile(). Forced
+      backends always take precedence over tuning decisions.
+
+      \code
+      BackendTuning::setEnabled(true);
+      MedianOp m(Size(5,5));
+      m.apply(src, dst);            // measures all median backends once
+      BackendTuning::dump(std::cout); // lists the decisions
+      \endcode
+  */
+  class ICLUtils_API BackendTuning {
+    public:
+    /// One tuning decision
+    struct Decision {
+      std::string key;                                  ///< qualified op name + context bucket
+      Backend winner;                                   ///< fastest backend
+      std::vector<std::pair<Backend,double>> timings;   ///< best time per backend in seconds
+    };
+
+    /// Enables/disables tuning mode process-wide
+    static void setEnabled(bool on);
+
+    /// Returns whether tuning mode is active for the calling thread
+    static bool isEnabled();
+
+    /// Enables or disables tuning for the calling thread only while alive
+    class ICLUtils_API ScopedMode {
+      int m_prev;
+      public:
+      explicit ScopedMode(bool on);
+      ~ScopedMode();
+      ScopedMode(const ScopedMode&) = delete;
+      ScopedMode &operator=(const ScopedMode&) = delete;
+    };
+
+    /// Sets the number of timed runs per backend (the minimum is used, default 3)
+    static void setRepetitions(int n);
+
+    /// Returns the number of timed runs per backend
+    static int getRepetitions();
+
+    /// Sets the cache file; an empty string disables persistence
+    /** The new file is loaded on the next lookup; in-memory decisions are
+        kept. */
+    static void setCacheFile(const std::string &filename);
+
+    /// Returns the current cache file name
+    static std::string getCacheFile();
+
+    /// Returns the CPU model string decisions are associated with
+    static const std::string &cpuModel();
+
+    /// Returns the recorded winner for the given key, if any
+    static std::optional<Backend> lookup(const std::string &key);
+
+    /// Records a decision and writes the cache file
+    static void record(Decision d);
+
+    /// Returns all decisions for the current CPU
+    static std::vector<Decision> decisions();
+
+    /// Writes a human readable table of all decisions to the stream
+    static void dump(std::ostream &s);
+
+    /// Forgets all in-memory decisions (the cache file is re-read on next lookup)
+    static void clear();
+
+    /// Returns the backend whose backendName() is name (or std::nullopt)
+    static std::optional<Backend> backendFromName(const std::string &name);
+  };
+
+  } // namespace icl::utils
@@ -61,6 +61,19 @@
   #define WARNING(msg) message(__FILE__ "(" STRINGSIZE(__LINE__) ") : warning: " #msg)
 #endif
 
+// Disables the contraction of a*b+c into fused multiply-adds for the rest of
+// the translation unit. Backend sources whose SIMD code reproduces the scalar
+// results bit by bit use it after their includes; GCC contracts by default
+// once FMA is available (e.g. -march=native), clang does so on ARM.
+#if defined(__clang__)
+#	define ICL_NO_FP_CONTRACT _Pragma("clang fp contract(off)")
+#elif defined(__GNUC__)
+#	define ICL_NO_FP_CONTRACT _Pragma("GCC optimize(\"fp-contract=off\")")
+#elif defined(_MSC_VER)
+#	define ICL_NO_FP_CONTRACT __pragma(fp_contract(off))
+#else
+#	define ICL_NO_FP_CONTRACT
+#endif
 
 #ifdef ICL_SYSTEM_WINDOWS
 #	define IPP_DECL __stdcall
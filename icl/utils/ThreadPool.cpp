@@ -0,0 +1,336 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// ICL - Image Component Library (https://github.com/iclcv/icl)
+// Copyright (C) 2006-2026 Christof Elbrechter
+
+#include <icl/utils/ThreadPool.h>
+#include <icl/utils/Macros.h>
+#include <icl/utils/StringUtils.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
+#ifdef ICL_SYSTEM_LINUX
+  #include <pthread.h>
+  #include <sched.h>
+#endif
+
+namespace icl::utils {
+  namespace {
+    /// worker identity of the calling thread (null/-1 for non-worker threads)
+    thread_local const void *t_pool = nullptr;
+    thread_local int t_workerIndex = -1;
+
+#ifdef ICL_SYSTEM_LINUX
+    /// parses sysfs cpu lists like "0-3,8,10-11"
+    std::vector<int> parse_cpu_list(const std::string &s){
+      std::vector<int> cpus;
+      for(const auto &range : tok(s, ",")){
+        std::vector<std::string> ab = tok(range, "-");
+        if(ab.empty()) continue;
+        int a = parse<int>(ab[0]);
+        int b = ab.size() > 1 ? parse<int>(ab[1]) : a;
+        for(int c = a; c <= b; ++c) cpus.push_back(c);
+      }
+      return cpus;
+    }
+
+    /// CPUs of the process' affinity mask, grouped by NUMA node
+    std::vector<int> numa_ordered_cpus(){
+      cpu_set_t allowed;
+      CPU_ZERO(&allowed);
+      if(sched_getaffinity(0, sizeof(allowed), &allowed)) return {};
+
+      std::vector<int> cpus;
+      for(int node = 0; ; ++node){
+        std::ifstream f("/sys/devices/system/node/node" + str(node) + "/cpulist");
+        if(!f) break;
+        std::string line;
+        std::getline(f, line);
+        for(int c : parse_cpu_list(line)){
+          if(c < CPU_SETSIZE && CPU_ISSET(c, &allowed)) cpus.push_back(c);
+        }
+      }
+      if(cpus.empty()){ // no NUMA information available
+        for(int c = 0; c < CPU_SETSIZE; ++c){
+          if(CPU_ISSET(c, &allowed)) cpus.push_back(c);
+        }
+      }
+      return cpus;
+    }
+#endif
+
+    int env_int(const char *name, int defaultValue){
+      const char *v = std::getenv(name);
+      if(!v || !*v) return defaultValue;
+      try{
+        return parse<int>(v);
+      }catch(...){
+        WARNING_LOG("unable to parse environment variable " << name << "='" << v << "'");
+        return defaultValue;
+      }
+    }
+  }
+
+  struct ThreadPool::Data {
+    struct Worker {
+      std::mutex mutex;
+      std::deque<Task> tasks;
+      std::thread thread;
+    };
+
+    /// guards the worker set: shared for submit, exclusive for (re)starting
+    std::shared_mutex config;
+    std::vector<std::unique_ptr<Worker>> workers;
+    bool stopping = false;
+    bool pin = false;
+
+    std::mutex sleepMutex;
+    std::condition_variable wakeup;
+    std::atomic<int> pending{0};
+    std::atomic<unsigned int> nextQueue{0};
+
+    bool pop(int i, Task &t){
+      Worker &w = *workers[i];
+      std::scoped_lock lock(w.mutex);
+      if(w.tasks.empty()) return false;
+      t = std::move(w.tasks.back());
+      w.tasks.pop_back();
+      return true;
+    }
+
+    bool steal(int self, Task &t){
+      const int n = static_cast<int>(workers.size());
+      for(int k = 1; k <= n; ++k){
+        Worker &w = *workers[(self + k) % n];
+        std::scoped_lock lock(w.mutex);
+        if(w.tasks.empty()) continue;
+        t = std::move(w.tasks.front());
+        w.tasks.pop_front();
+        return true;
+      }
+      return false;
+    }
+
+    static void run(Task &t){
+      try{
+        t();
+      }catch(const std::exception &e){
+        ERROR_LOG("uncaught exception in ThreadPool task: " << e.what());
+      }catch(...){
+        ERROR_LOG("uncaught unknown exception in ThreadPool task");
+      }
+    }
+
+    void workerLoop(int i){
+      t_pool = this;
+      t_workerIndex = i;
+      for(;;){
+        Task t;
+        if(pop(i, t) || steal(i, t)){
+          --pending;
+          run(t);
+          continue;
+        }
+        std::unique_lock lock(sleepMutex);
+        wakeup.wait(lock, [this]{ return stopping || pending.load() > 0; });
+        if(stopping && pending.load() <= 0) return;
+      }
+    }
+
+    /// requires exclusive config lock
+    void start(int n){
+      stopping = false;
+      workers.clear();
+      for(int i = 0; i < n; ++i) workers.push_back(std::make_unique<Worker>());
+#ifdef ICL_SYSTEM_LINUX
+      std::vector<int> cpus = pin ? numa_ordered_cpus() : std::vector<int>();
+#endif
+      for(int i = 0; i < n; ++i){
+        workers[i]->thread = std::thread([this, i]{ workerLoop(i); });
+#ifdef ICL_SYSTEM_LINUX
+        if(!cpus.empty()){
+          cpu_set_t set;
+          CPU_ZERO(&set);
+          CPU_SET(cpus[i % cpus.size()], &set);
+          if(pthread_setaffinity_np(workers[i]->thread.native_handle(), sizeof(set), &set)){
+            WARNING_LOG("unable to pin ThreadPool worker " << i << " to CPU " << cpus[i % cpus.size()]);
+          }
+        }
+#endif
+      }
+    }
+
+    /// drains all queues and joins the workers
+    void stop(){
+      std::vector<std::thread> threads;
+      {
+        std::unique_lock lock(config);
+        std::scoped_lock sleepLock(sleepMutex);
+        stopping = true;
+        for(auto &w : workers) threads.push_back(std::move(w->thread));
+      }
+      wakeup.notify_all();
+      // joining happens without the config lock: tasks still running may
+      // call submit(), which executes them inline while stopping is set
+      for(auto &t : threads) if(t.joinable()) t.join();
+    }
+  };
+
+  ThreadPool::ThreadPool(int numWorkers, bool pinWorkers) : m_data(std::make_unique<Data>()){
+    if(numWorkers < 0) numWorkers = hardwareConcurrency() - 1;
+    std::unique_lock lock(m_data->config);
+    m_data->pin = pinWorkers;
+    m_data->start(numWorkers);
+  }
+
+  ThreadPool::~ThreadPool(){
+    m_data->stop();
+  }
+
+  ThreadPool &ThreadPool::global(){
+    static ThreadPool pool(env_int("ICL_NUM_THREADS", hardwareConcurrency()) - 1,
+                           env_int("ICL_PIN_THREADS", 0) != 0);
+    return pool;
+  }
+
+  int ThreadPool::hardwareConcurrency(){
+#ifdef ICL_SYSTEM_LINUX
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if(!sched_getaffinity(0, sizeof(set), &set)) return std::max(1, CPU_COUNT(&set));
+#endif
+    return std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  int ThreadPool::getNumWorkers() const {
+    std::shared_lock lock(m_data->config);
+    return m_data->stopping ? 0 : static_cast<int>(m_data->workers.size());
+  }
+
+  void ThreadPool::resize(int numWorkers){
+    if(numWorkers < 0) numWorkers = hardwareConcurrency() - 1;
+    m_data->stop();
+    std::unique_lock lock(m_data->config);
+    m_data->start(numWorkers);
+  }
+
+  void ThreadPool::setPinWorkers(bool pin){
+    if(pin == getPinWorkers()) return;
+    int n = getNumWorkers();
+    m_data->stop();
+    std::unique_lock lock(m_data->config);
+    m_data->pin = pin;
+    m_data->start(n);
+  }
+
+  bool ThreadPool::getPinWorkers() const {
+    std::shared_lock lock(m_data->config);
+    return m_data->pin;
+  }
+
+  void ThreadPool::submit(Task task){
+    {
+      std::shared_lock lock(m_data->config);
+      if(!m_data->stopping && !m_data->workers.empty()){
+        const int n = static_cast<int>(m_data->workers.size());
+        int q = (t_pool == m_data.get()) ? t_workerIndex
+                                         : static_cast<int>(m_data->nextQueue++ % n);
+        {
+          std::scoped_lock qlock(m_data->workers[q]->mutex);
+          m_data->workers[q]->tasks.push_back(std::move(task));
+        }
+        ++m_data->pending;
+        { std::scoped_lock sleepLock(m_data->sleepMutex); }
+        m_data->wakeup.notify_one();
+        return;
+      }
+    }
+    Data::run(task);
+  }
+
+  bool ThreadPool::runPendingTask(int self){
+    Task t;
+    if(m_data->pop(self, t) || m_data->steal(self, t)){
+      --m_data->pending;
+      Data::run(t);
+      return true;
+    }
+    return false;
+  }
+
+  void ThreadPool::parallelFor(int begin, int end, int grain,
+                               const std::function<void(int,int)> &f){
+    if(end <= begin) return;
+    const int n = end - begin;
+    const int numWorkers = getNumWorkers();
+    if(grain <= 0) grain = std::max(1, n / (4 * (numWorkers + 1)));
+    const int nChunks = (n + grain - 1) / grain;
+    if(nChunks == 1 || numWorkers == 0){
+      f(begin, end);
+      return;
+    }
+
+    struct State {
+      std::atomic<int> next{0};
+      std::atomic<int> done{0};
+      std::atomic<bool> failed{false};
+      std::exception_ptr error;
+      std::mutex mutex;
+      std::condition_variable finished;
+    };
+    auto s = std::make_shared<State>();
+    const std::function<void(int,int)> *fp = &f;
+
+    // Helpers that are scheduled after all chunks have been taken return
+    // immediately without touching f, so they may outlive this call.
+    auto work = [s, fp, begin, end, grain, nChunks]{
+      for(int c = s->next++; c < nChunks; c = s->next++){
+        if(!s->failed){
+          try{
+            const int a = begin + c * grain;
+            (*fp)(a, std::min(end, a + grain));
+          }catch(...){
+            std::scoped_lock lock(s->mutex);
+            if(!s->error) s->error = std::current_exception();
+            s->failed = true;
+          }
+        }
+        if(++s->done == nChunks){
+          std::scoped_lock lock(s->mutex);
+          s->finished.notify_all();
+        }
+      }
+    };
+
+    const int helpers = std::min(numWorkers, nChunks - 1);
+    for(int i = 0; i < helpers; ++i) submit(work);
+    work();
+
+    const bool isOwnWorker = (t_pool == m_data.get());
+    while(s->done.load() < nChunks){
+      // workers keep executing other pending tasks instead of idling
+      if(isOwnWorker && runPendingTask(t_workerIndex)) continue;
+      std::unique_lock lock(s->mutex);
+      s->finished.wait_for(lock, std::chrono::microseconds(100),
+                           [&]{ return s->done.load() >= nChunks; });
+    }
+    if(s->error) std::rethrow_exception(s->error);
+  }
+
+  bool ThreadPool::isWorkerThread(){
+    return t_pool != nullptr;
+  }
+
+  int ThreadPool::currentWorkerIndex(){
+    return t_workerIndex;
+  }
+
+  } // namespace icl::utils
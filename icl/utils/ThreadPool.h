@@ -0,0 +1,142 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// ICL - Image Component Library (https://github.com/iclcv/icl)
+// Copyright (C) 2006-2026 Christof Elbrechter
+
+#pragma once
+
+#include <icl/utils/CompatMacros.h>
+#include <functional>
+#include <future>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace icl::utils {
+  /// Work-stealing executor for data-parallel tile tasks \ingroup THREAD
+  /** The ThreadPool owns a fixed set of worker threads, each with its own
+      task deque. Workers pop from the back of their own deque and, once it
+      runs dry, steal from the front of the other workers' deques. Tasks
+      submitted from outside the pool are distributed round-robin.
+
+      Most code should not create pools itself but use the process-wide
+      instance returned by ThreadPool::global(), so operators, line
+      visitors and geometry code all share one set of threads instead of
+      spawning their own per call. Its size defaults to
+      std::thread::hardware_concurrency() and can be overridden by the
+      environment variable ICL_NUM_THREADS (total thread count, including
+      the calling thread) or at runtime via resize(). Setting
+      ICL_PIN_THREADS=1 pins the workers to individual CPUs (see
+      setPinWorkers()).
+
+      The main entry point is parallelFor(), which splits an index range
+      into chunks and blocks until all of them have been processed. The
+      calling thread always takes part in the work, so a pool with zero
+      workers degrades to a plain serial loop, and nested parallelFor
+      calls issued from within a worker cannot deadlock.
+
+      \code
+      ThreadPool::global().parallelFor(0, img.getHeight(), 16, [&](int y0, int y1){
+        for(int y = y0; y < y1; ++y) processRow(y);
+      });
+
+      auto f = ThreadPool::global().async([]{ return expensive(); });
+      int result = f.get();
+      \endcode
+  */
+  class ICLUtils_API ThreadPool {
+    public:
+    /// Type of tasks executed by the workers
+    using Task = std::function<void()>;
+
+    /// Creates a pool with the given number of worker threads
+    /** @param numWorkers number of dedicated workers (the calling thread of
+               parallelFor comes on top). If negative,
+               hardwareConcurrency()-1 workers are created.
+        @param pinWorkers if true, each worker is pinned to one CPU */
+    explicit ThreadPool(int numWorkers = -1, bool pinWorkers = false);
+
+    /// Destructor, processes all pending tasks and joins the workers
+    ~ThreadPool();
+
+    /// Non-copyable
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// Returns the process-wide shared pool (created on first use)
+    static ThreadPool &global();
+
+    /// Returns the number of logical CPUs available to the process (at least 1)
+    static int hardwareConcurrency();
+
+    /// Returns the number of dedicated worker threads
+    int getNumWorkers() const;
+
+    /// Returns the number of threads working on a parallelFor (workers + caller)
+    int getConcurrency() const { return getNumWorkers() + 1; }
+
+    /// Replaces the worker threads by a new set of the given size
+    /** Pending tasks are processed before the old workers are joined.
+        A negative value selects hardwareConcurrency()-1 workers. */
+    void resize(int numWorkers);
+
+    /// Enables/disables CPU affinity for the workers
+    /** Workers are assigned to the CPUs of the process' affinity mask,
+        ordered by NUMA node, so that neighbouring worker indices (and thus
+        neighbouring image bands) share a node. Only effective on Linux;
+        changing this restarts the workers. */
+    void setPinWorkers(bool pin);
+
+    /// Returns whether the workers are pinned to CPUs
+    bool getPinWorkers() const;
+
+    /// Enqueues a task (fire and forget)
+    /** Exceptions escaping the task are caught and logged. If the pool has
+        no workers, the task is executed immediately in the calling thread. */
+    void submit(Task task);
+
+    /// Enqueues a callable and returns a future for its result
+    template<class F>
+    [[nodiscard]] std::future<std::invoke_result_t<std::decay_t<F>>> async(F &&f){
+      using R = std::invoke_result_t<std::decay_t<F>>;
+      auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+      std::future<R> future = task->get_future();
+      submit([task]{ (*task)(); });
+      return future;
+    }
+
+    /// Calls f(chunkBegin, chunkEnd) for disjoint chunks covering [begin,end)
+    /** Blocks until all chunks are processed. Chunks have a size of (at
+        least) grain elements; a grain of 0 or less selects a chunk size
+        that yields about four chunks per thread. The calling thread
+        processes chunks as well. If any invocation of f throws, the
+        remaining chunks are skipped and the first exception is rethrown
+        in the calling thread. */
+    void parallelFor(int begin, int end, int grain,
+                     const std::function<void(int,int)> &f);
+
+    /// Calls f(i) for each i in [0,n), one task per index (e.g. per tile)
+    void parallelForEach(int n, const std::function<void(int)> &f){
+      parallelFor(0, n, 1, [&f](int a, int b){ for(int i = a; i < b; ++i) f(i); });
+    }
+
+    /// Returns true if the calling thread is a worker of any ThreadPool
+    static bool isWorkerThread();
+
+    /// Returns the calling thread's worker index within its pool, or -1
+    static int currentWorkerIndex();
+
+    private:
+    /// Pops (or steals) one pending task and runs it; returns false if none was found
+    bool runPendingTask(int self);
+
+    struct Data;
+    std::unique_ptr<Data> m_data;
+  };
+
+  /// Convenience function for ThreadPool::global().parallelFor(...) \ingroup THREAD
+  inline void parallelFor(int begin, int end, int grain,
+                          const std::function<void(int,int)> &f){
+    ThreadPool::global().parallelFor(begin, end, grain, f);
+  }
+
+  } // namespace icl::utils
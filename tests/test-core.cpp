@@ -468,6 +468,7 @@ ICL_REGISTER_TEST("Img.visitPixels_full", "visitPixels roiOnly=false ignores ROI
 // ---- Color conversion (cc) ----
 
 #include <icl/core/CCFunctions.h>
+#include <icl/utils/ThreadPool.h>
 
 ICL_REGISTER_TEST("core.cc.rgb_to_yuv_1x1", "cc() works for 1x1 images") {
   Img8u src(utils::Size(1,1), formatRGB);
@@ -514,3 +515,226 @@ ICL_REGISTER_TEST("core.cc.rgb_to_yuv_large", "cc() correct for normal-sized ima
   ICL_TEST_TRUE(std::abs((int)dst(0,0,1) - eu) <= 1);
   ICL_TEST_TRUE(std::abs((int)dst(0,0,2) - ev) <= 1);
 }
+
+ICL_REGISTER_TEST("core.cc.multithreaded", "banded MT cc() matches the serial conversion") {
+  utils::ThreadPool &pool = utils::ThreadPool::global();
+  const int workers = pool.getNumWorkers();
+  if(workers < 3) pool.resize(3);
+  Img8u src(utils::Size(640,480), formatRGB);
+  for(int c = 0; c < 3; ++c)
+    for(int i = 0; i < 640*480; ++i) src.getData(c)[i] = static_cast<icl8u>((i * 7 + c * 91) % 251);
+  const format fmts[] = { formatHLS, formatYUV, formatLAB, formatGray, formatChroma };
+  for(format f : fmts){
+    Img8u a(utils::Size(1,1), f), b(utils::Size(1,1), f);
+    setCCMultiThreaded(false);
+    cc(&src, &a);
+    setCCMultiThreaded(true);
+    cc(&src, &b);
+    ICL_TEST_TRUE(a == b);
+  }
+  // ROI with differing source and destination offsets
+  src.setROI(utils::Rect(10,20,600,400));
+  Img32f a(utils::Size(620,430), formatLAB), b(utils::Size(620,430), formatLAB);
+  a.setROI(utils::Rect(5,3,600,400));
+  b.setROI(a.getROI());
+  setCCMultiThreaded(false);
+  cc(&src, &a, true);
+  setCCMultiThreaded(true);
+  cc(&src, &b, true);
+  ICL_TEST_TRUE(a == b);
+  Img32f ref(utils::Size(600,400), formatLAB);
+  std::unique_ptr<const Img8u> view(src.shallowCopy(src.getROI(), std::vector<int>(), formatRGB));
+  cc(view.get(), &ref, true);
+  ICL_TEST_EQ(b(42,17,1), ref(37,14,1));
+  if(workers < 3) pool.resize(workers);
+}
+
+// ---- Visitors: multi-threaded variants ----
+
+#include <icl/core/VisitorsN.h>
+
+ICL_REGISTER_TEST("core.visitors.perChannelWithMT_roi", "MT visitor matches serial result with ROI") {
+  Img32f src(utils::Size(301,257), 3);
+  for(int c = 0; c < 3; ++c)
+    for(int i = 0; i < 301*257; ++i) src.getData(c)[i] = static_cast<float>((i * 13 + c) % 1000);
+  src.setROI(utils::Rect(3,5,280,240));
+  Img32f a(src.getSize(), 3), b(src.getSize(), 3);
+  a.setROI(src.getROI());
+  b.setROI(src.getROI());
+  auto f = [](const icl32f *s, icl32f *d, int ch, int w) {
+    for(int i = 0; i < w; ++i) d[i] = s[i] * 2 + ch;
+  };
+  visitROILinesPerChannelWith(src, a, f);
+  visitROILinesPerChannelWithMT(src, b, f, 7);
+  ICL_TEST_TRUE(a == b);
+}
+
+ICL_REGISTER_TEST("core.visitors.NWithMT_contiguous", "MT N-channel visitor covers full image once") {
+  Img8u src(utils::Size(640,480), 3);
+  src.fill(1);
+  Img8u dst(utils::Size(640,480), 1);
+  visitROILinesNWithMT<3,1>(src, dst, [](const icl8u *r, const icl8u *g, const icl8u *b,
+                                         icl8u *d, int w) {
+    for(int i = 0; i < w; ++i) d[i] += r[i] + g[i] + b[i];
+  });
+  bool allThree = true;
+  for(int i = 0; i < 640*480; ++i) allThree &= dst.getData(0)[i] == 3;
+  ICL_TEST_TRUE(allThree);
+}
+
+// ---- ImgAllocator ----
+
+#include <icl/core/ImgAllocator.h>
+
+ICL_REGISTER_TEST("core.ImgAllocator.size_classes", "capacities round up by at most 25%") {
+  ICL_TEST_EQ(ImgAllocator::getCapacity(1), size_t(64));
+  ICL_TEST_EQ(ImgAllocator::getCapacity(64), size_t(64));
+  ICL_TEST_EQ(ImgAllocator::getCapacity(65), size_t(80));
+  ICL_TEST_EQ(ImgAllocator::getCapacity(128), size_t(128));
+  ICL_TEST_EQ(ImgAllocator::getCapacity(640*480), size_t(5 << 16));
+  ICL_TEST_EQ(ImgAllocator::getCapacity(1280*1024), size_t(1280*1024));
+  bool ok = true;
+  for(size_t b = 1; b < (1 << 22); b = b * 3 / 2 + 1){
+    const size_t c = ImgAllocator::getCapacity(b);
+    ok &= c >= b && (b <= 64 || c * 4 <= b * 5 + 4);
+  }
+  ICL_TEST_TRUE(ok);
+}
+
+ICL_REGISTER_TEST("core.ImgAllocator.reuse", "same-sized images reuse pooled channel memory") {
+  const bool wasEnabled = ImgAllocator::isEnabled();
+  ImgAllocator::setEnabled(true);
+  { Img8u warmup(utils::Size(320,240), 3); }
+  ImgAllocator::resetStats();
+  for(int i = 0; i < 10; ++i){
+    Img8u a(utils::Size(320,240), 3);
+    std::unique_ptr<Img8u> b(a.deepCopy());
+    ICL_TEST_EQ(a.getData(2)[320*240-1], icl8u(0));
+  }
+  const ImgAllocator::Stats s = ImgAllocator::getStats();
+  ICL_TEST_TRUE(s.allocations > 0);
+  ICL_TEST_TRUE(s.poolHits * 10 >= s.allocations * 9);
+  ImgAllocator::setEnabled(wasEnabled);
+}
+
+ICL_REGISTER_TEST("core.ImgAllocator.alignment", "channel data is cache-line aligned") {
+  Img32f a(utils::Size(17,3), 2);
+  Img8u b(utils::Size(1024,1024), 1);
+  ICL_TEST_EQ(reinterpret_cast<uintptr_t>(a.getData(1)) % 64, uintptr_t(0));
+  ICL_TEST_EQ(reinterpret_cast<uintptr_t>(b.getData(0)) % 4096, uintptr_t(0));
+}
+
+// ---- BayerConverter ----
+
+#include <icl/core/BayerConverter.h>
+
+namespace {
+  Img8u bayer_test_image(const utils::Size &size){
+    Img8u img(size, 1);
+    for(int i = 0; i < size.getDim(); ++i) img.getData(0)[i] = static_cast<icl8u>((i * 37 + (i / size.width) * 11) % 256);
+    return img;
+  }
+}
+
+ICL_REGISTER_TEST("core.BayerConverter.reference", "bilinear and hqLinear match the per-pixel definition") {
+  const utils::Size size(53, 21); // odd width: SIMD body and scalar tails
+  const Img8u src = bayer_test_image(size);
+  auto at = [&](int x, int y){
+    auto m = [](int i, int n){ return i < 0 ? -i : i >= n ? 2 * n - 2 - i : i; };
+    return static_cast<int>(src(m(x, size.width), m(y, size.height), 0));
+  };
+  auto clip = [](int v){ return std::clamp(v, 0, 255); };
+  const char *patterns[] = { "RGGB", "GBRG", "GRBG", "BGGR" };
+  for(int p = 0; p < 4; ++p){
+    const int rx = p >> 1, ry = p & 1;
+    for(int hq = 0; hq < 2; ++hq){
+      BayerConverter bc(patterns[p], hq ? "hqLinear" : "bilinear");
+      Img8u dst;
+      bc.apply(src, dst);
+      bool ok = true;
+      for(int y = 0; y < size.height; ++y){
+        for(int x = 0; x < size.width; ++x){
+          const int c = at(x,y), N = at(x,y-1), S = at(x,y+1), W = at(x-1,y), E = at(x+1,y);
+          const int D = at(x-1,y-1) + at(x+1,y-1) + at(x-1,y+1) + at(x+1,y+1);
+          const int N2 = at(x,y-2), S2 = at(x,y+2), W2 = at(x-2,y), E2 = at(x+2,y);
+          int h, v, g, d;
+          if(hq){
+            h = clip((5*c + 4*(W+E) - W2 - E2 - D + ((N2+S2+1) >> 1) + 4) >> 3);
+            v = clip((5*c + 4*(N+S) - N2 - S2 - D + ((W2+E2+1) >> 1) + 4) >> 3);
+            g = clip((2*(N+S+W+E) - (N2+S2+W2+E2) + 4*c + 4) >> 3);
+            d = clip((2*D - ((3*(N2+S2+W2+E2) + 1) >> 1) + 6*c + 4) >> 3);
+          }else{
+            h = (W+E+1) >> 1;
+            v = (N+S+1) >> 1;
+            g = (N+S+W+E+2) >> 2;
+            d = (D+2) >> 2;
+          }
+          const bool redRow = (y & 1) == ry;
+          const bool colored = (x & 1) == (redRow ? rx : 1 - rx);
+          int rgb[3];
+          rgb[redRow ? 0 : 2] = colored ? c : h;
+          rgb[1] = colored ? g : c;
+          rgb[redRow ? 2 : 0] = colored ? d : v;
+          for(int ch = 0; ch < 3; ++ch) ok &= dst(x,y,ch) == rgb[ch];
+        }
+      }
+      ICL_TEST_TRUE(ok);
+    }
+  }
+}
+
+ICL_REGISTER_TEST("core.BayerConverter.outputs", "MT, planar and interleaved outputs are identical") {
+  utils::ThreadPool &pool = utils::ThreadPool::global();
+  const int workers = pool.getNumWorkers();
+  if(workers < 3) pool.resize(3);
+  const utils::Size size(402, 300);
+  const Img8u src = bayer_test_image(size);
+  const char *methods[] = { "nearestNeighbor", "simple", "bilinear", "hqLinear", "edgeSense" };
+  for(const char *method : methods){
+    BayerConverter bc("GRBG", method);
+    Img8u serial, parallel;
+    bc.setMultiThreaded(false);
+    bc.apply(src, serial);
+    bc.setMultiThreaded(true);
+    bc.apply(src, parallel);
+    ICL_TEST_TRUE(serial == parallel);
+
+    const int step = size.width * 3 + 5;
+    std::vector<icl8u> rgb(step * size.height);
+    bc.applyInterleaved(src, rgb.data(), step);
+    bool ok = true;
+    for(int y = 0; y < size.height; ++y)
+      for(int x = 0; x < size.width; ++x)
+        for(int c = 0; c < 3; ++c) ok &= rgb[y * step + 3 * x + c] == serial(x,y,c);
+    ICL_TEST_TRUE(ok);
+  }
+  if(workers < 3) pool.resize(workers);
+}
+
+ICL_REGISTER_TEST("core.BayerConverter.edgeSense", "edgeSense reproduces flat colors and gray edges") {
+  // a flat color (r,g,b) = (200,120,40) and a vertical gray edge
+  const utils::Size size(40, 24);
+  Img8u flat(size, 1), edge(size, 1);
+  for(int y = 0; y < size.height; ++y){
+    for(int x = 0; x < size.width; ++x){
+      flat(x,y,0) = (y & 1) ? ((x & 1) ? 40 : 120) : ((x & 1) ? 120 : 200);
+      edge(x,y,0) = x < 20 ? 30 : 220;
+    }
+  }
+  BayerConverter bc("RGGB", "edgeSense");
+  Img8u dst;
+  bc.apply(flat, dst);
+  bool ok = true;
+  for(int i = 0; i < size.getDim(); ++i){
+    ok &= dst.getData(0)[i] == 200 && dst.getData(1)[i] == 120 && dst.getData(2)[i] == 40;
+  }
+  ICL_TEST_TRUE(ok);
+  bc.apply(edge, dst);
+  ok = true;
+  for(int y = 0; y < size.height; ++y){
+    for(int x = 0; x < size.width; ++x){
+      for(int c = 0; c < 3; ++c) ok &= dst(x,y,c) == (x < 20 ? 30 : 220);
+    }
+  }
+  ICL_TEST_TRUE(ok);
+}
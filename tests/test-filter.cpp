@@ -30,6 +30,16 @@
 #include <icl/filter/FFTOp.h>
 #include <icl/filter/IFFTOp.h>
 #include <icl/filter/MotionSensitiveTemporalSmoothing.h>
+#include <icl/utils/BackendTuning.h>
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unistd.h>
 
 using namespace icl;
 using namespace icl::utils;
@@ -777,6 +787,54 @@ ICL_REGISTER_TEST("Filter.AffineOp.cross_validate_per_depth", "all combos match
   }
 }
 
+ICL_REGISTER_TEST("Filter.AffineOp.lin_matches_per_pixel", "row-major warp equals per-pixel inverse mapping") {
+  auto src = Img32f::from(23, 17, 1, [](int x, int y, int) -> icl32f { return (x * 7 + y * 13) % 200; });
+  AffineOp op(interpolateLIN);
+  op.rotate(30);
+  op.scale(1.3, 0.8);
+  op.translate(4, -2);
+  op.setAdaptResultImage(false);
+  op.forceAll(Backend::Cpp);
+  Image dst = op.apply(Image(src));
+
+  // reference: the inverse of x' = A x + t, evaluated independently per pixel
+  const double co = std::cos(30 * M_PI / 180), si = std::sin(30 * M_PI / 180);
+  const double a = co * 1.3, b = -si * 0.8, c = si * 1.3, d = co * 0.8, tx = 4, ty = -2;
+  const double det = a * d - b * c;
+  int lin = 0, bad = 0;
+  for(int y = 0; y < 17; ++y){
+    for(int x = 0; x < 23; ++x){
+      const float xs = ( d * (x - tx) - b * (y - ty)) / det;
+      const float ys = (-c * (x - tx) + a * (y - ty)) / det;
+      float expected = 0;
+      if(xs >= 0 && xs < 22 && ys >= 0 && ys < 16){
+        expected = src.subPixelLIN(xs, ys, 0);
+        ++lin;
+      }else if(src.getImageRect().contains(round(xs), round(ys))){
+        expected = src(round(xs), round(ys), 0);
+      }
+      if(std::abs(dst.as32f()(x, y, 0) - expected) > 1e-2f) ++bad;
+    }
+  }
+  ICL_TEST_TRUE(lin > 100);
+  ICL_TEST_EQ(bad, 0);
+}
+
+ICL_REGISTER_TEST("Filter.AffineOp.cross_validate_lin", "bilinear backends match on rotated images") {
+  for(auto d : { depth8u, depth32f }) {
+    Image src(Size(41, 29), d, 3, formatRGB);
+    src.visit([](auto &img) {
+      img.visitPixels([](int x, int y, int c, auto &val) {
+        val = static_cast<std::remove_reference_t<decltype(val)>>((x * 7 + y * 13 + c * 31) % 200);
+      });
+    });
+    AffineOp op(interpolateLIN);
+    op.rotate(17);
+    op.scale(1.7, 1.2);
+    crossValidateBackends(op, src, [&]{ return op.apply(src); });
+  }
+}
+
 // ====================================================================
 // ChamferOp — additional pixel tests
 // ====================================================================
@@ -1152,6 +1210,72 @@ ICL_REGISTER_TEST("Filter.CannyOp.binary_output", "output only contains 0 and 25
   ICL_TEST_TRUE(ok);
 }
 
+// circles with low-amplitude noise: long edge chains, weak and strong responses
+static Image makeCannyTestImage(int w, int h, int ch) {
+  return Image(Img8u::from(w, h, ch, [](int x, int y, int c) -> icl8u {
+    const int dx = x - 37 - 5*c, dy = y - 29, r2 = dx*dx + dy*dy;
+    const int base = (r2 < 400) ? 180 : (r2 < 900 ? 90 : 30);
+    const unsigned n = (unsigned(x) * 73856093u) ^ (unsigned(y) * 19349663u) ^ (unsigned(c) * 83492791u);
+    return icl8u(base + int((n >> 7) % 41) - 20);
+  }));
+}
+
+ICL_REGISTER_TEST("Filter.CannyOp.fused_matches_separate", "fused8u mode equals the separate derivatives mode") {
+  Image src = makeCannyTestImage(83, 61, 2);
+  const float thresholds[][2] = { {0, 0}, {20, 100}, {60, 200}, {150, 400} };
+  bool ok = true;
+  for(int blur = 0; blur <= 1; ++blur){
+    for(int clip = 0; clip <= 1; ++clip){
+      for(const Rect &roi : { src.getImageRect(), Rect(5, 3, 70, 50) }){
+        for(const auto &t : thresholds){
+          Image s = src.deepCopy();
+          s.setROI(roi);
+          CannyOp ref(t[0], t[1], blur), fused(t[0], t[1], blur);
+          fused.setMode(CannyOp::fused8u);
+          ref.setClipToROI(clip);
+          fused.setClipToROI(clip);
+          Image a, b;
+          ref.apply(s, a);
+          fused.apply(s, b);
+          if(!(a.as8u() == b.as8u()) || a.getROI() != b.getROI()) ok = false;
+        }
+      }
+    }
+  }
+  ICL_TEST_TRUE(ok);
+}
+
+ICL_REGISTER_TEST("Filter.CannyOp.fused_cross_backend", "fused8u backends produce identical output") {
+  Image src = makeCannyTestImage(83, 61, 1);
+  CannyOp op(20, 100);
+  op.setMode(CannyOp::fused8u);
+  crossValidateBackends(op, src, [&]{ return op.apply(src); });
+}
+
+ICL_REGISTER_TEST("Filter.CannyOp.weak_only", "weak edges without a strong pixel are removed") {
+  auto src = Img8u::from(20, 20, 1, [](int x,int,int) -> icl8u { return (x < 10) ? 0 : 255; });
+  for(auto m : { CannyOp::separateDerivatives, CannyOp::fused8u }){
+    CannyOp op(10, 2000);
+    op.setMode(m);
+    Image dst = op.apply(Image(src));
+    bool anyNonZero = false;
+    dst.as8u().visitPixels([&](const icl8u &v) { if(v) anyNonZero = true; });
+    ICL_TEST_FALSE(anyNonZero);
+  }
+}
+
+ICL_REGISTER_TEST("Filter.CannyOp.threaded", "banded hysteresis equals the serial result") {
+  Image src = makeCannyTestImage(160, 120, 1);
+  for(auto m : { CannyOp::separateDerivatives, CannyOp::fused8u }){
+    CannyOp op(20, 120);
+    op.setMode(m);
+    Image serial = op.apply(src).deepCopy();
+    op.setThreadCount(4);
+    Image banded = op.apply(src);
+    ICL_TEST_TRUE(serial.as8u() == banded.as8u());
+  }
+}
+
 ICL_REGISTER_TEST("Filter.GaborOp.impulse_response", "gabor on impulse produces non-zero output") {
   GaborOp op(Size(3, 3), {3.0f}, {0.0f}, {0.0f}, {1.0f}, {1.0f});
   Img32f src(Size(7, 7), 1);
@@ -1332,6 +1456,68 @@ ICL_REGISTER_TEST("Filter.ConvolutionOp.even_4x4_cross_validate", "even kernel b
   crossValidateBackends(op, srcImg, [&]{ return op.apply(srcImg); });
 }
 
+ICL_REGISTER_TEST("Filter.ConvolutionKernel.separate", "rank-1 kernels are decomposed") {
+  std::vector<int> col, row;
+  ICL_TEST_TRUE(ConvolutionKernel(ConvolutionKernel::gauss3x3).separate(col, row));
+  ICL_TEST_TRUE(col == std::vector<int>({1,2,1}));
+  ICL_TEST_TRUE(row == std::vector<int>({1,2,1}));
+  ICL_TEST_TRUE(ConvolutionKernel(ConvolutionKernel::sobelX5x5).separate(col, row));
+  ICL_TEST_TRUE(col == std::vector<int>({1,4,6,4,1}));
+  ICL_TEST_TRUE(row == std::vector<int>({1,2,0,-2,-1}));
+  ICL_TEST_FALSE(ConvolutionKernel(ConvolutionKernel::laplace3x3).separate(col, row));
+  ICL_TEST_FALSE(ConvolutionKernel(ConvolutionKernel::gauss5x5).separate(col, row));
+
+  std::vector<float> fcol, frow;
+  ICL_TEST_TRUE(ConvolutionKernel(ConvolutionKernel::gauss3x3, true).separate(fcol, frow));
+  ICL_TEST_NEAR(fcol[0] * frow[0], 1.f/16, 1e-7f);
+  ICL_TEST_NEAR(fcol[1] * frow[1], 4.f/16, 1e-7f);
+  ICL_TEST_FALSE(ConvolutionKernel(ConvolutionKernel::gauss3x3).separate(fcol, frow));
+}
+
+ICL_REGISTER_TEST("Filter.ConvolutionOp.separable_equals_2d", "separable path matches the 2D convolution") {
+  // sobelX5x5 is separable; the 8u result must equal the exact 2D sum
+  auto src = Img8u::from(37, 23, 1, [](int x, int y, int) -> icl8u { return (x * 7 + y * 13) % 256; });
+  ConvolutionKernel kernel{ConvolutionKernel::sobelX5x5};
+  ConvolutionOp op{kernel};
+  Image dst = op.apply(Image(src));
+  ICL_TEST_EQ(dst.getWidth(), 33);
+  ICL_TEST_EQ(dst.getHeight(), 19);
+  const int *k = kernel.getIntData();
+  bool equal = true;
+  for(int y = 0; y < 19; ++y){
+    for(int x = 0; x < 33; ++x){
+      int sum = 0;
+      for(int my = 0; my < 5; ++my){
+        for(int mx = 0; mx < 5; ++mx) sum += k[my * 5 + mx] * src(x + mx, y + my, 0);
+      }
+      if(dst.as16s()(x, y, 0) != clipped_cast<int, icl16s>(sum)) equal = false;
+    }
+  }
+  ICL_TEST_TRUE(equal);
+}
+
+ICL_REGISTER_TEST("Filter.ConvolutionOp.cross_validate_kernels", "separable and 2D kernels match across backends") {
+  const ConvolutionKernel::fixedType types[] = {
+    ConvolutionKernel::gauss3x3, ConvolutionKernel::gauss5x5, ConvolutionKernel::sobelX3x3,
+    ConvolutionKernel::sobelY5x5, ConvolutionKernel::laplace3x3, ConvolutionKernel::laplace5x5
+  };
+  for(auto d : { depth8u, depth16s, depth32f }) {
+    // odd width: exercises the scalar tails of the vectorized loops
+    Image src(Size(43, 21), d, 2, formatMatrix);
+    src.visit([](auto &img) {
+      img.visitPixels([](int x, int y, int c, auto &val) {
+        val = static_cast<std::remove_reference_t<decltype(val)>>((x * 7 + y * 13 + c * 5) % 200);
+      });
+    });
+    for(auto t : types) {
+      for(bool forceUnsigned : { false, true }) {
+        ConvolutionOp op(ConvolutionKernel(t), forceUnsigned);
+        crossValidateBackends(op, src, [&]{ return op.apply(src); });
+      }
+    }
+  }
+}
+
 // ============================================================
 // MorphologicalOp tests
 // ============================================================
@@ -1389,6 +1575,135 @@ ICL_REGISTER_TEST("Filter.MorphOp.32f", "morphological ops work on 32f") {
   ICL_TEST_EQ(dst.as32f()(2, 2, 0), 100.f);
 }
 
+ICL_REGISTER_TEST("Filter.MorphOp.setOptype_keeps_mask", "changing the optype keeps a custom mask") {
+  const icl8u mask[] = { 0,255,0, 255,255,255, 0,255,0 };
+  MorphologicalOp op(MorphologicalOp::dilate, Size(3, 3), mask);
+  for(int i = 0; i < 4; ++i){
+    op.setOptype(i % 2 ? MorphologicalOp::dilate : MorphologicalOp::erode);
+    ICL_TEST_TRUE(std::equal(mask, mask + 9, op.getMask()));
+  }
+  op.setMask(op.getMaskSize(), op.getMask());
+  ICL_TEST_TRUE(std::equal(mask, mask + 9, op.getMask()));
+
+  // the current mask does not fit a new size and is reset
+  op.setMask(Size(5, 5), op.getMask());
+  ICL_TEST_TRUE(std::all_of(op.getMask(), op.getMask() + 25, [](icl8u v){ return v == 255; }));
+}
+
+// brute force dilation/erosion of the full image (no ROI) with the given mask
+template<class T>
+static Img<T> morph_reference(const Img<T> &src, const Size &ms, const std::vector<icl8u> &mask, bool dilate) {
+  const int w = src.getWidth() - ms.width + 1, h = src.getHeight() - ms.height + 1;
+  Img<T> ref(Size(w, h), src.getChannels());
+  for(int c = 0; c < src.getChannels(); ++c) {
+    for(int y = 0; y < h; ++y) {
+      for(int x = 0; x < w; ++x) {
+        T best = dilate ? std::numeric_limits<T>::lowest() : std::numeric_limits<T>::max();
+        for(int my = 0; my < ms.height; ++my) {
+          for(int mx = 0; mx < ms.width; ++mx) {
+            if(!mask[my * ms.width + mx]) continue;
+            const T v = src(x + mx, y + my, c);
+            best = dilate ? std::max(best, v) : std::min(best, v);
+          }
+        }
+        ref(x, y, c) = best;
+      }
+    }
+  }
+  return ref;
+}
+
+// rectangle, disk, diamond, ring and a sparse pattern (direct evaluation)
+static std::vector<std::pair<Size, std::vector<icl8u>>> morph_test_masks() {
+  std::vector<std::pair<Size, std::vector<icl8u>>> masks;
+  for(Size s : { Size(1, 1), Size(3, 3), Size(15, 1), Size(1, 9), Size(7, 5), Size(15, 15), Size(67, 3) }) {
+    masks.push_back({ s, std::vector<icl8u>(s.getDim(), 255) });
+  }
+  for(int r : { 2, 7 }) {
+    const int d = 2 * r + 1;
+    std::vector<icl8u> disk(d * d), diamond(d * d), ring(d * d), sparse(d * d);
+    for(int y = 0; y < d; ++y) {
+      for(int x = 0; x < d; ++x) {
+        const int dx = x - r, dy = y - r, rr = dx * dx + dy * dy;
+        disk[y * d + x] = rr <= r * r ? 255 : 0;
+        diamond[y * d + x] = std::abs(dx) + std::abs(dy) <= r ? 1 : 0;
+        ring[y * d + x] = rr <= r * r && rr >= (r - 1) * (r - 1) ? 255 : 0;
+        sparse[y * d + x] = (x + 2 * y) % 3 == 0 ? 255 : 0;
+      }
+    }
+    for(auto *m : { &disk, &diamond, &ring, &sparse }) masks.push_back({ Size(d, d), *m });
+  }
+  return masks;
+}
+
+template<class T>
+static void test_morph_masks(const Img<T> &src) {
+  for(const auto &[ms, mask] : morph_test_masks()) {
+    for(bool dilate : { true, false }) {
+      MorphologicalOp op(dilate ? MorphologicalOp::dilate : MorphologicalOp::erode, ms, mask.data());
+      Image dst = op.apply(Image(src));
+      const Img<T> ref = morph_reference(src, ms, mask, dilate);
+      ICL_TEST_EQ(dst.getROISize(), ref.getSize());
+      bool equal = true;
+      const Img<T> &d = dst.as<T>();
+      const Rect roi = d.getROI();
+      for(int c = 0; c < ref.getChannels(); ++c) {
+        for(int y = 0; y < ref.getHeight(); ++y) {
+          for(int x = 0; x < ref.getWidth(); ++x) {
+            if(d(roi.x + x, roi.y + y, c) != ref(x, y, c)) equal = false;
+          }
+        }
+      }
+      ICL_TEST_TRUE(equal);
+    }
+  }
+}
+
+ICL_REGISTER_TEST("Filter.MorphOp.masks_gray", "rectangular and decomposed masks match brute force on gray images") {
+  // odd sizes exercise the scalar tails of the vectorized row passes
+  test_morph_masks(Img8u::from(101, 37, 2, [](int x, int y, int c) -> icl8u {
+    return static_cast<icl8u>((x * 37 + y * 91 + c * 17 + x * y) % 251);
+  }));
+  test_morph_masks(Img32f::from(83, 29, 1, [](int x, int y, int) -> icl32f {
+    return std::sin(x * 0.37f) * 100.f + std::cos(y * 0.71f) * 50.f - 20.f;
+  }));
+}
+
+ICL_REGISTER_TEST("Filter.MorphOp.masks_binary", "bit-packed path matches brute force on two-valued images") {
+  // 0/255 and arbitrary two-valued data, wider than 64 pixels
+  test_morph_masks(Img8u::from(203, 31, 1, [](int x, int y, int) -> icl8u {
+    return ((x / 5 + y / 3) % 4 == 0 || (x * 13 + y * 7) % 29 == 0) ? 255 : 0;
+  }));
+  test_morph_masks(Img8u::from(131, 23, 1, [](int x, int y, int) -> icl8u {
+    return (x * 3 + y * 11) % 17 < 9 ? 40 : 7;
+  }));
+  // a constant image stays constant
+  Img8u flat(Size(70, 20), 1);
+  flat.clear(-1, 77);
+  test_morph_masks(flat);
+}
+
+ICL_REGISTER_TEST("Filter.MorphOp.composite_large_mask", "opening/closing with large masks match composed erode/dilate") {
+  auto src = Img8u::from(120, 90, 1, [](int x, int y, int) -> icl8u {
+    return static_cast<icl8u>((x * 37 + y * 91 + x * y) % 251);
+  });
+  const Size ms(11, 7);
+  const std::vector<icl8u> mask(ms.getDim(), 255);
+  MorphologicalOp close(MorphologicalOp::closeBorder, ms);
+  Image dst = close.apply(Image(src));
+  const Img8u ref = morph_reference(morph_reference(src, ms, mask, true), ms, mask, false);
+  ICL_TEST_EQ(dst.getROISize(), ref.getSize());
+  const Img8u &d = dst.as8u();
+  const Rect roi = d.getROI();
+  bool equal = true;
+  for(int y = 0; y < ref.getHeight(); ++y) {
+    for(int x = 0; x < ref.getWidth(); ++x) {
+      if(d(roi.x + x, roi.y + y, 0) != ref(x, y, 0)) equal = false;
+    }
+  }
+  ICL_TEST_TRUE(equal);
+}
+
 ICL_REGISTER_TEST("Filter.ROI.MorphOp", "ROI handling for MorphologicalOp") {
   MorphologicalOp op(MorphologicalOp::erode, Size(3, 3));
   Image src = makeGradient<icl8u>(12, 12);
@@ -1638,6 +1953,29 @@ ICL_REGISTER_TEST("Filter.MedianOp.huang_nontrivial", "7x7 Huang median with non
   ICL_TEST_EQ(dst.as8u()(2, 2, 0), vals[49/2]);
 }
 
+ICL_REGISTER_TEST("Filter.MedianOp.networks_exact", "3x3/5x5 sorting networks match a sorted reference") {
+  auto src = Img32f::from(37, 29, 1, [](int x, int y, int) -> icl32f {
+    return float((x * 7919 + y * 104729 + x * y * 31) % 1009);
+  });
+  for (int m : {3, 5}) {
+    MedianOp op(Size(m, m));
+    Image dst = op.apply(Image(src));
+    const Img32f &d = dst.as32f();
+    int wrong = 0;
+    for (int y = 0; y < d.getHeight(); y++) {
+      for (int x = 0; x < d.getWidth(); x++) {
+        std::vector<icl32f> vals;
+        for (int sy = 0; sy < m; sy++)
+          for (int sx = 0; sx < m; sx++)
+            vals.push_back(src(x + sx, y + sy, 0));
+        std::sort(vals.begin(), vals.end());
+        wrong += d(x, y, 0) != vals[m * m / 2];
+      }
+    }
+    ICL_TEST_EQ(wrong, 0);
+  }
+}
+
 ICL_REGISTER_TEST("Filter.MedianOp.cross_validate", "all backend combos produce identical output") {
   auto src = Img8u::from(30, 20, 1, [](int x, int y, int) -> icl8u {
     return (x * 7 + y * 13) % 256;
@@ -1922,6 +2260,107 @@ ICL_REGISTER_TEST("Filter.WarpOp.cross_validate_per_depth", "all combos match ac
   }
 }
 
+// Helper: rotation by angle (radians) around the image center, scaled by s
+static Img32f makeRotationWarpMap(int w, int h, float angle, float s) {
+  const float cx = (w - 1) / 2.0f, cy = (h - 1) / 2.0f;
+  const float ca = std::cos(angle) * s, sa = std::sin(angle) * s;
+  return Img32f::from(w, h, 2, [=](int x, int y, int c) -> icl32f {
+    return c == 0 ? cx + ca * (x - cx) - sa * (y - cy)
+                  : cy + sa * (x - cx) + ca * (y - cy);
+  });
+}
+
+ICL_REGISTER_TEST("Filter.WarpOp.compact_identity", "compact map reproduces identity and integer shifts exactly") {
+  depth depths[] = { depth8u, depth16s, depth32f };
+  for(auto d : depths) {
+    Image src(Size(21, 13), d, 2, formatMatrix);
+    src.visit([](auto &img) {
+      img.visitPixels([](int x, int y, int c, auto &val) {
+        val = static_cast<std::remove_reference_t<decltype(val)>>((x * 7 + y * 13 + c * 50) % 200);
+      });
+    });
+    for(scalemode mode : { interpolateNN, interpolateLIN }) {
+      WarpOp op(makeIdentityWarpMap(21, 13), mode);
+      op.setUseCompactMap(true);
+      ICL_TEST_TRUE(op.apply(src) == src);
+
+      op.setWarpMap(makeShiftWarpMap(21, 13, 2, 3));
+      Image dst = op.apply(src);
+      bool match = true;
+      dst.visit([&](const auto &r) {
+        using T = typename std::remove_reference_t<decltype(r)>::type;
+        const Img<T> &s = src.as<T>();
+        for(int c = 0; c < 2; ++c)
+          for(int y = 0; y < 13; ++y)
+            for(int x = 0; x < 21; ++x)
+              if(r(x, y, c) != (x < 19 && y < 10 ? s(x + 2, y + 3, c) : T(0))) match = false;
+      });
+      ICL_TEST_TRUE(match);
+    }
+  }
+}
+
+ICL_REGISTER_TEST("Filter.WarpOp.compact_vs_float", "compact map matches the float map up to its sub-pixel resolution") {
+  auto src = Img32f::from(64, 48, 1, [](int x, int y, int) -> icl32f {
+    return x + 2.0f * y;
+  });
+  Img32f wm = makeRotationWarpMap(64, 48, 0.3f, 0.9f);
+  WarpOp ref(wm, interpolateLIN), op(wm, interpolateLIN);
+  op.setUseCompactMap(true);
+  Image a = ref.apply(Image(src)), b = op.apply(Image(src));
+  float maxDiff = 0;
+  int nValid = 0;
+  for(int y = 0; y < 48; ++y) {
+    for(int x = 0; x < 64; ++x) {
+      const float va = a.as32f()(x, y, 0), vb = b.as32f()(x, y, 0);
+      if(va == 0 || vb == 0) continue; // border pixels may differ in validity
+      maxDiff = std::max(maxDiff, std::fabs(va - vb));
+      ++nValid;
+    }
+  }
+  ICL_TEST_TRUE(nValid > 64 * 48 / 2);
+  // quantization error <= 1/64 pixel per axis, gradient (1,2)
+  ICL_TEST_TRUE(maxDiff <= 3.0f / 64 + 1e-3f);
+}
+
+ICL_REGISTER_TEST("Filter.WarpOp.compact_border", "compact map never reads outside the image at the right/bottom border") {
+  // all entries point into the last half pixel at the bottom-right corner
+  Img32f wm(Size(9, 7), 2);
+  wm.fill(0); // make the channels exist
+  std::fill(wm.begin(0), wm.end(0), 8.4f);
+  std::fill(wm.begin(1), wm.end(1), 6.3f);
+  auto src = Img8u::from(9, 7, 1, [](int x, int y, int) -> icl8u { return x + 10 * y; });
+  for(scalemode mode : { interpolateNN, interpolateLIN }) {
+    WarpOp op(wm, mode);
+    op.setUseCompactMap(true);
+    Image dst = op.apply(Image(src));
+    bool allCorner = true;
+    for(int i = 0; i < 9 * 7; ++i) if(dst.as8u().begin(0)[i] != 68) allCorner = false;
+    ICL_TEST_TRUE(allCorner);
+  }
+}
+
+ICL_REGISTER_TEST("Filter.WarpOp.compact_cross_validate", "compact C++ and SIMD backends are bit-identical") {
+  depth depths[] = { depth8u, depth16s, depth32f };
+  for(auto d : depths) {
+    Image src(Size(67, 45), d, 1, formatMatrix);
+    src.visit([](auto &img) {
+      img.visitPixels([](int x, int y, int, auto &val) {
+        val = static_cast<std::remove_reference_t<decltype(val)>>(((x * 37 + y * 91) % 251) - (sizeof(val) == 2 ? 100 : 0));
+      });
+    });
+    src.setROI(Rect(3, 2, 61, 40));
+    for(scalemode mode : { interpolateNN, interpolateLIN }) {
+      WarpOp op(makeRotationWarpMap(67, 45, 0.5f, 1.2f), mode);
+      op.setUseCompactMap(true);
+      for(bool clip : { true, false }) {
+        op.setClipToROI(clip);
+        crossValidateBackends(op, src, [&]{ return op.apply(src); });
+      }
+    }
+  }
+}
+
 // ============================================================
 // ThresholdOp — FilterDispatch framework proof-of-concept
 // ============================================================
@@ -3151,3 +3590,179 @@ ICL_REGISTER_TEST("Filter.WienerOp.32f_float_path",
     }
   }
 }
+
+// ====================================================================
+// Band-parallel apply (UnaryOp::setThreadCount)
+// ====================================================================
+
+// Applies op serially and split into bands, with and without source ROI,
+// and checks that the results are pixel-identical. The bands are formed
+// even if the global pool has no workers, so this also covers 1-CPU hosts.
+static void testBandSplit(UnaryOp &op, const Image &src) {
+  for(bool useROI : {false, true}) {
+    Image s = src.deepCopy();
+    if(useROI) s.setROI(Rect(7, 5, s.getWidth() - 15, s.getHeight() - 11));
+    op.setThreadCount(1);
+    Image ref = op.apply(s).deepCopy();
+    op.setThreadCount(4);
+    Image dst = op.apply(s).deepCopy();
+    ICL_TEST_EQ(dst.getSize(), ref.getSize());
+    ICL_TEST_EQ(dst.getROI(), ref.getROI());
+    ICL_TEST_TRUE(dst == ref);
+  }
+  op.setThreadCount(1);
+}
+
+ICL_REGISTER_TEST("Filter.Bands.policy", "thread count property and setParallel") {
+  MedianOp op(Size(3, 3));
+  ICL_TEST_EQ(op.getThreadCount(), 1);
+  ICL_TEST_FALSE(op.getParallel());
+  op.setParallel(true);
+  ICL_TEST_EQ(op.getThreadCount(), 0);
+  ICL_TEST_EQ(op.getPropertyValue("UnaryOp.threads").as<int>(), 0);
+  op.setPropertyValue("UnaryOp.threads", 3);
+  ICL_TEST_EQ(op.getThreadCount(), 3);
+  MedianOp copy(op);
+  ICL_TEST_EQ(copy.getThreadCount(), 3);
+}
+
+ICL_REGISTER_TEST("Filter.Bands.MedianOp", "banded median equals serial median") {
+  MedianOp op3(Size(3, 3));
+  testBandSplit(op3, makeGradient<icl8u>(160, 120, 3));
+  MedianOp op7(Size(7, 5));
+  testBandSplit(op7, makeGradient<icl32f>(160, 120));
+}
+
+ICL_REGISTER_TEST("Filter.Bands.ConvolutionOp", "banded convolution equals serial convolution") {
+  ConvolutionOp op(ConvolutionKernel(ConvolutionKernel::sobelX3x3));
+  testBandSplit(op, makeGradient<icl8u>(160, 120));
+  ConvolutionOp gauss(ConvolutionKernel(ConvolutionKernel::gauss5x5));
+  testBandSplit(gauss, makeGradient<icl32f>(160, 120, 2));
+}
+
+ICL_REGISTER_TEST("Filter.Bands.MorphologicalOp", "banded dilation/erosion equals serial result") {
+  MorphologicalOp dilate(MorphologicalOp::dilate, Size(5, 3));
+  testBandSplit(dilate, makeGradient<icl8u>(160, 120));
+  MorphologicalOp erode(MorphologicalOp::erode, Size(3, 3));
+  testBandSplit(erode, makeGradient<icl32f>(160, 120));
+  MorphologicalOp open(MorphologicalOp::openBorder, Size(3, 3));
+  testBandSplit(open, makeGradient<icl8u>(160, 120));
+}
+
+ICL_REGISTER_TEST("Filter.Bands.BilateralFilterOp", "banded bilateral filter equals serial result") {
+  BilateralFilterOp op(2, 3.f, 30.f, false);
+  op.forceAll(Backend::Cpp);
+  Image src = makeGradient<icl8u>(160, 120);
+  op.setThreadCount(1);
+  Image ref = op.apply(src).deepCopy();
+  op.setThreadCount(4);
+  ICL_TEST_TRUE(op.apply(src) == ref);
+
+  BilateralFilterOp lab(2, 3.f, 30.f, true);
+  lab.forceAll(Backend::Cpp);
+  Image rgb = makeGradient<icl8u>(160, 120, 3);
+  rgb.setFormat(formatRGB);
+  lab.setThreadCount(1);
+  ref = lab.apply(rgb).deepCopy();
+  lab.setThreadCount(4);
+  ICL_TEST_TRUE(lab.apply(rgb) == ref);
+}
+
+ICL_REGISTER_TEST("Filter.Bands.AffineOp", "banded affine warp equals serial result") {
+  AffineOp op(interpolateLIN);
+  op.rotate(17);
+  op.scale(1.3, 0.9);
+  testBandSplit(op, makeGradient<icl32f>(160, 120));
+}
+
+ICL_REGISTER_TEST("Filter.Bands.WarpOp", "banded warp equals serial result") {
+  WarpOp op(makeShiftWarpMap(160, 120, 2.5f, -1.5f), interpolateLIN);
+  op.forceAll(Backend::Cpp);
+  testBandSplit(op, makeGradient<icl8u>(160, 120, 2));
+}
+
+namespace {
+  void copy_band(const Image &src, Image &band, int y0){
+    const Img8u &s = src.as8u();
+    Img8u &d = band.as8u();
+    const Rect r = d.getROI();
+    for(int y = 0; y < r.height; ++y){
+      const icl8u *row = s.getROIData(0) + (y0 + y) * s.getWidth();
+      std::copy(row, row + r.width, d.getROIData(0) + y * d.getWidth());
+    }
+  }
+
+  // copies its input; the faster Simd backend is stateful and records
+  // which bands each of its state instances processed
+  class BandStateProbeOp : public UnaryOp, public ImageBackendDispatching {
+    public:
+    enum class Op : int { copy };
+    using Sig = void(const Image&, Image&, int);
+
+    std::mutex mutex;
+    std::map<int, std::set<int>> bandsPerState;
+    int numStates = 0;
+
+    BandStateProbeOp(){
+      addSelector<Sig>(Op::copy);
+      backends(Backend::Cpp).add<Sig>(Op::copy, [](const Image &src, Image &band, int y0){
+        std::this_thread::sleep_for(std::chrono::milliseconds(3));
+        copy_band(src, band, y0);
+      }, nullptr, "slow copy");
+      backends(Backend::Simd).addStateful<Sig>(Op::copy, [this]{
+        std::scoped_lock lock(mutex);
+        return [this, id = numStates++](const Image &src, Image &band, int y0){
+          {
+            std::scoped_lock lock(mutex);
+            bandsPerState[id].insert(y0);
+          }
+          copy_band(src, band, y0);
+        };
+      }, nullptr, "stateful copy");
+    }
+
+    void apply(const Image &src, Image &dst) override {
+      if(!prepare(dst, src)) return;
+      applyBands(getSelector<Sig>(Op::copy).resolve(src), dst,
+                 [&](auto &impl, Image &band, int y0){ impl.apply(src, band, y0); });
+    }
+    using UnaryOp::apply;
+  };
+
+  const char *toString(BandStateProbeOp::Op){ return "copy"; }
+}
+
+ICL_REGISTER_TEST("Filter.Bands.tuning", "measured backend selection keeps stateful backends per band") {
+  const std::string file = (std::filesystem::temp_directory_path()
+                            / ("icl-band-tuning-test-" + std::to_string(::getpid()) + ".txt")).string();
+  const std::string oldFile = BackendTuning::getCacheFile();
+  BackendTuning::setCacheFile(file);
+  BackendTuning::ScopedMode tuning(true);
+
+  BandStateProbeOp op;
+  op.setThreadCount(4);
+  Image src = makeGradient<icl8u>(160, 120);
+  for(int i = 0; i < 2; ++i){
+    op.bandsPerState.clear();
+    ICL_TEST_TRUE(op.apply(src) == src);
+    // the Simd backend wins; no state instance may serve two bands
+    ICL_TEST_FALSE(op.bandsPerState.empty());
+    for(const auto &[id, bands] : op.bandsPerState) ICL_TEST_EQ(static_cast<int>(bands.size()), 1);
+  }
+
+  BackendTuning::setCacheFile(oldFile);
+  BackendTuning::clear();
+  std::remove(file.c_str());
+}
+
+ICL_REGISTER_TEST("Filter.Bands.applyMT", "NeighborhoodOp::applyMT keeps the op's policy") {
+  MedianOp op(Size(5, 5));
+  Image src = makeGradient<icl8u>(160, 120);
+  Image ref = op.apply(src).deepCopy();
+  ImgBase *dst = nullptr;
+  op.applyMT(src.ptr(), &dst, 4);
+  ICL_TEST_TRUE(dst != nullptr);
+  ICL_TEST_TRUE(Image(*dst) == ref);
+  ICL_TEST_EQ(op.getThreadCount(), 1);
+  delete dst;
+}
@@ -6,6 +6,10 @@
 #include <icl/math/FixedMatrix.h>
 #include <icl/math/DynMatrix.h>
 #include <icl/math/Homography2D.h>
+#include <icl/math/FlatKDTree.h>
+#include <icl/math/KDTree.h>
+
+#include <random>
 
 using namespace icl::utils;
 using namespace icl::math;
@@ -1213,3 +1217,162 @@ ICL_REGISTER_TEST("math.homography.roundtrip_rotated_quad",
     ICL_TEST_NEAR(p.y, ps[i].y, 1.0f);
   }
 }
+
+// =====================================================================
+// FlatKDTree / KDTree
+// =====================================================================
+
+namespace {
+  std::vector<float> random_points(int n, int dim, unsigned seed){
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> u(-1.f, 1.f);
+    std::vector<float> pts(n * dim);
+    for(auto &v : pts) v = u(rng);
+    return pts;
+  }
+
+  std::vector<std::pair<float,int>> brute_force(const std::vector<float> &pts, int dim, const float *q){
+    std::vector<std::pair<float,int>> d;
+    for(int i = 0; i < static_cast<int>(pts.size()) / dim; ++i){
+      float s = 0;
+      for(int j = 0; j < dim; ++j) s += (pts[i*dim+j] - q[j]) * (pts[i*dim+j] - q[j]);
+      d.emplace_back(s, i);
+    }
+    std::sort(d.begin(), d.end());
+    return d;
+  }
+}
+
+ICL_REGISTER_TEST("math.kdtree.knn_matches_brute_force", "exact k-NN equals a linear scan")
+{
+  const int dim = 3;
+  std::vector<float> pts = random_points(2000, dim, 1), qs = random_points(50, dim, 2);
+  FlatKDTree<float> tree(pts.data(), 2000, dim, true);
+  ICL_TEST_EQ(tree.size(), 2000);
+  std::vector<FlatKDTree<float>::Neighbour> nn;
+  bool ok = true;
+  for(int i = 0; i < 50; ++i){
+    auto ref = brute_force(pts, dim, &qs[i*dim]);
+    tree.knn(&qs[i*dim], 7, nn);
+    if(nn.size() != 7) ok = false;
+    for(size_t j = 0; j < nn.size(); ++j){
+      if(nn[j].sqrDist != ref[j].first) ok = false;
+    }
+    float d = 0;
+    if(tree.nearest(&qs[i*dim], &d) != ref[0].second || d != ref[0].first) ok = false;
+  }
+  ICL_TEST_TRUE(ok);
+}
+
+ICL_REGISTER_TEST("math.kdtree.nearest_within", "bounded nearest neighbour search")
+{
+  const int dim = 3;
+  std::vector<float> pts = random_points(2000, dim, 8), qs = random_points(100, dim, 9);
+  FlatKDTree<float> tree(pts.data(), 2000, dim);
+  bool ok = true;
+  for(int i = 0; i < 100; ++i){
+    auto ref = brute_force(pts, dim, &qs[i*dim]);
+    float d = 0;
+    // bounds above the nearest distance find it, others find nothing
+    if(tree.nearestWithin(&qs[i*dim], ref[1].first, &d) != ref[0].second || d != ref[0].first) ok = false;
+    if(tree.nearestWithin(&qs[i*dim], ref[0].first) != -1) ok = false;
+  }
+  ICL_TEST_TRUE(ok);
+  ICL_TEST_EQ(FlatKDTree<float>().nearestWithin(qs.data(), 1.f), -1);
+}
+
+ICL_REGISTER_TEST("math.kdtree.nan_query", "a NaN query has no nearest neighbour")
+{
+  const int dim = 3;
+  std::vector<float> pts = random_points(500, dim, 10);
+  FlatKDTree<float> tree(pts.data(), 500, dim);
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  const float q[] = { 0.1f, nan, -0.2f };
+  float d = 0;
+  ICL_TEST_EQ(tree.nearest(q, &d), -1);
+  ICL_TEST_EQ(tree.nearestWithin(q, 1.f), -1);
+
+  // NaN points (e.g. invalid depth pixels) are skipped, the others found
+  for(int i = 0; i < 500; i += 3) pts[i*dim + i%dim] = nan;
+  FlatKDTree<float> withNaN(pts.data(), 500, dim);
+  std::vector<float> qs = random_points(50, dim, 11);
+  bool ok = true;
+  for(int i = 0; i < 50; ++i){
+    int ref = -1;
+    float refDist = std::numeric_limits<float>::max();
+    for(int j = 0; j < 500; ++j){
+      float s = 0;
+      for(int k = 0; k < dim; ++k) s += (pts[j*dim+k] - qs[i*dim+k]) * (pts[j*dim+k] - qs[i*dim+k]);
+      if(s < refDist){ refDist = s; ref = j; }
+    }
+    if(withNaN.nearest(&qs[i*dim], &d) != ref || d != refDist) ok = false;
+  }
+  ICL_TEST_TRUE(ok);
+}
+
+ICL_REGISTER_TEST("math.kdtree.radius_and_eps", "radius search is complete, eps bounds the error")
+{
+  const int dim = 4;
+  std::vector<float> pts = random_points(1500, dim, 3), qs = random_points(40, dim, 4);
+  FlatKDTree<float> tree(pts.data(), 1500, dim);
+  std::vector<FlatKDTree<float>::Neighbour> nn;
+  bool ok = true;
+  for(int i = 0; i < 40; ++i){
+    auto ref = brute_force(pts, dim, &qs[i*dim]);
+    const size_t inside = std::count_if(ref.begin(), ref.end(), [](auto &p){ return p.first <= 0.25f; });
+    tree.radius(&qs[i*dim], 0.5f, nn, true);
+    if(nn.size() != inside) ok = false;
+    for(auto &n : nn) if(n.sqrDist > 0.25f) ok = false;
+
+    float d = 0;
+    tree.nearest(&qs[i*dim], &d, 0.5f);
+    if(std::sqrt(d) > 1.5f * std::sqrt(ref[0].first) + 1e-6f) ok = false;
+  }
+  ICL_TEST_TRUE(ok);
+}
+
+ICL_REGISTER_TEST("math.kdtree.batch", "batched queries equal single queries")
+{
+  const int dim = 2;
+  std::vector<float> pts = random_points(3000, dim, 5), qs = random_points(500, dim, 6);
+  FlatKDTree<float> tree(pts.data(), 3000, dim);
+  std::vector<int> idx;
+  std::vector<float> dists;
+  tree.knnBatch(qs.data(), 500, 3, idx, dists);
+  std::vector<int> nearest(500);
+  tree.nearestBatch(qs.data(), 500, nearest.data());
+  std::vector<FlatKDTree<float>::Neighbour> nn;
+  bool ok = true;
+  for(int i = 0; i < 500; ++i){
+    tree.knn(&qs[i*dim], 3, nn);
+    for(int j = 0; j < 3; ++j){
+      if(idx[i*3+j] != nn[j].index || dists[i*3+j] != nn[j].sqrDist) ok = false;
+    }
+    if(nearest[i] != nn[0].index) ok = false;
+  }
+  ICL_TEST_TRUE(ok);
+
+  FlatKDTree<float> small(pts.data(), 2, dim);
+  small.knnBatch(qs.data(), 1, 3, idx, dists);
+  ICL_TEST_EQ(idx[2], -1);
+}
+
+ICL_REGISTER_TEST("math.kdtree.dynmatrix_wrapper", "KDTree returns the exact nearest DynMatrix")
+{
+  std::vector<float> pts = random_points(300, 3, 7);
+  std::vector<DynMatrix<double>> list;
+  for(int i = 0; i < 300; ++i){
+    DynMatrix<double> m(1, 3);
+    for(int j = 0; j < 3; ++j) m[j] = pts[i*3+j];
+    list.push_back(m);
+  }
+  KDTree tree(list);
+  DynMatrix<double> q(1, 3);
+  q[0] = 0.1; q[1] = -0.2; q[2] = 0.3;
+  const DynMatrix<double> *best = &list[0];
+  auto d2 = [&](const DynMatrix<double> &m){
+    return (m[0]-q[0])*(m[0]-q[0]) + (m[1]-q[1])*(m[1]-q[1]) + (m[2]-q[2])*(m[2]-q[2]);
+  };
+  for(auto &m : list) if(d2(m) < d2(*best)) best = &m;
+  ICL_TEST_TRUE(tree.nearestNeighbour(q) == best);
+}
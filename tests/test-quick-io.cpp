@@ -3,8 +3,11 @@
 #include <icl/qt/QuickCreate.h>
 #include <icl/core/Img.h>
 #include <icl/io/ImageCompressor.h>
+#include <icl/utils/ThreadPool.h>
 
 #include <icl/io/detail/compression-plugins/CompressionRegistry.h>
+#include <icl/io/detail/grabbers/ColorFormatDecoder.h>
+#include <icl/core/Converter.h>
 #ifdef ICL_HAVE_QT_WEBSOCKETS
 #include <icl/io/detail/network/WSImageOutput.h>
 #include <icl/io/detail/network/WSGrabber.h>
@@ -13,6 +16,8 @@
 #include <thread>
 #endif
 
+#include <algorithm>
+#include <cmath>
 #include <cstdio>
 #include <fstream>
 
@@ -155,6 +160,251 @@ ICL_REGISTER_TEST("ImageCompressor.zstd.roundtrip",
 }
 #endif
 
+// ---- Pre-filters (prediction, byte planes, temporal delta) ----
+
+#ifdef ICL_HAVE_ZSTD
+namespace {
+  // smooth single channel 16s "depth" frames with a moving object
+  Img16s depthFrame(int t) {
+    Img16s img(Size(64, 48), 1);
+    for (int y = 0; y < 48; ++y)
+      for (int x = 0; x < 64; ++x)
+        img(x, y, 0) = static_cast<icl16s>(800 + 7 * x + 3 * y
+                                           + ((x - t) * (x - t) + (y - 20) * (y - 20) < 50 ? 400 : 0));
+    return img;
+  }
+}
+#endif
+
+ICL_REGISTER_TEST("ImageCompressor.rlen.prefilter_roundtrip",
+                  "rlen quality 8 with paeth prediction and keyframes is lossless") {
+  io::ImageCompressor enc(io::ImageCompressor::CompressionSpec("rlen", "8;paeth,key3"));
+  io::ImageCompressor plain(io::ImageCompressor::CompressionSpec("rlen", "8"));
+  io::ImageCompressor dec;
+  for (int t = 0; t < 7; ++t) {
+    Img8u src(Size(40, 30), 3);
+    for (int c = 0; c < 3; ++c)
+      for (int y = 0; y < 30; ++y)
+        for (int x = 0; x < 40; ++x) src(x, y, c) = static_cast<icl8u>(x * 3 + y * (c + 1) + (x == t ? 90 : 0));
+    auto data = enc.compress(Image(src));
+    ICL_TEST_TRUE(dec.uncompress(data.bytes, data.len) == Image(src));
+    ICL_TEST_TRUE(data.len < plain.compress(Image(src)).len);
+  }
+}
+
+#ifdef ICL_HAVE_ZSTD
+ICL_REGISTER_TEST("ImageCompressor.zstd.prefilter_roundtrip",
+                  "all zstd pre-filter combinations are lossless for 8u/16s/32f") {
+  const char *filters[] = { "left", "up", "paeth,split", "none,split,key4", "paeth,split,key2" };
+  for (const char *f : filters) {
+    io::ImageCompressor enc(io::ImageCompressor::CompressionSpec("zstd", std::string("3;") + f));
+    io::ImageCompressor dec;
+    for (int t = 0; t < 6; ++t) {
+      Img16s d = depthFrame(t);
+      Img32f f32(d.getSize(), 1);
+      d.convert(&f32);
+      f32(3, 4, 0) = -1.5e-7f;
+      Img8u u8(d.getSize(), 1);
+      d.convert(&u8);
+      for (const Image &src : { Image(d), Image(f32), Image(u8) }) {
+        auto data = enc.compress(src);
+        ICL_TEST_TRUE(dec.uncompress(data.bytes, data.len) == src);
+      }
+    }
+  }
+}
+
+ICL_REGISTER_TEST("ImageCompressor.zstd.prefilter_gain",
+                  "prediction and byte planes shrink depth images") {
+  io::ImageCompressor plain(io::ImageCompressor::CompressionSpec("zstd", "3"));
+  io::ImageCompressor filtered(io::ImageCompressor::CompressionSpec("zstd", "3;paeth,split"));
+  const Image src(depthFrame(10));
+  ICL_TEST_TRUE(filtered.compress(src).len * 2 < plain.compress(src).len);
+}
+
+ICL_REGISTER_TEST("ImageCompressor.zstd.prefilter_missing_keyframe",
+                  "a receiver joining mid-stream waits for the next keyframe") {
+  io::ImageCompressor enc(io::ImageCompressor::CompressionSpec("zstd", "3;paeth,key3"));
+  io::ImageCompressor dec;
+  enc.compress(Image(depthFrame(0)));                 // keyframe, not received
+  auto delta = enc.compress(Image(depthFrame(1)));
+  ICL_TEST_THROW(dec.uncompress(delta.bytes, delta.len), ICLException);
+  enc.compress(Image(depthFrame(2)));
+  auto key = enc.compress(Image(depthFrame(3)));      // next keyframe
+  ICL_TEST_TRUE(dec.uncompress(key.bytes, key.len) == Image(depthFrame(3)));
+  auto next = enc.compress(Image(depthFrame(4)));
+  ICL_TEST_TRUE(dec.uncompress(next.bytes, next.len) == Image(depthFrame(4)));
+}
+#endif
+
+// ---- Fused color format decoding ----
+
+namespace {
+  // raw frame of a smooth scene (chroma and Bayer colors vary slowly)
+  std::vector<icl8u> rawFrame(const std::string &fourcc, const Size &s) {
+    const int W = s.width, H = s.height;
+    auto Y = [](int x, int y) { return static_cast<icl8u>(60 + x + y / 2); };
+    auto U = [](int x, int y) { return static_cast<icl8u>(110 + x / 4); };
+    auto V = [](int x, int y) { return static_cast<icl8u>(140 - y / 4); };
+    std::vector<icl8u> d;
+    if (fourcc == "YUYV" || fourcc == "YUY2") {
+      const bool yuyv = fourcc == "YUYV";
+      for (int y = 0; y < H; ++y)
+        for (int x = 0; x < W; x += 2) {
+          const icl8u q[4] = { Y(x, y), U(x, y), Y(x + 1, y), V(x, y) };
+          if (yuyv) d.insert(d.end(), q, q + 4);
+          else d.insert(d.end(), { q[1], q[0], q[3], q[2] });
+        }
+    } else if (fourcc == "YU12" || fourcc == "NV12") {
+      for (int y = 0; y < H; ++y)
+        for (int x = 0; x < W; ++x) d.push_back(Y(x, y));
+      if (fourcc == "YU12") {
+        for (int p = 0; p < 2; ++p)
+          for (int y = 0; y < H; y += 2)
+            for (int x = 0; x < W; x += 2) d.push_back(p ? V(x, y) : U(x, y));
+      } else {
+        for (int y = 0; y < H; y += 2)
+          for (int x = 0; x < W; x += 2) d.insert(d.end(), { U(x, y), V(x, y) });
+      }
+    } else if (fourcc.size() == 4 && fourcc.find_first_not_of("RGB") == std::string::npos) {
+      for (int y = 0; y < H; ++y)
+        for (int x = 0; x < W; ++x) {
+          const char c = fourcc[2 * (y & 1) + (x & 1)];
+          d.push_back(c == 'R' ? Y(x, y) : c == 'G' ? U(x, y) : V(x, y));
+        }
+    } else {
+      for (int y = 0; y < H; ++y)
+        for (int x = 0; x < W; ++x) d.push_back(Y(x, y));
+    }
+    return d;
+  }
+}
+
+ICL_REGISTER_TEST("ColorFormatDecoder.fused.matches_plain",
+                  "fused decoding equals decode() followed by conversion and scaling") {
+  struct Case { const char *fourcc; std::vector<format> fmts; std::vector<int> factors; };
+  const std::vector<Case> cases = {
+    { "GRAY", { formatGray }, { 1, 2 } },
+    { "Y800", { formatGray }, { 1, 2 } },
+    { "GREY", { formatGray }, { 1, 2 } },
+    { "YUYV", { formatGray, formatYUV, formatRGB }, { 1, 2 } },
+    { "YUY2", { formatGray, formatYUV, formatRGB }, { 1, 2 } },
+    { "YU12", { formatGray, formatYUV, formatRGB }, { 1, 2 } },
+    { "NV12", { formatGray, formatYUV, formatRGB }, { 1, 2 } },
+    { "RGGB", { formatGray, formatRGB }, { 2 } },
+    { "GBRG", { formatGray, formatRGB }, { 2 } },
+    { "GRBG", { formatGray, formatRGB }, { 2 } },
+    { "BGGR", { formatGray, formatRGB }, { 2 } },
+  };
+  const Size size(64, 48);
+  ColorFormatDecoder dec;
+  for (const Case &c : cases) {
+    const std::vector<icl8u> raw = rawFrame(c.fourcc, size);
+    const bool gray = c.fmts.size() == 1;
+    const bool bayer = c.factors.size() == 1;
+    ImgBase *plain = nullptr;
+    dec.decode(FourCC(c.fourcc), raw.data(), size, &plain);
+    for (format fmt : c.fmts) {
+      for (int f : c.factors) {
+        for (depth d : { depth8u, depth32f }) {
+          // the plain decoders already produce their own default output
+          if (f == 1 && d == depth8u && fmt == (gray ? formatGray : formatRGB)) continue;
+          ImgBase *fused = nullptr;
+          ICL_TEST_TRUE(dec.decode(FourCC(c.fourcc), raw.data(), size, &fused, fmt, d, size / f));
+          // gray output of YUV sources is their luma channel
+          const format refFmt = fmt == formatGray && !gray && !bayer ? formatYUV : fmt;
+          ImgBase *ref = imgNew(d, size / f, refFmt);
+          Converter().apply(plain, ref);
+          // YUV (and luma) references went through RGB; at half resolution, the
+          // plain result is subsampled, while fused pixels are block means
+          const double tol = refFmt == formatYUV ? 3 : f == 2 ? 2 : 1;
+          double maxDiff = 0;
+          for (int ch = 0; ch < fused->getChannels(); ++ch) {
+            for (int i = 0; i < fused->getDim(); ++i) {
+              const double a = d == depth8u ? fused->as8u()->getData(ch)[i] : fused->as32f()->getData(ch)[i];
+              const double b = d == depth8u ? ref->as8u()->getData(ch)[i] : ref->as32f()->getData(ch)[i];
+              maxDiff = std::max(maxDiff, std::abs(a - b));
+            }
+          }
+          ICL_TEST_TRUE(fused->getSize() == size / f && fused->getFormat() == fmt && fused->getDepth() == d);
+          ICL_TEST_LE(maxDiff, tol);
+          delete fused;
+          delete ref;
+        }
+      }
+    }
+    delete plain;
+  }
+}
+
+// ---- Tiled compression ----
+
+ICL_REGISTER_TEST("ImageCompressor.tiles.roundtrip",
+                  "row and channel tiles decode to the original image") {
+  ThreadPool &pool = ThreadPool::global();
+  const int workers = pool.getNumWorkers();
+  if (workers < 3) pool.resize(3);
+  Img8u src(Size(50, 37), 3);
+  for (int c = 0; c < 3; ++c)
+    for (int y = 0; y < 37; ++y)
+      for (int x = 0; x < 50; ++x) src(x, y, c) = static_cast<icl8u>(x * 5 + y * 3 + c * 40);
+  src.setFormat(formatRGB);
+  src.setROI(Rect(2, 3, 20, 10));
+  src.setTime(Time(123456));
+  src.getMetaData() = "tiled";
+  for (const char *mode : { "raw", "rlen" }) {
+    for (const char *tiles : { "5", "37", "channels" }) {
+      io::ImageCompressor enc(io::ImageCompressor::CompressionSpec(mode, mode == std::string("rlen") ? "8" : ""));
+      if (tiles == std::string("channels")) {
+        enc.setPropertyValue("tiles", "2");
+        enc.setPropertyValue("tile mode", "channels");
+      } else {
+        enc.setPropertyValue("tiles", tiles);
+      }
+      auto data = enc.compress(Image(src));
+      ICL_TEST_EQ(static_cast<int>(data.bytes[4]), 2);  // tiled envelope version
+      io::ImageCompressor dec;
+      Image got = dec.uncompress(data.bytes, data.len);
+      ICL_TEST_TRUE(got == Image(src));
+      ICL_TEST_TRUE(got.getROI() == src.getROI());
+      ICL_TEST_EQ(got.getFormat(), formatRGB);
+      ICL_TEST_TRUE(got.getTime() == src.getTime());
+      ICL_TEST_EQ(got.ptr()->getMetaData(), std::string("tiled"));
+    }
+  }
+  if (workers < 3) pool.resize(workers);
+}
+
+ICL_REGISTER_TEST("ImageCompressor.tiles.untiled_envelope",
+                  "tiles = 1 and small images in auto mode keep the version-1 envelope") {
+  Img16s src = Img16s(Size(64, 48), 1);
+  io::ImageCompressor off(io::ImageCompressor::CompressionSpec("raw"));
+  io::ImageCompressor autoTiles(io::ImageCompressor::CompressionSpec("raw"));
+  autoTiles.setPropertyValue("tiles", "0");
+  auto a = off.compress(Image(src));
+  std::vector<icl8u> first(a.bytes, a.bytes + a.len);
+  auto b = autoTiles.compress(Image(src));
+  ICL_TEST_EQ(static_cast<int>(b.bytes[4]), 1);
+  ICL_TEST_TRUE(std::vector<icl8u>(b.bytes, b.bytes + b.len) == first);
+}
+
+#ifdef ICL_HAVE_ZSTD
+ICL_REGISTER_TEST("ImageCompressor.tiles.zstd_keyframes",
+                  "per-tile plugin instances keep temporal pre-filter state consistent") {
+  ThreadPool &pool = ThreadPool::global();
+  const int workers = pool.getNumWorkers();
+  if (workers < 3) pool.resize(3);
+  io::ImageCompressor enc(io::ImageCompressor::CompressionSpec("zstd", "3;paeth,split,key3"));
+  enc.setPropertyValue("tiles", "4");
+  io::ImageCompressor dec;
+  for (int t = 0; t < 7; ++t) {
+    auto data = enc.compress(Image(depthFrame(t)));
+    ICL_TEST_TRUE(dec.uncompress(data.bytes, data.len) == Image(depthFrame(t)));
+  }
+  if (workers < 3) pool.resize(workers);
+}
+#endif
+
 // ---- Kinect 11-bit pack/unpack roundtrip via ImageCompressor("1611") ----
 // Replaces the retired io/demos/depth_img_endcoding_test demo. The "1611"
 // mode has two quality levels (see ImageCompressor.cpp:368-372):
@@ -166,3 +166,198 @@ ICL_REGISTER_TEST("utils.clipped_cast.int_to_int", "integer narrowing clamps")
   auto fs = [](icl16s v){ return clipped_cast<icl16s,icl8u>(v); };
   ICL_TEST_EQ(fs(-1), (icl8u)0);
 }
+
+// --- ThreadPool ---
+
+#include <icl/utils/ThreadPool.h>
+#include <atomic>
+#include <stdexcept>
+
+ICL_REGISTER_TEST("utils.threadpool.parallel_for_coverage", "every index visited exactly once")
+{
+  ThreadPool pool(3);
+  std::vector<std::atomic<int>> hits(1000);
+  pool.parallelFor(0, 1000, 7, [&](int a, int b){
+    for(int i = a; i < b; ++i) hits[i]++;
+  });
+  for(auto &h : hits) ICL_TEST_EQ(h.load(), 1);
+}
+
+ICL_REGISTER_TEST("utils.threadpool.no_workers", "zero workers degrades to a serial loop")
+{
+  ThreadPool pool(0);
+  ICL_TEST_EQ(pool.getNumWorkers(), 0);
+  int sum = 0;
+  pool.parallelFor(0, 100, 10, [&](int a, int b){ for(int i = a; i < b; ++i) sum += i; });
+  ICL_TEST_EQ(sum, 4950);
+  ICL_TEST_EQ(pool.async([]{ return 42; }).get(), 42);
+}
+
+ICL_REGISTER_TEST("utils.threadpool.nested", "nested parallelFor does not deadlock")
+{
+  ThreadPool pool(2);
+  std::atomic<int> count{0};
+  pool.parallelForEach(8, [&](int){
+    pool.parallelFor(0, 64, 4, [&](int a, int b){ count += b - a; });
+  });
+  ICL_TEST_EQ(count.load(), 8 * 64);
+}
+
+ICL_REGISTER_TEST("utils.threadpool.exception", "exceptions propagate to the caller")
+{
+  ThreadPool pool(2);
+  bool caught = false;
+  try{
+    pool.parallelForEach(16, [](int i){ if(i == 11) throw std::runtime_error("boom"); });
+  }catch(const std::runtime_error &){
+    caught = true;
+  }
+  ICL_TEST_TRUE(caught);
+}
+
+ICL_REGISTER_TEST("utils.threadpool.resize", "resize keeps the pool usable")
+{
+  ThreadPool pool(1);
+  auto f = pool.async([]{ return 7; });
+  pool.resize(3);
+  ICL_TEST_EQ(pool.getNumWorkers(), 3);
+  ICL_TEST_EQ(f.get(), 7);
+  std::atomic<int> n{0};
+  pool.parallelForEach(50, [&](int){ n++; });
+  ICL_TEST_EQ(n.load(), 50);
+}
+
+// --- BackendTuning ---
+
+#include <icl/utils/BackendDispatching.h>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+  struct TuneCtx { int size = 0; int *out = nullptr; };
+  enum class TuneOp : int { run };
+  const char *toString(TuneOp){ return "run"; }
+}
+
+template<> struct icl::utils::BackendTuningTraits<TuneCtx> {
+  static constexpr bool enabled = true;
+  static std::string key(const TuneCtx &c){ return std::to_string(c.size); }
+  static const void *identity(const TuneCtx &c){ return c.out; }
+};
+
+namespace {
+  using TuneSig = void(const TuneCtx&, TuneCtx&);
+
+  // the higher-priority Simd backend is deliberately slow
+  BackendDispatching<TuneCtx> make_tuning_dispatcher(std::atomic<int> &simdCalls){
+    BackendDispatching<TuneCtx> d;
+    auto &sel = d.addSelector<TuneSig>(TuneOp::run);
+    sel.add(Backend::Cpp, [](const TuneCtx &, TuneCtx &dst){ *dst.out = 1; });
+    sel.add(Backend::Simd, [&simdCalls](const TuneCtx &, TuneCtx &dst){
+      ++simdCalls;
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+      *dst.out = 2;
+    });
+    return d;
+  }
+}
+
+ICL_REGISTER_TEST("utils.backend_tuning.measured_winner", "tuning picks the fastest backend and persists it")
+{
+  const std::string file = (std::filesystem::temp_directory_path()
+                            / ("icl-tuning-test-" + std::to_string(::getpid()) + ".txt")).string();
+  const std::string oldFile = BackendTuning::getCacheFile();
+  BackendTuning::setCacheFile(file);
+  BackendTuning::ScopedMode tuning(true);
+
+  std::atomic<int> simdCalls{0};
+  auto d = make_tuning_dispatcher(simdCalls);
+  auto &sel = d.getSelector<TuneSig>(TuneOp::run);
+  int a = 0, b = 0;
+  TuneCtx src{640, &a}, dst{640, &b};
+
+  // untuned: static priority; first tuned call measures both backends
+  sel.resolve(src)->apply(src, dst);
+  ICL_TEST_EQ(b, 1);
+  ICL_TEST_TRUE(simdCalls.load() > 0);
+  ICL_TEST_EQ(static_cast<int>(sel.resolve(src)->backend), static_cast<int>(Backend::Cpp));
+
+  // in-place calls are not measured
+  TuneCtx other{1 << 20, &a};
+  sel.resolve(other)->apply(other, other);
+  ICL_TEST_EQ(a, 2);
+  ICL_TEST_FALSE(BackendTuning::lookup(sel.qualifiedName + " [1048576]").has_value());
+
+  // the decision survives a reload from disk
+  BackendTuning::clear();
+  auto w = BackendTuning::lookup(sel.qualifiedName + " [640]");
+  ICL_TEST_TRUE(w.has_value());
+  ICL_TEST_TRUE(w && *w == Backend::Cpp);
+  std::ostringstream s;
+  BackendTuning::dump(s);
+  ICL_TEST_TRUE(s.str().find("TuneOp::run [640]") != std::string::npos);
+
+  // forcing overrides tuning
+  sel.force(Backend::Simd);
+  ICL_TEST_EQ(static_cast<int>(sel.resolve(src)->backend), static_cast<int>(Backend::Simd));
+  sel.unforce();
+
+  BackendTuning::setCacheFile(oldFile);
+  BackendTuning::clear();
+  std::remove(file.c_str());
+}
+
+ICL_REGISTER_TEST("utils.backend_tuning.candidate_change", "tuning state survives candidate set changes and caches decisions")
+{
+  const std::string file = (std::filesystem::temp_directory_path()
+                            / ("icl-tuning-test-" + std::to_string(::getpid()) + ".txt")).string();
+  const std::string oldFile = BackendTuning::getCacheFile();
+  BackendTuning::setCacheFile(file);
+  BackendTuning::ScopedMode tuning(true);
+
+  std::atomic<int> simdCalls{0};
+  bool withIpp = false;
+  auto d = make_tuning_dispatcher(simdCalls);
+  auto &sel = d.getSelector<TuneSig>(TuneOp::run);
+  sel.add(Backend::Ipp, [](const TuneCtx &, TuneCtx &dst){ *dst.out = 3; },
+          [&withIpp](const TuneCtx &){ return withIpp; });
+  int a = 0, b = 0;
+  TuneCtx src{320, &a}, dst{320, &b};
+
+  // a changed candidate set gets its own tuning state, the previously
+  // returned one stays valid
+  auto *first = sel.resolve(src);
+  withIpp = true;
+  auto *second = sel.resolve(src);
+  ICL_TEST_TRUE(first != second);
+  withIpp = false;
+  ICL_TEST_TRUE(sel.resolve(src) == first);
+  first->apply(src, dst);
+  ICL_TEST_EQ(b, 1);
+
+  // the decision is kept by the selector, even if the global cache is gone
+  BackendTuning::setCacheFile("");
+  BackendTuning::clear();
+  ICL_TEST_EQ(static_cast<int>(sel.resolve(src)->backend), static_cast<int>(Backend::Cpp));
+  ICL_TEST_TRUE(sel.resolve(src)->concurrentImpl() == sel.resolve(src));
+
+  BackendTuning::setCacheFile(oldFile);
+  BackendTuning::clear();
+  std::remove(file.c_str());
+}
+
+ICL_REGISTER_TEST("utils.backend_tuning.disabled", "without tuning mode the static priority is used")
+{
+  BackendTuning::ScopedMode tuning(false);
+  std::atomic<int> simdCalls{0};
+  auto d = make_tuning_dispatcher(simdCalls);
+  int a = 0, b = 0;
+  TuneCtx src{640, &a}, dst{640, &b};
+  d.getSelector<TuneSig>(TuneOp::run).resolve(src)->apply(src, dst);
+  ICL_TEST_EQ(b, 2);
+  ICL_TEST_EQ(simdCalls.load(), 1);
+}